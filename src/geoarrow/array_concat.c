@@ -0,0 +1,79 @@
+
+#include <errno.h>
+#include <stdint.h>
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+
+// Reserves the exact size of every offset and coordinate buffer in the output so
+// that each array's buffers can be appended without reallocating
+static GeoArrowErrorCode GeoArrowConcatReserve(struct GeoArrowBuilder* builder,
+                                               struct GeoArrowArrayView* array_views,
+                                               int64_t n_arrays) {
+  struct GeoArrowArrayView* first = array_views;
+  int64_t n_items[4] = {0, 0, 0, 0};
+
+  for (int64_t i = 0; i < n_arrays; i++) {
+    int64_t begin = 0;
+    int64_t end = array_views[i].length;
+    n_items[0] += end;
+    for (int32_t level = 0; level < first->n_offsets; level++) {
+      begin = array_views[i].offsets[level][begin];
+      end = array_views[i].offsets[level][end];
+      n_items[level + 1] += end - begin;
+    }
+  }
+
+  // Offset buffers have one more element than their number of items
+  for (int32_t level = 0; level < first->n_offsets; level++) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowBuilderReserveBuffer(
+        builder, 1 + level, (n_items[level] + 1) * sizeof(int32_t)));
+  }
+
+  for (int32_t j = 0; j < first->coords.n_values; j++) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowBuilderReserveBuffer(
+        builder, 1 + first->n_offsets + j, n_items[first->n_offsets] * sizeof(double)));
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowConcat(struct GeoArrowArrayView* array_views, int64_t n_arrays,
+                                 struct ArrowArray* out, struct GeoArrowError* error) {
+  if (n_arrays < 1) {
+    ArrowErrorSet((struct ArrowError*)error, "Expected n_arrays >= 1 but got %ld",
+                  (long)n_arrays);
+    return EINVAL;
+  }
+
+  enum GeoArrowType type = array_views[0].schema_view.type;
+  for (int64_t i = 1; i < n_arrays; i++) {
+    if (array_views[i].schema_view.type != type) {
+      ArrowErrorSet((struct ArrowError*)error,
+                    "Expected array %ld to have type %d but found type %d", (long)i,
+                    (int)type, (int)array_views[i].schema_view.type);
+      return EINVAL;
+    }
+  }
+
+  struct GeoArrowBuilder builder;
+  NANOARROW_RETURN_NOT_OK(GeoArrowBuilderInitFromType(&builder, type));
+
+  int result = GeoArrowConcatReserve(&builder, array_views, n_arrays);
+  for (int64_t i = 0; i < n_arrays && result == GEOARROW_OK; i++) {
+    result = GeoArrowBuilderAppendArrayView(&builder, array_views + i, 0,
+                                            array_views[i].length);
+    if (result == EOVERFLOW) {
+      ArrowErrorSet((struct ArrowError*)error,
+                    "Concatenated offsets of array %ld exceed the int32 range", (long)i);
+    }
+  }
+
+  if (result == GEOARROW_OK) {
+    result = GeoArrowBuilderFinish(&builder, out, error);
+  }
+
+  GeoArrowBuilderReset(&builder);
+  return result;
+}
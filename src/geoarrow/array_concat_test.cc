@@ -0,0 +1,112 @@
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+static std::vector<std::string> ConcatWKT(
+    enum GeoArrowType type, const std::vector<std::vector<std::string>>& batches) {
+  std::vector<struct ArrowArray> arrays(batches.size());
+  std::vector<struct GeoArrowArrayView> array_views(batches.size());
+  for (size_t i = 0; i < batches.size(); i++) {
+    ArrayFromWKT(type, batches[i], &arrays[i]);
+    EXPECT_EQ(GeoArrowArrayViewInitFromType(&array_views[i], type), GEOARROW_OK);
+    EXPECT_EQ(GeoArrowArrayViewSetArray(&array_views[i], &arrays[i], nullptr),
+              GEOARROW_OK);
+  }
+
+  struct ArrowArray out;
+  struct GeoArrowError error;
+  EXPECT_EQ(GeoArrowConcat(array_views.data(), array_views.size(), &out, &error),
+            GEOARROW_OK)
+      << error.message;
+
+  int64_t expected_null_count = 0;
+  for (auto& array : arrays) {
+    expected_null_count += array.null_count;
+    array.release(&array);
+  }
+
+  EXPECT_EQ(out.null_count, expected_null_count);
+  auto values = ArrayToWKT(type, &out);
+  out.release(&out);
+  return values;
+}
+
+TEST(ArrayConcatTest, ArrayConcatTestPoint) {
+  auto values = ConcatWKT(
+      GEOARROW_TYPE_POINT,
+      {{"POINT (0 1)", "POINT (2 3)", "POINT (4 5)"}, {}, {"", "POINT (6 7)"}});
+  EXPECT_EQ(values, std::vector<std::string>({"POINT (0 1)", "POINT (2 3)",
+                                              "POINT (4 5)", "<null value>",
+                                              "POINT (6 7)"}));
+}
+
+TEST(ArrayConcatTest, ArrayConcatTestNested) {
+  auto values = ConcatWKT(
+      GEOARROW_TYPE_MULTIPOLYGON,
+      {{"MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)))", "MULTIPOLYGON EMPTY"},
+       {"MULTIPOLYGON (((10 10, 11 10, 10 11, 10 10)), ((0 0, 1 0, 0 1, 0 0), "
+        "(0.1 0.1, 0.2 0.1, 0.1 0.2, 0.1 0.1)))"},
+       {"", "MULTIPOLYGON (((1 1, 2 1, 1 2, 1 1)))"}});
+  EXPECT_EQ(values,
+            std::vector<std::string>(
+                {"MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)))", "MULTIPOLYGON EMPTY",
+                 "MULTIPOLYGON (((10 10, 11 10, 10 11, 10 10)), ((0 0, 1 0, 0 1, 0 0), "
+                 "(0.1 0.1, 0.2 0.1, 0.1 0.2, 0.1 0.1)))",
+                 "<null value>", "MULTIPOLYGON (((1 1, 2 1, 1 2, 1 1)))"}));
+}
+
+TEST(ArrayConcatTest, ArrayConcatTestValidityNotByteAligned) {
+  // Batches of 3, 5, and 11 features put every batch boundary in the middle of a
+  // byte of the output validity bitmap
+  std::vector<std::vector<std::string>> batches;
+  std::vector<std::string> expected;
+  int feature_id = 0;
+  for (int batch_size : {3, 5, 11}) {
+    std::vector<std::string> batch;
+    for (int i = 0; i < batch_size; i++) {
+      if (feature_id % 4 == 1) {
+        batch.push_back("");
+        expected.push_back("<null value>");
+      } else {
+        std::string wkt = "LINESTRING (" + std::to_string(feature_id) + " 0, 1 1)";
+        batch.push_back(wkt);
+        expected.push_back(wkt);
+      }
+
+      feature_id++;
+    }
+
+    batches.push_back(batch);
+  }
+
+  EXPECT_EQ(ConcatWKT(GEOARROW_TYPE_LINESTRING, batches), expected);
+
+  // Batches without nulls mixed with batches that have them
+  batches[0] = {"LINESTRING (0 0, 1 1)", "LINESTRING (2 2, 3 3)", "LINESTRING EMPTY"};
+  expected[0] = "LINESTRING (0 0, 1 1)";
+  expected[1] = "LINESTRING (2 2, 3 3)";
+  expected[2] = "LINESTRING EMPTY";
+  EXPECT_EQ(ConcatWKT(GEOARROW_TYPE_LINESTRING, batches), expected);
+}
+
+TEST(ArrayConcatTest, ArrayConcatTestErrors) {
+  struct ArrowArray out;
+  struct GeoArrowError error;
+  EXPECT_EQ(GeoArrowConcat(nullptr, 0, &out, &error), EINVAL);
+  EXPECT_STREQ(error.message, "Expected n_arrays >= 1 but got 0");
+
+  struct GeoArrowArrayView array_views[2];
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(array_views + 0, GEOARROW_TYPE_POINT),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(array_views + 1, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  EXPECT_EQ(GeoArrowConcat(array_views, 2, &out, &error), EINVAL);
+  std::string expected_message =
+      "Expected array 1 to have type " + std::to_string(GEOARROW_TYPE_POINT) +
+      " but found type " + std::to_string(GEOARROW_TYPE_LINESTRING);
+  EXPECT_EQ(std::string(error.message), expected_message);
+}
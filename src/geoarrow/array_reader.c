@@ -0,0 +1,206 @@
+
+#include <errno.h>
+#include <string.h>
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+
+struct GeoArrowArrayReaderPrivate {
+  enum GeoArrowType type;
+  struct ArrowArrayView array_view;
+  struct GeoArrowArrayView geo_array_view;
+  struct GeoArrowUnionArrayView union_array_view;
+  struct GeoArrowWKBReader wkb_reader;
+  struct GeoArrowWKTReader wkt_reader;
+};
+
+static int GeoArrowArrayReaderVisitWKB(struct GeoArrowArrayReaderPrivate* private,
+                                       int64_t offset, int64_t length,
+                                       struct GeoArrowVisitor* v) {
+  struct GeoArrowBufferView item;
+  struct ArrowBufferView value;
+  for (int64_t i = 0; i < length; i++) {
+    if (ArrowArrayViewIsNull(&private->array_view, offset + i)) {
+      NANOARROW_RETURN_NOT_OK(v->feat_start(v));
+      NANOARROW_RETURN_NOT_OK(v->null_feat(v));
+      NANOARROW_RETURN_NOT_OK(v->feat_end(v));
+    } else {
+      value = ArrowArrayViewGetBytesUnsafe(&private->array_view, offset + i);
+      item.data = value.data.as_uint8;
+      item.n_bytes = value.n_bytes;
+      NANOARROW_RETURN_NOT_OK(GeoArrowWKBReaderVisit(&private->wkb_reader, item, v));
+    }
+  }
+
+  return GEOARROW_OK;
+}
+
+static int GeoArrowArrayReaderVisitWKT(struct GeoArrowArrayReaderPrivate* private,
+                                       int64_t offset, int64_t length,
+                                       struct GeoArrowVisitor* v) {
+  struct GeoArrowStringView item;
+  struct ArrowStringView value;
+  for (int64_t i = 0; i < length; i++) {
+    if (ArrowArrayViewIsNull(&private->array_view, offset + i)) {
+      NANOARROW_RETURN_NOT_OK(v->feat_start(v));
+      NANOARROW_RETURN_NOT_OK(v->null_feat(v));
+      NANOARROW_RETURN_NOT_OK(v->feat_end(v));
+    } else {
+      value = ArrowArrayViewGetStringUnsafe(&private->array_view, offset + i);
+      item.data = value.data;
+      item.n_bytes = value.n_bytes;
+      NANOARROW_RETURN_NOT_OK(GeoArrowWKTReaderVisit(&private->wkt_reader, item, v));
+    }
+  }
+
+  return GEOARROW_OK;
+}
+
+static GeoArrowErrorCode GeoArrowArrayReaderInitInternal(
+    struct GeoArrowArrayReader* reader, enum GeoArrowType type) {
+  struct GeoArrowArrayReaderPrivate* private =
+      (struct GeoArrowArrayReaderPrivate*)ArrowMalloc(
+          sizeof(struct GeoArrowArrayReaderPrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct GeoArrowArrayReaderPrivate));
+  private->type = type;
+
+  int result;
+  switch (type) {
+    case GEOARROW_TYPE_WKB:
+      ArrowArrayViewInit(&private->array_view, NANOARROW_TYPE_BINARY);
+      result = GeoArrowWKBReaderInit(&private->wkb_reader);
+      break;
+    case GEOARROW_TYPE_LARGE_WKB:
+      ArrowArrayViewInit(&private->array_view, NANOARROW_TYPE_LARGE_BINARY);
+      result = GeoArrowWKBReaderInit(&private->wkb_reader);
+      break;
+    case GEOARROW_TYPE_WKT:
+      ArrowArrayViewInit(&private->array_view, NANOARROW_TYPE_STRING);
+      result = GeoArrowWKTReaderInit(&private->wkt_reader);
+      break;
+    case GEOARROW_TYPE_LARGE_WKT:
+      ArrowArrayViewInit(&private->array_view, NANOARROW_TYPE_LARGE_STRING);
+      result = GeoArrowWKTReaderInit(&private->wkt_reader);
+      break;
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
+      result = GeoArrowUnionArrayViewInitFromType(&private->union_array_view, type);
+      break;
+    default:
+      result = GeoArrowArrayViewInitFromType(&private->geo_array_view, type);
+      break;
+  }
+
+  if (result != GEOARROW_OK) {
+    ArrowFree(private);
+    return result;
+  }
+
+  reader->private_data = private;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowArrayReaderInitFromType(struct GeoArrowArrayReader* reader,
+                                                  enum GeoArrowType type) {
+  return GeoArrowArrayReaderInitInternal(reader, type);
+}
+
+GeoArrowErrorCode GeoArrowArrayReaderInitFromSchema(struct GeoArrowArrayReader* reader,
+                                                    struct ArrowSchema* schema,
+                                                    struct GeoArrowError* error) {
+  struct GeoArrowSchemaView schema_view;
+  NANOARROW_RETURN_NOT_OK(GeoArrowSchemaViewInit(&schema_view, schema, error));
+  NANOARROW_RETURN_NOT_OK(GeoArrowArrayReaderInitInternal(reader, schema_view.type));
+
+  // The children of a union may be any subset of geometry types in any order
+  if (schema_view.type == GeoArrowMakeUnionType(schema_view.dimensions)) {
+    struct GeoArrowArrayReaderPrivate* private =
+        (struct GeoArrowArrayReaderPrivate*)reader->private_data;
+    int result = GeoArrowUnionArrayViewInitFromSchema(&private->union_array_view,
+                                                      schema, error);
+    if (result != GEOARROW_OK) {
+      GeoArrowArrayReaderReset(reader);
+      return result;
+    }
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowArrayReaderSetArray(struct GeoArrowArrayReader* reader,
+                                              struct ArrowArray* array,
+                                              struct GeoArrowError* error) {
+  struct GeoArrowArrayReaderPrivate* private =
+      (struct GeoArrowArrayReaderPrivate*)reader->private_data;
+
+  switch (private->type) {
+    case GEOARROW_TYPE_WKB:
+    case GEOARROW_TYPE_LARGE_WKB:
+    case GEOARROW_TYPE_WKT:
+    case GEOARROW_TYPE_LARGE_WKT:
+      return ArrowArrayViewSetArray(&private->array_view, array,
+                                    (struct ArrowError*)error);
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
+      return GeoArrowUnionArrayViewSetArray(&private->union_array_view, array, error);
+    default:
+      return GeoArrowArrayViewSetArray(&private->geo_array_view, array, error);
+  }
+}
+
+GeoArrowErrorCode GeoArrowArrayReaderVisit(struct GeoArrowArrayReader* reader,
+                                           int64_t offset, int64_t length,
+                                           struct GeoArrowVisitor* v) {
+  struct GeoArrowArrayReaderPrivate* private =
+      (struct GeoArrowArrayReaderPrivate*)reader->private_data;
+
+  NANOARROW_RETURN_NOT_OK(v->reserve_feat(v, length));
+
+  switch (private->type) {
+    case GEOARROW_TYPE_WKB:
+    case GEOARROW_TYPE_LARGE_WKB:
+      return GeoArrowArrayReaderVisitWKB(private, offset, length, v);
+    case GEOARROW_TYPE_WKT:
+    case GEOARROW_TYPE_LARGE_WKT:
+      return GeoArrowArrayReaderVisitWKT(private, offset, length, v);
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
+      return GeoArrowUnionArrayViewVisit(&private->union_array_view, offset, length, v);
+    default:
+      return GeoArrowArrayViewVisit(&private->geo_array_view, offset, length, v);
+  }
+}
+
+void GeoArrowArrayReaderReset(struct GeoArrowArrayReader* reader) {
+  struct GeoArrowArrayReaderPrivate* private =
+      (struct GeoArrowArrayReaderPrivate*)reader->private_data;
+
+  switch (private->type) {
+    case GEOARROW_TYPE_WKB:
+    case GEOARROW_TYPE_LARGE_WKB:
+      ArrowArrayViewReset(&private->array_view);
+      GeoArrowWKBReaderReset(&private->wkb_reader);
+      break;
+    case GEOARROW_TYPE_WKT:
+    case GEOARROW_TYPE_LARGE_WKT:
+      ArrowArrayViewReset(&private->array_view);
+      GeoArrowWKTReaderReset(&private->wkt_reader);
+      break;
+    default:
+      break;
+  }
+
+  ArrowFree(private);
+  reader->private_data = NULL;
+}
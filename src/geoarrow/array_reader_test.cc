@@ -0,0 +1,81 @@
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+TEST(ArrayReaderTest, ArrayReaderTestBasic) {
+  struct GeoArrowArrayReader reader;
+  ASSERT_EQ(GeoArrowArrayReaderInitFromType(&reader, GEOARROW_TYPE_WKB), GEOARROW_OK);
+  GeoArrowArrayReaderReset(&reader);
+
+  struct ArrowSchema schema;
+  ASSERT_EQ(GeoArrowSchemaInitExtension(&schema, GEOARROW_TYPE_WKT), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayReaderInitFromSchema(&reader, &schema, nullptr), GEOARROW_OK);
+  GeoArrowArrayReaderReset(&reader);
+  schema.release(&schema);
+}
+
+TEST(ArrayReaderTest, ArrayReaderTestVisitWKT) {
+  struct ArrowArray array;
+  ASSERT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_STRING), GEOARROW_OK);
+  ASSERT_EQ(ArrowArrayStartAppending(&array), GEOARROW_OK);
+  ASSERT_EQ(ArrowArrayAppendString(&array, ArrowCharView("POINT (0 1)")), GEOARROW_OK);
+  ASSERT_EQ(ArrowArrayAppendNull(&array, 1), GEOARROW_OK);
+  ASSERT_EQ(ArrowArrayAppendString(&array, ArrowCharView("LINESTRING (0 1, 2 3)")),
+            GEOARROW_OK);
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, nullptr), GEOARROW_OK);
+
+  struct GeoArrowArrayReader reader;
+  ASSERT_EQ(GeoArrowArrayReaderInitFromType(&reader, GEOARROW_TYPE_WKT), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayReaderSetArray(&reader, &array, nullptr), GEOARROW_OK);
+
+  WKXTester tester;
+  ASSERT_EQ(GeoArrowArrayReaderVisit(&reader, 0, array.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  auto values = tester.WKTValues("<null value>");
+  ASSERT_EQ(values.size(), 3);
+  EXPECT_EQ(values[0], "POINT (0 1)");
+  EXPECT_EQ(values[1], "<null value>");
+  EXPECT_EQ(values[2], "LINESTRING (0 1, 2 3)");
+
+  // Visit a subset of the array
+  ASSERT_EQ(GeoArrowArrayReaderVisit(&reader, 1, 2, tester.WKTVisitor()), GEOARROW_OK);
+  values = tester.WKTValues("<null value>");
+  ASSERT_EQ(values.size(), 2);
+  EXPECT_EQ(values[0], "<null value>");
+  EXPECT_EQ(values[1], "LINESTRING (0 1, 2 3)");
+
+  GeoArrowArrayReaderReset(&reader);
+  array.release(&array);
+}
+
+TEST(ArrayReaderTest, ArrayReaderTestVisitWKB) {
+  WKXTester tester;
+  std::basic_string<uint8_t> wkb = tester.AsWKB("POINT (0 1)");
+
+  struct ArrowArray array;
+  ASSERT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_BINARY), GEOARROW_OK);
+  ASSERT_EQ(ArrowArrayStartAppending(&array), GEOARROW_OK);
+  struct ArrowBufferView item;
+  item.data.as_uint8 = wkb.data();
+  item.n_bytes = wkb.size();
+  ASSERT_EQ(ArrowArrayAppendBytes(&array, item), GEOARROW_OK);
+  ASSERT_EQ(ArrowArrayAppendNull(&array, 1), GEOARROW_OK);
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, nullptr), GEOARROW_OK);
+
+  struct GeoArrowArrayReader reader;
+  ASSERT_EQ(GeoArrowArrayReaderInitFromType(&reader, GEOARROW_TYPE_WKB), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayReaderSetArray(&reader, &array, nullptr), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayReaderVisit(&reader, 0, array.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  auto values = tester.WKTValues("<null value>");
+  ASSERT_EQ(values.size(), 2);
+  EXPECT_EQ(values[0], "POINT (0 1)");
+  EXPECT_EQ(values[1], "<null value>");
+
+  GeoArrowArrayReaderReset(&reader);
+  array.release(&array);
+}
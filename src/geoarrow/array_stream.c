@@ -0,0 +1,418 @@
+
+#include <errno.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+
+struct GeoArrowArrayStreamConvertPrivate {
+  struct ArrowArrayStream input;
+  struct ArrowSchema schema;
+  struct GeoArrowArrayReader reader;
+  struct GeoArrowArrayWriter writer;
+  struct GeoArrowVisitor v;
+
+  // The first error from get_next(), which every later call returns
+  int result;
+  struct GeoArrowError error;
+};
+
+static int GeoArrowArrayStreamConvertGetSchema(struct ArrowArrayStream* stream,
+                                               struct ArrowSchema* out) {
+  struct GeoArrowArrayStreamConvertPrivate* private =
+      (struct GeoArrowArrayStreamConvertPrivate*)stream->private_data;
+  return ArrowSchemaDeepCopy(&private->schema, out);
+}
+
+static int GeoArrowArrayStreamConvertGetNextInternal(
+    struct GeoArrowArrayStreamConvertPrivate* private, struct ArrowArray* out) {
+  struct ArrowArray array_in;
+  array_in.release = NULL;
+  int result = private->input.get_next(&private->input, &array_in);
+  if (result != GEOARROW_OK) {
+    const char* message = private->input.get_last_error(&private->input);
+    ArrowErrorSet((struct ArrowError*)&private->error,
+                  "get_next() failed on input stream: %s",
+                  message == NULL ? "<no message>" : message);
+    return result;
+  }
+
+  // End of stream
+  if (array_in.release == NULL) {
+    out->release = NULL;
+    return GEOARROW_OK;
+  }
+
+  result = GeoArrowArrayReaderSetArray(&private->reader, &array_in, &private->error);
+  if (result == GEOARROW_OK) {
+    result = GeoArrowArrayReaderVisit(&private->reader, 0, array_in.length, &private->v);
+  }
+
+  array_in.release(&array_in);
+  NANOARROW_RETURN_NOT_OK(result);
+
+  return GeoArrowArrayWriterFinish(&private->writer, out, &private->error);
+}
+
+static int GeoArrowArrayStreamConvertGetNext(struct ArrowArrayStream* stream,
+                                             struct ArrowArray* out) {
+  struct GeoArrowArrayStreamConvertPrivate* private =
+      (struct GeoArrowArrayStreamConvertPrivate*)stream->private_data;
+
+  // A batch that fails partway leaves its first features in the writer, so the
+  // stream stays failed instead of prepending them to the next batch
+  if (private->result != GEOARROW_OK) {
+    return private->result;
+  }
+
+  private->error.message[0] = '\0';
+  private->result = GeoArrowArrayStreamConvertGetNextInternal(private, out);
+  return private->result;
+}
+
+static const char* GeoArrowArrayStreamConvertGetLastError(
+    struct ArrowArrayStream* stream) {
+  struct GeoArrowArrayStreamConvertPrivate* private =
+      (struct GeoArrowArrayStreamConvertPrivate*)stream->private_data;
+  return private->error.message;
+}
+
+static void GeoArrowArrayStreamConvertRelease(struct ArrowArrayStream* stream) {
+  struct GeoArrowArrayStreamConvertPrivate* private =
+      (struct GeoArrowArrayStreamConvertPrivate*)stream->private_data;
+
+  if (private->input.release != NULL) {
+    private->input.release(&private->input);
+  }
+
+  if (private->schema.release != NULL) {
+    private->schema.release(&private->schema);
+  }
+
+  if (private->reader.private_data != NULL) {
+    GeoArrowArrayReaderReset(&private->reader);
+  }
+
+  if (private->writer.private_data != NULL) {
+    GeoArrowArrayWriterReset(&private->writer);
+  }
+
+  ArrowFree(private);
+  stream->release = NULL;
+}
+
+static GeoArrowErrorCode GeoArrowArrayStreamConvertInitInternal(
+    struct GeoArrowArrayStreamConvertPrivate* private, struct ArrowArrayStream* input,
+    enum GeoArrowType type, struct GeoArrowError* error) {
+  struct ArrowSchema schema_in;
+  int result = input->get_schema(input, &schema_in);
+  if (result != GEOARROW_OK) {
+    const char* message = input->get_last_error(input);
+    ArrowErrorSet((struct ArrowError*)error, "get_schema() failed on input stream: %s",
+                  message == NULL ? "<no message>" : message);
+    return result;
+  }
+
+  struct GeoArrowSchemaView schema_view;
+  struct GeoArrowMetadataView metadata_view;
+  result = GeoArrowSchemaViewInit(&schema_view, &schema_in, error);
+  if (result == GEOARROW_OK) {
+    result =
+        GeoArrowMetadataViewInit(&metadata_view, schema_view.extension_metadata, error);
+  }
+
+  // The output keeps the name and the extension metadata (e.g., crs) of the input
+  if (result == GEOARROW_OK) {
+    result = GeoArrowSchemaInitExtension(&private->schema, type);
+  }
+
+  if (result == GEOARROW_OK) {
+    result = GeoArrowSchemaSetMetadata(&private->schema, &metadata_view);
+  }
+
+  if (result == GEOARROW_OK) {
+    result = ArrowSchemaSetName(&private->schema, schema_in.name);
+  }
+
+  if (result == GEOARROW_OK) {
+    result = GeoArrowArrayReaderInitFromType(&private->reader, schema_view.type);
+  }
+
+  schema_in.release(&schema_in);
+  NANOARROW_RETURN_NOT_OK(result);
+
+  result = GeoArrowArrayWriterInitFromType(&private->writer, type);
+  if (result != GEOARROW_OK) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Can't create GeoArrowArrayWriter for output type %d", (int)type);
+    return result;
+  }
+
+  NANOARROW_RETURN_NOT_OK(GeoArrowArrayWriterInitVisitor(&private->writer, &private->v));
+  private->v.error = &private->error;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowArrayStreamConvert(struct ArrowArrayStream* input,
+                                             enum GeoArrowType type,
+                                             struct ArrowArrayStream* out,
+                                             struct GeoArrowError* error) {
+  struct GeoArrowArrayStreamConvertPrivate* private =
+      (struct GeoArrowArrayStreamConvertPrivate*)ArrowMalloc(
+          sizeof(struct GeoArrowArrayStreamConvertPrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct GeoArrowArrayStreamConvertPrivate));
+  out->private_data = private;
+
+  int result = GeoArrowArrayStreamConvertInitInternal(private, input, type, error);
+  if (result != GEOARROW_OK) {
+    GeoArrowArrayStreamConvertRelease(out);
+    return result;
+  }
+
+  // Take ownership of the input stream
+  memcpy(&private->input, input, sizeof(struct ArrowArrayStream));
+  input->release = NULL;
+
+  out->get_schema = &GeoArrowArrayStreamConvertGetSchema;
+  out->get_next = &GeoArrowArrayStreamConvertGetNext;
+  out->get_last_error = &GeoArrowArrayStreamConvertGetLastError;
+  out->release = &GeoArrowArrayStreamConvertRelease;
+  return GEOARROW_OK;
+}
+
+#if !defined(_WIN32)
+
+struct GeoArrowArrayStreamPrefetchPrivate {
+  struct ArrowArrayStream input;
+  struct ArrowSchema schema;
+
+  // Ring buffer of batches that have been pulled from input but not yet
+  // requested by the consumer
+  struct ArrowArray* queue;
+  int64_t queue_depth;
+  int64_t queue_head;
+  int64_t queue_size;
+
+  // Worker state (protected by mutex)
+  int finished;
+  int stop;
+  int result;
+  struct GeoArrowError error;
+
+  pthread_t worker;
+  pthread_mutex_t mutex;
+  pthread_cond_t not_empty;
+  pthread_cond_t not_full;
+};
+
+static void* GeoArrowArrayStreamPrefetchWorker(void* private_data) {
+  struct GeoArrowArrayStreamPrefetchPrivate* private =
+      (struct GeoArrowArrayStreamPrefetchPrivate*)private_data;
+  struct ArrowArray array;
+
+  pthread_mutex_lock(&private->mutex);
+  while (1) {
+    while (private->queue_size == private->queue_depth && !private->stop) {
+      pthread_cond_wait(&private->not_full, &private->mutex);
+    }
+
+    if (private->stop) {
+      break;
+    }
+
+    // Only the worker touches input after initialization, so the (possibly slow)
+    // call to get_next() happens without holding the lock
+    pthread_mutex_unlock(&private->mutex);
+    array.release = NULL;
+    int result = private->input.get_next(&private->input, &array);
+    const char* message = NULL;
+    if (result != GEOARROW_OK) {
+      message = private->input.get_last_error(&private->input);
+    }
+    pthread_mutex_lock(&private->mutex);
+
+    if (result != GEOARROW_OK) {
+      private->result = result;
+      ArrowErrorSet((struct ArrowError*)&private->error, "%s",
+                    message == NULL ? "get_next() failed on input stream" : message);
+      pthread_cond_broadcast(&private->not_empty);
+      break;
+    }
+
+    if (array.release == NULL) {
+      private->finished = 1;
+      pthread_cond_broadcast(&private->not_empty);
+      break;
+    }
+
+    if (private->stop) {
+      array.release(&array);
+      break;
+    }
+
+    int64_t i = (private->queue_head + private->queue_size) % private->queue_depth;
+    memcpy(private->queue + i, &array, sizeof(struct ArrowArray));
+    private->queue_size++;
+    pthread_cond_signal(&private->not_empty);
+  }
+
+  pthread_mutex_unlock(&private->mutex);
+  return NULL;
+}
+
+static int GeoArrowArrayStreamPrefetchGetSchema(struct ArrowArrayStream* stream,
+                                                struct ArrowSchema* out) {
+  struct GeoArrowArrayStreamPrefetchPrivate* private =
+      (struct GeoArrowArrayStreamPrefetchPrivate*)stream->private_data;
+  return ArrowSchemaDeepCopy(&private->schema, out);
+}
+
+static int GeoArrowArrayStreamPrefetchGetNext(struct ArrowArrayStream* stream,
+                                              struct ArrowArray* out) {
+  struct GeoArrowArrayStreamPrefetchPrivate* private =
+      (struct GeoArrowArrayStreamPrefetchPrivate*)stream->private_data;
+
+  pthread_mutex_lock(&private->mutex);
+  while (private->queue_size == 0 && !private->finished &&
+         private->result == GEOARROW_OK) {
+    pthread_cond_wait(&private->not_empty, &private->mutex);
+  }
+
+  // Batches that were successfully pulled before an error are still returned
+  int result = GEOARROW_OK;
+  if (private->queue_size > 0) {
+    memcpy(out, private->queue + private->queue_head, sizeof(struct ArrowArray));
+    private->queue_head = (private->queue_head + 1) % private->queue_depth;
+    private->queue_size--;
+    pthread_cond_signal(&private->not_full);
+  } else if (private->result != GEOARROW_OK) {
+    result = private->result;
+  } else {
+    out->release = NULL;
+  }
+
+  pthread_mutex_unlock(&private->mutex);
+  return result;
+}
+
+static const char* GeoArrowArrayStreamPrefetchGetLastError(
+    struct ArrowArrayStream* stream) {
+  struct GeoArrowArrayStreamPrefetchPrivate* private =
+      (struct GeoArrowArrayStreamPrefetchPrivate*)stream->private_data;
+  return private->error.message;
+}
+
+static void GeoArrowArrayStreamPrefetchRelease(struct ArrowArrayStream* stream) {
+  struct GeoArrowArrayStreamPrefetchPrivate* private =
+      (struct GeoArrowArrayStreamPrefetchPrivate*)stream->private_data;
+
+  pthread_mutex_lock(&private->mutex);
+  private->stop = 1;
+  pthread_cond_broadcast(&private->not_full);
+  pthread_mutex_unlock(&private->mutex);
+  pthread_join(private->worker, NULL);
+
+  for (int64_t i = 0; i < private->queue_size; i++) {
+    struct ArrowArray* array =
+        private->queue + ((private->queue_head + i) % private->queue_depth);
+    array->release(array);
+  }
+
+  private->input.release(&private->input);
+  private->schema.release(&private->schema);
+  pthread_cond_destroy(&private->not_full);
+  pthread_cond_destroy(&private->not_empty);
+  pthread_mutex_destroy(&private->mutex);
+  ArrowFree(private->queue);
+  ArrowFree(private);
+  stream->release = NULL;
+}
+
+GeoArrowErrorCode GeoArrowArrayStreamPrefetch(struct ArrowArrayStream* input,
+                                              int64_t queue_depth,
+                                              struct ArrowArrayStream* out,
+                                              struct GeoArrowError* error) {
+  if (queue_depth < 1) {
+    ArrowErrorSet((struct ArrowError*)error, "Expected queue_depth >= 1 but got %ld",
+                  (long)queue_depth);
+    return EINVAL;
+  }
+
+  struct GeoArrowArrayStreamPrefetchPrivate* private =
+      (struct GeoArrowArrayStreamPrefetchPrivate*)ArrowMalloc(
+          sizeof(struct GeoArrowArrayStreamPrefetchPrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct GeoArrowArrayStreamPrefetchPrivate));
+  private->queue_depth = queue_depth;
+  private->queue =
+      (struct ArrowArray*)ArrowMalloc(queue_depth * sizeof(struct ArrowArray));
+  if (private->queue == NULL) {
+    ArrowFree(private);
+    return ENOMEM;
+  }
+
+  // The schema is cached up front so that get_schema() never races with the
+  // worker's calls to get_next()
+  int result = input->get_schema(input, &private->schema);
+  if (result != GEOARROW_OK) {
+    const char* message = input->get_last_error(input);
+    ArrowErrorSet((struct ArrowError*)error, "get_schema() failed on input stream: %s",
+                  message == NULL ? "<no message>" : message);
+    ArrowFree(private->queue);
+    ArrowFree(private);
+    return result;
+  }
+
+  pthread_mutex_init(&private->mutex, NULL);
+  pthread_cond_init(&private->not_empty, NULL);
+  pthread_cond_init(&private->not_full, NULL);
+
+  memcpy(&private->input, input, sizeof(struct ArrowArrayStream));
+  result = pthread_create(&private->worker, NULL, &GeoArrowArrayStreamPrefetchWorker,
+                          private);
+  if (result != 0) {
+    ArrowErrorSet((struct ArrowError*)error, "Failed to start prefetch worker thread");
+    pthread_cond_destroy(&private->not_full);
+    pthread_cond_destroy(&private->not_empty);
+    pthread_mutex_destroy(&private->mutex);
+    private->schema.release(&private->schema);
+    ArrowFree(private->queue);
+    ArrowFree(private);
+    return result;
+  }
+
+  // The worker now owns the input stream
+  input->release = NULL;
+
+  out->private_data = private;
+  out->get_schema = &GeoArrowArrayStreamPrefetchGetSchema;
+  out->get_next = &GeoArrowArrayStreamPrefetchGetNext;
+  out->get_last_error = &GeoArrowArrayStreamPrefetchGetLastError;
+  out->release = &GeoArrowArrayStreamPrefetchRelease;
+  return GEOARROW_OK;
+}
+
+#else
+
+GeoArrowErrorCode GeoArrowArrayStreamPrefetch(struct ArrowArrayStream* input,
+                                              int64_t queue_depth,
+                                              struct ArrowArrayStream* out,
+                                              struct GeoArrowError* error) {
+  ArrowErrorSet((struct ArrowError*)error,
+                "GeoArrowArrayStreamPrefetch() is not supported on this platform");
+  return ENOTSUP;
+}
+
+#endif
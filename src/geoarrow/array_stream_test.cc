@@ -0,0 +1,285 @@
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+// An ArrowArrayStream of geoarrow.wkt batches built from vectors of strings,
+// where an empty string is a null feature
+class WKTBatchStream {
+ public:
+  static void Make(const std::vector<std::vector<std::string>>& batches,
+                   struct ArrowArrayStream* out) {
+    auto private_data = new WKTBatchStream();
+    private_data->batches_ = batches;
+    out->get_schema = &GetSchema;
+    out->get_next = &GetNext;
+    out->get_last_error = &GetLastError;
+    out->release = &Release;
+    out->private_data = private_data;
+  }
+
+  int fail_at_batch_{-1};
+
+ private:
+  std::vector<std::vector<std::string>> batches_;
+  size_t i_{0};
+
+  static int GetSchema(struct ArrowArrayStream* stream, struct ArrowSchema* out) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowSchemaInitExtension(out, GEOARROW_TYPE_WKT));
+    return ArrowSchemaSetName(out, "geometry");
+  }
+
+  static int GetNext(struct ArrowArrayStream* stream, struct ArrowArray* out) {
+    auto self = reinterpret_cast<WKTBatchStream*>(stream->private_data);
+    if (self->i_ >= self->batches_.size()) {
+      out->release = nullptr;
+      return GEOARROW_OK;
+    }
+
+    if (static_cast<int>(self->i_) == self->fail_at_batch_) {
+      return EIO;
+    }
+
+    NANOARROW_RETURN_NOT_OK(ArrowArrayInit(out, NANOARROW_TYPE_STRING));
+    NANOARROW_RETURN_NOT_OK(ArrowArrayStartAppending(out));
+    for (const auto& item : self->batches_[self->i_]) {
+      if (item.empty()) {
+        NANOARROW_RETURN_NOT_OK(ArrowArrayAppendNull(out, 1));
+      } else {
+        NANOARROW_RETURN_NOT_OK(ArrowArrayAppendString(out, ArrowCharView(item.c_str())));
+      }
+    }
+
+    self->i_++;
+    return ArrowArrayFinishBuilding(out, nullptr);
+  }
+
+  static const char* GetLastError(struct ArrowArrayStream* stream) {
+    return "WKTBatchStream failed";
+  }
+
+  static void Release(struct ArrowArrayStream* stream) {
+    delete reinterpret_cast<WKTBatchStream*>(stream->private_data);
+    stream->release = nullptr;
+  }
+};
+
+TEST(ArrayStreamTest, ArrayStreamTestConvertSchema) {
+  struct ArrowArrayStream input;
+  struct ArrowArrayStream output;
+  struct ArrowSchema schema;
+  struct GeoArrowError error;
+  WKTBatchStream::Make({}, &input);
+
+  ASSERT_EQ(GeoArrowArrayStreamConvert(&input, GEOARROW_TYPE_WKB, &output, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(input.release, nullptr);
+
+  ASSERT_EQ(output.get_schema(&output, &schema), GEOARROW_OK);
+  EXPECT_STREQ(schema.name, "geometry");
+
+  struct GeoArrowSchemaView schema_view;
+  ASSERT_EQ(GeoArrowSchemaViewInit(&schema_view, &schema, &error), GEOARROW_OK);
+  EXPECT_EQ(schema_view.type, GEOARROW_TYPE_WKB);
+  schema.release(&schema);
+
+  struct ArrowArray array;
+  ASSERT_EQ(output.get_next(&output, &array), GEOARROW_OK);
+  EXPECT_EQ(array.release, nullptr);
+
+  output.release(&output);
+}
+
+TEST(ArrayStreamTest, ArrayStreamTestConvertBatches) {
+  struct ArrowArrayStream input;
+  struct ArrowArrayStream output;
+  struct GeoArrowError error;
+  WKTBatchStream::Make({{"LINESTRING (0 1, 2 3)", ""}, {}, {"LINESTRING EMPTY"}},
+                       &input);
+
+  ASSERT_EQ(
+      GeoArrowArrayStreamConvert(&input, GEOARROW_TYPE_LINESTRING, &output, &error),
+      GEOARROW_OK);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+
+  std::vector<std::string> values;
+  struct ArrowArray array;
+  while (true) {
+    ASSERT_EQ(output.get_next(&output, &array), GEOARROW_OK)
+        << output.get_last_error(&output);
+    if (array.release == nullptr) {
+      break;
+    }
+
+    ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, &error), GEOARROW_OK);
+    WKXTester tester;
+    ASSERT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array.length, tester.WKTVisitor()),
+              GEOARROW_OK);
+    for (const auto& value : tester.WKTValues("<null value>")) {
+      values.push_back(value);
+    }
+
+    array.release(&array);
+  }
+
+  ASSERT_EQ(values.size(), 3);
+  EXPECT_EQ(values[0], "LINESTRING (0 1, 2 3)");
+  EXPECT_EQ(values[1], "<null value>");
+  EXPECT_EQ(values[2], "LINESTRING EMPTY");
+
+  output.release(&output);
+}
+
+TEST(ArrayStreamTest, ArrayStreamTestConvertErrors) {
+  struct ArrowArrayStream input;
+  struct ArrowArrayStream output;
+  struct GeoArrowError error;
+  struct ArrowArray array;
+
+  // Output type not supported: input is not consumed
+  WKTBatchStream::Make({}, &input);
+  EXPECT_EQ(GeoArrowArrayStreamConvert(&input, GEOARROW_TYPE_LARGE_WKB, &output, &error),
+            ENOTSUP);
+  ASSERT_NE(input.release, nullptr);
+  input.release(&input);
+
+  // Geometry that can't be written to the output type
+  WKTBatchStream::Make({{"LINESTRING (0 1, 2 3)"}}, &input);
+  ASSERT_EQ(GeoArrowArrayStreamConvert(&input, GEOARROW_TYPE_POINT, &output, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(output.get_next(&output, &array), EINVAL);
+  EXPECT_STREQ(output.get_last_error(&output),
+               "Can't append geometry of type LINESTRING to builder of type POINT");
+  output.release(&output);
+
+  // Errors from the input stream
+  WKTBatchStream::Make({{"POINT (0 1)"}}, &input);
+  reinterpret_cast<WKTBatchStream*>(input.private_data)->fail_at_batch_ = 0;
+  ASSERT_EQ(GeoArrowArrayStreamConvert(&input, GEOARROW_TYPE_POINT, &output, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(output.get_next(&output, &array), EIO);
+  EXPECT_STREQ(output.get_last_error(&output),
+               "get_next() failed on input stream: WKTBatchStream failed");
+  output.release(&output);
+}
+
+TEST(ArrayStreamTest, ArrayStreamTestConvertErrorIsFinal) {
+  struct ArrowArrayStream input;
+  struct ArrowArrayStream output;
+  struct GeoArrowError error;
+  struct ArrowArray array;
+
+  // The first feature of the failing batch is written before the second one fails
+  // and must not turn up in a later batch
+  WKTBatchStream::Make({{"POINT (0 1)", "LINESTRING (2 3)"}, {"POINT (4 5)"}}, &input);
+  ASSERT_EQ(GeoArrowArrayStreamConvert(&input, GEOARROW_TYPE_POINT, &output, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(output.get_next(&output, &array), EINVAL);
+  std::string message = output.get_last_error(&output);
+  EXPECT_EQ(message, "Can't append geometry of type LINESTRING to builder of type POINT");
+
+  EXPECT_EQ(output.get_next(&output, &array), EINVAL);
+  EXPECT_EQ(output.get_last_error(&output), message);
+  output.release(&output);
+}
+
+static std::vector<std::string> CollectWKT(struct ArrowArrayStream* stream,
+                                           enum GeoArrowType type) {
+  struct GeoArrowArrayReader reader;
+  struct ArrowArray array;
+  std::vector<std::string> values;
+  EXPECT_EQ(GeoArrowArrayReaderInitFromType(&reader, type), GEOARROW_OK);
+
+  while (true) {
+    int result = stream->get_next(stream, &array);
+    EXPECT_EQ(result, GEOARROW_OK) << stream->get_last_error(stream);
+    if (result != GEOARROW_OK || array.release == nullptr) {
+      break;
+    }
+
+    EXPECT_EQ(GeoArrowArrayReaderSetArray(&reader, &array, nullptr), GEOARROW_OK);
+    WKXTester tester;
+    EXPECT_EQ(GeoArrowArrayReaderVisit(&reader, 0, array.length, tester.WKTVisitor()),
+              GEOARROW_OK);
+    for (const auto& value : tester.WKTValues("<null value>")) {
+      values.push_back(value);
+    }
+
+    array.release(&array);
+  }
+
+  GeoArrowArrayReaderReset(&reader);
+  return values;
+}
+
+TEST(ArrayStreamTest, ArrayStreamTestPrefetch) {
+  std::vector<std::vector<std::string>> batches;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 20; i++) {
+    std::string wkt = "POINT (" + std::to_string(i) + " 1)";
+    batches.push_back({wkt, ""});
+    expected.push_back(wkt);
+    expected.push_back("<null value>");
+  }
+
+  for (int64_t queue_depth : {1, 3, 100}) {
+    struct ArrowArrayStream input;
+    struct ArrowArrayStream converted;
+    struct ArrowArrayStream output;
+    struct ArrowSchema schema;
+    struct GeoArrowError error;
+    WKTBatchStream::Make(batches, &input);
+
+    ASSERT_EQ(GeoArrowArrayStreamConvert(&input, GEOARROW_TYPE_WKB, &converted, &error),
+              GEOARROW_OK);
+    ASSERT_EQ(GeoArrowArrayStreamPrefetch(&converted, queue_depth, &output, &error),
+              GEOARROW_OK);
+    EXPECT_EQ(converted.release, nullptr);
+
+    ASSERT_EQ(output.get_schema(&output, &schema), GEOARROW_OK);
+    EXPECT_STREQ(schema.name, "geometry");
+    schema.release(&schema);
+
+    EXPECT_EQ(CollectWKT(&output, GEOARROW_TYPE_WKB), expected);
+    output.release(&output);
+  }
+}
+
+TEST(ArrayStreamTest, ArrayStreamTestPrefetchErrors) {
+  struct ArrowArrayStream input;
+  struct ArrowArrayStream output;
+  struct GeoArrowError error;
+  struct ArrowArray array;
+
+  WKTBatchStream::Make({}, &input);
+  EXPECT_EQ(GeoArrowArrayStreamPrefetch(&input, 0, &output, &error), EINVAL);
+  EXPECT_STREQ(error.message, "Expected queue_depth >= 1 but got 0");
+  ASSERT_NE(input.release, nullptr);
+  input.release(&input);
+
+  // Batches pulled before the error are still returned
+  WKTBatchStream::Make({{"POINT (0 1)"}, {"POINT (2 3)"}}, &input);
+  reinterpret_cast<WKTBatchStream*>(input.private_data)->fail_at_batch_ = 1;
+  ASSERT_EQ(GeoArrowArrayStreamPrefetch(&input, 2, &output, &error), GEOARROW_OK);
+  ASSERT_EQ(output.get_next(&output, &array), GEOARROW_OK);
+  ASSERT_NE(array.release, nullptr);
+  EXPECT_EQ(array.length, 1);
+  array.release(&array);
+  EXPECT_EQ(output.get_next(&output, &array), EIO);
+  EXPECT_STREQ(output.get_last_error(&output), "WKTBatchStream failed");
+  output.release(&output);
+
+  // Releasing while the worker is waiting on a full queue
+  WKTBatchStream::Make({{"POINT (0 1)"}, {"POINT (2 3)"}, {"POINT (4 5)"}}, &input);
+  ASSERT_EQ(GeoArrowArrayStreamPrefetch(&input, 1, &output, &error), GEOARROW_OK);
+  output.release(&output);
+}
@@ -0,0 +1,120 @@
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+
+// Appends features [begin, begin + length) as a single range. A failed append leaves
+// the builder unchanged, so on failure the range is appended again one feature at a
+// time to find the feature that can't be appended.
+static GeoArrowErrorCode GeoArrowTakeAppendRange(struct GeoArrowBuilder* builder,
+                                                 struct GeoArrowArrayView* array_view,
+                                                 int64_t begin, int64_t length,
+                                                 struct GeoArrowError* error) {
+  int result = GeoArrowBuilderAppendArrayView(builder, array_view, begin, length);
+  if (result == GEOARROW_OK) {
+    return GEOARROW_OK;
+  }
+
+  for (int64_t i = begin; i < (begin + length); i++) {
+    result = GeoArrowBuilderAppendArrayView(builder, array_view, i, 1);
+    if (result == EOVERFLOW) {
+      ArrowErrorSet((struct ArrowError*)error,
+                    "Can't append feature %ld: offsets exceed the int32 range", (long)i);
+      return result;
+    } else if (result != GEOARROW_OK) {
+      ArrowErrorSet((struct ArrowError*)error, "Can't append feature %ld: %s", (long)i,
+                    strerror(result));
+      return result;
+    }
+  }
+
+  return GEOARROW_OK;
+}
+
+static GeoArrowErrorCode GeoArrowTakeInternal(struct GeoArrowArrayView* array_view,
+                                              const int64_t* indices, int64_t n_indices,
+                                              struct GeoArrowBuilder* builder,
+                                              struct GeoArrowError* error) {
+  int64_t i = 0;
+  while (i < n_indices) {
+    int64_t begin = indices[i];
+    int64_t length = 1;
+    while ((i + length) < n_indices && indices[i + length] == (begin + length)) {
+      length++;
+    }
+
+    if (begin < 0 || (begin + length) > array_view->length) {
+      ArrowErrorSet((struct ArrowError*)error,
+                    "Index %ld is out of bounds for array of length %ld",
+                    (long)(begin < 0 ? begin : (begin + length - 1)),
+                    (long)array_view->length);
+      return EINVAL;
+    }
+
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowTakeAppendRange(builder, array_view, begin, length, error));
+    i += length;
+  }
+
+  return GEOARROW_OK;
+}
+
+static GeoArrowErrorCode GeoArrowFilterInternal(struct GeoArrowArrayView* array_view,
+                                                const uint8_t* filter,
+                                                struct GeoArrowBuilder* builder,
+                                                struct GeoArrowError* error) {
+  int64_t i = 0;
+  while (i < array_view->length) {
+    while (i < array_view->length && !ArrowBitGet(filter, i)) {
+      i++;
+    }
+
+    int64_t begin = i;
+    while (i < array_view->length && ArrowBitGet(filter, i)) {
+      i++;
+    }
+
+    if (i > begin) {
+      NANOARROW_RETURN_NOT_OK(
+          GeoArrowTakeAppendRange(builder, array_view, begin, i - begin, error));
+    }
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowTake(struct GeoArrowArrayView* array_view,
+                               const int64_t* indices, int64_t n_indices,
+                               struct ArrowArray* out, struct GeoArrowError* error) {
+  struct GeoArrowBuilder builder;
+  NANOARROW_RETURN_NOT_OK(
+      GeoArrowBuilderInitFromType(&builder, array_view->schema_view.type));
+
+  int result = GeoArrowTakeInternal(array_view, indices, n_indices, &builder, error);
+  if (result == GEOARROW_OK) {
+    result = GeoArrowBuilderFinish(&builder, out, error);
+  }
+
+  GeoArrowBuilderReset(&builder);
+  return result;
+}
+
+GeoArrowErrorCode GeoArrowFilter(struct GeoArrowArrayView* array_view,
+                                 const uint8_t* filter, struct ArrowArray* out,
+                                 struct GeoArrowError* error) {
+  struct GeoArrowBuilder builder;
+  NANOARROW_RETURN_NOT_OK(
+      GeoArrowBuilderInitFromType(&builder, array_view->schema_view.type));
+
+  int result = GeoArrowFilterInternal(array_view, filter, &builder, error);
+  if (result == GEOARROW_OK) {
+    result = GeoArrowBuilderFinish(&builder, out, error);
+  }
+
+  GeoArrowBuilderReset(&builder);
+  return result;
+}
@@ -0,0 +1,179 @@
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+TEST(ArrayTakeTest, ArrayTakeTestTake) {
+  enum GeoArrowType type = GEOARROW_TYPE_MULTIPOLYGON;
+  struct ArrowArray array;
+  ArrayFromWKT(type,
+               {"MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)))", "",
+                "MULTIPOLYGON (((10 10, 11 10, 10 11, 10 10)), ((0 0, 1 0, 0 1, 0 0), "
+                "(0.1 0.1, 0.2 0.1, 0.1 0.2, 0.1 0.1)))",
+                "MULTIPOLYGON EMPTY"},
+               &array);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, type), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  struct ArrowArray out;
+  std::vector<int64_t> indices = {2, 3, 0, 1, 2, 2};
+  ASSERT_EQ(GeoArrowTake(&array_view, indices.data(), indices.size(), &out, nullptr),
+            GEOARROW_OK);
+  EXPECT_EQ(out.length, 6);
+  EXPECT_EQ(out.null_count, 1);
+
+  auto values = ArrayToWKT(type, &out);
+  ASSERT_EQ(values.size(), 6);
+  EXPECT_EQ(values[0],
+            "MULTIPOLYGON (((10 10, 11 10, 10 11, 10 10)), ((0 0, 1 0, 0 1, 0 0), "
+            "(0.1 0.1, 0.2 0.1, 0.1 0.2, 0.1 0.1)))");
+  EXPECT_EQ(values[1], "MULTIPOLYGON EMPTY");
+  EXPECT_EQ(values[2], "MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)))");
+  EXPECT_EQ(values[3], "<null value>");
+  EXPECT_EQ(values[4], values[0]);
+  EXPECT_EQ(values[5], values[0]);
+  out.release(&out);
+
+  // Zero indices
+  ASSERT_EQ(GeoArrowTake(&array_view, nullptr, 0, &out, nullptr), GEOARROW_OK);
+  EXPECT_EQ(out.length, 0);
+  out.release(&out);
+
+  array.release(&array);
+}
+
+TEST(ArrayTakeTest, ArrayTakeTestFilter) {
+  enum GeoArrowType type = GEOARROW_TYPE_LINESTRING_Z;
+  std::vector<std::string> wkts;
+  for (int i = 0; i < 20; i++) {
+    if (i % 7 == 3) {
+      wkts.push_back("");
+    } else {
+      wkts.push_back("LINESTRING Z (" + std::to_string(i) + " 1 2, 3 4 5)");
+    }
+  }
+
+  struct ArrowArray array;
+  ArrayFromWKT(type, wkts, &array);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, type), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  // Keep runs that start and end in the middle of bytes
+  uint8_t filter[3];
+  std::vector<int64_t> expected_indices;
+  memset(filter, 0, sizeof(filter));
+  for (int64_t i = 0; i < 20; i++) {
+    if ((i >= 2 && i < 5) || (i >= 6 && i < 13) || i == 19) {
+      ArrowBitSet(filter, i);
+      expected_indices.push_back(i);
+    }
+  }
+
+  struct ArrowArray out;
+  ASSERT_EQ(GeoArrowFilter(&array_view, filter, &out, nullptr), GEOARROW_OK);
+  EXPECT_EQ(out.length, expected_indices.size());
+  EXPECT_EQ(out.null_count, 2);
+
+  auto values = ArrayToWKT(type, &out);
+  ASSERT_EQ(values.size(), expected_indices.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    const std::string& expected = wkts[expected_indices[i]];
+    EXPECT_EQ(values[i], expected == "" ? "<null value>" : expected);
+  }
+
+  out.release(&out);
+
+  // ...and the result is the same as the equivalent take
+  ASSERT_EQ(GeoArrowTake(&array_view, expected_indices.data(), expected_indices.size(),
+                         &out, nullptr),
+            GEOARROW_OK);
+  EXPECT_EQ(ArrayToWKT(type, &out), values);
+  out.release(&out);
+
+  array.release(&array);
+}
+
+TEST(ArrayTakeTest, ArrayTakeTestPoint) {
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_POINT, {"POINT (0 1)", "", "POINT (2 3)", "POINT (4 5)"},
+               &array);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_POINT),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  struct ArrowArray out;
+  std::vector<int64_t> indices = {3, 2, 3};
+  ASSERT_EQ(GeoArrowTake(&array_view, indices.data(), indices.size(), &out, nullptr),
+            GEOARROW_OK);
+  EXPECT_EQ(out.null_count, 0);
+  EXPECT_EQ(ArrayToWKT(GEOARROW_TYPE_POINT, &out),
+            std::vector<std::string>({"POINT (4 5)", "POINT (2 3)", "POINT (4 5)"}));
+  out.release(&out);
+
+  uint8_t filter = 0x03;
+  ASSERT_EQ(GeoArrowFilter(&array_view, &filter, &out, nullptr), GEOARROW_OK);
+  EXPECT_EQ(out.null_count, 1);
+  EXPECT_EQ(ArrayToWKT(GEOARROW_TYPE_POINT, &out),
+            std::vector<std::string>({"POINT (0 1)", "<null value>"}));
+  out.release(&out);
+
+  array.release(&array);
+}
+
+TEST(ArrayTakeTest, ArrayTakeTestErrors) {
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_LINESTRING, {"LINESTRING (0 1, 2 3)"}, &array);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  struct ArrowArray out;
+  struct GeoArrowError error;
+  std::vector<int64_t> indices = {0, 1};
+  EXPECT_EQ(GeoArrowTake(&array_view, indices.data(), indices.size(), &out, &error),
+            EINVAL);
+  EXPECT_STREQ(error.message, "Index 1 is out of bounds for array of length 1");
+
+  indices = {-1};
+  EXPECT_EQ(GeoArrowTake(&array_view, indices.data(), indices.size(), &out, &error),
+            EINVAL);
+  EXPECT_STREQ(error.message, "Index -1 is out of bounds for array of length 1");
+
+  array.release(&array);
+}
+
+TEST(ArrayTakeTest, ArrayTakeTestOverflow) {
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_MULTIPOINT, {"MULTIPOINT (0 1)", "MULTIPOINT (2 3)"},
+               &array);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_MULTIPOINT),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  // The second feature claims enough points to overflow the output's offsets once
+  // anything else has been appended. Its coordinates are never read.
+  int32_t offsets[] = {0, 1, INT32_MAX};
+  array_view.offsets[0] = offsets;
+
+  struct ArrowArray out;
+  struct GeoArrowError error;
+  std::vector<int64_t> indices = {0, 0, 1};
+  EXPECT_EQ(GeoArrowTake(&array_view, indices.data(), indices.size(), &out, &error),
+            EOVERFLOW);
+  EXPECT_STREQ(error.message, "Can't append feature 1: offsets exceed the int32 range");
+
+  array.release(&array);
+}
@@ -0,0 +1,406 @@
+
+#include <errno.h>
+#include <string.h>
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+
+struct UnifyingBuilderPrivate {
+  // Only valid if has_builder is non-zero
+  struct GeoArrowBuilder builder;
+  struct GeoArrowVisitor builder_v;
+  int has_builder;
+
+  // Null features seen before the first non-null feature are appended when the
+  // builder is created
+  int64_t n_leading_nulls;
+
+  // feat_start is passed on once the type of the feature is known
+  int feat_pending;
+  int32_t level;
+
+  // Set on each builder that is created if has_allocator is non-zero
+  struct GeoArrowBufferAllocator allocator;
+  int has_allocator;
+};
+
+static int GeoArrowUnifyDimensionsHasZ(enum GeoArrowDimensions dimensions) {
+  return dimensions == GEOARROW_DIMENSIONS_XYZ || dimensions == GEOARROW_DIMENSIONS_XYZM;
+}
+
+static int GeoArrowUnifyDimensionsHasM(enum GeoArrowDimensions dimensions) {
+  return dimensions == GEOARROW_DIMENSIONS_XYM || dimensions == GEOARROW_DIMENSIONS_XYZM;
+}
+
+static enum GeoArrowDimensions GeoArrowUnifyDimensions(enum GeoArrowDimensions lhs,
+                                                       enum GeoArrowDimensions rhs) {
+  int has_z = GeoArrowUnifyDimensionsHasZ(lhs) || GeoArrowUnifyDimensionsHasZ(rhs);
+  int has_m = GeoArrowUnifyDimensionsHasM(lhs) || GeoArrowUnifyDimensionsHasM(rhs);
+  if (has_z && has_m) {
+    return GEOARROW_DIMENSIONS_XYZM;
+  } else if (has_z) {
+    return GEOARROW_DIMENSIONS_XYZ;
+  } else if (has_m) {
+    return GEOARROW_DIMENSIONS_XYM;
+  } else {
+    return GEOARROW_DIMENSIONS_XY;
+  }
+}
+
+// Returns the multi geometry type for a single geometry type (or the type itself)
+static enum GeoArrowGeometryType GeoArrowUnifyMultiType(
+    enum GeoArrowGeometryType geometry_type) {
+  switch (geometry_type) {
+    case GEOARROW_GEOMETRY_TYPE_POINT:
+      return GEOARROW_GEOMETRY_TYPE_MULTIPOINT;
+    case GEOARROW_GEOMETRY_TYPE_LINESTRING:
+      return GEOARROW_GEOMETRY_TYPE_MULTILINESTRING;
+    case GEOARROW_GEOMETRY_TYPE_POLYGON:
+      return GEOARROW_GEOMETRY_TYPE_MULTIPOLYGON;
+    default:
+      return geometry_type;
+  }
+}
+
+static int GeoArrowUnifyGeometryType(enum GeoArrowGeometryType lhs,
+                                     enum GeoArrowGeometryType rhs,
+                                     enum GeoArrowGeometryType* out,
+                                     struct GeoArrowError* error) {
+  if (rhs < GEOARROW_GEOMETRY_TYPE_POINT || rhs > GEOARROW_GEOMETRY_TYPE_MULTIPOLYGON) {
+    const char* name = GeoArrowGeometryTypeString(rhs);
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Can't build a native array from geometry of type %s",
+                  name == NULL ? "<unknown>" : name);
+    return ENOTSUP;
+  }
+
+  if (lhs == rhs) {
+    *out = lhs;
+    return GEOARROW_OK;
+  }
+
+  if (GeoArrowUnifyMultiType(lhs) != GeoArrowUnifyMultiType(rhs)) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Can't find a common native type for geometries of type %s and %s",
+                  GeoArrowGeometryTypeString(lhs), GeoArrowGeometryTypeString(rhs));
+    return EINVAL;
+  }
+
+  *out = GeoArrowUnifyMultiType(lhs);
+  return GEOARROW_OK;
+}
+
+static GeoArrowErrorCode GeoArrowUnifyingBuilderCreate(
+    struct GeoArrowUnifyingBuilder* builder, enum GeoArrowType type) {
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  NANOARROW_RETURN_NOT_OK(GeoArrowBuilderInitFromType(&private->builder, type));
+  if (private->has_allocator) {
+    int result = GeoArrowBuilderSetAllocator(&private->builder, private->allocator);
+    if (result != GEOARROW_OK) {
+      GeoArrowBuilderReset(&private->builder);
+      return result;
+    }
+  }
+
+  private->builder.coerce_dimensions = 1;
+  GeoArrowBuilderInitVisitor(&private->builder, &private->builder_v);
+  private->has_builder = 1;
+  builder->type = type;
+
+  struct GeoArrowVisitor* v = &private->builder_v;
+  for (int64_t i = 0; i < private->n_leading_nulls; i++) {
+    NANOARROW_RETURN_NOT_OK(v->feat_start(v));
+    NANOARROW_RETURN_NOT_OK(v->null_feat(v));
+    NANOARROW_RETURN_NOT_OK(v->feat_end(v));
+  }
+
+  private->n_leading_nulls = 0;
+  return GEOARROW_OK;
+}
+
+// Rebuilds the features that have already been built with a wider type. This
+// happens at most three times (once for the geometry type and once for each of z
+// and m) and visits only native coordinates.
+static GeoArrowErrorCode GeoArrowUnifyingBuilderPromote(
+    struct GeoArrowUnifyingBuilder* builder, enum GeoArrowType type,
+    struct GeoArrowError* error) {
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+
+  struct ArrowArray array;
+  NANOARROW_RETURN_NOT_OK(GeoArrowBuilderFinish(&private->builder, &array, error));
+  GeoArrowBuilderReset(&private->builder);
+  private->has_builder = 0;
+
+  struct GeoArrowArrayView array_view;
+  int result = GeoArrowArrayViewInitFromType(&array_view, builder->type);
+  if (result == GEOARROW_OK) {
+    result = GeoArrowArrayViewSetArray(&array_view, &array, error);
+  }
+
+  if (result == GEOARROW_OK) {
+    result = GeoArrowUnifyingBuilderCreate(builder, type);
+  }
+
+  if (result == GEOARROW_OK) {
+    private->builder_v.error = error;
+    result = GeoArrowArrayViewVisit(&array_view, 0, array.length, &private->builder_v);
+  }
+
+  array.release(&array);
+  return result;
+}
+
+static int GeoArrowUnifyingBuilderFlushFeatStart(struct UnifyingBuilderPrivate* private) {
+  if (private->feat_pending) {
+    private->feat_pending = 0;
+    return private->builder_v.feat_start(&private->builder_v);
+  }
+
+  return GEOARROW_OK;
+}
+
+static int reserve_coord_unify(struct GeoArrowVisitor* v, int64_t n) {
+  struct GeoArrowUnifyingBuilder* builder =
+      (struct GeoArrowUnifyingBuilder*)v->private_data;
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  if (private->has_builder) {
+    return private->builder_v.reserve_coord(&private->builder_v, n);
+  }
+
+  return GEOARROW_OK;
+}
+
+static int reserve_feat_unify(struct GeoArrowVisitor* v, int64_t n) {
+  struct GeoArrowUnifyingBuilder* builder =
+      (struct GeoArrowUnifyingBuilder*)v->private_data;
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  if (private->has_builder) {
+    return private->builder_v.reserve_feat(&private->builder_v, n);
+  }
+
+  return GEOARROW_OK;
+}
+
+static int feat_start_unify(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnifyingBuilder* builder =
+      (struct GeoArrowUnifyingBuilder*)v->private_data;
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  private->feat_pending = 1;
+  private->level = 0;
+  private->builder_v.error = v->error;
+  return GEOARROW_OK;
+}
+
+static int null_feat_unify(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnifyingBuilder* builder =
+      (struct GeoArrowUnifyingBuilder*)v->private_data;
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  if (!private->has_builder) {
+    private->feat_pending = 0;
+    private->n_leading_nulls++;
+    return GEOARROW_OK;
+  }
+
+  NANOARROW_RETURN_NOT_OK(GeoArrowUnifyingBuilderFlushFeatStart(private));
+  return private->builder_v.null_feat(&private->builder_v);
+}
+
+static int geom_start_unify(struct GeoArrowVisitor* v,
+                            enum GeoArrowGeometryType geometry_type,
+                            enum GeoArrowDimensions dimensions) {
+  struct GeoArrowUnifyingBuilder* builder =
+      (struct GeoArrowUnifyingBuilder*)v->private_data;
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+
+  // The type of a feature is decided by its outermost geometry; nested geometries
+  // are coerced to the builder's dimensions
+  if (private->level++ == 0) {
+    enum GeoArrowGeometryType unified_type;
+    enum GeoArrowDimensions unified_dimensions;
+    if (private->has_builder) {
+      NANOARROW_RETURN_NOT_OK(
+          GeoArrowUnifyGeometryType(GeoArrowGeometryTypeFromType(builder->type),
+                                    geometry_type, &unified_type, v->error));
+      unified_dimensions =
+          GeoArrowUnifyDimensions(GeoArrowDimensionsFromType(builder->type), dimensions);
+    } else {
+      NANOARROW_RETURN_NOT_OK(GeoArrowUnifyGeometryType(geometry_type, geometry_type,
+                                                        &unified_type, v->error));
+      unified_dimensions = GeoArrowUnifyDimensions(dimensions, dimensions);
+    }
+
+    enum GeoArrowType type =
+        GeoArrowMakeType(unified_type, unified_dimensions, GEOARROW_COORD_TYPE_SEPARATE);
+    if (!private->has_builder) {
+      NANOARROW_RETURN_NOT_OK(GeoArrowUnifyingBuilderCreate(builder, type));
+      private->builder_v.error = v->error;
+    } else if (type != builder->type) {
+      NANOARROW_RETURN_NOT_OK(GeoArrowUnifyingBuilderPromote(builder, type, v->error));
+    }
+
+    NANOARROW_RETURN_NOT_OK(GeoArrowUnifyingBuilderFlushFeatStart(private));
+  }
+
+  return private->builder_v.geom_start(&private->builder_v, geometry_type, dimensions);
+}
+
+static int ring_start_unify(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnifyingBuilder* builder =
+      (struct GeoArrowUnifyingBuilder*)v->private_data;
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  return private->builder_v.ring_start(&private->builder_v);
+}
+
+static int coords_unify(struct GeoArrowVisitor* v,
+                        const struct GeoArrowCoordView* coords) {
+  struct GeoArrowUnifyingBuilder* builder =
+      (struct GeoArrowUnifyingBuilder*)v->private_data;
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  return private->builder_v.coords(&private->builder_v, coords);
+}
+
+static int ring_end_unify(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnifyingBuilder* builder =
+      (struct GeoArrowUnifyingBuilder*)v->private_data;
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  return private->builder_v.ring_end(&private->builder_v);
+}
+
+static int geom_end_unify(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnifyingBuilder* builder =
+      (struct GeoArrowUnifyingBuilder*)v->private_data;
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  private->level--;
+  return private->builder_v.geom_end(&private->builder_v);
+}
+
+static int feat_end_unify(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnifyingBuilder* builder =
+      (struct GeoArrowUnifyingBuilder*)v->private_data;
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+
+  // A feature without any geometry is treated as null
+  if (private->feat_pending) {
+    NANOARROW_RETURN_NOT_OK(null_feat_unify(v));
+  }
+
+  if (!private->has_builder) {
+    return GEOARROW_OK;
+  }
+
+  return private->builder_v.feat_end(&private->builder_v);
+}
+
+GeoArrowErrorCode GeoArrowUnifyingBuilderInit(struct GeoArrowUnifyingBuilder* builder) {
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)ArrowMalloc(sizeof(struct UnifyingBuilderPrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct UnifyingBuilderPrivate));
+  builder->type = GEOARROW_TYPE_UNINITIALIZED;
+  builder->private_data = private;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowUnifyingBuilderSetAllocator(
+    struct GeoArrowUnifyingBuilder* builder, struct GeoArrowBufferAllocator allocator) {
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  if (private->has_builder) {
+    return EINVAL;
+  }
+
+  private->allocator = allocator;
+  private->has_allocator = 1;
+  return GEOARROW_OK;
+}
+
+void GeoArrowUnifyingBuilderInitVisitor(struct GeoArrowUnifyingBuilder* builder,
+                                        struct GeoArrowVisitor* v) {
+  GeoArrowVisitorInitVoid(v);
+  v->reserve_coord = &reserve_coord_unify;
+  v->reserve_feat = &reserve_feat_unify;
+  v->feat_start = &feat_start_unify;
+  v->null_feat = &null_feat_unify;
+  v->geom_start = &geom_start_unify;
+  v->ring_start = &ring_start_unify;
+  v->coords = &coords_unify;
+  v->ring_end = &ring_end_unify;
+  v->geom_end = &geom_end_unify;
+  v->feat_end = &feat_end_unify;
+  v->private_data = builder;
+}
+
+GeoArrowErrorCode GeoArrowUnifyingBuilderFinish(struct GeoArrowUnifyingBuilder* builder,
+                                                struct ArrowArray* array,
+                                                struct GeoArrowError* error) {
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  if (!private->has_builder) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowUnifyingBuilderCreate(builder, GEOARROW_TYPE_POINT));
+  }
+
+  int result = GeoArrowBuilderFinish(&private->builder, array, error);
+  GeoArrowBuilderReset(&private->builder);
+  private->has_builder = 0;
+  builder->type = GEOARROW_TYPE_UNINITIALIZED;
+  return result;
+}
+
+void GeoArrowUnifyingBuilderReset(struct GeoArrowUnifyingBuilder* builder) {
+  struct UnifyingBuilderPrivate* private =
+      (struct UnifyingBuilderPrivate*)builder->private_data;
+  if (private->has_builder) {
+    GeoArrowBuilderReset(&private->builder);
+  }
+
+  ArrowFree(private);
+}
+
+GeoArrowErrorCode GeoArrowArrayUnify(enum GeoArrowType type, struct ArrowArray* array,
+                                     struct ArrowArray* out, enum GeoArrowType* type_out,
+                                     struct GeoArrowError* error) {
+  struct GeoArrowArrayReader reader;
+  NANOARROW_RETURN_NOT_OK(GeoArrowArrayReaderInitFromType(&reader, type));
+
+  struct GeoArrowUnifyingBuilder builder;
+  int result = GeoArrowUnifyingBuilderInit(&builder);
+  if (result != GEOARROW_OK) {
+    GeoArrowArrayReaderReset(&reader);
+    return result;
+  }
+
+  struct GeoArrowVisitor v;
+  GeoArrowUnifyingBuilderInitVisitor(&builder, &v);
+  v.error = error;
+
+  result = GeoArrowArrayReaderSetArray(&reader, array, error);
+  if (result == GEOARROW_OK) {
+    result = GeoArrowArrayReaderVisit(&reader, 0, array->length, &v);
+  }
+
+  if (result == GEOARROW_OK) {
+    *type_out = builder.type == GEOARROW_TYPE_UNINITIALIZED ? GEOARROW_TYPE_POINT
+                                                            : builder.type;
+    result = GeoArrowUnifyingBuilderFinish(&builder, out, error);
+  }
+
+  GeoArrowUnifyingBuilderReset(&builder);
+  GeoArrowArrayReaderReset(&reader);
+  return result;
+}
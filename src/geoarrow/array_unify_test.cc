@@ -0,0 +1,144 @@
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+// Unifies WKB built from wkts and returns the resulting type and features as WKT
+static std::vector<std::string> UnifyWKB(const std::vector<std::string>& wkts,
+                                         enum GeoArrowType* type_out) {
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_WKB, wkts, &array);
+
+  struct ArrowArray out;
+  struct GeoArrowError error;
+  int result = GeoArrowArrayUnify(GEOARROW_TYPE_WKB, &array, &out, type_out, &error);
+  array.release(&array);
+  EXPECT_EQ(result, GEOARROW_OK) << error.message;
+  if (result != GEOARROW_OK) {
+    return {};
+  }
+
+  std::vector<std::string> values = ArrayToWKT(*type_out, &out);
+  out.release(&out);
+  return values;
+}
+
+TEST(ArrayUnifyTest, ArrayUnifyTestSameType) {
+  enum GeoArrowType type;
+  EXPECT_EQ(UnifyWKB({"LINESTRING (0 1, 2 3)", "", "LINESTRING EMPTY"}, &type),
+            std::vector<std::string>(
+                {"LINESTRING (0 1, 2 3)", "<null value>", "LINESTRING EMPTY"}));
+  EXPECT_EQ(type, GEOARROW_TYPE_LINESTRING);
+
+  // Leading nulls are kept once the type is known
+  EXPECT_EQ(UnifyWKB({"", "", "POLYGON Z ((0 0 1, 1 0 1, 0 1 1, 0 0 1))"}, &type),
+            std::vector<std::string>({"<null value>", "<null value>",
+                                      "POLYGON Z ((0 0 1, 1 0 1, 0 1 1, 0 0 1))"}));
+  EXPECT_EQ(type, GEOARROW_TYPE_POLYGON_Z);
+
+  // Arrays with no non-null features are built as points
+  EXPECT_EQ(UnifyWKB({"", ""}, &type),
+            std::vector<std::string>({"<null value>", "<null value>"}));
+  EXPECT_EQ(type, GEOARROW_TYPE_POINT);
+  EXPECT_EQ(UnifyWKB({}, &type), std::vector<std::string>({}));
+  EXPECT_EQ(type, GEOARROW_TYPE_POINT);
+}
+
+TEST(ArrayUnifyTest, ArrayUnifyTestPromoteGeometryType) {
+  enum GeoArrowType type;
+  EXPECT_EQ(UnifyWKB({"POINT (0 1)", "", "MULTIPOINT ((1 2), (3 4))", "POINT (5 6)"},
+                     &type),
+            std::vector<std::string>({"MULTIPOINT ((0 1))", "<null value>",
+                                      "MULTIPOINT ((1 2), (3 4))",
+                                      "MULTIPOINT ((5 6))"}));
+  EXPECT_EQ(type, GEOARROW_TYPE_MULTIPOINT);
+
+  EXPECT_EQ(UnifyWKB({"MULTILINESTRING ((0 1, 2 3))", "LINESTRING (4 5, 6 7)"}, &type),
+            std::vector<std::string>(
+                {"MULTILINESTRING ((0 1, 2 3))", "MULTILINESTRING ((4 5, 6 7))"}));
+  EXPECT_EQ(type, GEOARROW_TYPE_MULTILINESTRING);
+
+  EXPECT_EQ(UnifyWKB({"POLYGON ((0 0, 1 0, 0 1, 0 0))",
+                      "MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)), ((1 1, 2 1, 1 2, 1 1)))"},
+                     &type),
+            std::vector<std::string>(
+                {"MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)))",
+                 "MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)), ((1 1, 2 1, 1 2, 1 1)))"}));
+  EXPECT_EQ(type, GEOARROW_TYPE_MULTIPOLYGON);
+}
+
+TEST(ArrayUnifyTest, ArrayUnifyTestPromoteDimensions) {
+  enum GeoArrowType type;
+  EXPECT_EQ(UnifyWKB({"LINESTRING (0 1, 2 3)", "LINESTRING Z (0 1 2, 3 4 5)"}, &type),
+            std::vector<std::string>(
+                {"LINESTRING Z (0 1 0, 2 3 0)", "LINESTRING Z (0 1 2, 3 4 5)"}));
+  EXPECT_EQ(type, GEOARROW_TYPE_LINESTRING_Z);
+
+  // Both the geometry type and the dimensions are promoted
+  EXPECT_EQ(UnifyWKB({"POINT Z (0 1 2)", "POINT (3 4)", "MULTIPOINT M ((5 6 7))"}, &type),
+            std::vector<std::string>({"MULTIPOINT ZM ((0 1 2 0))",
+                                      "MULTIPOINT ZM ((3 4 0 0))",
+                                      "MULTIPOINT ZM ((5 6 0 7))"}));
+  EXPECT_EQ(type, GEOARROW_TYPE_MULTIPOINT_ZM);
+}
+
+TEST(ArrayUnifyTest, ArrayUnifyTestErrors) {
+  struct ArrowArray array;
+  struct ArrowArray out;
+  struct GeoArrowError error;
+  enum GeoArrowType type;
+
+  ArrayFromWKT(GEOARROW_TYPE_WKB, {"POINT (0 1)", "LINESTRING (0 0, 1 1)"}, &array);
+  EXPECT_EQ(GeoArrowArrayUnify(GEOARROW_TYPE_WKB, &array, &out, &type, &error), EINVAL);
+  EXPECT_STREQ(error.message,
+               "Can't find a common native type for geometries of type POINT and "
+               "LINESTRING");
+  array.release(&array);
+
+  ArrayFromWKT(GEOARROW_TYPE_WKT, {"GEOMETRYCOLLECTION (POINT (0 1))"}, &array);
+  EXPECT_EQ(GeoArrowArrayUnify(GEOARROW_TYPE_WKT, &array, &out, &type, &error), ENOTSUP);
+  EXPECT_STREQ(error.message,
+               "Can't build a native array from geometry of type GEOMETRYCOLLECTION");
+  array.release(&array);
+}
+
+TEST(ArrayUnifyTest, ArrayUnifyTestBuilderReuse) {
+  struct GeoArrowUnifyingBuilder builder;
+  struct GeoArrowVisitor v;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowUnifyingBuilderInit(&builder), GEOARROW_OK);
+  EXPECT_EQ(builder.type, GEOARROW_TYPE_UNINITIALIZED);
+  GeoArrowUnifyingBuilderInitVisitor(&builder, &v);
+  v.error = &error;
+
+  WKXTester tester;
+  struct GeoArrowWKTReader reader;
+  GeoArrowWKTReaderInit(&reader);
+  std::string wkt = "POINT (0 1)";
+  struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+  ASSERT_EQ(GeoArrowWKTReaderVisit(&reader, item, &v), GEOARROW_OK);
+  EXPECT_EQ(builder.type, GEOARROW_TYPE_POINT);
+
+  struct ArrowArray out;
+  ASSERT_EQ(GeoArrowUnifyingBuilderFinish(&builder, &out, &error), GEOARROW_OK);
+  EXPECT_EQ(ArrayToWKT(GEOARROW_TYPE_POINT, &out),
+            std::vector<std::string>({"POINT (0 1)"}));
+  out.release(&out);
+
+  // The type is chosen again for the next array
+  EXPECT_EQ(builder.type, GEOARROW_TYPE_UNINITIALIZED);
+  wkt = "LINESTRING (0 1, 2 3)";
+  item = {wkt.data(), (int64_t)wkt.size()};
+  ASSERT_EQ(GeoArrowWKTReaderVisit(&reader, item, &v), GEOARROW_OK);
+  EXPECT_EQ(builder.type, GEOARROW_TYPE_LINESTRING);
+  ASSERT_EQ(GeoArrowUnifyingBuilderFinish(&builder, &out, &error), GEOARROW_OK);
+  EXPECT_EQ(ArrayToWKT(GEOARROW_TYPE_LINESTRING, &out),
+            std::vector<std::string>({"LINESTRING (0 1, 2 3)"}));
+  out.release(&out);
+
+  GeoArrowWKTReaderReset(&reader);
+  GeoArrowUnifyingBuilderReset(&builder);
+}
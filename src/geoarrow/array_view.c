@@ -1,5 +1,7 @@
 
 #include <errno.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "geoarrow.h"
 
@@ -32,7 +34,7 @@ static int GeoArrowArrayViewInitInternal(struct GeoArrowArrayView* array_view,
 
   array_view->length = 0;
   array_view->validity_bitmap = NULL;
-  for (int i = 0; i < 4; i++) {
+  for (int i = 0; i < 3; i++) {
     array_view->offsets[i] = NULL;
   }
 
@@ -203,6 +205,60 @@ GeoArrowErrorCode GeoArrowArrayViewSetArray(struct GeoArrowArrayView* array_view
   return GEOARROW_OK;
 }
 
+GeoArrowErrorCode GeoArrowArrayViewRebind(struct GeoArrowArrayView* array_view,
+                                          struct ArrowArray* array,
+                                          struct GeoArrowError* error) {
+  // The structure of array was checked by a previous GeoArrowArrayViewSetArray(), so
+  // only the pointers and lengths that can differ between batches are updated
+  struct ArrowArray* level_array = array;
+  for (int32_t level = 0; level < array_view->n_offsets; level++) {
+    if (level_array->offset != 0) {
+      ArrowErrorSet((struct ArrowError*)error,
+                    "ArrowArray with offset != 0 is not yet supported in "
+                    "GeoArrowArrayViewRebind()");
+      return ENOTSUP;
+    }
+
+    if (level_array->length > 0) {
+      array_view->offsets[level] = (const int32_t*)level_array->buffers[1];
+      array_view->last_offset[level] = array_view->offsets[level][level_array->length];
+    } else {
+      array_view->offsets[level] = &kZeroInt32;
+      array_view->last_offset[level] = 0;
+    }
+
+    level_array = level_array->children[0];
+  }
+
+  if (level_array->offset != 0) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "ArrowArray with offset != 0 is not yet supported in "
+                  "GeoArrowArrayViewRebind()");
+    return ENOTSUP;
+  }
+
+  if (array_view->n_offsets > 0) {
+    array_view->coords.n_coords = array_view->last_offset[array_view->n_offsets - 1];
+  } else {
+    array_view->coords.n_coords = level_array->length;
+  }
+
+  if (array_view->schema_view.coord_type == GEOARROW_COORD_TYPE_SEPARATE) {
+    for (int32_t i = 0; i < array_view->coords.n_values; i++) {
+      array_view->coords.values[i] = (const double*)level_array->children[i]->buffers[1];
+    }
+  } else {
+    for (int32_t i = 0; i < array_view->coords.n_values; i++) {
+      array_view->coords.values[i] =
+          ((const double*)level_array->children[0]->buffers[1]) + i;
+    }
+  }
+
+  array_view->validity_bitmap = array->buffers[0];
+  array_view->length = array->length;
+  return GEOARROW_OK;
+}
+
 static inline void GeoArrowCoordViewUpdate(struct GeoArrowCoordView* src,
                                            struct GeoArrowCoordView* dst, int64_t offset,
                                            int64_t length) {
@@ -212,15 +268,66 @@ static inline void GeoArrowCoordViewUpdate(struct GeoArrowCoordView* src,
   dst->n_coords = length;
 }
 
+// Returns the index of the first null in [i, end) (or end if there isn't one),
+// testing 64 rows of the validity bitmap at a time once i is byte-aligned so that
+// long runs of valid rows cost one comparison per word
+static inline int64_t GeoArrowArrayViewNextNull(const uint8_t* validity_bitmap,
+                                                int64_t i, int64_t end) {
+  if (validity_bitmap == NULL) {
+    return end;
+  }
+
+  while (i < end && (i % 8) != 0) {
+    if (!ArrowBitGet(validity_bitmap, i)) {
+      return i;
+    }
+
+    i++;
+  }
+
+  uint64_t word;
+  while ((end - i) >= 64) {
+    memcpy(&word, validity_bitmap + (i / 8), sizeof(uint64_t));
+    if (word != UINT64_MAX) {
+      break;
+    }
+
+    i += 64;
+  }
+
+  while ((end - i) >= 8 && validity_bitmap[i / 8] == 0xff) {
+    i += 8;
+  }
+
+  while (i < end && ArrowBitGet(validity_bitmap, i)) {
+    i++;
+  }
+
+  return i;
+}
+
+// Checks whether row is valid, only looking at the validity bitmap again once row
+// is past the run of valid rows found by the last lookup
+static inline int GeoArrowArrayViewRowIsValid(struct GeoArrowArrayView* array_view,
+                                              int64_t row, int64_t end,
+                                              int64_t* valid_end) {
+  if (row >= *valid_end) {
+    *valid_end = GeoArrowArrayViewNextNull(array_view->validity_bitmap, row, end);
+  }
+
+  return row < *valid_end;
+}
+
 static GeoArrowErrorCode GeoArrowArrayViewVisitPoint(struct GeoArrowArrayView* array_view,
                                                      int64_t offset, int64_t length,
                                                      struct GeoArrowVisitor* v) {
   struct GeoArrowCoordView coords = array_view->coords;
 
+  int64_t valid_end = offset;
   for (int64_t i = 0; i < length; i++) {
     NANOARROW_RETURN_NOT_OK(v->feat_start(v));
-    if (!array_view->validity_bitmap ||
-        ArrowBitGet(array_view->validity_bitmap, offset + i)) {
+    if (GeoArrowArrayViewRowIsValid(array_view, offset + i, offset + length,
+                                    &valid_end)) {
       NANOARROW_RETURN_NOT_OK(v->geom_start(v, GEOARROW_GEOMETRY_TYPE_POINT,
                                             array_view->schema_view.dimensions));
       GeoArrowCoordViewUpdate(&array_view->coords, &coords, offset + i, 1);
@@ -247,10 +354,11 @@ static GeoArrowErrorCode GeoArrowArrayViewVisitLinestring(
 
   int64_t coord_offset;
   int64_t n_coords;
+  int64_t valid_end = offset;
   for (int64_t i = 0; i < length; i++) {
     NANOARROW_RETURN_NOT_OK(v->feat_start(v));
-    if (!array_view->validity_bitmap ||
-        ArrowBitGet(array_view->validity_bitmap, offset + i)) {
+    if (GeoArrowArrayViewRowIsValid(array_view, offset + i, offset + length,
+                                    &valid_end)) {
       NANOARROW_RETURN_NOT_OK(v->geom_start(v, GEOARROW_GEOMETRY_TYPE_LINESTRING,
                                             array_view->schema_view.dimensions));
       coord_offset = array_view->offsets[0][offset + i];
@@ -277,10 +385,11 @@ static GeoArrowErrorCode GeoArrowArrayViewVisitPolygon(
   int64_t n_rings;
   int64_t coord_offset;
   int64_t n_coords;
+  int64_t valid_end = offset;
   for (int64_t i = 0; i < length; i++) {
     NANOARROW_RETURN_NOT_OK(v->feat_start(v));
-    if (!array_view->validity_bitmap ||
-        ArrowBitGet(array_view->validity_bitmap, offset + i)) {
+    if (GeoArrowArrayViewRowIsValid(array_view, offset + i, offset + length,
+                                    &valid_end)) {
       NANOARROW_RETURN_NOT_OK(v->geom_start(v, GEOARROW_GEOMETRY_TYPE_POLYGON,
                                             array_view->schema_view.dimensions));
       ring_offset = array_view->offsets[0][offset + i];
@@ -313,10 +422,11 @@ static GeoArrowErrorCode GeoArrowArrayViewVisitMultipoint(
 
   int64_t coord_offset;
   int64_t n_coords;
+  int64_t valid_end = offset;
   for (int64_t i = 0; i < length; i++) {
     NANOARROW_RETURN_NOT_OK(v->feat_start(v));
-    if (!array_view->validity_bitmap ||
-        ArrowBitGet(array_view->validity_bitmap, offset + i)) {
+    if (GeoArrowArrayViewRowIsValid(array_view, offset + i, offset + length,
+                                    &valid_end)) {
       NANOARROW_RETURN_NOT_OK(v->geom_start(v, GEOARROW_GEOMETRY_TYPE_MULTIPOINT,
                                             array_view->schema_view.dimensions));
       coord_offset = array_view->offsets[0][offset + i];
@@ -348,10 +458,11 @@ static GeoArrowErrorCode GeoArrowArrayViewVisitMultilinestring(
   int64_t n_linestrings;
   int64_t coord_offset;
   int64_t n_coords;
+  int64_t valid_end = offset;
   for (int64_t i = 0; i < length; i++) {
     NANOARROW_RETURN_NOT_OK(v->feat_start(v));
-    if (!array_view->validity_bitmap ||
-        ArrowBitGet(array_view->validity_bitmap, offset + i)) {
+    if (GeoArrowArrayViewRowIsValid(array_view, offset + i, offset + length,
+                                    &valid_end)) {
       NANOARROW_RETURN_NOT_OK(v->geom_start(v, GEOARROW_GEOMETRY_TYPE_MULTILINESTRING,
                                             array_view->schema_view.dimensions));
       linestring_offset = array_view->offsets[0][offset + i];
@@ -389,10 +500,11 @@ static GeoArrowErrorCode GeoArrowArrayViewVisitMultipolygon(
   int64_t n_rings;
   int64_t coord_offset;
   int64_t n_coords;
+  int64_t valid_end = offset;
   for (int64_t i = 0; i < length; i++) {
     NANOARROW_RETURN_NOT_OK(v->feat_start(v));
-    if (!array_view->validity_bitmap ||
-        ArrowBitGet(array_view->validity_bitmap, offset + i)) {
+    if (GeoArrowArrayViewRowIsValid(array_view, offset + i, offset + length,
+                                    &valid_end)) {
       NANOARROW_RETURN_NOT_OK(v->geom_start(v, GEOARROW_GEOMETRY_TYPE_MULTIPOLYGON,
                                             array_view->schema_view.dimensions));
 
@@ -404,12 +516,12 @@ static GeoArrowErrorCode GeoArrowArrayViewVisitMultipolygon(
                                               array_view->schema_view.dimensions));
 
         ring_offset = array_view->offsets[1][polygon_offset + j];
-        n_rings = array_view->offsets[1][polygon_offset + j + 1];
+        n_rings = array_view->offsets[1][polygon_offset + j + 1] - ring_offset;
 
         for (int64_t k = 0; k < n_rings; k++) {
           NANOARROW_RETURN_NOT_OK(v->ring_start(v));
-          coord_offset = array_view->offsets[2][ring_offset + j];
-          n_coords = array_view->offsets[2][ring_offset + j + 1] - coord_offset;
+          coord_offset = array_view->offsets[2][ring_offset + k];
+          n_coords = array_view->offsets[2][ring_offset + k + 1] - coord_offset;
           GeoArrowCoordViewUpdate(&array_view->coords, &coords, coord_offset, n_coords);
           NANOARROW_RETURN_NOT_OK(v->coords(v, &coords));
           NANOARROW_RETURN_NOT_OK(v->ring_end(v));
@@ -429,9 +541,9 @@ static GeoArrowErrorCode GeoArrowArrayViewVisitMultipolygon(
   return GEOARROW_OK;
 }
 
-GeoArrowErrorCode GeoArrowArrayViewVisit(struct GeoArrowArrayView* array_view,
-                                         int64_t offset, int64_t length,
-                                         struct GeoArrowVisitor* v) {
+static GeoArrowErrorCode GeoArrowArrayViewVisitNative(
+    struct GeoArrowArrayView* array_view, int64_t offset, int64_t length,
+    struct GeoArrowVisitor* v) {
   switch (array_view->schema_view.geometry_type) {
     case GEOARROW_GEOMETRY_TYPE_POINT:
       return GeoArrowArrayViewVisitPoint(array_view, offset, length, v);
@@ -449,3 +561,189 @@ GeoArrowErrorCode GeoArrowArrayViewVisit(struct GeoArrowArrayView* array_view,
       return ENOTSUP;
   }
 }
+
+// The number of bytes of coordinates in features [offset, offset + length)
+static int64_t GeoArrowArrayViewCoordBytes(struct GeoArrowArrayView* array_view,
+                                           int64_t offset, int64_t length) {
+  int64_t begin = offset;
+  int64_t end = offset + length;
+  for (int32_t level = 0; level < array_view->n_offsets; level++) {
+    begin = array_view->offsets[level][begin];
+    end = array_view->offsets[level][end];
+  }
+
+  return (end - begin) * array_view->coords.n_values * sizeof(double);
+}
+
+GeoArrowErrorCode GeoArrowArrayViewVisit(struct GeoArrowArrayView* array_view,
+                                         int64_t offset, int64_t length,
+                                         struct GeoArrowVisitor* v) {
+  struct GeoArrowTracer* tracer = GeoArrowGetTracer();
+  if (tracer == NULL) {
+    return GeoArrowArrayViewVisitNative(array_view, offset, length, v);
+  }
+
+  tracer->begin(tracer, GEOARROW_TRACE_EVENT_ARRAY_VIEW_VISIT);
+  int result = GeoArrowArrayViewVisitNative(array_view, offset, length, v);
+  int64_t n_bytes = 0;
+  if (result == GEOARROW_OK) {
+    n_bytes = GeoArrowArrayViewCoordBytes(array_view, offset, length);
+  }
+
+  tracer->end(tracer, GEOARROW_TRACE_EVENT_ARRAY_VIEW_VISIT, length, n_bytes, result);
+  return result;
+}
+
+static GeoArrowErrorCode GeoArrowUnionArrayViewInitChildren(
+    struct GeoArrowUnionArrayView* array_view, const int8_t* type_ids,
+    int64_t n_children) {
+  enum GeoArrowDimensions dimensions = array_view->schema_view.dimensions;
+  array_view->length = 0;
+  array_view->type_ids = NULL;
+  array_view->offsets = NULL;
+  array_view->n_children = n_children;
+  memset(array_view->child_index, -1, sizeof(array_view->child_index));
+
+  for (int64_t i = 0; i < n_children; i++) {
+    enum GeoArrowGeometryType geometry_type =
+        (enum GeoArrowGeometryType)(type_ids[i] % 10);
+    array_view->child_index[geometry_type] = (int8_t)i;
+    NANOARROW_RETURN_NOT_OK(GeoArrowArrayViewInitFromType(
+        &array_view->children[geometry_type - 1],
+        GeoArrowMakeType(geometry_type, dimensions, GEOARROW_COORD_TYPE_SEPARATE)));
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowUnionArrayViewInitFromType(
+    struct GeoArrowUnionArrayView* array_view, enum GeoArrowType type) {
+  NANOARROW_RETURN_NOT_OK(GeoArrowSchemaViewInitFromType(&array_view->schema_view, type));
+  if (array_view->schema_view.geometry_type != GEOARROW_GEOMETRY_TYPE_GEOMETRY ||
+      array_view->schema_view.dimensions == GEOARROW_DIMENSIONS_UNKNOWN) {
+    return EINVAL;
+  }
+
+  // The layout written by GeoArrowSchemaInit(): one child per geometry type in order
+  int8_t type_ids[6];
+  for (int i = 0; i < 6; i++) {
+    type_ids[i] = GeoArrowUnionTypeId(GEOARROW_GEOMETRY_TYPE_POINT + i,
+                                      array_view->schema_view.dimensions);
+  }
+
+  return GeoArrowUnionArrayViewInitChildren(array_view, type_ids, 6);
+}
+
+GeoArrowErrorCode GeoArrowUnionArrayViewInitFromSchema(
+    struct GeoArrowUnionArrayView* array_view, struct ArrowSchema* schema,
+    struct GeoArrowError* error) {
+  NANOARROW_RETURN_NOT_OK(
+      GeoArrowSchemaViewInit(&array_view->schema_view, schema, error));
+  if (array_view->schema_view.geometry_type != GEOARROW_GEOMETRY_TYPE_GEOMETRY) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Expected extension 'geoarrow.geometry' in "
+                  "GeoArrowUnionArrayViewInitFromSchema()");
+    return EINVAL;
+  }
+
+  // The schema view has already checked that the format is "+ud:" followed by one
+  // valid type id per child
+  int8_t type_ids[6];
+  const char* format = schema->format + 4;
+  for (int64_t i = 0; i < schema->n_children; i++) {
+    char* end;
+    type_ids[i] = (int8_t)strtol(format, &end, 10);
+    format = end + 1;
+  }
+
+  return GeoArrowUnionArrayViewInitChildren(array_view, type_ids, schema->n_children);
+}
+
+GeoArrowErrorCode GeoArrowUnionArrayViewSetArray(
+    struct GeoArrowUnionArrayView* array_view, struct ArrowArray* array,
+    struct GeoArrowError* error) {
+  if (array->offset != 0) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "ArrowArray with offset != 0 is not yet supported in "
+                  "GeoArrowUnionArrayViewSetArray()");
+    return ENOTSUP;
+  }
+
+  if (array->n_buffers != 2 || array->n_children != array_view->n_children) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Unexpected number of buffers or children in dense union array in "
+                  "GeoArrowUnionArrayViewSetArray()");
+    return EINVAL;
+  }
+
+  for (int i = 1; i < 7; i++) {
+    if (array_view->child_index[i] != -1) {
+      NANOARROW_RETURN_NOT_OK(GeoArrowArrayViewSetArray(
+          &array_view->children[i - 1], array->children[array_view->child_index[i]],
+          error));
+    }
+  }
+
+  array_view->type_ids = (const int8_t*)array->buffers[0];
+  array_view->offsets = (const int32_t*)array->buffers[1];
+  array_view->length = array->length;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowUnionArrayViewRebind(
+    struct GeoArrowUnionArrayView* array_view, struct ArrowArray* array,
+    struct GeoArrowError* error) {
+  if (array->offset != 0) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "ArrowArray with offset != 0 is not yet supported in "
+                  "GeoArrowUnionArrayViewRebind()");
+    return ENOTSUP;
+  }
+
+  for (int i = 1; i < 7; i++) {
+    if (array_view->child_index[i] != -1) {
+      NANOARROW_RETURN_NOT_OK(GeoArrowArrayViewRebind(
+          &array_view->children[i - 1], array->children[array_view->child_index[i]],
+          error));
+    }
+  }
+
+  array_view->type_ids = (const int8_t*)array->buffers[0];
+  array_view->offsets = (const int32_t*)array->buffers[1];
+  array_view->length = array->length;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowUnionArrayViewVisit(struct GeoArrowUnionArrayView* array_view,
+                                              int64_t offset, int64_t length,
+                                              struct GeoArrowVisitor* v) {
+  const int8_t* type_ids = array_view->type_ids;
+  const int32_t* offsets = array_view->offsets;
+  enum GeoArrowDimensions dimensions = array_view->schema_view.dimensions;
+  int64_t end = offset + length;
+
+  // Consecutive features that are consecutive in the same child are visited with a
+  // single call to GeoArrowArrayViewVisit()
+  int64_t i = offset;
+  while (i < end) {
+    int8_t type_id = type_ids[i];
+    int geometry_type = type_id % 10;
+    if (geometry_type < 1 || geometry_type > 6 ||
+        array_view->child_index[geometry_type] == -1 ||
+        type_id != GeoArrowUnionTypeId(geometry_type, dimensions)) {
+      return EINVAL;
+    }
+
+    int64_t n = 1;
+    while ((i + n) < end && type_ids[i + n] == type_id &&
+           offsets[i + n] == (offsets[i] + n)) {
+      n++;
+    }
+
+    NANOARROW_RETURN_NOT_OK(GeoArrowArrayViewVisit(
+        &array_view->children[geometry_type - 1], offsets[i], n, v));
+    i += n;
+  }
+
+  return GEOARROW_OK;
+}
@@ -97,6 +97,21 @@ TEST(ArrayViewTest, ArrayViewTestInitErrors) {
   schema.release(&schema);
 }
 
+TEST(ArrayViewTest, ArrayViewTestInitOffsetsInBounds) {
+  // Initializing clears the three offset pointers and nothing that comes after them
+  struct GeoArrowArrayView array_view;
+  array_view.last_offset[0] = 123;
+  array_view.last_offset[1] = 456;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_MULTIPOLYGON),
+            GEOARROW_OK);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(array_view.offsets[i], nullptr);
+  }
+
+  EXPECT_EQ(array_view.last_offset[0], 123);
+  EXPECT_EQ(array_view.last_offset[1], 456);
+}
+
 TEST(ArrayViewTest, ArrayViewTestSetArrayErrors) {
   struct GeoArrowArrayView array_view;
   struct GeoArrowError error;
@@ -550,3 +565,119 @@ TEST(ArrayViewTest, ArrayViewTestSetArrayValidMultipolygon) {
   schema.release(&schema);
   array.release(&array);
 }
+
+TEST(ArrayViewTest, ArrayViewTestVisitMultipolygonRings) {
+  struct GeoArrowBuilder builder;
+  struct ArrowArray array;
+
+  // Build the array for [MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)),
+  //   ((10 10, 20 10, 10 20, 10 10), (11 11, 12 11, 11 12, 11 11)))], where the
+  // rings of the second polygon don't start at the first ring of the array
+  std::vector<int32_t> offset0 = {0, 2};
+  std::vector<int32_t> offset1 = {0, 1, 3};
+  std::vector<int32_t> offset2 = {0, 4, 8, 12};
+  std::vector<double> xs = {0, 1, 0, 0, 10, 20, 10, 10, 11, 12, 11, 11};
+  std::vector<double> ys = {0, 0, 1, 0, 10, 10, 20, 10, 11, 11, 12, 11};
+
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_MULTIPOLYGON),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderAppendBuffer(&builder, 1, MakeBufferView(offset0)),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderAppendBuffer(&builder, 2, MakeBufferView(offset1)),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderAppendBuffer(&builder, 3, MakeBufferView(offset2)),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderAppendBuffer(&builder, 4, MakeBufferView(xs)), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderAppendBuffer(&builder, 5, MakeBufferView(ys)), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_MULTIPOLYGON),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  WKXTester tester;
+  EXPECT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  auto values = tester.WKTValues("<null value>");
+  ASSERT_EQ(values.size(), 1);
+  EXPECT_EQ(values[0],
+            "MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)), ((10 10, 20 10, 10 20, 10 10), "
+            "(11 11, 12 11, 11 12, 11 11)))");
+
+  array.release(&array);
+}
+
+TEST(ArrayViewTest, ArrayViewTestRebind) {
+  std::vector<std::vector<std::string>> batches = {
+      {"MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)))", "MULTIPOLYGON EMPTY"},
+      {},
+      {"MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)), ((1 1, 2 1, 1 2, 1 1)))"},
+      {"MULTIPOLYGON EMPTY"}};
+
+  struct GeoArrowArrayView array_view;
+  struct GeoArrowArrayView expected;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_MULTIPOLYGON),
+            GEOARROW_OK);
+
+  for (size_t i = 0; i < batches.size(); i++) {
+    struct ArrowArray array;
+    ArrayFromWKT(GEOARROW_TYPE_MULTIPOLYGON, batches[i], &array);
+
+    // The first batch sets the structure that later batches are rebound to
+    if (i == 0) {
+      ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+    } else {
+      ASSERT_EQ(GeoArrowArrayViewRebind(&array_view, &array, nullptr), GEOARROW_OK);
+    }
+
+    // ...and give the same result as a fresh GeoArrowArrayViewSetArray()
+    ASSERT_EQ(GeoArrowArrayViewInitFromType(&expected, GEOARROW_TYPE_MULTIPOLYGON),
+              GEOARROW_OK);
+    ASSERT_EQ(GeoArrowArrayViewSetArray(&expected, &array, nullptr), GEOARROW_OK);
+    EXPECT_EQ(array_view.length, expected.length);
+    EXPECT_EQ(array_view.validity_bitmap, expected.validity_bitmap);
+    for (int j = 0; j < 3; j++) {
+      EXPECT_EQ(array_view.offsets[j], expected.offsets[j]);
+      EXPECT_EQ(array_view.last_offset[j], expected.last_offset[j]);
+    }
+
+    EXPECT_EQ(array_view.coords.n_coords, expected.coords.n_coords);
+    EXPECT_EQ(array_view.coords.values[0], expected.coords.values[0]);
+    EXPECT_EQ(array_view.coords.values[1], expected.coords.values[1]);
+
+    WKXTester tester;
+    EXPECT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array.length, tester.WKTVisitor()),
+              GEOARROW_OK);
+    EXPECT_EQ(tester.WKTValues(), batches[i]);
+    array.release(&array);
+  }
+
+  // Points have no offsets
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_POINT_Z),
+            GEOARROW_OK);
+  ArrayFromWKT(GEOARROW_TYPE_POINT_Z, {"POINT Z (0 1 2)"}, &array);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+  array.release(&array);
+
+  ArrayFromWKT(GEOARROW_TYPE_POINT_Z, {"POINT Z (3 4 5)", "POINT Z (6 7 8)"}, &array);
+  ASSERT_EQ(GeoArrowArrayViewRebind(&array_view, &array, nullptr), GEOARROW_OK);
+  EXPECT_EQ(array_view.coords.n_coords, 2);
+  WKXTester tester;
+  EXPECT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  EXPECT_EQ(tester.WKTValues(),
+            std::vector<std::string>({"POINT Z (3 4 5)", "POINT Z (6 7 8)"}));
+
+  // Offsets still aren't supported
+  struct GeoArrowError error;
+  array.offset = 1;
+  EXPECT_EQ(GeoArrowArrayViewRebind(&array_view, &array, &error), ENOTSUP);
+  EXPECT_STREQ(error.message,
+               "ArrowArray with offset != 0 is not yet supported in "
+               "GeoArrowArrayViewRebind()");
+  array.offset = 0;
+  array.release(&array);
+}
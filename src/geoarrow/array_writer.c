@@ -0,0 +1,150 @@
+
+#include <errno.h>
+#include <string.h>
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+
+struct GeoArrowArrayWriterPrivate {
+  enum GeoArrowType type;
+  struct GeoArrowWKTWriter wkt_writer;
+  struct GeoArrowWKBWriter wkb_writer;
+  struct GeoArrowBuilder builder;
+  struct GeoArrowUnionBuilder union_builder;
+};
+
+GeoArrowErrorCode GeoArrowArrayWriterInitFromType(struct GeoArrowArrayWriter* writer,
+                                                  enum GeoArrowType type) {
+  struct GeoArrowArrayWriterPrivate* private =
+      (struct GeoArrowArrayWriterPrivate*)ArrowMalloc(
+          sizeof(struct GeoArrowArrayWriterPrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct GeoArrowArrayWriterPrivate));
+  private->type = type;
+
+  int result;
+  switch (type) {
+    case GEOARROW_TYPE_WKB:
+      result = GeoArrowWKBWriterInit(&private->wkb_writer);
+      break;
+    case GEOARROW_TYPE_WKT:
+      result = GeoArrowWKTWriterInit(&private->wkt_writer);
+      break;
+    case GEOARROW_TYPE_LARGE_WKB:
+    case GEOARROW_TYPE_LARGE_WKT:
+      result = ENOTSUP;
+      break;
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
+      result = GeoArrowUnionBuilderInitFromType(&private->union_builder, type);
+      break;
+    default:
+      result = GeoArrowBuilderInitFromType(&private->builder, type);
+      break;
+  }
+
+  if (result != GEOARROW_OK) {
+    ArrowFree(private);
+    return result;
+  }
+
+  writer->private_data = private;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowArrayWriterInitVisitor(struct GeoArrowArrayWriter* writer,
+                                                 struct GeoArrowVisitor* v) {
+  struct GeoArrowArrayWriterPrivate* private =
+      (struct GeoArrowArrayWriterPrivate*)writer->private_data;
+
+  switch (private->type) {
+    case GEOARROW_TYPE_WKB:
+      GeoArrowWKBWriterInitVisitor(&private->wkb_writer, v);
+      return GEOARROW_OK;
+    case GEOARROW_TYPE_WKT:
+      GeoArrowWKTWriterInitVisitor(&private->wkt_writer, v);
+      return GEOARROW_OK;
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
+      GeoArrowUnionBuilderInitVisitor(&private->union_builder, v);
+      return GEOARROW_OK;
+    default:
+      GeoArrowBuilderInitVisitor(&private->builder, v);
+      return GEOARROW_OK;
+  }
+}
+
+GeoArrowErrorCode GeoArrowArrayWriterSetAllocator(
+    struct GeoArrowArrayWriter* writer, struct GeoArrowBufferAllocator allocator) {
+  struct GeoArrowArrayWriterPrivate* private =
+      (struct GeoArrowArrayWriterPrivate*)writer->private_data;
+
+  switch (private->type) {
+    case GEOARROW_TYPE_WKB:
+      return GeoArrowWKBWriterSetAllocator(&private->wkb_writer, allocator);
+    case GEOARROW_TYPE_WKT:
+      return GeoArrowWKTWriterSetAllocator(&private->wkt_writer, allocator);
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
+      return GeoArrowUnionBuilderSetAllocator(&private->union_builder, allocator);
+    default:
+      return GeoArrowBuilderSetAllocator(&private->builder, allocator);
+  }
+}
+
+GeoArrowErrorCode GeoArrowArrayWriterFinish(struct GeoArrowArrayWriter* writer,
+                                            struct ArrowArray* array,
+                                            struct GeoArrowError* error) {
+  struct GeoArrowArrayWriterPrivate* private =
+      (struct GeoArrowArrayWriterPrivate*)writer->private_data;
+
+  switch (private->type) {
+    case GEOARROW_TYPE_WKB:
+      return GeoArrowWKBWriterFinish(&private->wkb_writer, array, error);
+    case GEOARROW_TYPE_WKT:
+      return GeoArrowWKTWriterFinish(&private->wkt_writer, array, error);
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
+      return GeoArrowUnionBuilderFinish(&private->union_builder, array, error);
+    default:
+      return GeoArrowBuilderFinish(&private->builder, array, error);
+  }
+}
+
+void GeoArrowArrayWriterReset(struct GeoArrowArrayWriter* writer) {
+  struct GeoArrowArrayWriterPrivate* private =
+      (struct GeoArrowArrayWriterPrivate*)writer->private_data;
+
+  switch (private->type) {
+    case GEOARROW_TYPE_WKB:
+      GeoArrowWKBWriterReset(&private->wkb_writer);
+      break;
+    case GEOARROW_TYPE_WKT:
+      GeoArrowWKTWriterReset(&private->wkt_writer);
+      break;
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
+      GeoArrowUnionBuilderReset(&private->union_builder);
+      break;
+    default:
+      GeoArrowBuilderReset(&private->builder);
+      break;
+  }
+
+  ArrowFree(private);
+  writer->private_data = NULL;
+}
@@ -0,0 +1,149 @@
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+TEST(ArrayWriterTest, ArrayWriterTestBasic) {
+  struct GeoArrowArrayWriter writer;
+  ASSERT_EQ(GeoArrowArrayWriterInitFromType(&writer, GEOARROW_TYPE_WKB), GEOARROW_OK);
+  GeoArrowArrayWriterReset(&writer);
+
+  ASSERT_EQ(GeoArrowArrayWriterInitFromType(&writer, GEOARROW_TYPE_WKT), GEOARROW_OK);
+  GeoArrowArrayWriterReset(&writer);
+
+  ASSERT_EQ(GeoArrowArrayWriterInitFromType(&writer, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  GeoArrowArrayWriterReset(&writer);
+
+  EXPECT_EQ(GeoArrowArrayWriterInitFromType(&writer, GEOARROW_TYPE_LARGE_WKB), ENOTSUP);
+}
+
+class ArrayWriterTypeFixture : public ::testing::TestWithParam<enum GeoArrowType> {};
+
+TEST_P(ArrayWriterTypeFixture, ArrayWriterTestRoundtrip) {
+  enum GeoArrowType type = GetParam();
+
+  struct GeoArrowArrayWriter writer;
+  struct GeoArrowVisitor v;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowArrayWriterInitFromType(&writer, type), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayWriterInitVisitor(&writer, &v), GEOARROW_OK);
+  v.error = &error;
+
+  struct GeoArrowWKTReader wkt_reader;
+  GeoArrowWKTReaderInit(&wkt_reader);
+  std::string wkt = "LINESTRING (0 1, 2 3)";
+  struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+  ASSERT_EQ(GeoArrowWKTReaderVisit(&wkt_reader, item, &v), GEOARROW_OK);
+  ASSERT_EQ(v.feat_start(&v), GEOARROW_OK);
+  ASSERT_EQ(v.null_feat(&v), GEOARROW_OK);
+  ASSERT_EQ(v.feat_end(&v), GEOARROW_OK);
+  GeoArrowWKTReaderReset(&wkt_reader);
+
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowArrayWriterFinish(&writer, &array, &error), GEOARROW_OK);
+  GeoArrowArrayWriterReset(&writer);
+  EXPECT_EQ(array.length, 2);
+  EXPECT_EQ(array.null_count, 1);
+
+  struct GeoArrowArrayReader reader;
+  ASSERT_EQ(GeoArrowArrayReaderInitFromType(&reader, type), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayReaderSetArray(&reader, &array, nullptr), GEOARROW_OK);
+
+  WKXTester tester;
+  ASSERT_EQ(GeoArrowArrayReaderVisit(&reader, 0, array.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  auto values = tester.WKTValues("<null value>");
+  ASSERT_EQ(values.size(), 2);
+  EXPECT_EQ(values[0], "LINESTRING (0 1, 2 3)");
+  EXPECT_EQ(values[1], "<null value>");
+
+  GeoArrowArrayReaderReset(&reader);
+  array.release(&array);
+}
+
+
+INSTANTIATE_TEST_SUITE_P(ArrayWriterTest, ArrayWriterTypeFixture,
+                         ::testing::Values(GEOARROW_TYPE_WKB, GEOARROW_TYPE_WKT,
+                                           GEOARROW_TYPE_LINESTRING));
+
+struct CountingAllocatorData {
+  int64_t n_allocations;
+  int64_t bytes_allocated;
+};
+
+static uint8_t* CountingAllocatorReallocate(struct ArrowBufferAllocator* allocator,
+                                            uint8_t* ptr, int64_t old_size,
+                                            int64_t new_size) {
+  auto data = reinterpret_cast<struct CountingAllocatorData*>(allocator->private_data);
+  data->n_allocations++;
+  data->bytes_allocated += new_size - old_size;
+  return reinterpret_cast<uint8_t*>(realloc(ptr, new_size));
+}
+
+static void CountingAllocatorFree(struct ArrowBufferAllocator* allocator, uint8_t* ptr,
+                                  int64_t size) {
+  auto data = reinterpret_cast<struct CountingAllocatorData*>(allocator->private_data);
+  data->bytes_allocated -= size;
+  free(ptr);
+}
+
+static void TestWriterAllocator(enum GeoArrowType type) {
+  struct CountingAllocatorData data = {0, 0};
+  struct GeoArrowBufferAllocator allocator = {&CountingAllocatorReallocate,
+                                              &CountingAllocatorFree, &data};
+
+  struct GeoArrowArrayWriter writer;
+  struct GeoArrowVisitor v;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowArrayWriterInitFromType(&writer, type), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayWriterSetAllocator(&writer, allocator), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayWriterInitVisitor(&writer, &v), GEOARROW_OK);
+  v.error = &error;
+
+  struct GeoArrowWKTReader wkt_reader;
+  GeoArrowWKTReaderInit(&wkt_reader);
+  std::string wkt = "LINESTRING (0 1, 2 3)";
+  struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+
+  // The allocator can't be changed once something was allocated
+  ASSERT_EQ(GeoArrowWKTReaderVisit(&wkt_reader, item, &v), GEOARROW_OK);
+  EXPECT_GT(data.n_allocations, 0);
+  EXPECT_EQ(GeoArrowArrayWriterSetAllocator(&writer, allocator), EINVAL);
+
+  struct ArrowArray array1;
+  ASSERT_EQ(GeoArrowArrayWriterFinish(&writer, &array1, &error), GEOARROW_OK);
+
+  // ...and is used for later arrays
+  int64_t bytes_allocated = data.bytes_allocated;
+  ASSERT_EQ(GeoArrowWKTReaderVisit(&wkt_reader, item, &v), GEOARROW_OK);
+  struct ArrowArray array2;
+  ASSERT_EQ(GeoArrowArrayWriterFinish(&writer, &array2, &error), GEOARROW_OK);
+  EXPECT_GT(data.bytes_allocated, bytes_allocated);
+  GeoArrowWKTReaderReset(&wkt_reader);
+  GeoArrowArrayWriterReset(&writer);
+
+  struct GeoArrowArrayReader reader;
+  ASSERT_EQ(GeoArrowArrayReaderInitFromType(&reader, type), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayReaderSetArray(&reader, &array2, nullptr), GEOARROW_OK);
+  WKXTester tester;
+  ASSERT_EQ(GeoArrowArrayReaderVisit(&reader, 0, array2.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  EXPECT_EQ(tester.WKTValues(), std::vector<std::string>({wkt}));
+  GeoArrowArrayReaderReset(&reader);
+
+  // Everything is given back to the allocator when the arrays are released
+  array1.release(&array1);
+  array2.release(&array2);
+  EXPECT_EQ(data.bytes_allocated, 0);
+}
+
+TEST(ArrayWriterTest, ArrayWriterTestAllocator) {
+  for (enum GeoArrowType type : {GEOARROW_TYPE_WKB, GEOARROW_TYPE_WKT,
+                                 GEOARROW_TYPE_LINESTRING, GEOARROW_TYPE_GEOMETRY}) {
+    SCOPED_TRACE(type);
+    TestWriterAllocator(type);
+  }
+}
@@ -0,0 +1,219 @@
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+#include "sync.h"
+
+// Sizes are rounded up to 64 bytes or to a multiple of a quarter of the power of two
+// below them, so that a cached block wastes less than 25% of its size. There are
+// four classes for each power of two from 2^6 to 2^62.
+#define GEOARROW_BUFFER_POOL_MIN_SIZE 64
+#define GEOARROW_BUFFER_POOL_N_CLASSES (1 + 4 * 57)
+
+struct BufferPoolPrivate {
+  // Cached blocks of each size class as a singly linked list whose next pointers are
+  // stored in the first bytes of each block
+  void* free_lists[GEOARROW_BUFFER_POOL_N_CLASSES];
+  int64_t cached_bytes;
+  int64_t max_cached_bytes;
+
+  // One for the pool itself and one for each block that was handed out and not yet
+  // freed: arrays may be released after GeoArrowBufferPoolReset()
+  int64_t ref_count;
+  int closed;
+  struct GeoArrowMutex mutex;
+};
+
+static void GeoArrowBufferPoolLock(struct BufferPoolPrivate* private) {
+  GeoArrowMutexLock(&private->mutex);
+}
+
+static void GeoArrowBufferPoolUnlock(struct BufferPoolPrivate* private) {
+  GeoArrowMutexUnlock(&private->mutex);
+}
+
+// Returns the size class of size and writes the number of bytes that are actually
+// allocated for it to class_size_out
+static int GeoArrowBufferPoolClass(int64_t size, int64_t* class_size_out) {
+  if (size <= GEOARROW_BUFFER_POOL_MIN_SIZE) {
+    *class_size_out = GEOARROW_BUFFER_POOL_MIN_SIZE;
+    return 0;
+  }
+
+  // size is in (2^k, 2^(k + 1)]
+  int k = 0;
+  for (uint64_t n = (uint64_t)(size - 1); n > 1; n >>= 1) {
+    k++;
+  }
+
+  int64_t step = ((int64_t)1) << (k - 2);
+  int64_t n_steps = (size + step - 1) / step;
+  *class_size_out = n_steps * step;
+  return 1 + (k - 6) * 4 + (int)(n_steps - 5);
+}
+
+static void GeoArrowBufferPoolFreePrivate(struct BufferPoolPrivate* private) {
+  for (int i = 0; i < GEOARROW_BUFFER_POOL_N_CLASSES; i++) {
+    void* block = private->free_lists[i];
+    while (block != NULL) {
+      void* next;
+      memcpy(&next, block, sizeof(void*));
+      free(block);
+      block = next;
+    }
+
+    private->free_lists[i] = NULL;
+  }
+
+  private->cached_bytes = 0;
+}
+
+// Releases one reference to the pool while the lock is held, unlocking it and
+// freeing the pool if it was the last one
+static void GeoArrowBufferPoolReleaseUnlock(struct BufferPoolPrivate* private) {
+  private->ref_count--;
+  int64_t ref_count = private->ref_count;
+  GeoArrowBufferPoolUnlock(private);
+
+  if (ref_count == 0) {
+    GeoArrowMutexReset(&private->mutex);
+    ArrowFree(private);
+  }
+}
+
+// Takes a block of size_class from the cache or allocates a new one
+static uint8_t* GeoArrowBufferPoolTake(struct BufferPoolPrivate* private,
+                                       int size_class, int64_t class_size) {
+  GeoArrowBufferPoolLock(private);
+  void* block = private->free_lists[size_class];
+  if (block != NULL) {
+    memcpy(&private->free_lists[size_class], block, sizeof(void*));
+    private->cached_bytes -= class_size;
+  }
+
+  private->ref_count++;
+  GeoArrowBufferPoolUnlock(private);
+
+  if (block == NULL) {
+    block = malloc(class_size);
+    if (block == NULL) {
+      GeoArrowBufferPoolLock(private);
+      GeoArrowBufferPoolReleaseUnlock(private);
+    }
+  }
+
+  return (uint8_t*)block;
+}
+
+// Puts a block of size_class back into the cache (or frees it if the cache is full
+// or the pool was reset)
+static void GeoArrowBufferPoolGive(struct BufferPoolPrivate* private, uint8_t* block,
+                                   int size_class, int64_t class_size) {
+  GeoArrowBufferPoolLock(private);
+  if (!private->closed &&
+      (private->cached_bytes + class_size) <= private->max_cached_bytes) {
+    memcpy(block, &private->free_lists[size_class], sizeof(void*));
+    private->free_lists[size_class] = block;
+    private->cached_bytes += class_size;
+  } else {
+    free(block);
+  }
+
+  GeoArrowBufferPoolReleaseUnlock(private);
+}
+
+static uint8_t* GeoArrowBufferPoolReallocate(struct ArrowBufferAllocator* allocator,
+                                             uint8_t* ptr, int64_t old_size,
+                                             int64_t new_size) {
+  struct BufferPoolPrivate* private = (struct BufferPoolPrivate*)allocator->private_data;
+  int64_t old_class_size = 0;
+  int64_t new_class_size;
+  int old_class = GeoArrowBufferPoolClass(old_size, &old_class_size);
+  int new_class = GeoArrowBufferPoolClass(new_size, &new_class_size);
+
+  if (ptr != NULL && new_size <= 0) {
+    GeoArrowBufferPoolGive(private, ptr, old_class, old_class_size);
+    return NULL;
+  }
+
+  // Growing within a size class is free
+  if (ptr != NULL && old_class == new_class) {
+    return ptr;
+  }
+
+  uint8_t* out = GeoArrowBufferPoolTake(private, new_class, new_class_size);
+  if (out == NULL) {
+    return NULL;
+  }
+
+  if (ptr != NULL) {
+    memcpy(out, ptr, old_size < new_size ? old_size : new_size);
+    GeoArrowBufferPoolGive(private, ptr, old_class, old_class_size);
+  }
+
+  return out;
+}
+
+static void GeoArrowBufferPoolFree(struct ArrowBufferAllocator* allocator, uint8_t* ptr,
+                                   int64_t size) {
+  if (ptr == NULL) {
+    return;
+  }
+
+  struct BufferPoolPrivate* private = (struct BufferPoolPrivate*)allocator->private_data;
+  int64_t class_size;
+  int size_class = GeoArrowBufferPoolClass(size, &class_size);
+  GeoArrowBufferPoolGive(private, ptr, size_class, class_size);
+}
+
+GeoArrowErrorCode GeoArrowBufferPoolInit(struct GeoArrowBufferPool* pool,
+                                         int64_t max_cached_bytes) {
+  struct BufferPoolPrivate* private =
+      (struct BufferPoolPrivate*)ArrowMalloc(sizeof(struct BufferPoolPrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct BufferPoolPrivate));
+  private->max_cached_bytes = max_cached_bytes;
+  private->ref_count = 1;
+
+  int result = GeoArrowMutexInit(&private->mutex);
+  if (result != GEOARROW_OK) {
+    ArrowFree(private);
+    return result;
+  }
+
+  pool->private_data = private;
+  return GEOARROW_OK;
+}
+
+struct GeoArrowBufferAllocator GeoArrowBufferPoolAllocator(
+    struct GeoArrowBufferPool* pool) {
+  struct GeoArrowBufferAllocator allocator;
+  allocator.reallocate = &GeoArrowBufferPoolReallocate;
+  allocator.free = &GeoArrowBufferPoolFree;
+  allocator.private_data = pool->private_data;
+  return allocator;
+}
+
+int64_t GeoArrowBufferPoolCachedBytes(struct GeoArrowBufferPool* pool) {
+  struct BufferPoolPrivate* private = (struct BufferPoolPrivate*)pool->private_data;
+  GeoArrowBufferPoolLock(private);
+  int64_t cached_bytes = private->cached_bytes;
+  GeoArrowBufferPoolUnlock(private);
+  return cached_bytes;
+}
+
+void GeoArrowBufferPoolReset(struct GeoArrowBufferPool* pool) {
+  struct BufferPoolPrivate* private = (struct BufferPoolPrivate*)pool->private_data;
+  GeoArrowBufferPoolLock(private);
+  GeoArrowBufferPoolFreePrivate(private);
+  private->closed = 1;
+  GeoArrowBufferPoolReleaseUnlock(private);
+  pool->private_data = NULL;
+}
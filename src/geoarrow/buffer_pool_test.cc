@@ -0,0 +1,160 @@
+
+#include <pthread.h>
+
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+static std::set<const void*> ArrayBuffers(struct ArrowArray* array) {
+  std::set<const void*> out;
+  for (int64_t i = 0; i < array->n_buffers; i++) {
+    if (array->buffers[i] != nullptr) {
+      out.insert(array->buffers[i]);
+    }
+  }
+
+  return out;
+}
+
+TEST(BufferPoolTest, BufferPoolTestReuse) {
+  struct GeoArrowBufferPool pool;
+  ASSERT_EQ(GeoArrowBufferPoolInit(&pool, 1 << 20), GEOARROW_OK);
+  struct GeoArrowBufferAllocator allocator = GeoArrowBufferPoolAllocator(&pool);
+  EXPECT_EQ(GeoArrowBufferPoolCachedBytes(&pool), 0);
+
+  std::vector<std::string> wkts = {"LINESTRING (0 1, 2 3)", "LINESTRING (4 5, 6 7, 8 9)"};
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_WKB, wkts, &array, &allocator);
+  std::set<const void*> buffers = ArrayBuffers(&array);
+  ASSERT_EQ(buffers.size(), 2);
+
+  // Releasing the array puts its buffers back into the pool
+  array.release(&array);
+  int64_t cached_bytes = GeoArrowBufferPoolCachedBytes(&pool);
+  EXPECT_GT(cached_bytes, 0);
+
+  // ...and a batch with the same shape takes them out again without needing any
+  // more memory
+  ArrayFromWKT(GEOARROW_TYPE_WKB, wkts, &array, &allocator);
+  EXPECT_EQ(ArrayBuffers(&array), buffers);
+  EXPECT_LT(GeoArrowBufferPoolCachedBytes(&pool), cached_bytes);
+  array.release(&array);
+  EXPECT_EQ(GeoArrowBufferPoolCachedBytes(&pool), cached_bytes);
+
+  // The buffers of builders are recycled too
+  ArrayFromWKT(GEOARROW_TYPE_LINESTRING, wkts, &array, &allocator);
+  EXPECT_EQ(array.children[0]->length, 5);
+  array.release(&array);
+  EXPECT_GT(GeoArrowBufferPoolCachedBytes(&pool), cached_bytes);
+
+  GeoArrowBufferPoolReset(&pool);
+}
+
+TEST(BufferPoolTest, BufferPoolTestLimit) {
+  struct GeoArrowBufferPool pool;
+  ASSERT_EQ(GeoArrowBufferPoolInit(&pool, 0), GEOARROW_OK);
+  struct GeoArrowBufferAllocator allocator = GeoArrowBufferPoolAllocator(&pool);
+
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_WKT, {"POINT (0 1)"}, &array, &allocator);
+  array.release(&array);
+  EXPECT_EQ(GeoArrowBufferPoolCachedBytes(&pool), 0);
+
+  GeoArrowBufferPoolReset(&pool);
+}
+
+TEST(BufferPoolTest, BufferPoolTestGrow) {
+  struct GeoArrowBufferPool pool;
+  ASSERT_EQ(GeoArrowBufferPoolInit(&pool, 1 << 20), GEOARROW_OK);
+
+  struct ArrowBuffer buffer;
+  struct GeoArrowBufferAllocator allocator = GeoArrowBufferPoolAllocator(&pool);
+  struct ArrowBufferAllocator arrow_allocator;
+  memcpy(&arrow_allocator, &allocator, sizeof(struct ArrowBufferAllocator));
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferSetAllocator(&buffer, arrow_allocator), GEOARROW_OK);
+
+  // Growing within a size class doesn't move the data
+  ASSERT_EQ(ArrowBufferReserve(&buffer, 10), GEOARROW_OK);
+  ArrowBufferAppendUnsafe(&buffer, "0123456789", 10);
+  const uint8_t* data = buffer.data;
+  ASSERT_EQ(ArrowBufferResize(&buffer, 64, 0), GEOARROW_OK);
+  EXPECT_EQ(buffer.data, data);
+
+  // Growing into another size class copies the data and caches the old block
+  ASSERT_EQ(ArrowBufferResize(&buffer, 1000, 0), GEOARROW_OK);
+  EXPECT_NE(buffer.data, data);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(buffer.data), 10), "0123456789");
+  EXPECT_EQ(GeoArrowBufferPoolCachedBytes(&pool), 64);
+
+  // 1000 bytes are rounded up to 1024
+  ArrowBufferReset(&buffer);
+  EXPECT_EQ(GeoArrowBufferPoolCachedBytes(&pool), 64 + 1024);
+
+  GeoArrowBufferPoolReset(&pool);
+}
+
+TEST(BufferPoolTest, BufferPoolTestOutlivePool) {
+  struct GeoArrowBufferPool pool;
+  ASSERT_EQ(GeoArrowBufferPoolInit(&pool, 1 << 20), GEOARROW_OK);
+  struct GeoArrowBufferAllocator allocator = GeoArrowBufferPoolAllocator(&pool);
+
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_POINT, {"POINT (0 1)", "POINT (2 3)"}, &array, &allocator);
+  GeoArrowBufferPoolReset(&pool);
+
+  const double* xs = reinterpret_cast<const double*>(array.children[0]->buffers[1]);
+  EXPECT_EQ(xs[1], 2);
+  array.release(&array);
+}
+
+struct BufferPoolThreadArgs {
+  struct GeoArrowBufferPool* pool;
+  int n_ok;
+};
+
+static void* BufferPoolThread(void* arg) {
+  struct BufferPoolThreadArgs* args = reinterpret_cast<struct BufferPoolThreadArgs*>(arg);
+  // The callbacks are given the allocator as a builder or writer installs it
+  struct GeoArrowBufferAllocator pool_allocator = GeoArrowBufferPoolAllocator(args->pool);
+  struct ArrowBufferAllocator allocator;
+  allocator.reallocate = pool_allocator.reallocate;
+  allocator.free = pool_allocator.free;
+  allocator.private_data = pool_allocator.private_data;
+  for (int i = 0; i < 1000; i++) {
+    int64_t size = 64 + (i % 16) * 100;
+    uint8_t* ptr = allocator.reallocate(&allocator, nullptr, 0, size);
+    if (ptr != nullptr) {
+      memset(ptr, i % 256, size);
+      allocator.free(&allocator, ptr, size);
+      args->n_ok++;
+    }
+  }
+
+  return nullptr;
+}
+
+TEST(BufferPoolTest, BufferPoolTestThreads) {
+  struct GeoArrowBufferPool pool;
+  ASSERT_EQ(GeoArrowBufferPoolInit(&pool, 1 << 20), GEOARROW_OK);
+
+  pthread_t threads[8];
+  struct BufferPoolThreadArgs args[8];
+  for (int i = 0; i < 8; i++) {
+    args[i] = {&pool, 0};
+    ASSERT_EQ(pthread_create(&threads[i], nullptr, &BufferPoolThread, &args[i]), 0);
+  }
+
+  for (int i = 0; i < 8; i++) {
+    pthread_join(threads[i], nullptr);
+    EXPECT_EQ(args[i].n_ok, 1000);
+  }
+
+  EXPECT_GT(GeoArrowBufferPoolCachedBytes(&pool), 0);
+  GeoArrowBufferPoolReset(&pool);
+}
@@ -1,10 +1,14 @@
 
+#include <errno.h>
+#include <math.h>
 #include <string.h>
 
 #include "nanoarrow.h"
 
 #include "geoarrow.h"
 
+#include "instrumentation.h"
+
 struct BuilderPrivate {
   // The ArrowArray responsible for owning the memory
   struct ArrowArray array;
@@ -26,12 +30,55 @@ struct BuilderPrivate {
   int64_t size_pos[32];
   uint32_t size[32];
   int32_t level;
+  int32_t n_offsets;
+  int64_t length;
+  int64_t null_count;
+  int64_t feat_n_coords;
 
   // Options
   int significant_digits;
   int use_flat_multipoint;
+  enum GeoArrowGrowthPolicy growth_policy;
+  int64_t growth_increment_bytes;
+  struct ArrowBufferAllocator allocator;
+
+  struct GeoArrowInstrumentation instrumentation;
 };
 
+static GeoArrowErrorCode GeoArrowBuilderInitArray(struct GeoArrowBuilder* builder) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+
+  struct ArrowSchema schema;
+  NANOARROW_RETURN_NOT_OK(GeoArrowSchemaInit(&schema, builder->view.schema_view.type));
+  int result = ArrowArrayInitFromSchema(&private->array, &schema, NULL);
+  schema.release(&schema);
+  NANOARROW_RETURN_NOT_OK(result);
+
+  // Cache the ArrowBitmap and ArrowBuffer pointers we need to allocate
+  private->validity = ArrowArrayValidityBitmap(&private->array);
+
+  struct _GeoArrowFindBufferResult res;
+  for (int64_t i = 0; i < builder->view.n_buffers; i++) {
+    res.array = NULL;
+    _GeoArrowArrayFindBuffer(&private->array, &res, i, 0, 0);
+    if (res.array == NULL) {
+      return EINVAL;
+    }
+
+    private->buffers[i] = ArrowArrayBuffer(res.array, res.i);
+    NANOARROW_RETURN_NOT_OK(
+        ArrowBufferSetAllocator(private->buffers[i], private->allocator));
+    builder->view.buffers[i].data.data = NULL;
+    builder->view.buffers[i].size_bytes = 0;
+    builder->view.buffers[i].capacity_bytes = 0;
+  }
+
+  builder->view.length = 0;
+  private->length = 0;
+  private->null_count = 0;
+  return GEOARROW_OK;
+}
+
 static GeoArrowErrorCode GeoArrowBuilderInitInternal(struct GeoArrowBuilder* builder) {
   enum GeoArrowType type = builder->view.schema_view.type;
 
@@ -47,21 +94,8 @@ static GeoArrowErrorCode GeoArrowBuilderInitInternal(struct GeoArrowBuilder* bui
 
   memset(private, 0, sizeof(struct BuilderPrivate));
 
-  struct ArrowSchema schema;
-  int result = GeoArrowSchemaInit(&schema, type);
-  if (result != GEOARROW_OK) {
-    ArrowFree(private);
-    return result;
-  }
-
-  result = ArrowArrayInitFromSchema(&private->array, &schema, NULL);
-  schema.release(&schema);
-  if (result != GEOARROW_OK) {
-    ArrowFree(private);
-    return result;
-  }
-
   // Update a few things about the writable view from the regular view
+  private->n_offsets = array_view.n_offsets;
   builder->view.coords.n_values = array_view.coords.n_values;
   builder->view.coords.coords_stride = array_view.coords.coords_stride;
   switch (builder->view.schema_view.coord_type) {
@@ -75,26 +109,18 @@ static GeoArrowErrorCode GeoArrowBuilderInitInternal(struct GeoArrowBuilder* bui
       break;
   }
 
-  // Cache the ArrowBitmap and ArrowBuffer pointers we need to allocate
-  private->validity = ArrowArrayValidityBitmap(&private->array);
-
-  struct _GeoArrowFindBufferResult res;
-  for (int64_t i = 0; i < builder->view.n_buffers; i++) {
-    res.array = NULL;
-    _GeoArrowArrayFindBuffer(&private->array, &res, i, 0, 0);
-    if (res.array == NULL) {
-      ArrowFree(private);
-      return EINVAL;
-    }
-
-    private->buffers[i] = ArrowArrayBuffer(res.array, res.i);
-  }
-
   // Some default options
   private->significant_digits = 16;
   private->use_flat_multipoint = 1;
+  private->allocator = ArrowBufferAllocatorDefault();
 
   builder->private_data = private;
+  int result = GeoArrowBuilderInitArray(builder);
+  if (result != GEOARROW_OK) {
+    GeoArrowBuilderReset(builder);
+    return result;
+  }
+
   return GEOARROW_OK;
 }
 
@@ -115,6 +141,31 @@ GeoArrowErrorCode GeoArrowBuilderInitFromSchema(struct GeoArrowBuilder* builder,
   return GeoArrowBuilderInitInternal(builder);
 }
 
+// Grows buffer to hold at least min_capacity_bytes according to the growth policy
+static GeoArrowErrorCode GeoArrowBuilderGrowBuffer(struct BuilderPrivate* private,
+                                                   struct ArrowBuffer* buffer,
+                                                   int64_t min_capacity_bytes) {
+  GEOARROW_INSTRUMENT(private->instrumentation.n_reallocations++);
+  int64_t increment_bytes;
+  switch (private->growth_policy) {
+    case GEOARROW_GROWTH_POLICY_LINEAR:
+      // Grow by the smallest multiple of the increment that fits
+      increment_bytes = private->growth_increment_bytes;
+      return ArrowBufferResize(
+          buffer,
+          buffer->capacity_bytes +
+              ((min_capacity_bytes - buffer->capacity_bytes + increment_bytes - 1) /
+               increment_bytes) *
+                  increment_bytes,
+          0);
+    case GEOARROW_GROWTH_POLICY_EXACT:
+      return ArrowBufferResize(buffer, min_capacity_bytes, 0);
+    default:
+      // Use nanoarrow's reserve
+      return ArrowBufferReserve(buffer, min_capacity_bytes - buffer->size_bytes);
+  }
+}
+
 GeoArrowErrorCode GeoArrowBuilderReserveBuffer(struct GeoArrowBuilder* builder, int64_t i,
                                                int64_t additional_size_bytes) {
   struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
@@ -124,8 +175,11 @@ GeoArrowErrorCode GeoArrowBuilderReserveBuffer(struct GeoArrowBuilder* builder,
   // Sync any changes from the builder's view of the buffer to nanoarrow's
   buffer_src->size_bytes = buffer_dst->size_bytes;
 
-  // Use nanoarrow's reserve
-  NANOARROW_RETURN_NOT_OK(ArrowBufferReserve(buffer_src, additional_size_bytes));
+  int64_t min_capacity_bytes = buffer_src->size_bytes + additional_size_bytes;
+  if (min_capacity_bytes > buffer_src->capacity_bytes) {
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowBuilderGrowBuffer(private, buffer_src, min_capacity_bytes));
+  }
 
   // Sync any changes back to the builder's view
   builder->view.buffers[i].data.data = buffer_src->data;
@@ -133,9 +187,614 @@ GeoArrowErrorCode GeoArrowBuilderReserveBuffer(struct GeoArrowBuilder* builder,
   return GEOARROW_OK;
 }
 
+// Makes room for additional_size_bits more bits in the validity bitmap. Like
+// ArrowBitmapReserve() but growing according to the growth policy.
+static GeoArrowErrorCode GeoArrowBuilderReserveValidity(struct GeoArrowBuilder* builder,
+                                                        int64_t additional_size_bits) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  struct ArrowBitmap* validity = private->validity;
+  int64_t min_capacity_bytes =
+      _ArrowBytesForBits(validity->size_bits + additional_size_bits);
+  if (min_capacity_bytes > validity->buffer.capacity_bytes) {
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowBuilderGrowBuffer(private, &validity->buffer, min_capacity_bytes));
+    // Zero the last byte so that unused trailing bits are deterministic
+    validity->buffer.data[validity->buffer.capacity_bytes - 1] = 0;
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowBuilderSetGrowthPolicy(struct GeoArrowBuilder* builder,
+                                                 enum GeoArrowGrowthPolicy policy,
+                                                 int64_t increment_bytes) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  switch (policy) {
+    case GEOARROW_GROWTH_POLICY_GEOMETRIC:
+    case GEOARROW_GROWTH_POLICY_EXACT:
+      break;
+    case GEOARROW_GROWTH_POLICY_LINEAR:
+      if (increment_bytes <= 0) {
+        return EINVAL;
+      }
+      break;
+    default:
+      return EINVAL;
+  }
+
+  private->growth_policy = policy;
+  private->growth_increment_bytes = increment_bytes;
+  return GEOARROW_OK;
+}
+
+static inline int64_t GeoArrowBuilderCoordBufferSize(struct GeoArrowBuilder* builder) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  return builder->view.buffers[1 + private->n_offsets].size_bytes / sizeof(double);
+}
+
+// The current size of the child array (either the next offset buffer or the
+// coordinates) of the offset buffer at level
+static inline int64_t GeoArrowBuilderChildSize(struct GeoArrowBuilder* builder,
+                                               int32_t level) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  if ((level + 1) < private->n_offsets) {
+    return (builder->view.buffers[2 + level].size_bytes / sizeof(int32_t)) - 1;
+  } else {
+    return GeoArrowBuilderCoordBufferSize(builder);
+  }
+}
+
+// Finishes an item at offset buffer level by appending the current size of the
+// child array to its offsets.
+static inline int GeoArrowBuilderFinishItem(struct GeoArrowBuilder* builder,
+                                            int32_t level) {
+  int64_t child_size = GeoArrowBuilderChildSize(builder, level);
+  if (child_size > INT32_MAX) {
+    return EOVERFLOW;
+  }
+
+  int32_t child_size32 = (int32_t)child_size;
+  struct GeoArrowBufferView value = {(const uint8_t*)&child_size32, sizeof(int32_t)};
+  return GeoArrowBuilderAppendBuffer(builder, 1 + level, value);
+}
+
+static inline void GeoArrowBuilderSyncValidity(struct GeoArrowBuilder* builder) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  builder->view.buffers[0].data.data = private->validity->buffer.data;
+  builder->view.buffers[0].size_bytes = private->validity->buffer.size_bytes;
+  builder->view.buffers[0].capacity_bytes = private->validity->buffer.capacity_bytes;
+}
+
+GeoArrowErrorCode GeoArrowBuilderSetAllocator(struct GeoArrowBuilder* builder,
+                                              struct GeoArrowBufferAllocator allocator) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  struct ArrowBufferAllocator arrow_allocator;
+  arrow_allocator.reallocate = allocator.reallocate;
+  arrow_allocator.free = allocator.free;
+  arrow_allocator.private_data = allocator.private_data;
+
+  // Buffers can only change allocators before they allocate anything
+  for (int64_t i = 0; i < builder->view.n_buffers; i++) {
+    if (builder->view.buffers[i].data.data != NULL) {
+      return EINVAL;
+    }
+  }
+
+  for (int64_t i = 0; i < builder->view.n_buffers; i++) {
+    NANOARROW_RETURN_NOT_OK(
+        ArrowBufferSetAllocator(private->buffers[i], arrow_allocator));
+  }
+
+  private->allocator = arrow_allocator;
+  return GEOARROW_OK;
+}
+
+// Reserves n_items more values of size_bytes in buffer i, plus the leading zero of
+// an offset buffer that hasn't been started yet
+static GeoArrowErrorCode GeoArrowBuilderReserveItems(struct GeoArrowBuilder* builder,
+                                                     int64_t i, int64_t n_items,
+                                                     int64_t size_bytes,
+                                                     int is_offsets) {
+  if (is_offsets && builder->view.buffers[i].size_bytes == 0) {
+    n_items++;
+  }
+
+  if (n_items <= 0) {
+    return GEOARROW_OK;
+  }
+
+  if (!GeoArrowBuilderBufferCheck(builder, i, n_items * size_bytes)) {
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowBuilderReserveBuffer(builder, i, n_items * size_bytes));
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowBuilderReserve(struct GeoArrowBuilder* builder,
+                                         int64_t n_features, int64_t n_geoms,
+                                         int64_t n_rings, int64_t n_coords) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  if (n_features < 0 || n_geoms < 0 || n_rings < 0 || n_coords < 0) {
+    return EINVAL;
+  }
+
+  // The number of items in each offset buffer, from the outermost level
+  int64_t n_items[3] = {n_features, 0, 0};
+  switch (builder->view.schema_view.geometry_type) {
+    case GEOARROW_GEOMETRY_TYPE_POINT:
+      n_coords = n_features > n_coords ? n_features : n_coords;
+      break;
+    case GEOARROW_GEOMETRY_TYPE_POLYGON:
+      n_items[1] = n_rings;
+      break;
+    case GEOARROW_GEOMETRY_TYPE_MULTILINESTRING:
+      n_items[1] = n_geoms;
+      break;
+    case GEOARROW_GEOMETRY_TYPE_MULTIPOLYGON:
+      n_items[1] = n_geoms;
+      n_items[2] = n_rings;
+      break;
+    default:
+      break;
+  }
+
+  for (int32_t level = 0; level < private->n_offsets; level++) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowBuilderReserveItems(
+        builder, 1 + level, n_items[level], sizeof(int32_t), 1));
+  }
+
+  // Separate coordinates have one buffer per dimension; interleaved coordinates have
+  // a single buffer holding all of them
+  int64_t n_coord_buffers = builder->view.n_buffers - 1 - private->n_offsets;
+  int64_t n_values_per_buffer = builder->view.coords.n_values / n_coord_buffers;
+  for (int64_t j = 0; j < n_coord_buffers; j++) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowBuilderReserveItems(
+        builder, 1 + private->n_offsets + j, n_coords * n_values_per_buffer,
+        sizeof(double), 0));
+  }
+
+  // The validity bitmap is only allocated when the first null is encountered
+  if (private->validity->buffer.data != NULL) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowBuilderReserveValidity(builder, n_features));
+    GeoArrowBuilderSyncValidity(builder);
+  }
+
+  return GEOARROW_OK;
+}
+
+static inline enum GeoArrowGeometryType GeoArrowBuilderChildGeometryType(
+    enum GeoArrowGeometryType geometry_type) {
+  switch (geometry_type) {
+    case GEOARROW_GEOMETRY_TYPE_MULTIPOINT:
+      return GEOARROW_GEOMETRY_TYPE_POINT;
+    case GEOARROW_GEOMETRY_TYPE_MULTILINESTRING:
+      return GEOARROW_GEOMETRY_TYPE_LINESTRING;
+    case GEOARROW_GEOMETRY_TYPE_MULTIPOLYGON:
+      return GEOARROW_GEOMETRY_TYPE_POLYGON;
+    default:
+      return GEOARROW_GEOMETRY_TYPE_GEOMETRY;
+  }
+}
+
+static int reserve_coord_builder(struct GeoArrowVisitor* v, int64_t n) {
+  struct GeoArrowBuilder* builder = (struct GeoArrowBuilder*)v->private_data;
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  for (int32_t j = 0; j < builder->view.coords.n_values; j++) {
+    int64_t i = 1 + private->n_offsets + j;
+    if (!GeoArrowBuilderBufferCheck(builder, i, n * sizeof(double))) {
+      NANOARROW_RETURN_NOT_OK(
+          GeoArrowBuilderReserveBuffer(builder, i, n * sizeof(double)));
+    }
+  }
+
+  return GEOARROW_OK;
+}
+
+static int reserve_feat_builder(struct GeoArrowVisitor* v, int64_t n) {
+  struct GeoArrowBuilder* builder = (struct GeoArrowBuilder*)v->private_data;
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  if (private->n_offsets == 0) {
+    return reserve_coord_builder(v, n);
+  } else if (!GeoArrowBuilderBufferCheck(builder, 1, n * sizeof(int32_t))) {
+    return GeoArrowBuilderReserveBuffer(builder, 1, n * sizeof(int32_t));
+  } else {
+    return GEOARROW_OK;
+  }
+}
+
+static int feat_start_builder(struct GeoArrowVisitor* v) {
+  struct GeoArrowBuilder* builder = (struct GeoArrowBuilder*)v->private_data;
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  private->level = 0;
+  private->length++;
+  private->feat_n_coords = GeoArrowBuilderCoordBufferSize(builder);
+  GEOARROW_INSTRUMENT(private->instrumentation.n_features++);
+
+  // Offset buffers always start with a zero
+  if (private->n_offsets > 0 && builder->view.buffers[1].size_bytes == 0) {
+    int32_t zero = 0;
+    struct GeoArrowBufferView value = {(const uint8_t*)&zero, sizeof(int32_t)};
+    for (int32_t i = 0; i < private->n_offsets; i++) {
+      if (builder->view.buffers[1 + i].size_bytes == 0) {
+        NANOARROW_RETURN_NOT_OK(GeoArrowBuilderAppendBuffer(builder, 1 + i, value));
+      }
+    }
+  }
+
+  if (private->validity->buffer.data != NULL) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowBuilderReserveValidity(builder, 1));
+    ArrowBitmapAppendUnsafe(private->validity, 1, 1);
+    GeoArrowBuilderSyncValidity(builder);
+  }
+
+  return GEOARROW_OK;
+}
+
+static int null_feat_builder(struct GeoArrowVisitor* v) {
+  struct GeoArrowBuilder* builder = (struct GeoArrowBuilder*)v->private_data;
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  if (private->length == 0) {
+    return EINVAL;
+  }
+
+  // The validity bitmap is only allocated when the first null is encountered
+  if (private->validity->buffer.data == NULL) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowBuilderReserveValidity(builder, private->length));
+    ArrowBitmapAppendUnsafe(private->validity, 1, private->length);
+  }
+
+  private->null_count++;
+  ArrowBitClear(private->validity->buffer.data, private->length - 1);
+  GeoArrowBuilderSyncValidity(builder);
+  return GEOARROW_OK;
+}
+
+static int geom_start_builder(struct GeoArrowVisitor* v,
+                              enum GeoArrowGeometryType geometry_type,
+                              enum GeoArrowDimensions dimensions) {
+  struct GeoArrowBuilder* builder = (struct GeoArrowBuilder*)v->private_data;
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  if (private->level < 0 || private->level > 30) {
+    return EINVAL;
+  }
+
+  enum GeoArrowGeometryType builder_geometry_type =
+      builder->view.schema_view.geometry_type;
+  int geometry_type_ok;
+  if (private->level == 0) {
+    geometry_type_ok =
+        geometry_type == builder_geometry_type ||
+        geometry_type == GeoArrowBuilderChildGeometryType(builder_geometry_type);
+  } else {
+    geometry_type_ok = geometry_type == GeoArrowBuilderChildGeometryType(
+                                            private->geometry_type[private->level - 1]);
+  }
+
+  if (!geometry_type_ok) {
+    const char* geometry_type_name = GeoArrowGeometryTypeString(geometry_type);
+    ArrowErrorSet((struct ArrowError*)v->error,
+                  "Can't append geometry of type %s to builder of type %s",
+                  geometry_type_name == NULL ? "<unknown>" : geometry_type_name,
+                  GeoArrowGeometryTypeString(builder_geometry_type));
+    return EINVAL;
+  }
+
+  if (!builder->coerce_dimensions && dimensions != builder->view.schema_view.dimensions) {
+    ArrowErrorSet((struct ArrowError*)v->error,
+                  "Can't append geometry with dimensions %d to builder with "
+                  "dimensions %d",
+                  (int)dimensions, (int)builder->view.schema_view.dimensions);
+    return EINVAL;
+  }
+
+  private->geometry_type[private->level] = geometry_type;
+  private->dimensions[private->level] = dimensions;
+  private->level++;
+  return GEOARROW_OK;
+}
+
+// Returns the dimensions of coords given the dimensions passed to geom_start
+static enum GeoArrowDimensions GeoArrowBuilderCoordDimensions(
+    enum GeoArrowDimensions dimensions, const struct GeoArrowCoordView* coords) {
+  switch (coords->n_values) {
+    case 2:
+      return GEOARROW_DIMENSIONS_XY;
+    case 3:
+      return dimensions == GEOARROW_DIMENSIONS_XYM ? GEOARROW_DIMENSIONS_XYM
+                                                   : GEOARROW_DIMENSIONS_XYZ;
+    default:
+      return GEOARROW_DIMENSIONS_XYZM;
+  }
+}
+
+static int coords_builder(struct GeoArrowVisitor* v,
+                          const struct GeoArrowCoordView* coords) {
+  struct GeoArrowBuilder* builder = (struct GeoArrowBuilder*)v->private_data;
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+
+  // map[j] is the value of coords that is copied to the j-th coordinate buffer
+  int32_t map[4] = {0, 1, 2, 3};
+  if (builder->coerce_dimensions) {
+    enum GeoArrowDimensions dimensions =
+        private->level > 0 ? private->dimensions[private->level - 1]
+                           : GEOARROW_DIMENSIONS_UNKNOWN;
+    GeoArrowDimensionsMapValues(GeoArrowBuilderCoordDimensions(dimensions, coords),
+                                builder->view.schema_view.dimensions, map);
+  } else if (coords->n_values != builder->view.coords.n_values) {
+    ArrowErrorSet((struct ArrowError*)v->error,
+                  "Can't append %d-dimensional coordinates to builder with %d dimensions",
+                  (int)coords->n_values, (int)builder->view.coords.n_values);
+    return EINVAL;
+  }
+
+  if (private->n_offsets == 0 &&
+      (GeoArrowBuilderCoordBufferSize(builder) - private->feat_n_coords +
+       coords->n_coords) > 1) {
+    ArrowErrorSet((struct ArrowError*)v->error,
+                  "Can't append more than one coordinate to a point");
+    return EINVAL;
+  }
+
+  int64_t n_bytes = coords->n_coords * sizeof(double);
+  for (int32_t j = 0; j < builder->view.coords.n_values; j++) {
+    int64_t i = 1 + private->n_offsets + j;
+    if (!GeoArrowBuilderBufferCheck(builder, i, n_bytes)) {
+      NANOARROW_RETURN_NOT_OK(GeoArrowBuilderReserveBuffer(builder, i, n_bytes));
+    }
+
+    struct GeoArrowWritableBufferView* buffer = builder->view.buffers + i;
+    double* out = (double*)(buffer->data.as_uint8 + buffer->size_bytes);
+    if (map[j] == -1) {
+      memset(out, 0, n_bytes);
+    } else if (coords->coords_stride == 1) {
+      memcpy(out, coords->values[map[j]], n_bytes);
+    } else {
+      for (int64_t k = 0; k < coords->n_coords; k++) {
+        out[k] = GeoArrowCoordViewValueUnaligned(coords, k, map[j]);
+      }
+    }
+
+    buffer->size_bytes += n_bytes;
+  }
+
+  GEOARROW_INSTRUMENT(private->instrumentation.n_coords += coords->n_coords);
+  return GEOARROW_OK;
+}
+
+static int ring_end_builder(struct GeoArrowVisitor* v) {
+  struct GeoArrowBuilder* builder = (struct GeoArrowBuilder*)v->private_data;
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  switch (builder->view.schema_view.geometry_type) {
+    case GEOARROW_GEOMETRY_TYPE_POLYGON:
+    case GEOARROW_GEOMETRY_TYPE_MULTIPOLYGON:
+      return GeoArrowBuilderFinishItem(builder, private->n_offsets - 1);
+    default:
+      return EINVAL;
+  }
+}
+
+static int geom_end_builder(struct GeoArrowVisitor* v) {
+  struct GeoArrowBuilder* builder = (struct GeoArrowBuilder*)v->private_data;
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  if (private->level <= 0) {
+    return EINVAL;
+  }
+
+  private->level--;
+  enum GeoArrowGeometryType geometry_type = private->geometry_type[private->level];
+  switch (builder->view.schema_view.geometry_type) {
+    case GEOARROW_GEOMETRY_TYPE_MULTILINESTRING:
+      if (geometry_type == GEOARROW_GEOMETRY_TYPE_LINESTRING) {
+        return GeoArrowBuilderFinishItem(builder, 1);
+      }
+      break;
+    case GEOARROW_GEOMETRY_TYPE_MULTIPOLYGON:
+      if (geometry_type == GEOARROW_GEOMETRY_TYPE_POLYGON) {
+        return GeoArrowBuilderFinishItem(builder, 1);
+      }
+      break;
+    default:
+      break;
+  }
+
+  return GEOARROW_OK;
+}
+
+static int feat_end_builder(struct GeoArrowVisitor* v) {
+  struct GeoArrowBuilder* builder = (struct GeoArrowBuilder*)v->private_data;
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  if (private->n_offsets > 0) {
+    return GeoArrowBuilderFinishItem(builder, 0);
+  }
+
+  // Null and empty points are written as a coordinate of nan values
+  if (GeoArrowBuilderCoordBufferSize(builder) == private->feat_n_coords) {
+    double nan_value = NAN;
+    struct GeoArrowBufferView value = {(const uint8_t*)&nan_value, sizeof(double)};
+    for (int32_t j = 0; j < builder->view.coords.n_values; j++) {
+      NANOARROW_RETURN_NOT_OK(GeoArrowBuilderAppendBuffer(builder, 1 + j, value));
+    }
+  }
+
+  return GEOARROW_OK;
+}
+
 void GeoArrowBuilderInitVisitor(struct GeoArrowBuilder* builder,
                                 struct GeoArrowVisitor* v) {
-  return;
+  GeoArrowVisitorInitVoid(v);
+  v->private_data = builder;
+  v->reserve_coord = &reserve_coord_builder;
+  v->reserve_feat = &reserve_feat_builder;
+  v->feat_start = &feat_start_builder;
+  v->null_feat = &null_feat_builder;
+  v->geom_start = &geom_start_builder;
+  v->coords = &coords_builder;
+  v->ring_end = &ring_end_builder;
+  v->geom_end = &geom_end_builder;
+  v->feat_end = &feat_end_builder;
+}
+
+// Appends length bits of src starting at src_offset to bitmap, which must have room
+// for them. Once the end of bitmap is byte-aligned, whole bytes are copied (shifted
+// into place if src_offset isn't byte-aligned) instead of single bits.
+static void GeoArrowBitmapAppendBitsUnsafe(struct ArrowBitmap* bitmap,
+                                           const uint8_t* src, int64_t src_offset,
+                                           int64_t length) {
+  while (length > 0 && (bitmap->size_bits % 8) != 0) {
+    ArrowBitmapAppendUnsafe(bitmap, ArrowBitGet(src, src_offset), 1);
+    src_offset++;
+    length--;
+  }
+
+  uint8_t* dst = bitmap->buffer.data + (bitmap->size_bits / 8);
+  const uint8_t* src_bytes = src + (src_offset / 8);
+  int shift = src_offset % 8;
+  int64_t n_bytes = length / 8;
+  if (shift == 0) {
+    memcpy(dst, src_bytes, n_bytes);
+  } else {
+    for (int64_t i = 0; i < n_bytes; i++) {
+      dst[i] = (uint8_t)((src_bytes[i] >> shift) | (src_bytes[i + 1] << (8 - shift)));
+    }
+  }
+
+  bitmap->size_bits += n_bytes * 8;
+  bitmap->buffer.size_bytes = _ArrowBytesForBits(bitmap->size_bits);
+  src_offset += n_bytes * 8;
+  length -= n_bytes * 8;
+
+  for (int64_t i = 0; i < length; i++) {
+    ArrowBitmapAppendUnsafe(bitmap, ArrowBitGet(src, src_offset + i), 1);
+  }
+}
+
+static int GeoArrowBuilderAppendValidity(struct GeoArrowBuilder* builder,
+                                         const uint8_t* validity_bitmap, int64_t offset,
+                                         int64_t length) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  int64_t n_valid = length;
+  if (validity_bitmap != NULL) {
+    n_valid = ArrowBitCountSet(validity_bitmap, offset, length);
+  }
+
+  // If there are no nulls, a bitmap is only needed if one was already allocated
+  if (n_valid == length) {
+    if (private->validity->buffer.data != NULL) {
+      NANOARROW_RETURN_NOT_OK(GeoArrowBuilderReserveValidity(builder, length));
+      ArrowBitmapAppendUnsafe(private->validity, 1, length);
+      GeoArrowBuilderSyncValidity(builder);
+    }
+
+    return GEOARROW_OK;
+  }
+
+  if (private->validity->buffer.data == NULL) {
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowBuilderReserveValidity(builder, private->length + length));
+    ArrowBitmapAppendUnsafe(private->validity, 1, private->length);
+  } else {
+    NANOARROW_RETURN_NOT_OK(GeoArrowBuilderReserveValidity(builder, length));
+  }
+
+  GeoArrowBitmapAppendBitsUnsafe(private->validity, validity_bitmap, offset, length);
+  private->null_count += length - n_valid;
+  GeoArrowBuilderSyncValidity(builder);
+  return GEOARROW_OK;
+}
+
+static GeoArrowErrorCode GeoArrowBuilderAppendArrayViewInternal(
+    struct GeoArrowBuilder* builder, struct GeoArrowArrayView* array_view,
+    int64_t offset, int64_t length) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  if (array_view->schema_view.type != builder->view.schema_view.type) {
+    return EINVAL;
+  }
+
+  if (offset < 0 || length < 0 || (offset + length) > array_view->length) {
+    return EINVAL;
+  }
+
+  // Offset buffers always start with a zero
+  int32_t zero = 0;
+  struct GeoArrowBufferView zero_value = {(const uint8_t*)&zero, sizeof(int32_t)};
+  for (int32_t i = 0; i < private->n_offsets; i++) {
+    if (builder->view.buffers[1 + i].size_bytes == 0) {
+      NANOARROW_RETURN_NOT_OK(GeoArrowBuilderAppendBuffer(builder, 1 + i, zero_value));
+    }
+  }
+
+  // Each level of offsets is copied as a single range, rebased to start at the
+  // current size of its child. The range of items selected at each level gives the
+  // range to copy at the next level.
+  int64_t begin = offset;
+  int64_t end = offset + length;
+  for (int32_t level = 0; level < private->n_offsets; level++) {
+    const int32_t* offsets = array_view->offsets[level];
+    int64_t child_size = GeoArrowBuilderChildSize(builder, level);
+    if ((child_size + offsets[end] - offsets[begin]) > INT32_MAX) {
+      return EOVERFLOW;
+    }
+
+    int64_t n = end - begin;
+    int64_t i = 1 + level;
+    if (!GeoArrowBuilderBufferCheck(builder, i, n * sizeof(int32_t))) {
+      NANOARROW_RETURN_NOT_OK(
+          GeoArrowBuilderReserveBuffer(builder, i, n * sizeof(int32_t)));
+    }
+
+    struct GeoArrowWritableBufferView* buffer = builder->view.buffers + i;
+    int32_t* out = (int32_t*)(buffer->data.as_uint8 + buffer->size_bytes);
+    const int32_t* in = offsets + begin + 1;
+    int32_t delta = (int32_t)(child_size - offsets[begin]);
+    for (int64_t k = 0; k < n; k++) {
+      out[k] = in[k] + delta;
+    }
+
+    buffer->size_bytes += n * sizeof(int32_t);
+    begin = offsets[begin];
+    end = offsets[end];
+  }
+
+  // Coordinates are copied as a contiguous run from each coordinate buffer
+  if (end > begin) {
+    struct GeoArrowBufferView value;
+    value.n_bytes = (end - begin) * sizeof(double);
+    for (int32_t j = 0; j < builder->view.coords.n_values; j++) {
+      value.data = (const uint8_t*)(array_view->coords.values[j] + begin);
+      NANOARROW_RETURN_NOT_OK(
+          GeoArrowBuilderAppendBuffer(builder, 1 + private->n_offsets + j, value));
+    }
+  }
+
+  NANOARROW_RETURN_NOT_OK(GeoArrowBuilderAppendValidity(
+      builder, array_view->validity_bitmap, offset, length));
+  private->length += length;
+  GEOARROW_INSTRUMENT(private->instrumentation.n_features += length);
+  GEOARROW_INSTRUMENT(private->instrumentation.n_coords += end - begin);
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowBuilderAppendArrayView(struct GeoArrowBuilder* builder,
+                                                 struct GeoArrowArrayView* array_view,
+                                                 int64_t offset, int64_t length) {
+  int64_t size_bytes[8];
+  for (int64_t i = 0; i < builder->view.n_buffers; i++) {
+    size_bytes[i] = builder->view.buffers[i].size_bytes;
+  }
+
+  // Offsets may have been appended before a later level overflowed or a reallocation
+  // failed. The validity bitmap is only changed once nothing else can fail, so
+  // truncating the other buffers leaves the builder as it was.
+  int result =
+      GeoArrowBuilderAppendArrayViewInternal(builder, array_view, offset, length);
+  if (result != GEOARROW_OK) {
+    for (int64_t i = 1; i < builder->view.n_buffers; i++) {
+      builder->view.buffers[i].size_bytes = size_bytes[i];
+    }
+  }
+
+  return result;
 }
 
 static void GeoArrowSetArrayLengthFromBufferLength(struct GeoArrowSchemaView* schema_view,
@@ -144,11 +803,20 @@ static void GeoArrowSetArrayLengthFromBufferLength(struct GeoArrowSchemaView* sc
 
 static void GeoArrowSetCoordContainerLength(struct GeoArrowBuilder* builder);
 
-GeoArrowErrorCode GeoArrowBuilderFinish(struct GeoArrowBuilder* builder,
-                                        struct ArrowArray* array,
-                                        struct GeoArrowError* error) {
+static GeoArrowErrorCode GeoArrowBuilderFinishArray(struct GeoArrowBuilder* builder,
+                                                    struct ArrowArray* array,
+                                                    struct GeoArrowError* error) {
   struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
 
+  // Offset buffers always need at least one value, even for a zero-length array
+  int32_t zero = 0;
+  struct GeoArrowBufferView zero_value = {(const uint8_t*)&zero, sizeof(int32_t)};
+  for (int32_t i = 0; i < private->n_offsets; i++) {
+    if (builder->view.buffers[1 + i].size_bytes == 0) {
+      NANOARROW_RETURN_NOT_OK(GeoArrowBuilderAppendBuffer(builder, 1 + i, zero_value));
+    }
+  }
+
   // Sync builder buffer's back to the array; set array lengths from buffer sizes
   struct _GeoArrowFindBufferResult res;
   for (int64_t i = 0; i < builder->view.n_buffers; i++) {
@@ -167,6 +835,21 @@ GeoArrowErrorCode GeoArrowBuilderFinish(struct GeoArrowBuilder* builder,
   // Set the struct or fixed-size list container length
   GeoArrowSetCoordContainerLength(builder);
 
+  // Set the null count from the validity bitmap if one was written
+  if (private->validity->buffer.size_bytes > 0) {
+    int64_t length = private->array.length;
+    if (private->validity->buffer.size_bytes < _ArrowBytesForBits(length)) {
+      ArrowErrorSet((struct ArrowError*)error,
+                    "Expected validity buffer with at least %ld bytes but found %ld",
+                    (long)_ArrowBytesForBits(length),
+                    (long)private->validity->buffer.size_bytes);
+      return EINVAL;
+    }
+
+    private->array.null_count =
+        length - ArrowBitCountSet(private->validity->buffer.data, 0, length);
+  }
+
   // Call finish building, which will flush the buffer pointers into the array
   // and validate sizes.
   NANOARROW_RETURN_NOT_OK(
@@ -176,7 +859,59 @@ GeoArrowErrorCode GeoArrowBuilderFinish(struct GeoArrowBuilder* builder,
   memcpy(array, &private->array, sizeof(struct ArrowArray));
   private->array.release = NULL;
 
+  // Initialize a fresh array so that the builder can be reused
+  int result = GeoArrowBuilderInitArray(builder);
+  if (result != GEOARROW_OK) {
+    array->release(array);
+    return result;
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowBuilderFinish(struct GeoArrowBuilder* builder,
+                                        struct ArrowArray* array,
+                                        struct GeoArrowError* error) {
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  struct GeoArrowTracer* tracer = GeoArrowGetTracer();
+  int64_t n_rows = private->length;
+  int64_t n_bytes = 0;
+  GEOARROW_INSTRUMENT(int64_t start_ns = GeoArrowInstrumentationNowNs());
+
+  if (tracer != NULL) {
+    tracer->begin(tracer, GEOARROW_TRACE_EVENT_BUILDER_FINISH);
+  }
+
+  for (int64_t i = 0; i < builder->view.n_buffers; i++) {
+    n_bytes += builder->view.buffers[i].size_bytes;
+  }
+
+  int result = GeoArrowBuilderFinishArray(builder, array, error);
+
+  GEOARROW_INSTRUMENT(private->instrumentation.n_bytes_out += n_bytes);
+  GEOARROW_INSTRUMENT(GeoArrowInstrumentationEnd(&private->instrumentation, start_ns));
+
+  if (tracer != NULL) {
+    if (result == GEOARROW_OK) {
+      n_rows = array->length;
+    }
+
+    tracer->end(tracer, GEOARROW_TRACE_EVENT_BUILDER_FINISH, n_rows, n_bytes, result);
+  }
+
+  return result;
+}
+
+GeoArrowErrorCode GeoArrowBuilderGetInstrumentation(
+    struct GeoArrowBuilder* builder, struct GeoArrowInstrumentation* out) {
+#if defined(GEOARROW_INSTRUMENTATION)
+  struct BuilderPrivate* private = (struct BuilderPrivate*)builder->private_data;
+  memcpy(out, &private->instrumentation, sizeof(struct GeoArrowInstrumentation));
   return GEOARROW_OK;
+#else
+  memset(out, 0, sizeof(struct GeoArrowInstrumentation));
+  return ENOTSUP;
+#endif
 }
 
 void GeoArrowBuilderReset(struct GeoArrowBuilder* builder) {
@@ -348,3 +348,476 @@ TEST(BuilderTest, BuilderTestSetBuffersMultipolygon) {
 
   array_out.release(&array_out);
 }
+
+TEST(BuilderTest, BuilderTestBitCountSetWithinByte) {
+  // ArrowBitCountSet() is vendored from nanoarrow, where ranges that start and end
+  // within the same byte used to count the bits outside of the range
+  uint8_t bits[] = {0xf0, 0x00};
+  EXPECT_EQ(ArrowBitCountSet(bits, 0, 4), 0);
+  EXPECT_EQ(ArrowBitCountSet(bits, 2, 4), 2);
+  EXPECT_EQ(ArrowBitCountSet(bits, 4, 3), 3);
+  EXPECT_EQ(ArrowBitCountSet(bits, 0, 8), 4);
+}
+
+static std::vector<std::string> BuilderRoundtrip(enum GeoArrowType type,
+                                                 const std::vector<std::string>& wkts) {
+  struct GeoArrowBuilder builder;
+  struct ArrowArray array_out;
+  EXPECT_EQ(GeoArrowBuilderInitFromType(&builder, type), GEOARROW_OK);
+  BuildFromWKT(&builder, wkts);
+  EXPECT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+
+  struct GeoArrowArrayView array_view;
+  EXPECT_EQ(GeoArrowArrayViewInitFromType(&array_view, type), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_out, nullptr), GEOARROW_OK);
+
+  WKXTester tester;
+  EXPECT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array_out.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  array_out.release(&array_out);
+  return tester.WKTValues("<null value>");
+}
+
+TEST(BuilderTest, BuilderTestVisitorPoint) {
+  auto values = BuilderRoundtrip(GEOARROW_TYPE_POINT, {"POINT (0 1)", "", "POINT (2 3)"});
+  ASSERT_EQ(values.size(), 3);
+  EXPECT_EQ(values[0], "POINT (0 1)");
+  EXPECT_EQ(values[1], "<null value>");
+  EXPECT_EQ(values[2], "POINT (2 3)");
+
+  values = BuilderRoundtrip(GEOARROW_TYPE_POINT_Z, {"POINT Z (0 1 2)"});
+  ASSERT_EQ(values.size(), 1);
+  EXPECT_EQ(values[0], "POINT Z (0 1 2)");
+}
+
+TEST(BuilderTest, BuilderTestVisitorNested) {
+  auto values = BuilderRoundtrip(GEOARROW_TYPE_LINESTRING,
+                                 {"LINESTRING (0 1, 2 3)", "", "LINESTRING EMPTY"});
+  ASSERT_EQ(values.size(), 3);
+  EXPECT_EQ(values[0], "LINESTRING (0 1, 2 3)");
+  EXPECT_EQ(values[1], "<null value>");
+  EXPECT_EQ(values[2], "LINESTRING EMPTY");
+
+  values = BuilderRoundtrip(
+      GEOARROW_TYPE_POLYGON,
+      {"POLYGON ((0 0, 1 0, 0 1, 0 0), (0.1 0.1, 0.2 0.1, 0.1 0.2, 0.1 0.1))"});
+  ASSERT_EQ(values.size(), 1);
+  EXPECT_EQ(values[0],
+            "POLYGON ((0 0, 1 0, 0 1, 0 0), (0.1 0.1, 0.2 0.1, 0.1 0.2, 0.1 0.1))");
+
+  values = BuilderRoundtrip(GEOARROW_TYPE_MULTIPOINT,
+                            {"MULTIPOINT ((0 1), (2 3))", "POINT (4 5)"});
+  ASSERT_EQ(values.size(), 2);
+  EXPECT_EQ(values[0], "MULTIPOINT ((0 1), (2 3))");
+  EXPECT_EQ(values[1], "MULTIPOINT ((4 5))");
+
+  values = BuilderRoundtrip(GEOARROW_TYPE_MULTILINESTRING,
+                            {"MULTILINESTRING ((0 1, 2 3), (4 5, 6 7))", ""});
+  ASSERT_EQ(values.size(), 2);
+  EXPECT_EQ(values[0], "MULTILINESTRING ((0 1, 2 3), (4 5, 6 7))");
+  EXPECT_EQ(values[1], "<null value>");
+
+  values = BuilderRoundtrip(
+      GEOARROW_TYPE_MULTIPOLYGON,
+      {"MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)), ((10 10, 11 10, 10 11, 10 10)))",
+       "POLYGON ((0 0, 1 0, 0 1, 0 0))"});
+  ASSERT_EQ(values.size(), 2);
+  EXPECT_EQ(values[0],
+            "MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)), ((10 10, 11 10, 10 11, 10 10)))");
+  EXPECT_EQ(values[1], "MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)))");
+}
+
+TEST(BuilderTest, BuilderTestVisitorErrors) {
+  struct GeoArrowBuilder builder;
+  struct GeoArrowWKTReader reader;
+  struct GeoArrowVisitor v;
+  struct GeoArrowError error;
+  GeoArrowWKTReaderInit(&reader);
+
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  GeoArrowBuilderInitVisitor(&builder, &v);
+  v.error = &error;
+
+  std::string wkt = "LINESTRING (0 1, 2 3)";
+  struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+  EXPECT_EQ(GeoArrowWKTReaderVisit(&reader, item, &v), EINVAL);
+  EXPECT_STREQ(error.message,
+               "Can't append geometry of type LINESTRING to builder of type POINT");
+  GeoArrowBuilderReset(&builder);
+
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  GeoArrowBuilderInitVisitor(&builder, &v);
+  v.error = &error;
+
+  wkt = "POINT Z (0 1 2)";
+  item = {wkt.data(), (int64_t)wkt.size()};
+  EXPECT_EQ(GeoArrowWKTReaderVisit(&reader, item, &v), EINVAL);
+  EXPECT_STREQ(error.message,
+               "Can't append geometry with dimensions 2 to builder with dimensions 1");
+  GeoArrowBuilderReset(&builder);
+
+  GeoArrowWKTReaderReset(&reader);
+}
+
+TEST(BuilderTest, BuilderTestVisitorCoerceDimensions) {
+  for (auto type : {GEOARROW_TYPE_LINESTRING, GEOARROW_TYPE_LINESTRING_Z}) {
+    struct GeoArrowBuilder builder;
+    struct ArrowArray array_out;
+    ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, type), GEOARROW_OK);
+    EXPECT_EQ(builder.coerce_dimensions, 0);
+    builder.coerce_dimensions = 1;
+    BuildFromWKT(&builder, {"LINESTRING (0 1, 2 3)", "LINESTRING Z (0 1 2, 3 4 5)",
+                            "LINESTRING M (0 1 2, 3 4 5)", "",
+                            "LINESTRING ZM (0 1 2 3, 4 5 6 7)"});
+    ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+    GeoArrowBuilderReset(&builder);
+
+    struct GeoArrowArrayView array_view;
+    ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, type), GEOARROW_OK);
+    ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_out, nullptr), GEOARROW_OK);
+    WKXTester tester;
+    ASSERT_EQ(
+        GeoArrowArrayViewVisit(&array_view, 0, array_out.length, tester.WKTVisitor()),
+        GEOARROW_OK);
+    array_out.release(&array_out);
+
+    if (type == GEOARROW_TYPE_LINESTRING) {
+      EXPECT_EQ(tester.WKTValues("<null value>"),
+                std::vector<std::string>(
+                    {"LINESTRING (0 1, 2 3)", "LINESTRING (0 1, 3 4)",
+                     "LINESTRING (0 1, 3 4)", "<null value>", "LINESTRING (0 1, 4 5)"}));
+    } else {
+      EXPECT_EQ(tester.WKTValues("<null value>"),
+                std::vector<std::string>({"LINESTRING Z (0 1 0, 2 3 0)",
+                                          "LINESTRING Z (0 1 2, 3 4 5)",
+                                          "LINESTRING Z (0 1 0, 3 4 0)", "<null value>",
+                                          "LINESTRING Z (0 1 2, 4 5 6)"}));
+    }
+  }
+}
+
+TEST(BuilderTest, BuilderTestVisitorReuse) {
+  struct GeoArrowBuilder builder;
+  struct ArrowArray array_out;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+
+  BuildFromWKT(&builder, {"LINESTRING (0 1, 2 3)", ""});
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  EXPECT_EQ(array_out.length, 2);
+  EXPECT_EQ(array_out.null_count, 1);
+  array_out.release(&array_out);
+
+  BuildFromWKT(&builder, {"LINESTRING (4 5, 6 7, 8 9)"});
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  EXPECT_EQ(array_out.length, 1);
+  EXPECT_EQ(array_out.null_count, 0);
+  EXPECT_EQ(array_out.children[0]->length, 3);
+  array_out.release(&array_out);
+
+  GeoArrowBuilderReset(&builder);
+}
+
+TEST(BuilderTest, BuilderTestAppendArrayView) {
+  struct GeoArrowBuilder builder;
+  struct ArrowArray array_in;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POLYGON), GEOARROW_OK);
+  BuildFromWKT(&builder, {"POLYGON ((0 0, 1 0, 0 1, 0 0))", "",
+                          "POLYGON ((10 10, 11 10, 10 11, 10 10))"});
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_in, nullptr), GEOARROW_OK);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_POLYGON),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_in, nullptr), GEOARROW_OK);
+
+  // Mix features from the visitor with ranges copied from array_view
+  BuildFromWKT(&builder, {"POLYGON ((5 5, 6 5, 5 6, 5 5))"});
+  ASSERT_EQ(GeoArrowBuilderAppendArrayView(&builder, &array_view, 1, 2), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderAppendArrayView(&builder, &array_view, 0, 0), GEOARROW_OK);
+  BuildFromWKT(&builder, {"POLYGON EMPTY"});
+  ASSERT_EQ(GeoArrowBuilderAppendArrayView(&builder, &array_view, 0, 1), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowBuilderAppendArrayView(&builder, &array_view, 2, 2), EINVAL);
+
+  struct ArrowArray array_out;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  EXPECT_EQ(array_out.length, 5);
+  EXPECT_EQ(array_out.null_count, 1);
+  GeoArrowBuilderReset(&builder);
+  array_in.release(&array_in);
+
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_out, nullptr), GEOARROW_OK);
+  WKXTester tester;
+  ASSERT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array_out.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  auto values = tester.WKTValues("<null value>");
+  ASSERT_EQ(values.size(), 5);
+  EXPECT_EQ(values[0], "POLYGON ((5 5, 6 5, 5 6, 5 5))");
+  EXPECT_EQ(values[1], "<null value>");
+  EXPECT_EQ(values[2], "POLYGON ((10 10, 11 10, 10 11, 10 10))");
+  EXPECT_EQ(values[3], "POLYGON EMPTY");
+  EXPECT_EQ(values[4], "POLYGON ((0 0, 1 0, 0 1, 0 0))");
+
+  array_out.release(&array_out);
+}
+
+TEST(BuilderTest, BuilderTestAppendArrayViewError) {
+  struct GeoArrowBuilder builder;
+  struct ArrowArray array_in;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POLYGON), GEOARROW_OK);
+  BuildFromWKT(&builder, {"POLYGON ((0 0, 1 0, 0 1, 0 0))",
+                          "POLYGON ((10 10, 11 10, 10 11, 10 10))"});
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_in, nullptr), GEOARROW_OK);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_POLYGON),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_in, nullptr), GEOARROW_OK);
+
+  // The ring offsets of the second polygon overflow only after its polygon offset
+  // has been appended. Its coordinates are never read.
+  int32_t ring_offsets[] = {0, 4, INT32_MAX};
+  array_view.offsets[1] = ring_offsets;
+
+  ASSERT_EQ(GeoArrowBuilderAppendArrayView(&builder, &array_view, 0, 1), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderAppendArrayView(&builder, &array_view, 0, 1), GEOARROW_OK);
+  int64_t size_bytes[4];
+  for (int64_t i = 0; i < 4; i++) {
+    size_bytes[i] = builder.view.buffers[i].size_bytes;
+  }
+
+  EXPECT_EQ(GeoArrowBuilderAppendArrayView(&builder, &array_view, 1, 1), EOVERFLOW);
+  for (int64_t i = 0; i < 4; i++) {
+    EXPECT_EQ(builder.view.buffers[i].size_bytes, size_bytes[i]);
+  }
+
+  // The builder can still be used after the failed append
+  BuildFromWKT(&builder, {"POLYGON EMPTY"});
+  struct ArrowArray array_out;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+  array_in.release(&array_in);
+
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_out, nullptr), GEOARROW_OK);
+  WKXTester tester;
+  ASSERT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array_out.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  EXPECT_EQ(tester.WKTValues("<null value>"),
+            std::vector<std::string>({"POLYGON ((0 0, 1 0, 0 1, 0 0))",
+                                      "POLYGON ((0 0, 1 0, 0 1, 0 0))",
+                                      "POLYGON EMPTY"}));
+
+  array_out.release(&array_out);
+}
+
+TEST(BuilderTest, BuilderTestAppendArrayViewValidity) {
+  // Enough features for several words of the validity bitmap with sparse nulls
+  std::vector<std::string> wkts;
+  for (int i = 0; i < 300; i++) {
+    if (i == 3 || i == 64 || i == 65 || i == 200) {
+      wkts.push_back("");
+    } else {
+      wkts.push_back("POINT (" + std::to_string(i) + " 0)");
+    }
+  }
+
+  struct GeoArrowBuilder builder;
+  struct ArrowArray array_in;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  BuildFromWKT(&builder, wkts);
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_in, nullptr), GEOARROW_OK);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_in, nullptr), GEOARROW_OK);
+
+  // Copy ranges that start and end at offsets that aren't byte-aligned in either the
+  // input or the output
+  std::vector<std::pair<int64_t, int64_t>> ranges = {{5, 1}, {1, 130}, {77, 223}, {0, 9}};
+  std::vector<std::string> expected;
+  for (const auto& range : ranges) {
+    ASSERT_EQ(GeoArrowBuilderAppendArrayView(&builder, &array_view, range.first,
+                                             range.second),
+              GEOARROW_OK);
+    for (int64_t i = range.first; i < (range.first + range.second); i++) {
+      expected.push_back(wkts[i] == "" ? "<null value>" : wkts[i]);
+    }
+  }
+
+  struct ArrowArray array_out;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  EXPECT_EQ(array_out.length, 363);
+  EXPECT_EQ(array_out.null_count, 5);
+  GeoArrowBuilderReset(&builder);
+  array_in.release(&array_in);
+
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_out, nullptr), GEOARROW_OK);
+  WKXTester tester;
+  ASSERT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array_out.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  EXPECT_EQ(tester.WKTValues("<null value>"), expected);
+
+  WKXTester tester_slice;
+  ASSERT_EQ(GeoArrowArrayViewVisit(&array_view, 131, 200, tester_slice.WKTVisitor()),
+            GEOARROW_OK);
+  EXPECT_EQ(tester_slice.WKTValues("<null value>"),
+            std::vector<std::string>(expected.begin() + 131, expected.begin() + 331));
+
+  array_out.release(&array_out);
+}
+
+TEST(BuilderTest, BuilderTestAppendArrayViewValidityShort) {
+  // Fewer rows than a byte of the validity bitmap, so the bitmap ends partway through
+  // its only byte
+  std::vector<std::string> wkts = {"", "POINT (1 2)"};
+  struct GeoArrowBuilder builder;
+  struct ArrowArray array_in;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  BuildFromWKT(&builder, wkts);
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_in, nullptr), GEOARROW_OK);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_in, nullptr), GEOARROW_OK);
+
+  BuildFromWKT(&builder, {"POINT (0 1)", "POINT (2 3)", "POINT (4 5)"});
+  ASSERT_EQ(GeoArrowBuilderAppendArrayView(&builder, &array_view, 0, 2), GEOARROW_OK);
+
+  struct ArrowArray array_out;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+  array_in.release(&array_in);
+  EXPECT_EQ(array_out.length, 5);
+  EXPECT_EQ(array_out.null_count, 1);
+
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_out, nullptr), GEOARROW_OK);
+  WKXTester tester;
+  ASSERT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array_out.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  EXPECT_EQ(tester.WKTValues("<null value>"),
+            std::vector<std::string>({"POINT (0 1)", "POINT (2 3)", "POINT (4 5)",
+                                      "<null value>", "POINT (1 2)"}));
+  array_out.release(&array_out);
+}
+
+TEST(BuilderTest, BuilderTestInstrumentation) {
+  struct GeoArrowBuilder builder;
+  struct GeoArrowInstrumentation instrumentation;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  if (GeoArrowBuilderGetInstrumentation(&builder, &instrumentation) == ENOTSUP) {
+    EXPECT_EQ(instrumentation.n_calls, 0);
+    GeoArrowBuilderReset(&builder);
+    GTEST_SKIP() << "Built without GEOARROW_INSTRUMENTATION";
+  }
+
+  ASSERT_EQ(GeoArrowBuilderSetGrowthPolicy(&builder, GEOARROW_GROWTH_POLICY_EXACT, 0),
+            GEOARROW_OK);
+  BuildFromWKT(&builder, {"LINESTRING (0 1, 2 3)", "", "LINESTRING (4 5, 6 7, 8 9)"});
+
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array, nullptr), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderGetInstrumentation(&builder, &instrumentation), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+  array.release(&array);
+
+  EXPECT_EQ(instrumentation.n_calls, 1);
+  EXPECT_EQ(instrumentation.n_features, 3);
+  EXPECT_EQ(instrumentation.n_coords, 5);
+  EXPECT_GT(instrumentation.n_reallocations, 0);
+
+  // One validity byte, four offsets and five x and y values
+  EXPECT_EQ(instrumentation.n_bytes_out, 1 + 4 * 4 + 5 * 8 * 2);
+}
+
+TEST(BuilderTest, BuilderTestReserve) {
+  struct GeoArrowBuilder builder;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_MULTIPOLYGON),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderSetGrowthPolicy(&builder, GEOARROW_GROWTH_POLICY_EXACT, 0),
+            GEOARROW_OK);
+
+  // 2 features, 3 polygons, 4 rings, 16 coordinates
+  ASSERT_EQ(GeoArrowBuilderReserve(&builder, 2, 3, 4, 16), GEOARROW_OK);
+  EXPECT_EQ(builder.view.buffers[1].capacity_bytes, 3 * sizeof(int32_t));
+  EXPECT_EQ(builder.view.buffers[2].capacity_bytes, 4 * sizeof(int32_t));
+  EXPECT_EQ(builder.view.buffers[3].capacity_bytes, 5 * sizeof(int32_t));
+  EXPECT_EQ(builder.view.buffers[4].capacity_bytes, 16 * sizeof(double));
+  EXPECT_EQ(builder.view.buffers[5].capacity_bytes, 16 * sizeof(double));
+
+  // Building exactly what was reserved doesn't reallocate
+  const uint8_t* coords = builder.view.buffers[4].data.as_uint8;
+  BuildFromWKT(&builder,
+               {"MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)), ((10 10, 11 10, 10 11, 10 10), "
+                "(10 10, 11 10, 10 11, 10 10)))",
+                "MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)))"});
+  EXPECT_EQ(builder.view.buffers[4].data.as_uint8, coords);
+  for (int i = 1; i < 6; i++) {
+    EXPECT_EQ(builder.view.buffers[i].size_bytes, builder.view.buffers[i].capacity_bytes);
+  }
+
+  EXPECT_EQ(GeoArrowBuilderReserve(&builder, -1, 0, 0, 0), EINVAL);
+  GeoArrowBuilderReset(&builder);
+
+  // Points reserve a coordinate for each feature
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POINT_Z), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderReserve(&builder, 5, 0, 0, 0), GEOARROW_OK);
+  for (int i = 1; i < 4; i++) {
+    EXPECT_EQ(builder.view.buffers[i].capacity_bytes, 5 * sizeof(double));
+  }
+  GeoArrowBuilderReset(&builder);
+}
+
+TEST(BuilderTest, BuilderTestGrowthPolicy) {
+  std::vector<std::string> wkts = {"LINESTRING (0 1, 2 3)", "LINESTRING (4 5, 6 7, 8 9)",
+                                   "", "LINESTRING (0 1, 2 3)"};
+
+  struct GeoArrowBuilder builder;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  EXPECT_EQ(GeoArrowBuilderSetGrowthPolicy(&builder, GEOARROW_GROWTH_POLICY_LINEAR, 0),
+            EINVAL);
+  EXPECT_EQ(GeoArrowBuilderSetGrowthPolicy(
+                &builder, static_cast<enum GeoArrowGrowthPolicy>(100), 0),
+            EINVAL);
+
+  // Exact growth never leaves unused capacity (including in the validity bitmap)
+  ASSERT_EQ(GeoArrowBuilderSetGrowthPolicy(&builder, GEOARROW_GROWTH_POLICY_EXACT, 0),
+            GEOARROW_OK);
+  BuildFromWKT(&builder, wkts);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(builder.view.buffers[i].size_bytes, builder.view.buffers[i].capacity_bytes);
+  }
+
+  // The policy is kept for the next array
+  struct ArrowArray array_out;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  array_out.release(&array_out);
+  BuildFromWKT(&builder, wkts);
+  EXPECT_EQ(builder.view.buffers[2].size_bytes, 7 * sizeof(double));
+  EXPECT_EQ(builder.view.buffers[2].capacity_bytes, 7 * sizeof(double));
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  array_out.release(&array_out);
+
+  // Linear growth allocates multiples of the increment
+  ASSERT_EQ(GeoArrowBuilderSetGrowthPolicy(&builder, GEOARROW_GROWTH_POLICY_LINEAR, 24),
+            GEOARROW_OK);
+  BuildFromWKT(&builder, wkts);
+  EXPECT_EQ(builder.view.buffers[2].size_bytes, 7 * sizeof(double));
+  EXPECT_EQ(builder.view.buffers[2].capacity_bytes, 72);
+  EXPECT_EQ(builder.view.buffers[0].capacity_bytes, 24);
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_out, nullptr), GEOARROW_OK);
+  WKXTester tester;
+  EXPECT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array_out.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  wkts[2] = "<null value>";
+  EXPECT_EQ(tester.WKTValues("<null value>"), wkts);
+  array_out.release(&array_out);
+}
@@ -0,0 +1,35 @@
+
+#include "cpu_features.h"
+
+#if defined(GEOARROW_X86_DISPATCH)
+
+// One copy for the whole library (rather than one per translation unit that selects
+// a kernel), so the CPU is queried once per process
+static int cached_features = -1;
+
+int GeoArrowCpuFeatures(void) {
+  int features = __atomic_load_n(&cached_features, __ATOMIC_RELAXED);
+  if (features != -1) {
+    return features;
+  }
+
+  __builtin_cpu_init();
+  features = 0;
+  if (__builtin_cpu_supports("ssse3")) {
+    features |= GEOARROW_CPU_SSSE3;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    features |= GEOARROW_CPU_SSE41;
+  }
+  if (__builtin_cpu_supports("avx")) {
+    features |= GEOARROW_CPU_AVX;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    features |= GEOARROW_CPU_AVX2;
+  }
+
+  __atomic_store_n(&cached_features, features, __ATOMIC_RELAXED);
+  return features;
+}
+
+#endif
@@ -0,0 +1,23 @@
+
+#ifndef GEOARROW_CPU_FEATURES_H_INCLUDED
+#define GEOARROW_CPU_FEATURES_H_INCLUDED
+
+// Not part of the public API: x86 builds with GCC or clang select vectorized kernels
+// at runtime so that the library doesn't need to be compiled with -mavx2 or similar
+// to use them
+
+#if !defined(GEOARROW_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define GEOARROW_X86_DISPATCH
+
+#define GEOARROW_CPU_SSSE3 1
+#define GEOARROW_CPU_SSE41 2
+#define GEOARROW_CPU_AVX 4
+#define GEOARROW_CPU_AVX2 8
+
+// Returns the GEOARROW_CPU_* flags supported by this CPU. The CPU is only queried on
+// the first call so that kernels can be selected cheaply wherever they are used.
+int GeoArrowCpuFeatures(void);
+#endif
+
+#endif
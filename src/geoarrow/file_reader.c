@@ -0,0 +1,305 @@
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "geoarrow.h"
+
+#include "nanoarrow.h"
+
+struct GeoArrowFileReaderPrivate {
+  enum GeoArrowFileFormat format;
+  const uint8_t* data;
+  int64_t n_bytes;
+};
+
+static inline uint32_t GeoArrowFileReadUInt32LE(const uint8_t* data) {
+  return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+         ((uint32_t)data[3] << 24);
+}
+
+// Computes the bounds of the record starting at offset. A record with
+// n_bytes == 0 is a null feature.
+static int GeoArrowFileReaderNextRecord(struct GeoArrowFileReaderPrivate* private,
+                                        int64_t offset, struct GeoArrowBufferView* record,
+                                        int64_t* next, struct GeoArrowError* error) {
+  const uint8_t* data = private->data;
+  int64_t n_bytes = private->n_bytes;
+
+  switch (private->format) {
+    case GEOARROW_FILE_FORMAT_WKB_LENGTH_PREFIXED: {
+      if ((n_bytes - offset) < 4) {
+        ArrowErrorSet((struct ArrowError*)error,
+                      "Expected length prefix but found end of file at byte %ld",
+                      (long)offset);
+        return EINVAL;
+      }
+
+      int64_t record_size = GeoArrowFileReadUInt32LE(data + offset);
+      if ((n_bytes - offset - 4) < record_size) {
+        ArrowErrorSet((struct ArrowError*)error,
+                      "Expected record of %ld bytes at byte %ld but found %ld bytes",
+                      (long)record_size, (long)offset, (long)(n_bytes - offset - 4));
+        return EINVAL;
+      }
+
+      record->data = data + offset + 4;
+      record->n_bytes = record_size;
+      *next = offset + 4 + record_size;
+      return GEOARROW_OK;
+    }
+
+    case GEOARROW_FILE_FORMAT_WKB: {
+      record->data = data + offset;
+      record->n_bytes = n_bytes - offset;
+      NANOARROW_RETURN_NOT_OK(GeoArrowWKBSize(*record, &record->n_bytes, error));
+      *next = offset + record->n_bytes;
+      return GEOARROW_OK;
+    }
+
+    case GEOARROW_FILE_FORMAT_WKT: {
+      const uint8_t* newline =
+          (const uint8_t*)memchr(data + offset, '\n', n_bytes - offset);
+      int64_t end = newline == NULL ? n_bytes : (newline - data);
+      *next = newline == NULL ? n_bytes : (end + 1);
+
+      if (end > offset && data[end - 1] == '\r') {
+        end--;
+      }
+
+      record->data = data + offset;
+      record->n_bytes = end - offset;
+      return GEOARROW_OK;
+    }
+
+    default:
+      ArrowErrorSet((struct ArrowError*)error, "Unknown file format %d",
+                    (int)private->format);
+      return EINVAL;
+  }
+}
+
+static int GeoArrowFileReaderVisitRange(struct GeoArrowFileReaderPrivate* private,
+                                        int64_t begin, int64_t end,
+                                        struct GeoArrowWKBReader* wkb_reader,
+                                        struct GeoArrowWKTReader* wkt_reader,
+                                        struct GeoArrowVisitor* v) {
+  struct GeoArrowBufferView record;
+  struct GeoArrowStringView record_str;
+  int64_t offset = begin;
+  int64_t next;
+
+  while (offset < end) {
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowFileReaderNextRecord(private, offset, &record, &next, v->error));
+
+    if (record.n_bytes == 0) {
+      NANOARROW_RETURN_NOT_OK(v->feat_start(v));
+      NANOARROW_RETURN_NOT_OK(v->null_feat(v));
+      NANOARROW_RETURN_NOT_OK(v->feat_end(v));
+    } else if (private->format == GEOARROW_FILE_FORMAT_WKT) {
+      record_str.data = (const char*)record.data;
+      record_str.n_bytes = record.n_bytes;
+      NANOARROW_RETURN_NOT_OK(GeoArrowWKTReaderVisit(wkt_reader, record_str, v));
+    } else {
+      NANOARROW_RETURN_NOT_OK(GeoArrowWKBReaderVisit(wkb_reader, record, v));
+    }
+
+    offset = next;
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowFileReaderInit(struct GeoArrowFileReader* reader,
+                                         const char* path,
+                                         enum GeoArrowFileFormat format,
+                                         struct GeoArrowError* error) {
+#if defined(_WIN32)
+  ArrowErrorSet((struct ArrowError*)error,
+                "GeoArrowFileReaderInit() is not supported on this platform");
+  return ENOTSUP;
+#else
+  switch (format) {
+    case GEOARROW_FILE_FORMAT_WKB_LENGTH_PREFIXED:
+    case GEOARROW_FILE_FORMAT_WKB:
+    case GEOARROW_FILE_FORMAT_WKT:
+      break;
+    default:
+      ArrowErrorSet((struct ArrowError*)error, "Unknown file format %d", (int)format);
+      return EINVAL;
+  }
+
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    int result = errno;
+    ArrowErrorSet((struct ArrowError*)error, "Failed to open '%s': %s", path,
+                  strerror(result));
+    return result;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    int result = errno;
+    ArrowErrorSet((struct ArrowError*)error, "Failed to stat '%s': %s", path,
+                  strerror(result));
+    close(fd);
+    return result;
+  }
+
+  // mmap() of zero bytes is an error, so empty files are never mapped
+  void* mapped = NULL;
+  if (st.st_size > 0) {
+    mapped = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+      int result = errno;
+      ArrowErrorSet((struct ArrowError*)error, "Failed to mmap '%s': %s", path,
+                    strerror(result));
+      close(fd);
+      return result;
+    }
+
+    madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+  }
+
+  // The mapping remains valid after the file descriptor is closed
+  close(fd);
+
+  struct GeoArrowFileReaderPrivate* private =
+      (struct GeoArrowFileReaderPrivate*)ArrowMalloc(
+          sizeof(struct GeoArrowFileReaderPrivate));
+  if (private == NULL) {
+    if (mapped != NULL) {
+      munmap(mapped, st.st_size);
+    }
+    return ENOMEM;
+  }
+
+  private->format = format;
+  private->data = (const uint8_t*)mapped;
+  private->n_bytes = st.st_size;
+  reader->private_data = private;
+  return GEOARROW_OK;
+#endif
+}
+
+int64_t GeoArrowFileReaderSize(struct GeoArrowFileReader* reader) {
+  struct GeoArrowFileReaderPrivate* private =
+      (struct GeoArrowFileReaderPrivate*)reader->private_data;
+  return private->n_bytes;
+}
+
+GeoArrowErrorCode GeoArrowFileReaderSplit(struct GeoArrowFileReader* reader,
+                                          int64_t n_ranges, int64_t* boundaries,
+                                          struct GeoArrowError* error) {
+  struct GeoArrowFileReaderPrivate* private =
+      (struct GeoArrowFileReaderPrivate*)reader->private_data;
+
+  if (n_ranges < 1) {
+    ArrowErrorSet((struct ArrowError*)error, "Expected n_ranges >= 1 but got %ld",
+                  (long)n_ranges);
+    return EINVAL;
+  }
+
+  boundaries[0] = 0;
+  boundaries[n_ranges] = private->n_bytes;
+
+  // Newline-delimited records can be found from any byte offset
+  if (private->format == GEOARROW_FILE_FORMAT_WKT) {
+    for (int64_t i = 1; i < n_ranges; i++) {
+      int64_t target = private->n_bytes / n_ranges * i;
+      if (target < boundaries[i - 1]) {
+        target = boundaries[i - 1];
+      }
+
+      if (target > 0 && private->data[target - 1] != '\n') {
+        const uint8_t* newline = (const uint8_t*)memchr(
+            private->data + target, '\n', private->n_bytes - target);
+        target = newline == NULL ? private->n_bytes : (newline - private->data + 1);
+      }
+
+      boundaries[i] = target;
+    }
+
+    return GEOARROW_OK;
+  }
+
+  // WKB records can only be found by walking from the start of the file
+  struct GeoArrowBufferView record;
+  int64_t offset = 0;
+  int64_t next;
+  int64_t i = 1;
+  while (i < n_ranges && offset < private->n_bytes) {
+    while (i < n_ranges && offset >= (private->n_bytes / n_ranges * i)) {
+      boundaries[i++] = offset;
+    }
+
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowFileReaderNextRecord(private, offset, &record, &next, error));
+    offset = next;
+  }
+
+  while (i < n_ranges) {
+    boundaries[i++] = private->n_bytes;
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowFileReaderVisit(struct GeoArrowFileReader* reader,
+                                          int64_t begin, int64_t end,
+                                          struct GeoArrowVisitor* v) {
+  struct GeoArrowFileReaderPrivate* private =
+      (struct GeoArrowFileReaderPrivate*)reader->private_data;
+
+  if (begin < 0 || end > private->n_bytes || begin > end) {
+    ArrowErrorSet((struct ArrowError*)v->error,
+                  "Range [%ld, %ld) is out of bounds for file of %ld bytes", (long)begin,
+                  (long)end, (long)private->n_bytes);
+    return EINVAL;
+  }
+
+  // A WKT range that starts mid-line belongs to the previous range
+  if (private->format == GEOARROW_FILE_FORMAT_WKT && begin > 0 &&
+      private->data[begin - 1] != '\n') {
+    const uint8_t* newline =
+        (const uint8_t*)memchr(private->data + begin, '\n', private->n_bytes - begin);
+    begin = newline == NULL ? private->n_bytes : (newline - private->data + 1);
+  }
+
+  // Readers are created per call so that ranges can be visited concurrently
+  struct GeoArrowWKBReader wkb_reader;
+  struct GeoArrowWKTReader wkt_reader;
+  int result;
+  if (private->format == GEOARROW_FILE_FORMAT_WKT) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowWKTReaderInit(&wkt_reader));
+    result = GeoArrowFileReaderVisitRange(private, begin, end, NULL, &wkt_reader, v);
+    GeoArrowWKTReaderReset(&wkt_reader);
+  } else {
+    NANOARROW_RETURN_NOT_OK(GeoArrowWKBReaderInit(&wkb_reader));
+    result = GeoArrowFileReaderVisitRange(private, begin, end, &wkb_reader, NULL, v);
+    GeoArrowWKBReaderReset(&wkb_reader);
+  }
+
+  return result;
+}
+
+void GeoArrowFileReaderReset(struct GeoArrowFileReader* reader) {
+  struct GeoArrowFileReaderPrivate* private =
+      (struct GeoArrowFileReaderPrivate*)reader->private_data;
+#if !defined(_WIN32)
+  if (private->data != NULL) {
+    munmap((void*)private->data, private->n_bytes);
+  }
+#endif
+
+  ArrowFree(private);
+  reader->private_data = NULL;
+}
@@ -0,0 +1,204 @@
+
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+static std::string WriteTempFile(const std::string& name, const std::string& content) {
+  std::string path = ::testing::TempDir() + name;
+  std::ofstream out(path, std::ios::binary);
+  out.write(content.data(), content.size());
+  return path;
+}
+
+static std::string AsString(const std::basic_string<uint8_t>& value) {
+  return std::string(reinterpret_cast<const char*>(value.data()), value.size());
+}
+
+static std::string LengthPrefixed(const std::basic_string<uint8_t>& value) {
+  uint32_t size = value.size();
+  uint8_t prefix[4] = {static_cast<uint8_t>(size & 0xff),
+                       static_cast<uint8_t>((size >> 8) & 0xff),
+                       static_cast<uint8_t>((size >> 16) & 0xff),
+                       static_cast<uint8_t>((size >> 24) & 0xff)};
+  return std::string(reinterpret_cast<const char*>(prefix), 4) + AsString(value);
+}
+
+static std::vector<std::string> ReadWKT(struct GeoArrowFileReader* reader, int64_t begin,
+                                        int64_t end) {
+  WKXTester tester;
+  int result = GeoArrowFileReaderVisit(reader, begin, end, tester.WKTVisitor());
+  if (result != GEOARROW_OK) {
+    throw WKXTestException("GeoArrowFileReaderVisit", result,
+                           tester.LastErrorMessage().c_str());
+  }
+
+  return tester.WKTValues("<null value>");
+}
+
+static std::vector<std::string> ReadWKTSplit(struct GeoArrowFileReader* reader,
+                                             int64_t n_ranges) {
+  std::vector<int64_t> boundaries(n_ranges + 1);
+  EXPECT_EQ(GeoArrowFileReaderSplit(reader, n_ranges, boundaries.data(), nullptr),
+            GEOARROW_OK);
+
+  std::vector<std::string> out;
+  for (int64_t i = 0; i < n_ranges; i++) {
+    EXPECT_LE(boundaries[i], boundaries[i + 1]);
+    for (const auto& value : ReadWKT(reader, boundaries[i], boundaries[i + 1])) {
+      out.push_back(value);
+    }
+  }
+
+  return out;
+}
+
+TEST(FileReaderTest, FileReaderTestErrors) {
+  struct GeoArrowFileReader reader;
+  struct GeoArrowError error;
+  EXPECT_EQ(GeoArrowFileReaderInit(&reader, "this/file/does/not/exist.wkt",
+                                   GEOARROW_FILE_FORMAT_WKT, &error),
+            ENOENT);
+  EXPECT_EQ(std::string(error.message).substr(0, 16), "Failed to open '");
+
+  std::string path =
+      WriteTempFile("geoarrow_file_reader_bad.wkb", std::string("\x01\x02\x00", 3));
+  ASSERT_EQ(GeoArrowFileReaderInit(&reader, path.c_str(), GEOARROW_FILE_FORMAT_WKB,
+                                   &error),
+            GEOARROW_OK);
+  WKXTester tester;
+  EXPECT_EQ(GeoArrowFileReaderVisit(&reader, 0, 3, tester.WKTVisitor()), EINVAL);
+  EXPECT_STREQ(
+      tester.LastErrorMessage().c_str(),
+      "Expected endian byte and geometry type but found end of buffer at byte 0");
+  EXPECT_EQ(GeoArrowFileReaderVisit(&reader, 0, 4, tester.WKTVisitor()), EINVAL);
+  EXPECT_STREQ(tester.LastErrorMessage().c_str(),
+               "Range [0, 4) is out of bounds for file of 3 bytes");
+  GeoArrowFileReaderReset(&reader);
+}
+
+TEST(FileReaderTest, FileReaderTestEmpty) {
+  struct GeoArrowFileReader reader;
+  std::string path = WriteTempFile("geoarrow_file_reader_empty.wkt", "");
+  ASSERT_EQ(GeoArrowFileReaderInit(&reader, path.c_str(), GEOARROW_FILE_FORMAT_WKT,
+                                   nullptr),
+            GEOARROW_OK);
+  EXPECT_EQ(GeoArrowFileReaderSize(&reader), 0);
+  EXPECT_TRUE(ReadWKT(&reader, 0, 0).empty());
+  EXPECT_TRUE(ReadWKTSplit(&reader, 4).empty());
+  GeoArrowFileReaderReset(&reader);
+}
+
+TEST(FileReaderTest, FileReaderTestWKT) {
+  struct GeoArrowFileReader reader;
+  std::string path = WriteTempFile(
+      "geoarrow_file_reader.wkt",
+      "POINT (0 1)\nLINESTRING (0 1, 2 3)\r\n\nPOINT (4 5)\nPOINT (6 7)");
+  ASSERT_EQ(GeoArrowFileReaderInit(&reader, path.c_str(), GEOARROW_FILE_FORMAT_WKT,
+                                   nullptr),
+            GEOARROW_OK);
+
+  std::vector<std::string> expected = {"POINT (0 1)", "LINESTRING (0 1, 2 3)",
+                                       "<null value>", "POINT (4 5)", "POINT (6 7)"};
+  EXPECT_EQ(ReadWKT(&reader, 0, GeoArrowFileReaderSize(&reader)), expected);
+
+  // Ranges that start mid-line skip to the next line
+  EXPECT_EQ(ReadWKT(&reader, 1, 13), std::vector<std::string>({"LINESTRING (0 1, 2 3)"}));
+
+  for (int64_t n_ranges = 1; n_ranges < 10; n_ranges++) {
+    EXPECT_EQ(ReadWKTSplit(&reader, n_ranges), expected);
+  }
+
+  GeoArrowFileReaderReset(&reader);
+}
+
+TEST(FileReaderTest, FileReaderTestWKB) {
+  WKXTester tester;
+  std::vector<std::string> expected = {
+      "POINT (0 1)", "LINESTRING Z (0 1 2, 3 4 5)",
+      "POLYGON ((0 0, 1 0, 0 1, 0 0))",
+      "GEOMETRYCOLLECTION (POINT M (0 1 2), MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0))))"};
+
+  std::string content;
+  std::string content_prefixed;
+  for (const auto& wkt : expected) {
+    content += AsString(tester.AsWKB(wkt));
+    content_prefixed += LengthPrefixed(tester.AsWKB(wkt));
+  }
+
+  // Null records are zero-length records in the length-prefixed format
+  content_prefixed += LengthPrefixed({});
+
+  struct GeoArrowFileReader reader;
+  std::string path = WriteTempFile("geoarrow_file_reader.wkb", content);
+  ASSERT_EQ(GeoArrowFileReaderInit(&reader, path.c_str(), GEOARROW_FILE_FORMAT_WKB,
+                                   nullptr),
+            GEOARROW_OK);
+  EXPECT_EQ(ReadWKT(&reader, 0, GeoArrowFileReaderSize(&reader)), expected);
+  for (int64_t n_ranges = 1; n_ranges < 10; n_ranges++) {
+    EXPECT_EQ(ReadWKTSplit(&reader, n_ranges), expected);
+  }
+  GeoArrowFileReaderReset(&reader);
+
+  expected.push_back("<null value>");
+  path = WriteTempFile("geoarrow_file_reader.wkbp", content_prefixed);
+  ASSERT_EQ(GeoArrowFileReaderInit(&reader, path.c_str(),
+                                   GEOARROW_FILE_FORMAT_WKB_LENGTH_PREFIXED, nullptr),
+            GEOARROW_OK);
+  EXPECT_EQ(ReadWKT(&reader, 0, GeoArrowFileReaderSize(&reader)), expected);
+  for (int64_t n_ranges = 1; n_ranges < 10; n_ranges++) {
+    EXPECT_EQ(ReadWKTSplit(&reader, n_ranges), expected);
+  }
+  GeoArrowFileReaderReset(&reader);
+}
+
+TEST(FileReaderTest, FileReaderTestTestingFiles) {
+  const char* testing_dir = getenv("GEOARROW_TESTING_DIR");
+  if (testing_dir == nullptr || strlen(testing_dir) == 0) {
+    GTEST_SKIP();
+  }
+
+  int n_tested = 0;
+  for (const auto& item : std::filesystem::directory_iterator(testing_dir)) {
+    std::string path = item.path();
+    if (path.size() < 4 || path.substr(path.size() - 4) != ".wkt") {
+      continue;
+    }
+
+    std::string stem = path.substr(0, path.size() - 4);
+    std::vector<std::basic_string<uint8_t>> values[3];
+    const std::pair<std::string, enum GeoArrowFileFormat> files[] = {
+        {path, GEOARROW_FILE_FORMAT_WKT},
+        {stem + ".wkb", GEOARROW_FILE_FORMAT_WKB},
+        {stem + ".ewkb", GEOARROW_FILE_FORMAT_WKB}};
+
+    for (int i = 0; i < 3; i++) {
+      struct GeoArrowFileReader reader;
+      struct GeoArrowError error;
+      ASSERT_EQ(GeoArrowFileReaderInit(&reader, files[i].first.c_str(), files[i].second,
+                                       &error),
+                GEOARROW_OK)
+          << error.message;
+
+      WKXTester tester;
+      ASSERT_EQ(GeoArrowFileReaderVisit(&reader, 0, GeoArrowFileReaderSize(&reader),
+                                        tester.WKBVisitor()),
+                GEOARROW_OK)
+          << files[i].first << ": " << tester.LastErrorMessage();
+      values[i] = tester.WKBValues();
+      GeoArrowFileReaderReset(&reader);
+    }
+
+    EXPECT_GT(values[0].size(), 0);
+    EXPECT_EQ(values[1], values[0]) << stem;
+    EXPECT_EQ(values[2], values[0]) << stem;
+    n_tested++;
+  }
+
+  EXPECT_GT(n_tested, 0);
+}
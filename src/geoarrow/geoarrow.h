@@ -117,6 +117,63 @@ GeoArrowErrorCode GeoArrowMetadataViewInit(struct GeoArrowMetadataView* metadata
                                            struct GeoArrowStringView metadata,
                                            struct GeoArrowError* error);
 
+// Memoizes GeoArrowSchemaViewInit() and GeoArrowMetadataViewInit() by the parts of a
+// schema that parsing reads (the root metadata, the format of every node and the
+// names of the coordinate fields) so that batches with a schema that has been seen
+// before aren't parsed again. Safe to share between threads; lookups of schemas that
+// are already cached don't take a lock. GeoArrowTypeCacheInit() returns ENOTSUP on
+// platforms other than Windows that aren't built with GCC or clang. The string views
+// written by GeoArrowTypeCacheGet() point into memory owned by the cache (not schema)
+// and stay valid until GeoArrowTypeCacheReset().
+struct GeoArrowTypeCache {
+  void* private_data;
+};
+
+GeoArrowErrorCode GeoArrowTypeCacheInit(struct GeoArrowTypeCache* cache);
+
+// metadata_view may be NULL
+GeoArrowErrorCode GeoArrowTypeCacheGet(struct GeoArrowTypeCache* cache,
+                                       struct ArrowSchema* schema,
+                                       struct GeoArrowSchemaView* schema_view,
+                                       struct GeoArrowMetadataView* metadata_view,
+                                       struct GeoArrowError* error);
+
+// The number of distinct schemas that have been parsed
+int64_t GeoArrowTypeCacheSize(struct GeoArrowTypeCache* cache);
+
+void GeoArrowTypeCacheReset(struct GeoArrowTypeCache* cache);
+
+// Recycles the buffers of released arrays. Builders and writers given the allocator
+// from GeoArrowBufferPoolAllocator() take buffers from the pool, and releasing the
+// arrays they build puts the buffers back, bucketed by size class (rounded up by at
+// most 25%), until max_cached_bytes are cached. Safe to share between threads (and
+// like GeoArrowTypeCacheInit(), GeoArrowBufferPoolInit() returns ENOTSUP where that
+// can't be guaranteed). Arrays built from the pool may be released after
+// GeoArrowBufferPoolReset().
+struct GeoArrowBufferPool {
+  void* private_data;
+};
+
+GeoArrowErrorCode GeoArrowBufferPoolInit(struct GeoArrowBufferPool* pool,
+                                         int64_t max_cached_bytes);
+
+struct GeoArrowBufferAllocator GeoArrowBufferPoolAllocator(
+    struct GeoArrowBufferPool* pool);
+
+// The number of bytes held by the pool that aren't in use
+int64_t GeoArrowBufferPoolCachedBytes(struct GeoArrowBufferPool* pool);
+
+void GeoArrowBufferPoolReset(struct GeoArrowBufferPool* pool);
+
+// Installs tracer for every traced entry point in the process (or removes the current
+// one if tracer is NULL). The tracer is not copied and must stay valid until it is
+// removed and calls that were already in progress on other threads have returned.
+// The tracer can be changed while other threads use the library. On platforms other
+// than Windows that aren't built with GCC or clang tracers are ignored.
+void GeoArrowSetTracer(struct GeoArrowTracer* tracer);
+
+struct GeoArrowTracer* GeoArrowGetTracer(void);
+
 int64_t GeoArrowMetadataSerialize(const struct GeoArrowMetadataView* metadata_view,
                                   char* out, int64_t n);
 
@@ -160,10 +217,39 @@ GeoArrowErrorCode GeoArrowArrayViewSetArray(struct GeoArrowArrayView* array_view
                                             struct ArrowArray* array,
                                             struct GeoArrowError* error);
 
+// Like GeoArrowArrayViewSetArray() without checking the number of buffers and
+// children of array and its descendants: use to bind each batch of a stream after
+// GeoArrowArrayViewSetArray() succeeded for an array with the same structure.
+GeoArrowErrorCode GeoArrowArrayViewRebind(struct GeoArrowArrayView* array_view,
+                                          struct ArrowArray* array,
+                                          struct GeoArrowError* error);
+
 GeoArrowErrorCode GeoArrowArrayViewVisit(struct GeoArrowArrayView* array_view,
                                          int64_t offset, int64_t length,
                                          struct GeoArrowVisitor* v);
 
+// Like GeoArrowArrayViewInitFromType() for the geoarrow.geometry types, assuming the
+// layout written by GeoArrowSchemaInit() (one child per geometry type in order)
+GeoArrowErrorCode GeoArrowUnionArrayViewInitFromType(
+    struct GeoArrowUnionArrayView* array_view, enum GeoArrowType type);
+
+GeoArrowErrorCode GeoArrowUnionArrayViewInitFromSchema(
+    struct GeoArrowUnionArrayView* array_view, struct ArrowSchema* schema,
+    struct GeoArrowError* error);
+
+GeoArrowErrorCode GeoArrowUnionArrayViewSetArray(
+    struct GeoArrowUnionArrayView* array_view, struct ArrowArray* array,
+    struct GeoArrowError* error);
+
+// Like GeoArrowArrayViewRebind() for a GeoArrowUnionArrayView
+GeoArrowErrorCode GeoArrowUnionArrayViewRebind(
+    struct GeoArrowUnionArrayView* array_view, struct ArrowArray* array,
+    struct GeoArrowError* error);
+
+GeoArrowErrorCode GeoArrowUnionArrayViewVisit(struct GeoArrowUnionArrayView* array_view,
+                                              int64_t offset, int64_t length,
+                                              struct GeoArrowVisitor* v);
+
 void GeoArrowVisitorInitVoid(struct GeoArrowVisitor* v);
 
 struct GeoArrowWKTWriter {
@@ -174,6 +260,16 @@ struct GeoArrowWKTWriter {
 
 GeoArrowErrorCode GeoArrowWKTWriterInit(struct GeoArrowWKTWriter* writer);
 
+// Must be called before anything is written. The allocator is kept for later arrays.
+GeoArrowErrorCode GeoArrowWKTWriterSetAllocator(
+    struct GeoArrowWKTWriter* writer, struct GeoArrowBufferAllocator allocator);
+
+// If retain_buffers is non-zero, GeoArrowWKTWriterFinish() copies the result into
+// exactly sized buffers and keeps the capacity of the writer's own buffers for the
+// next batch instead of handing them to the output array.
+void GeoArrowWKTWriterSetRetainBuffers(struct GeoArrowWKTWriter* writer,
+                                      int retain_buffers);
+
 void GeoArrowWKTWriterInitVisitor(struct GeoArrowWKTWriter* writer,
                                   struct GeoArrowVisitor* v);
 
@@ -181,9 +277,18 @@ GeoArrowErrorCode GeoArrowWKTWriterFinish(struct GeoArrowWKTWriter* writer,
                                           struct ArrowArray* array,
                                           struct GeoArrowError* error);
 
+// Copies the counters collected by writer into out. Returns ENOTSUP (and zeroes out)
+// if the library was compiled without GEOARROW_INSTRUMENTATION.
+GeoArrowErrorCode GeoArrowWKTWriterGetInstrumentation(
+    struct GeoArrowWKTWriter* writer, struct GeoArrowInstrumentation* out);
+
 void GeoArrowWKTWriterReset(struct GeoArrowWKTWriter* writer);
 
+// If dimensions is not GEOARROW_DIMENSIONS_UNKNOWN, every geometry is passed to the
+// visitor with those dimensions: ordinates that dimensions doesn't have are dropped
+// and ordinates that the source doesn't have are filled with zero.
 struct GeoArrowWKTReader {
+  enum GeoArrowDimensions dimensions;
   void* private_data;
 };
 
@@ -193,6 +298,9 @@ GeoArrowErrorCode GeoArrowWKTReaderVisit(struct GeoArrowWKTReader* reader,
                                          struct GeoArrowStringView s,
                                          struct GeoArrowVisitor* v);
 
+GeoArrowErrorCode GeoArrowWKTReaderGetInstrumentation(
+    struct GeoArrowWKTReader* reader, struct GeoArrowInstrumentation* out);
+
 void GeoArrowWKTReaderReset(struct GeoArrowWKTReader* reader);
 
 struct GeoArrowWKBWriter {
@@ -201,6 +309,12 @@ struct GeoArrowWKBWriter {
 
 GeoArrowErrorCode GeoArrowWKBWriterInit(struct GeoArrowWKBWriter* writer);
 
+GeoArrowErrorCode GeoArrowWKBWriterSetAllocator(
+    struct GeoArrowWKBWriter* writer, struct GeoArrowBufferAllocator allocator);
+
+void GeoArrowWKBWriterSetRetainBuffers(struct GeoArrowWKBWriter* writer,
+                                      int retain_buffers);
+
 void GeoArrowWKBWriterInitVisitor(struct GeoArrowWKBWriter* writer,
                                   struct GeoArrowVisitor* v);
 
@@ -208,9 +322,18 @@ GeoArrowErrorCode GeoArrowWKBWriterFinish(struct GeoArrowWKBWriter* writer,
                                           struct ArrowArray* array,
                                           struct GeoArrowError* error);
 
+GeoArrowErrorCode GeoArrowWKBWriterGetInstrumentation(
+    struct GeoArrowWKBWriter* writer, struct GeoArrowInstrumentation* out);
+
 void GeoArrowWKBWriterReset(struct GeoArrowWKBWriter* writer);
 
+// If use_unaligned_coords is non-zero, native-endian coordinates are always passed
+// to the visitor as pointers into the source buffer, even if they are not aligned.
+// Visitors must then read values with GeoArrowCoordViewValueUnaligned(). dimensions
+// coerces geometries to the given dimensions as for the GeoArrowWKTReader.
 struct GeoArrowWKBReader {
+  int use_unaligned_coords;
+  enum GeoArrowDimensions dimensions;
   void* private_data;
 };
 
@@ -222,8 +345,28 @@ GeoArrowErrorCode GeoArrowWKBReaderVisit(struct GeoArrowWKBReader* reader,
                                          struct GeoArrowBufferView src,
                                          struct GeoArrowVisitor* v);
 
+GeoArrowErrorCode GeoArrowWKBReaderGetInstrumentation(
+    struct GeoArrowWKBReader* reader, struct GeoArrowInstrumentation* out);
+
+GeoArrowErrorCode GeoArrowWKBSize(struct GeoArrowBufferView src, int64_t* size_out,
+                                  struct GeoArrowError* error);
+
+// Writes up to n_offsets offsets for consecutive WKB items in src, starting with 0.
+// If offsets is NULL, all items are counted.
+GeoArrowErrorCode GeoArrowWKBOffsetsInt32(struct GeoArrowBufferView src, int32_t* offsets,
+                                          int64_t n_offsets, int64_t* n_items_out,
+                                          struct GeoArrowError* error);
+
+GeoArrowErrorCode GeoArrowWKBOffsetsInt64(struct GeoArrowBufferView src, int64_t* offsets,
+                                          int64_t n_offsets, int64_t* n_items_out,
+                                          struct GeoArrowError* error);
+
+// If coerce_dimensions is non-zero, the builder's visitor accepts geometries with
+// any dimensions, dropping ordinates the builder doesn't have and filling missing
+// ordinates with zero.
 struct GeoArrowBuilder {
   struct GeoArrowWritableArrayView view;
+  int coerce_dimensions;
   void* private_data;
 };
 
@@ -237,6 +380,26 @@ GeoArrowErrorCode GeoArrowBuilderInitFromSchema(struct GeoArrowBuilder* builder,
 GeoArrowErrorCode GeoArrowBuilderReserveBuffer(struct GeoArrowBuilder* builder, int64_t i,
                                                int64_t additional_size_bytes);
 
+// Allocates the buffers of this and later arrays built by builder with allocator
+// instead of ArrowMalloc(). Must be called before anything is appended.
+GeoArrowErrorCode GeoArrowBuilderSetAllocator(struct GeoArrowBuilder* builder,
+                                              struct GeoArrowBufferAllocator allocator);
+
+// Sets how GeoArrowBuilderReserveBuffer() (and everything that calls it) grows
+// buffers, including the validity bitmap. increment_bytes is only used by
+// GEOARROW_GROWTH_POLICY_LINEAR.
+GeoArrowErrorCode GeoArrowBuilderSetGrowthPolicy(struct GeoArrowBuilder* builder,
+                                                 enum GeoArrowGrowthPolicy policy,
+                                                 int64_t increment_bytes);
+
+// Reserves space in all buffers for n_features more features made of n_geoms more
+// child geometries (e.g., linestrings of a multilinestring or polygons of a
+// multipolygon), n_rings more polygon rings and n_coords more coordinates. Counts
+// that don't apply to the builder's geometry type are ignored.
+GeoArrowErrorCode GeoArrowBuilderReserve(struct GeoArrowBuilder* builder,
+                                         int64_t n_features, int64_t n_geoms,
+                                         int64_t n_rings, int64_t n_coords);
+
 static inline int GeoArrowBuilderBufferCheck(struct GeoArrowBuilder* builder, int64_t i,
                                              int64_t additional_size_bytes);
 
@@ -257,6 +420,13 @@ static inline GeoArrowErrorCode GeoArrowBuilderAppendBuffer(
   return GEOARROW_OK;
 }
 
+// Appends features [offset, offset + length) of a native array_view of the same type
+// by copying ranges of its offset and coordinate buffers. On failure nothing is
+// appended and the builder can still be used.
+GeoArrowErrorCode GeoArrowBuilderAppendArrayView(struct GeoArrowBuilder* builder,
+                                                 struct GeoArrowArrayView* array_view,
+                                                 int64_t offset, int64_t length);
+
 void GeoArrowBuilderInitVisitor(struct GeoArrowBuilder* builder,
                                 struct GeoArrowVisitor* v);
 
@@ -264,8 +434,306 @@ GeoArrowErrorCode GeoArrowBuilderFinish(struct GeoArrowBuilder* builder,
                                         struct ArrowArray* array,
                                         struct GeoArrowError* error);
 
+GeoArrowErrorCode GeoArrowBuilderGetInstrumentation(
+    struct GeoArrowBuilder* builder, struct GeoArrowInstrumentation* out);
+
 void GeoArrowBuilderReset(struct GeoArrowBuilder* builder);
 
+// Builds a geoarrow.geometry array from visited features. Each feature is written to
+// the child for its outermost geometry type (coerced to the dimensions of type);
+// null features are written as null points. Geometry collections are not supported.
+struct GeoArrowUnionBuilder {
+  enum GeoArrowType type;
+  void* private_data;
+};
+
+GeoArrowErrorCode GeoArrowUnionBuilderInitFromType(struct GeoArrowUnionBuilder* builder,
+                                                   enum GeoArrowType type);
+
+GeoArrowErrorCode GeoArrowUnionBuilderSetAllocator(
+    struct GeoArrowUnionBuilder* builder, struct GeoArrowBufferAllocator allocator);
+
+void GeoArrowUnionBuilderInitVisitor(struct GeoArrowUnionBuilder* builder,
+                                     struct GeoArrowVisitor* v);
+
+GeoArrowErrorCode GeoArrowUnionBuilderFinish(struct GeoArrowUnionBuilder* builder,
+                                             struct ArrowArray* array,
+                                             struct GeoArrowError* error);
+
+void GeoArrowUnionBuilderReset(struct GeoArrowUnionBuilder* builder);
+
+struct GeoArrowArrayReader {
+  void* private_data;
+};
+
+GeoArrowErrorCode GeoArrowArrayReaderInitFromType(struct GeoArrowArrayReader* reader,
+                                                  enum GeoArrowType type);
+
+GeoArrowErrorCode GeoArrowArrayReaderInitFromSchema(struct GeoArrowArrayReader* reader,
+                                                    struct ArrowSchema* schema,
+                                                    struct GeoArrowError* error);
+
+GeoArrowErrorCode GeoArrowArrayReaderSetArray(struct GeoArrowArrayReader* reader,
+                                              struct ArrowArray* array,
+                                              struct GeoArrowError* error);
+
+GeoArrowErrorCode GeoArrowArrayReaderVisit(struct GeoArrowArrayReader* reader,
+                                           int64_t offset, int64_t length,
+                                           struct GeoArrowVisitor* v);
+
+void GeoArrowArrayReaderReset(struct GeoArrowArrayReader* reader);
+
+struct GeoArrowArrayWriter {
+  void* private_data;
+};
+
+GeoArrowErrorCode GeoArrowArrayWriterInitFromType(struct GeoArrowArrayWriter* writer,
+                                                  enum GeoArrowType type);
+
+GeoArrowErrorCode GeoArrowArrayWriterSetAllocator(
+    struct GeoArrowArrayWriter* writer, struct GeoArrowBufferAllocator allocator);
+
+GeoArrowErrorCode GeoArrowArrayWriterInitVisitor(struct GeoArrowArrayWriter* writer,
+                                                 struct GeoArrowVisitor* v);
+
+GeoArrowErrorCode GeoArrowArrayWriterFinish(struct GeoArrowArrayWriter* writer,
+                                            struct ArrowArray* array,
+                                            struct GeoArrowError* error);
+
+void GeoArrowArrayWriterReset(struct GeoArrowArrayWriter* writer);
+
+struct GeoArrowFileReader {
+  void* private_data;
+};
+
+GeoArrowErrorCode GeoArrowFileReaderInit(struct GeoArrowFileReader* reader,
+                                         const char* path,
+                                         enum GeoArrowFileFormat format,
+                                         struct GeoArrowError* error);
+
+int64_t GeoArrowFileReaderSize(struct GeoArrowFileReader* reader);
+
+// Computes n_ranges + 1 record-aligned byte offsets into boundaries such that
+// the file can be visited in n_ranges independent pieces
+GeoArrowErrorCode GeoArrowFileReaderSplit(struct GeoArrowFileReader* reader,
+                                          int64_t n_ranges, int64_t* boundaries,
+                                          struct GeoArrowError* error);
+
+// Visits every record that starts in [begin, end); may be called concurrently
+// from multiple threads on the same reader. For WKT files begin may be any offset.
+// For the WKB formats begin must be the start of a record (e.g., 0 or one of the
+// boundaries computed by GeoArrowFileReaderSplit()): records can't be found from an
+// arbitrary offset, so other values are read as if a record started there.
+GeoArrowErrorCode GeoArrowFileReaderVisit(struct GeoArrowFileReader* reader,
+                                          int64_t begin, int64_t end,
+                                          struct GeoArrowVisitor* v);
+
+void GeoArrowFileReaderReset(struct GeoArrowFileReader* reader);
+
+// Takes ownership of input on success; batches are converted one at a time
+// as get_next() is called on out. Once get_next() fails it returns the same error
+// for the rest of the stream.
+GeoArrowErrorCode GeoArrowArrayStreamConvert(struct ArrowArrayStream* input,
+                                             enum GeoArrowType type,
+                                             struct ArrowArrayStream* out,
+                                             struct GeoArrowError* error);
+
+// Takes ownership of input on success; a worker thread pulls up to queue_depth
+// batches from input ahead of the consumer's calls to get_next() on out.
+GeoArrowErrorCode GeoArrowArrayStreamPrefetch(struct ArrowArrayStream* input,
+                                              int64_t queue_depth,
+                                              struct ArrowArrayStream* out,
+                                              struct GeoArrowError* error);
+
+// Native geometry types only; runs of consecutive indices are copied as one range.
+// If a feature can't be appended, error names its index in array_view.
+GeoArrowErrorCode GeoArrowTake(struct GeoArrowArrayView* array_view,
+                               const int64_t* indices, int64_t n_indices,
+                               struct ArrowArray* out, struct GeoArrowError* error);
+
+// Native geometry types only; filter is a bitmap of array_view->length bits. Errors
+// name the failing feature as for GeoArrowTake().
+GeoArrowErrorCode GeoArrowFilter(struct GeoArrowArrayView* array_view,
+                                 const uint8_t* filter, struct ArrowArray* out,
+                                 struct GeoArrowError* error);
+
+// All array_views must have the same native geometry type
+GeoArrowErrorCode GeoArrowConcat(struct GeoArrowArrayView* array_views, int64_t n_arrays,
+                                 struct ArrowArray* out, struct GeoArrowError* error);
+
+// Builds a native array from visited features without knowing its type in advance.
+// type is the narrowest native type that can hold every non-null feature seen so far
+// (GEOARROW_TYPE_UNINITIALIZED before the first one). When a feature doesn't fit,
+// the features already built are converted to a wider type: single geometries are
+// promoted to the multi geometry of the same kind and dimensions are promoted to
+// include every ordinate seen (missing ordinates are filled with zero).
+struct GeoArrowUnifyingBuilder {
+  enum GeoArrowType type;
+  void* private_data;
+};
+
+GeoArrowErrorCode GeoArrowUnifyingBuilderInit(struct GeoArrowUnifyingBuilder* builder);
+
+GeoArrowErrorCode GeoArrowUnifyingBuilderSetAllocator(
+    struct GeoArrowUnifyingBuilder* builder, struct GeoArrowBufferAllocator allocator);
+
+void GeoArrowUnifyingBuilderInitVisitor(struct GeoArrowUnifyingBuilder* builder,
+                                        struct GeoArrowVisitor* v);
+
+// Features that are all null are built as GEOARROW_TYPE_POINT. The builder starts
+// over with no type afterwards.
+GeoArrowErrorCode GeoArrowUnifyingBuilderFinish(struct GeoArrowUnifyingBuilder* builder,
+                                                struct ArrowArray* array,
+                                                struct GeoArrowError* error);
+
+void GeoArrowUnifyingBuilderReset(struct GeoArrowUnifyingBuilder* builder);
+
+// Converts array (e.g., WKB or WKT) to the narrowest native type that can hold every
+// feature in one pass using a GeoArrowUnifyingBuilder
+GeoArrowErrorCode GeoArrowArrayUnify(enum GeoArrowType type, struct ArrowArray* array,
+                                     struct ArrowArray* out, enum GeoArrowType* type_out,
+                                     struct GeoArrowError* error);
+
+// Uses a grid with 10^decimal_places steps per unit and no offset in every dimension
+void GeoArrowGridInitDecimal(struct GeoArrowGrid* grid, int decimal_places);
+
+// Snaps the coordinates of a native writable_view (e.g., GeoArrowBuilder.view) to
+// the nearest grid point in place
+GeoArrowErrorCode GeoArrowWritableArrayViewSnapToGrid(
+    struct GeoArrowWritableArrayView* writable_view, const struct GeoArrowGrid* grid);
+
+// Writes coords->n_coords grid steps per dimension to out[0..n_values). Returns
+// ERANGE if a value can't be represented as an int32 step.
+GeoArrowErrorCode GeoArrowCoordViewQuantize(const struct GeoArrowCoordView* coords,
+                                            const struct GeoArrowGrid* grid,
+                                            int32_t** out, struct GeoArrowError* error);
+
+void GeoArrowDequantize(const int32_t* const* values, int64_t n_coords, int32_t n_values,
+                        const struct GeoArrowGrid* grid, double** out);
+
+// The tolerance is a distance for GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER and an
+// area for GEOARROW_SIMPLIFY_METHOD_VISVALINGAM. Scratch space is reused between
+// calls to GeoArrowSimplifierAppend().
+struct GeoArrowSimplifier {
+  enum GeoArrowSimplifyMethod method;
+  double tolerance;
+  void* private_data;
+};
+
+GeoArrowErrorCode GeoArrowSimplifierInit(struct GeoArrowSimplifier* simplifier);
+
+// Appends simplified copies of features [offset, offset + length) to builder
+GeoArrowErrorCode GeoArrowSimplifierAppend(struct GeoArrowSimplifier* simplifier,
+                                           struct GeoArrowArrayView* array_view,
+                                           int64_t offset, int64_t length,
+                                           struct GeoArrowBuilder* builder,
+                                           struct GeoArrowError* error);
+
+void GeoArrowSimplifierReset(struct GeoArrowSimplifier* simplifier);
+
+void GeoArrowAffineInitIdentity(struct GeoArrowAffine* affine);
+
+// Writes coords->n_coords transformed coordinates to out[0..n_values). dimensions
+// distinguishes z from m when coords has three values.
+void GeoArrowCoordViewTransform(const struct GeoArrowCoordView* coords,
+                                enum GeoArrowDimensions dimensions,
+                                const struct GeoArrowAffine* affine, double** out);
+
+// Transforms the coordinates of a native writable_view (e.g., GeoArrowBuilder.view)
+// in place
+GeoArrowErrorCode GeoArrowWritableArrayViewTransform(
+    struct GeoArrowWritableArrayView* writable_view,
+    const struct GeoArrowAffine* affine);
+
+// Writes a copy of array with transformed coordinates to out. array_view must have
+// been set from array. On success, array is moved into out, which shares its validity
+// and offset buffers instead of copying them.
+GeoArrowErrorCode GeoArrowArrayViewTransform(struct GeoArrowArrayView* array_view,
+                                             struct ArrowArray* array,
+                                             const struct GeoArrowAffine* affine,
+                                             struct ArrowArray* out,
+                                             struct GeoArrowError* error);
+
+// Transforms n coordinates in place (e.g., by calling proj_trans_generic()). z is
+// NULL when none of the coordinates have a z value. crs_type and crs describe the
+// output coordinates and are written by GeoArrowCoordTransformUpdateSchema().
+struct GeoArrowCoordTransform {
+  int (*transform)(struct GeoArrowCoordTransform* transform, double* x, double* y,
+                   double* z, int64_t n);
+  enum GeoArrowCrsType crs_type;
+  struct GeoArrowStringView crs;
+  void* private_data;
+};
+
+// Replaces the crs in the extension metadata of schema with that of transform
+GeoArrowErrorCode GeoArrowCoordTransformUpdateSchema(
+    const struct GeoArrowCoordTransform* transform, struct ArrowSchema* schema,
+    struct GeoArrowError* error);
+
+GeoArrowErrorCode GeoArrowWritableArrayViewReproject(
+    struct GeoArrowWritableArrayView* writable_view,
+    struct GeoArrowCoordTransform* transform, struct GeoArrowError* error);
+
+// Like GeoArrowArrayViewTransform(), passing all coordinates to one transform call
+GeoArrowErrorCode GeoArrowArrayViewReproject(struct GeoArrowArrayView* array_view,
+                                             struct ArrowArray* array,
+                                             struct GeoArrowCoordTransform* transform,
+                                             struct ArrowArray* out,
+                                             struct GeoArrowError* error);
+
+// A visitor filter that holds back whole features until at least batch_size
+// coordinates are pending, transforms them with one call, and forwards them to the
+// next visitor. GeoArrowReprojectorFlush() must be called after the last feature.
+struct GeoArrowReprojector {
+  int64_t batch_size;
+  void* private_data;
+};
+
+GeoArrowErrorCode GeoArrowReprojectorInit(struct GeoArrowReprojector* reprojector,
+                                          struct GeoArrowCoordTransform* transform);
+
+void GeoArrowReprojectorInitVisitor(struct GeoArrowReprojector* reprojector,
+                                    struct GeoArrowVisitor* next,
+                                    struct GeoArrowVisitor* v);
+
+GeoArrowErrorCode GeoArrowReprojectorFlush(struct GeoArrowReprojector* reprojector,
+                                           struct GeoArrowError* error);
+
+void GeoArrowReprojectorReset(struct GeoArrowReprojector* reprojector);
+
+// A chain of visitor filters that runs in a single traversal of the source. Each
+// stage changes the callbacks it receives and passes them to the next stage; the
+// last stage passes them to the sink given to GeoArrowVisitorPipelineInitVisitor().
+struct GeoArrowVisitorPipeline {
+  void* private_data;
+};
+
+GeoArrowErrorCode GeoArrowVisitorPipelineInit(struct GeoArrowVisitorPipeline* pipeline);
+
+GeoArrowErrorCode GeoArrowVisitorPipelineAppendTransform(
+    struct GeoArrowVisitorPipeline* pipeline, const struct GeoArrowAffine* affine);
+
+// Passes every callback to other before passing it to the next stage
+GeoArrowErrorCode GeoArrowVisitorPipelineAppendTee(
+    struct GeoArrowVisitorPipeline* pipeline, struct GeoArrowVisitor* other);
+
+// Removes z and/or m values from geometries that have dimensions not in dimensions
+GeoArrowErrorCode GeoArrowVisitorPipelineAppendDropDimensions(
+    struct GeoArrowVisitorPipeline* pipeline, enum GeoArrowDimensions dimensions);
+
+// Removes features whose geometry type isn't one of types; null features are kept
+GeoArrowErrorCode GeoArrowVisitorPipelineAppendFilterType(
+    struct GeoArrowVisitorPipeline* pipeline, const enum GeoArrowGeometryType* types,
+    int64_t n_types);
+
+// Stages can't be appended once this has been called (appending returns EINVAL). Errors
+// from the stages themselves are written to sink->error.
+void GeoArrowVisitorPipelineInitVisitor(struct GeoArrowVisitorPipeline* pipeline,
+                                        struct GeoArrowVisitor* sink,
+                                        struct GeoArrowVisitor* v);
+
+void GeoArrowVisitorPipelineReset(struct GeoArrowVisitorPipeline* pipeline);
+
 #ifdef __cplusplus
 }
 #endif
@@ -74,6 +74,25 @@ class VectorType {
     return VectorType(schema_view, metadata_view);
   }
 
+  /// \brief Make a VectorType from an ArrowSchema extension type using a
+  /// GeoArrowTypeCache
+  ///
+  /// The caller retains ownership of schema and cache.
+  static VectorType Make(struct ArrowSchema* schema, struct GeoArrowTypeCache* cache) {
+    struct GeoArrowSchemaView schema_view;
+    struct GeoArrowMetadataView metadata_view;
+    struct GeoArrowError error;
+    int result =
+        GeoArrowTypeCacheGet(cache, schema, &schema_view, &metadata_view, &error);
+    if (result != GEOARROW_OK) {
+      std::stringstream ss;
+      ss << "Failed to initialize GeoArrowSchemaView: " << error.message;
+      return Invalid(ss.str());
+    }
+
+    return VectorType(schema_view, metadata_view);
+  }
+
   /// \brief Make a VectorType from an ArrowSchema storage type
   ///
   /// The caller retains ownership of schema. If schema is an extension type,
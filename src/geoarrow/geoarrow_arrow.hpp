@@ -141,9 +141,10 @@ class VectorExtensionType : public arrow::ExtensionType {
       : arrow::ExtensionType(storage_type), extension_name_(extension_name) {}
 
   static std::vector<std::string> all_ext_names() {
-    return {"geoarrow.wkb",         "geoarrow.point",      "geoarrow.linestring",
-            "geoarrow.polygon",     "geoarrow.multipoint", "geoarrow.multilinestring",
-            "geoarrow.multipolygon"};
+    return {"geoarrow.wkb",        "geoarrow.wkt",
+            "geoarrow.point",      "geoarrow.linestring",
+            "geoarrow.polygon",    "geoarrow.multipoint",
+            "geoarrow.multilinestring", "geoarrow.multipolygon"};
   }
 };
 
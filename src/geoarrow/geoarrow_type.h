@@ -70,7 +70,16 @@ enum GeoArrowType {
   GEOARROW_TYPE_POLYGON_ZM,
   GEOARROW_TYPE_MULTIPOINT_ZM,
   GEOARROW_TYPE_MULTILINESTRING_ZM,
-  GEOARROW_TYPE_MULTIPOLYGON_ZM
+  GEOARROW_TYPE_MULTIPOLYGON_ZM,
+
+  GEOARROW_TYPE_GEOMETRY,
+  GEOARROW_TYPE_GEOMETRY_Z,
+  GEOARROW_TYPE_GEOMETRY_M,
+  GEOARROW_TYPE_GEOMETRY_ZM,
+
+  // New types are appended so that the values of the existing ones don't change
+  GEOARROW_TYPE_WKT,
+  GEOARROW_TYPE_LARGE_WKT
 };
 
 enum GeoArrowGeometryType {
@@ -100,6 +109,80 @@ enum GeoArrowCoordType {
 
 enum GeoArrowEdgeType { GEOARROW_EDGE_TYPE_PLANAR, GEOARROW_EDGE_TYPE_SPHERICAL };
 
+enum GeoArrowSimplifyMethod {
+  GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER = 0,
+  GEOARROW_SIMPLIFY_METHOD_VISVALINGAM = 1
+};
+
+enum GeoArrowFileFormat {
+  GEOARROW_FILE_FORMAT_WKB_LENGTH_PREFIXED = 0,
+  GEOARROW_FILE_FORMAT_WKB = 1,
+  GEOARROW_FILE_FORMAT_WKT = 2
+};
+
+// How a builder grows a buffer that is too small: by at least doubling its capacity,
+// by a multiple of a fixed number of bytes, or to exactly the required size
+enum GeoArrowGrowthPolicy {
+  GEOARROW_GROWTH_POLICY_GEOMETRIC = 0,
+  GEOARROW_GROWTH_POLICY_LINEAR = 1,
+  GEOARROW_GROWTH_POLICY_EXACT = 2
+};
+
+struct ArrowBufferAllocator;
+
+// Allocates the buffers of arrays built by builders and writers. Its members have the
+// types of those of nanoarrow's ArrowBufferAllocator, which is what the callbacks are
+// given (with the same private_data). The buffers of a built array are released with
+// free(), so whatever private_data refers to must outlive every array built with the
+// allocator.
+struct GeoArrowBufferAllocator {
+  uint8_t* (*reallocate)(struct ArrowBufferAllocator* allocator, uint8_t* ptr,
+                         int64_t old_size, int64_t new_size);
+  void (*free)(struct ArrowBufferAllocator* allocator, uint8_t* ptr, int64_t size);
+  void* private_data;
+};
+
+// Counters collected by readers, writers and builders when the library is compiled
+// with GEOARROW_INSTRUMENTATION defined. Each component only fills in the counters
+// that apply to it.
+struct GeoArrowInstrumentation {
+  // Calls to the component's entry point (e.g., GeoArrowWKBReaderVisit() or
+  // GeoArrowBuilderFinish()) and the wall time spent in them
+  int64_t n_calls;
+  int64_t elapsed_ns;
+
+  int64_t n_features;
+  int64_t n_coords;
+  int64_t n_bytes_in;
+  int64_t n_bytes_out;
+
+  // Buffer reallocations (builders), doubles whose bytes were swapped (WKB readers)
+  // and batches of coordinates passed on from an internal cache (WKB and WKT readers)
+  int64_t n_reallocations;
+  int64_t n_values_swapped;
+  int64_t n_chunks_flushed;
+};
+
+// The public entry points that report to a struct GeoArrowTracer
+enum GeoArrowTraceEvent {
+  GEOARROW_TRACE_EVENT_WKB_READER_VISIT = 0,
+  GEOARROW_TRACE_EVENT_WKT_READER_VISIT = 1,
+  GEOARROW_TRACE_EVENT_ARRAY_VIEW_VISIT = 2,
+  GEOARROW_TRACE_EVENT_BUILDER_FINISH = 3,
+  GEOARROW_TRACE_EVENT_WKB_WRITER_FINISH = 4,
+  GEOARROW_TRACE_EVENT_WKT_WRITER_FINISH = 5
+};
+
+// Callbacks invoked when a traced entry point starts and returns. end() receives the
+// number of rows (features) and bytes that the call processed and its return code.
+// Both may be called from any thread that uses the library.
+struct GeoArrowTracer {
+  void (*begin)(struct GeoArrowTracer* tracer, enum GeoArrowTraceEvent event);
+  void (*end)(struct GeoArrowTracer* tracer, enum GeoArrowTraceEvent event,
+              int64_t n_rows, int64_t n_bytes, GeoArrowErrorCode result);
+  void* private_data;
+};
+
 enum GeoArrowCrsType {
   GEOARROW_CRS_TYPE_NONE,
   GEOARROW_CRS_TYPE_UNKNOWN,
@@ -141,6 +224,22 @@ struct GeoArrowWritableCoordView {
 #define GEOARROW_COORD_VIEW_VALUE(coords_, row_, col_) \
   coords_->values[col_][row_ * coords_->coords_stride]
 
+// Values on a grid are offset + q / scale for some integer q
+struct GeoArrowGrid {
+  double scale[4];
+  double offset[4];
+};
+
+// The quantized representation of a nan coordinate value
+#define GEOARROW_QUANTIZED_NAN INT32_MIN
+
+// Rows are the output x, y, and z; columns are the input x, y, z, and a
+// translation. Terms involving z are ignored for coordinates without z and m
+// values are never changed.
+struct GeoArrowAffine {
+  double matrix[3][4];
+};
+
 struct GeoArrowArrayView {
   struct GeoArrowSchemaView schema_view;
   int64_t length;
@@ -151,6 +250,19 @@ struct GeoArrowArrayView {
   struct GeoArrowCoordView coords;
 };
 
+// A view of a geoarrow.geometry array: a dense union whose children are native
+// arrays with the same dimensions. children[geometry_type - 1] is valid if
+// child_index[geometry_type] (the position of that child in the ArrowArray) is not -1.
+struct GeoArrowUnionArrayView {
+  struct GeoArrowSchemaView schema_view;
+  int64_t length;
+  const int8_t* type_ids;
+  const int32_t* offsets;
+  int64_t n_children;
+  int8_t child_index[7];
+  struct GeoArrowArrayView children[6];
+};
+
 struct GeoArrowWritableArrayView {
   struct GeoArrowSchemaView schema_view;
   int64_t length;
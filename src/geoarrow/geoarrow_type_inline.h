@@ -16,6 +16,10 @@ static inline const char* GeoArrowExtensionNameFromType(enum GeoArrowType type)
     case GEOARROW_TYPE_LARGE_WKB:
       return "geoarrow.wkb";
 
+    case GEOARROW_TYPE_WKT:
+    case GEOARROW_TYPE_LARGE_WKT:
+      return "geoarrow.wkt";
+
     case GEOARROW_TYPE_POINT:
     case GEOARROW_TYPE_POINT_Z:
     case GEOARROW_TYPE_POINT_M:
@@ -52,6 +56,12 @@ static inline const char* GeoArrowExtensionNameFromType(enum GeoArrowType type)
     case GEOARROW_TYPE_MULTIPOLYGON_ZM:
       return "geoarrow.multipolygon";
 
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
+      return "geoarrow.geometry";
+
     default:
       return NULL;
   }
@@ -113,6 +123,7 @@ static inline enum GeoArrowDimensions GeoArrowDimensionsFromType(enum GeoArrowTy
     case GEOARROW_TYPE_MULTIPOINT:
     case GEOARROW_TYPE_MULTILINESTRING:
     case GEOARROW_TYPE_MULTIPOLYGON:
+    case GEOARROW_TYPE_GEOMETRY:
       return GEOARROW_DIMENSIONS_XY;
 
     case GEOARROW_TYPE_POINT_Z:
@@ -121,6 +132,7 @@ static inline enum GeoArrowDimensions GeoArrowDimensionsFromType(enum GeoArrowTy
     case GEOARROW_TYPE_MULTIPOINT_Z:
     case GEOARROW_TYPE_MULTILINESTRING_Z:
     case GEOARROW_TYPE_MULTIPOLYGON_Z:
+    case GEOARROW_TYPE_GEOMETRY_Z:
       return GEOARROW_DIMENSIONS_XYZ;
 
     case GEOARROW_TYPE_POINT_M:
@@ -129,6 +141,7 @@ static inline enum GeoArrowDimensions GeoArrowDimensionsFromType(enum GeoArrowTy
     case GEOARROW_TYPE_MULTIPOINT_M:
     case GEOARROW_TYPE_MULTILINESTRING_M:
     case GEOARROW_TYPE_MULTIPOLYGON_M:
+    case GEOARROW_TYPE_GEOMETRY_M:
       return GEOARROW_DIMENSIONS_XYM;
 
     case GEOARROW_TYPE_POINT_ZM:
@@ -137,6 +150,7 @@ static inline enum GeoArrowDimensions GeoArrowDimensionsFromType(enum GeoArrowTy
     case GEOARROW_TYPE_MULTIPOINT_ZM:
     case GEOARROW_TYPE_MULTILINESTRING_ZM:
     case GEOARROW_TYPE_MULTIPOLYGON_ZM:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
       return GEOARROW_DIMENSIONS_XYZM;
 
     default:
@@ -172,6 +186,10 @@ static inline enum GeoArrowCoordType GeoArrowCoordTypeFromType(enum GeoArrowType
     case GEOARROW_TYPE_MULTIPOINT_ZM:
     case GEOARROW_TYPE_MULTILINESTRING_ZM:
     case GEOARROW_TYPE_MULTIPOLYGON_ZM:
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
       return GEOARROW_COORD_TYPE_SEPARATE;
 
     default:
@@ -386,6 +404,78 @@ static inline enum GeoArrowType GeoArrowMakeType(enum GeoArrowGeometryType geome
   }
 }
 
+// Returns the geoarrow.geometry (dense union) type whose children have dimensions
+static inline enum GeoArrowType GeoArrowMakeUnionType(
+    enum GeoArrowDimensions dimensions) {
+  switch (dimensions) {
+    case GEOARROW_DIMENSIONS_XY:
+      return GEOARROW_TYPE_GEOMETRY;
+    case GEOARROW_DIMENSIONS_XYZ:
+      return GEOARROW_TYPE_GEOMETRY_Z;
+    case GEOARROW_DIMENSIONS_XYM:
+      return GEOARROW_TYPE_GEOMETRY_M;
+    case GEOARROW_DIMENSIONS_XYZM:
+      return GEOARROW_TYPE_GEOMETRY_ZM;
+    default:
+      return GEOARROW_TYPE_UNINITIALIZED;
+  }
+}
+
+// The type id of the child of a geoarrow.geometry array that holds geometries of
+// geometry_type: 1-6 for xy, 11-16 for xyz, 21-26 for xym, and 31-36 for xyzm
+static inline int8_t GeoArrowUnionTypeId(enum GeoArrowGeometryType geometry_type,
+                                         enum GeoArrowDimensions dimensions) {
+  return (int8_t)(geometry_type + 10 * (dimensions - 1));
+}
+
+// Sets map[j] to the position of the j-th value of a dst coordinate within a src
+// coordinate, or -1 if src doesn't have that ordinate. Returns the number of values
+// in a dst coordinate.
+static inline int32_t GeoArrowDimensionsMapValues(enum GeoArrowDimensions src,
+                                                  enum GeoArrowDimensions dst,
+                                                  int32_t* map) {
+  int32_t src_z = -1;
+  int32_t src_m = -1;
+  switch (src) {
+    case GEOARROW_DIMENSIONS_XYZ:
+      src_z = 2;
+      break;
+    case GEOARROW_DIMENSIONS_XYM:
+      src_m = 2;
+      break;
+    case GEOARROW_DIMENSIONS_XYZM:
+      src_z = 2;
+      src_m = 3;
+      break;
+    default:
+      break;
+  }
+
+  int32_t n_values = 0;
+  map[n_values++] = 0;
+  map[n_values++] = 1;
+  if (dst == GEOARROW_DIMENSIONS_XYZ || dst == GEOARROW_DIMENSIONS_XYZM) {
+    map[n_values++] = src_z;
+  }
+
+  if (dst == GEOARROW_DIMENSIONS_XYM || dst == GEOARROW_DIMENSIONS_XYZM) {
+    map[n_values++] = src_m;
+  }
+
+  return n_values;
+}
+
+// Reads a value from a coordinate view whose pointers may not be aligned
+static inline double GeoArrowCoordViewValueUnaligned(
+    const struct GeoArrowCoordView* coords, int64_t row, int32_t col) {
+  double value;
+  memcpy(&value,
+         (const unsigned char*)coords->values[col] +
+             row * coords->coords_stride * sizeof(double),
+         sizeof(double));
+  return value;
+}
+
 static inline const char* GeoArrowGeometryTypeString(
     enum GeoArrowGeometryType geometry_type) {
   switch (geometry_type) {
@@ -0,0 +1,38 @@
+
+#ifndef GEOARROW_INSTRUMENTATION_H_INCLUDED
+#define GEOARROW_INSTRUMENTATION_H_INCLUDED
+
+// Not part of the public API: statements wrapped in GEOARROW_INSTRUMENT() update a
+// struct GeoArrowInstrumentation and are compiled out unless GEOARROW_INSTRUMENTATION
+// is defined
+
+#include <stdint.h>
+
+#include "geoarrow.h"
+
+#if defined(GEOARROW_INSTRUMENTATION)
+#include <time.h>
+
+#define GEOARROW_INSTRUMENT(expr) expr
+
+static inline int64_t GeoArrowInstrumentationNowNs(void) {
+  struct timespec ts;
+#if defined(_WIN32)
+  timespec_get(&ts, TIME_UTC);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+  return ((int64_t)ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Counts a call to an entry point that started at start_ns
+static inline void GeoArrowInstrumentationEnd(
+    struct GeoArrowInstrumentation* instrumentation, int64_t start_ns) {
+  instrumentation->n_calls++;
+  instrumentation->elapsed_ns += GeoArrowInstrumentationNowNs() - start_ns;
+}
+#else
+#define GEOARROW_INSTRUMENT(expr)
+#endif
+
+#endif
@@ -1488,7 +1488,7 @@ static inline int64_t ArrowBitCountSet(const uint8_t* bits, int64_t start_offset
     // count bits within a single byte
     const uint8_t only_byte_mask =
         i_end % 8 == 0 ? first_byte_mask : (uint8_t)(first_byte_mask | last_byte_mask);
-    const uint8_t byte_masked = bits[bytes_begin] & only_byte_mask;
+    const uint8_t byte_masked = bits[bytes_begin] & ~only_byte_mask;
     return _ArrowkBytePopcount[byte_masked];
   }
 
@@ -0,0 +1,459 @@
+
+#include <errno.h>
+#include <string.h>
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+
+enum PipelineStageType {
+  PIPELINE_STAGE_TRANSFORM,
+  PIPELINE_STAGE_TEE,
+  PIPELINE_STAGE_DROP_DIMENSIONS,
+  PIPELINE_STAGE_FILTER_TYPE
+};
+
+struct PipelinePrivate;
+
+struct PipelineStage {
+  enum PipelineStageType type;
+  struct PipelinePrivate* pipeline;
+  struct GeoArrowVisitor v;
+  struct GeoArrowVisitor* next;
+
+  // Dimensions of the geometries currently being visited
+  enum GeoArrowDimensions dimensions[32];
+  int32_t level;
+
+  // PIPELINE_STAGE_TRANSFORM: transformed values are written to scratch before
+  // being passed on
+  struct GeoArrowAffine affine;
+  struct ArrowBuffer scratch;
+
+  // PIPELINE_STAGE_TEE
+  struct GeoArrowVisitor* other;
+
+  // PIPELINE_STAGE_DROP_DIMENSIONS
+  int keep_z;
+  int keep_m;
+
+  // PIPELINE_STAGE_FILTER_TYPE: feat_start is held back until the feature's type is
+  // known so that a removed feature is never seen by the next stage
+  uint32_t geometry_types;
+  int feat_pending;
+  int skip_feat;
+};
+
+struct PipelinePrivate {
+  struct PipelineStage* stages;
+  int64_t n_stages;
+
+  // Set by GeoArrowVisitorPipelineInitVisitor(), after which the stages (which point
+  // to each other) can't be reallocated
+  int initialized;
+  struct GeoArrowVisitor* sink;
+};
+
+// Stages report errors to the sink's error as it is when the error happens, so the
+// caller may set it after GeoArrowVisitorPipelineInitVisitor()
+static struct ArrowError* PipelineStageError(struct PipelineStage* stage) {
+  return (struct ArrowError*)stage->pipeline->sink->error;
+}
+
+static int PipelineStageHasZ(enum GeoArrowDimensions dimensions) {
+  return dimensions == GEOARROW_DIMENSIONS_XYZ || dimensions == GEOARROW_DIMENSIONS_XYZM;
+}
+
+static int PipelineStageHasM(enum GeoArrowDimensions dimensions) {
+  return dimensions == GEOARROW_DIMENSIONS_XYM || dimensions == GEOARROW_DIMENSIONS_XYZM;
+}
+
+static enum GeoArrowDimensions PipelineStageDropDimensions(
+    struct PipelineStage* stage, enum GeoArrowDimensions dimensions) {
+  int has_z = stage->keep_z && PipelineStageHasZ(dimensions);
+  int has_m = stage->keep_m && PipelineStageHasM(dimensions);
+  if (has_z && has_m) {
+    return GEOARROW_DIMENSIONS_XYZM;
+  } else if (has_z) {
+    return GEOARROW_DIMENSIONS_XYZ;
+  } else if (has_m) {
+    return GEOARROW_DIMENSIONS_XYM;
+  } else if (dimensions == GEOARROW_DIMENSIONS_UNKNOWN) {
+    return GEOARROW_DIMENSIONS_UNKNOWN;
+  } else {
+    return GEOARROW_DIMENSIONS_XY;
+  }
+}
+
+static int PipelineStageSkip(struct PipelineStage* stage) {
+  return stage->type == PIPELINE_STAGE_FILTER_TYPE && stage->skip_feat;
+}
+
+static int PipelineStageFlushFeatStart(struct PipelineStage* stage) {
+  if (stage->type == PIPELINE_STAGE_FILTER_TYPE && stage->feat_pending) {
+    stage->feat_pending = 0;
+    return stage->next->feat_start(stage->next);
+  }
+
+  return GEOARROW_OK;
+}
+
+static int reserve_coord_pipeline(struct GeoArrowVisitor* v, int64_t n) {
+  struct PipelineStage* stage = (struct PipelineStage*)v->private_data;
+  if (stage->type == PIPELINE_STAGE_TEE) {
+    NANOARROW_RETURN_NOT_OK(stage->other->reserve_coord(stage->other, n));
+  }
+
+  return stage->next->reserve_coord(stage->next, n);
+}
+
+static int reserve_feat_pipeline(struct GeoArrowVisitor* v, int64_t n) {
+  struct PipelineStage* stage = (struct PipelineStage*)v->private_data;
+  if (stage->type == PIPELINE_STAGE_TEE) {
+    NANOARROW_RETURN_NOT_OK(stage->other->reserve_feat(stage->other, n));
+  }
+
+  return stage->next->reserve_feat(stage->next, n);
+}
+
+static int feat_start_pipeline(struct GeoArrowVisitor* v) {
+  struct PipelineStage* stage = (struct PipelineStage*)v->private_data;
+  stage->level = 0;
+
+  switch (stage->type) {
+    case PIPELINE_STAGE_TEE:
+      NANOARROW_RETURN_NOT_OK(stage->other->feat_start(stage->other));
+      break;
+    case PIPELINE_STAGE_FILTER_TYPE:
+      stage->feat_pending = 1;
+      stage->skip_feat = 0;
+      return GEOARROW_OK;
+    default:
+      break;
+  }
+
+  return stage->next->feat_start(stage->next);
+}
+
+static int null_feat_pipeline(struct GeoArrowVisitor* v) {
+  struct PipelineStage* stage = (struct PipelineStage*)v->private_data;
+  if (stage->type == PIPELINE_STAGE_TEE) {
+    NANOARROW_RETURN_NOT_OK(stage->other->null_feat(stage->other));
+  }
+
+  NANOARROW_RETURN_NOT_OK(PipelineStageFlushFeatStart(stage));
+  return stage->next->null_feat(stage->next);
+}
+
+static int geom_start_pipeline(struct GeoArrowVisitor* v,
+                               enum GeoArrowGeometryType geometry_type,
+                               enum GeoArrowDimensions dimensions) {
+  struct PipelineStage* stage = (struct PipelineStage*)v->private_data;
+  if (stage->level < 0 || stage->level > 30) {
+    ArrowErrorSet(PipelineStageError(stage), "Geometries are nested too deeply");
+    return EINVAL;
+  }
+
+  stage->dimensions[stage->level++] = dimensions;
+
+  switch (stage->type) {
+    case PIPELINE_STAGE_TEE:
+      NANOARROW_RETURN_NOT_OK(
+          stage->other->geom_start(stage->other, geometry_type, dimensions));
+      break;
+    case PIPELINE_STAGE_DROP_DIMENSIONS:
+      dimensions = PipelineStageDropDimensions(stage, dimensions);
+      break;
+    case PIPELINE_STAGE_FILTER_TYPE:
+      if (stage->level == 1 && stage->feat_pending) {
+        if (!(stage->geometry_types & (UINT32_C(1) << geometry_type))) {
+          stage->feat_pending = 0;
+          stage->skip_feat = 1;
+        }
+
+        NANOARROW_RETURN_NOT_OK(PipelineStageFlushFeatStart(stage));
+      }
+
+      if (stage->skip_feat) {
+        return GEOARROW_OK;
+      }
+      break;
+    default:
+      break;
+  }
+
+  return stage->next->geom_start(stage->next, geometry_type, dimensions);
+}
+
+static int ring_start_pipeline(struct GeoArrowVisitor* v) {
+  struct PipelineStage* stage = (struct PipelineStage*)v->private_data;
+  if (stage->type == PIPELINE_STAGE_TEE) {
+    NANOARROW_RETURN_NOT_OK(stage->other->ring_start(stage->other));
+  } else if (PipelineStageSkip(stage)) {
+    return GEOARROW_OK;
+  }
+
+  return stage->next->ring_start(stage->next);
+}
+
+static int coords_transform(struct PipelineStage* stage,
+                            const struct GeoArrowCoordView* coords) {
+  int64_t n = coords->n_coords;
+  NANOARROW_RETURN_NOT_OK(
+      ArrowBufferReserve(&stage->scratch, coords->n_values * n * sizeof(double)));
+
+  struct GeoArrowCoordView out;
+  out.n_coords = n;
+  out.n_values = coords->n_values;
+  out.coords_stride = 1;
+  double* values[4];
+  for (int32_t j = 0; j < coords->n_values; j++) {
+    values[j] = ((double*)stage->scratch.data) + j * n;
+    out.values[j] = values[j];
+  }
+
+  GeoArrowCoordViewTransform(coords, stage->dimensions[stage->level - 1],
+                             &stage->affine, values);
+  return stage->next->coords(stage->next, &out);
+}
+
+static int coords_drop_dimensions(struct PipelineStage* stage,
+                                  const struct GeoArrowCoordView* coords) {
+  enum GeoArrowDimensions dimensions = stage->dimensions[stage->level - 1];
+  if (coords->n_values == 3 && dimensions == GEOARROW_DIMENSIONS_UNKNOWN) {
+    dimensions = GEOARROW_DIMENSIONS_XYZ;
+  } else if (coords->n_values == 4) {
+    dimensions = GEOARROW_DIMENSIONS_XYZM;
+  }
+
+  // Only the value pointers change, so no coordinates are copied
+  struct GeoArrowCoordView out = *coords;
+  out.n_values = 2;
+  int32_t col = 2;
+  if (PipelineStageHasZ(dimensions)) {
+    if (stage->keep_z) {
+      out.values[out.n_values++] = coords->values[col];
+    }
+    col++;
+  }
+
+  if (PipelineStageHasM(dimensions) && stage->keep_m) {
+    out.values[out.n_values++] = coords->values[col];
+  }
+
+  return stage->next->coords(stage->next, &out);
+}
+
+static int coords_pipeline(struct GeoArrowVisitor* v,
+                           const struct GeoArrowCoordView* coords) {
+  struct PipelineStage* stage = (struct PipelineStage*)v->private_data;
+  if (stage->level < 1) {
+    ArrowErrorSet(PipelineStageError(stage), "Coordinates outside of a geometry");
+    return EINVAL;
+  }
+
+  switch (stage->type) {
+    case PIPELINE_STAGE_TRANSFORM:
+      return coords_transform(stage, coords);
+    case PIPELINE_STAGE_TEE:
+      NANOARROW_RETURN_NOT_OK(stage->other->coords(stage->other, coords));
+      break;
+    case PIPELINE_STAGE_DROP_DIMENSIONS:
+      return coords_drop_dimensions(stage, coords);
+    case PIPELINE_STAGE_FILTER_TYPE:
+      if (stage->skip_feat) {
+        return GEOARROW_OK;
+      }
+      break;
+    default:
+      break;
+  }
+
+  return stage->next->coords(stage->next, coords);
+}
+
+static int ring_end_pipeline(struct GeoArrowVisitor* v) {
+  struct PipelineStage* stage = (struct PipelineStage*)v->private_data;
+  if (stage->type == PIPELINE_STAGE_TEE) {
+    NANOARROW_RETURN_NOT_OK(stage->other->ring_end(stage->other));
+  } else if (PipelineStageSkip(stage)) {
+    return GEOARROW_OK;
+  }
+
+  return stage->next->ring_end(stage->next);
+}
+
+static int geom_end_pipeline(struct GeoArrowVisitor* v) {
+  struct PipelineStage* stage = (struct PipelineStage*)v->private_data;
+  stage->level--;
+  if (stage->type == PIPELINE_STAGE_TEE) {
+    NANOARROW_RETURN_NOT_OK(stage->other->geom_end(stage->other));
+  } else if (PipelineStageSkip(stage)) {
+    return GEOARROW_OK;
+  }
+
+  return stage->next->geom_end(stage->next);
+}
+
+static int feat_end_pipeline(struct GeoArrowVisitor* v) {
+  struct PipelineStage* stage = (struct PipelineStage*)v->private_data;
+  if (stage->type == PIPELINE_STAGE_TEE) {
+    NANOARROW_RETURN_NOT_OK(stage->other->feat_end(stage->other));
+  } else if (PipelineStageSkip(stage)) {
+    stage->skip_feat = 0;
+    return GEOARROW_OK;
+  }
+
+  // A feature with no geometry at all is kept
+  NANOARROW_RETURN_NOT_OK(PipelineStageFlushFeatStart(stage));
+  return stage->next->feat_end(stage->next);
+}
+
+GeoArrowErrorCode GeoArrowVisitorPipelineInit(struct GeoArrowVisitorPipeline* pipeline) {
+  struct PipelinePrivate* private =
+      (struct PipelinePrivate*)ArrowMalloc(sizeof(struct PipelinePrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct PipelinePrivate));
+  pipeline->private_data = private;
+  return GEOARROW_OK;
+}
+
+static GeoArrowErrorCode GeoArrowVisitorPipelineAppendStage(
+    struct GeoArrowVisitorPipeline* pipeline, enum PipelineStageType type,
+    struct PipelineStage** stage_out) {
+  struct PipelinePrivate* private = (struct PipelinePrivate*)pipeline->private_data;
+  if (private->initialized) {
+    return EINVAL;
+  }
+
+  struct PipelineStage* stages = (struct PipelineStage*)ArrowRealloc(
+      private->stages, (private->n_stages + 1) * sizeof(struct PipelineStage));
+  if (stages == NULL) {
+    return ENOMEM;
+  }
+
+  private->stages = stages;
+  struct PipelineStage* stage = stages + private->n_stages++;
+  memset(stage, 0, sizeof(struct PipelineStage));
+  stage->type = type;
+  ArrowBufferInit(&stage->scratch);
+  *stage_out = stage;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowVisitorPipelineAppendTransform(
+    struct GeoArrowVisitorPipeline* pipeline, const struct GeoArrowAffine* affine) {
+  struct PipelineStage* stage;
+  NANOARROW_RETURN_NOT_OK(
+      GeoArrowVisitorPipelineAppendStage(pipeline, PIPELINE_STAGE_TRANSFORM, &stage));
+  stage->affine = *affine;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowVisitorPipelineAppendTee(
+    struct GeoArrowVisitorPipeline* pipeline, struct GeoArrowVisitor* other) {
+  struct PipelineStage* stage;
+  NANOARROW_RETURN_NOT_OK(
+      GeoArrowVisitorPipelineAppendStage(pipeline, PIPELINE_STAGE_TEE, &stage));
+  stage->other = other;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowVisitorPipelineAppendDropDimensions(
+    struct GeoArrowVisitorPipeline* pipeline, enum GeoArrowDimensions dimensions) {
+  switch (dimensions) {
+    case GEOARROW_DIMENSIONS_XY:
+    case GEOARROW_DIMENSIONS_XYZ:
+    case GEOARROW_DIMENSIONS_XYM:
+    case GEOARROW_DIMENSIONS_XYZM:
+      break;
+    default:
+      return EINVAL;
+  }
+
+  struct PipelineStage* stage;
+  NANOARROW_RETURN_NOT_OK(GeoArrowVisitorPipelineAppendStage(
+      pipeline, PIPELINE_STAGE_DROP_DIMENSIONS, &stage));
+  stage->keep_z = PipelineStageHasZ(dimensions);
+  stage->keep_m = PipelineStageHasM(dimensions);
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowVisitorPipelineAppendFilterType(
+    struct GeoArrowVisitorPipeline* pipeline, const enum GeoArrowGeometryType* types,
+    int64_t n_types) {
+  uint32_t geometry_types = 0;
+  for (int64_t i = 0; i < n_types; i++) {
+    if (types[i] < GEOARROW_GEOMETRY_TYPE_GEOMETRY ||
+        types[i] > GEOARROW_GEOMETRY_TYPE_GEOMETRYCOLLECTION) {
+      return EINVAL;
+    }
+
+    geometry_types |= UINT32_C(1) << types[i];
+  }
+
+  struct PipelineStage* stage;
+  NANOARROW_RETURN_NOT_OK(
+      GeoArrowVisitorPipelineAppendStage(pipeline, PIPELINE_STAGE_FILTER_TYPE, &stage));
+  stage->geometry_types = geometry_types;
+  return GEOARROW_OK;
+}
+
+static void GeoArrowVisitorPipelineInitStageVisitor(struct PipelineStage* stage,
+                                                    struct GeoArrowVisitor* v) {
+  GeoArrowVisitorInitVoid(v);
+  v->reserve_coord = &reserve_coord_pipeline;
+  v->reserve_feat = &reserve_feat_pipeline;
+  v->feat_start = &feat_start_pipeline;
+  v->null_feat = &null_feat_pipeline;
+  v->geom_start = &geom_start_pipeline;
+  v->ring_start = &ring_start_pipeline;
+  v->coords = &coords_pipeline;
+  v->ring_end = &ring_end_pipeline;
+  v->geom_end = &geom_end_pipeline;
+  v->feat_end = &feat_end_pipeline;
+  v->private_data = stage;
+}
+
+void GeoArrowVisitorPipelineInitVisitor(struct GeoArrowVisitorPipeline* pipeline,
+                                        struct GeoArrowVisitor* sink,
+                                        struct GeoArrowVisitor* v) {
+  struct PipelinePrivate* private = (struct PipelinePrivate*)pipeline->private_data;
+  private->initialized = 1;
+  private->sink = sink;
+  if (private->n_stages == 0) {
+    memcpy(v, sink, sizeof(struct GeoArrowVisitor));
+    return;
+  }
+
+  // Wired from the sink backwards so that each stage's next is already initialized
+  struct GeoArrowVisitor* next = sink;
+  for (int64_t i = private->n_stages - 1; i >= 0; i--) {
+    struct PipelineStage* stage = private->stages + i;
+    stage->pipeline = private;
+    stage->next = next;
+    stage->level = 0;
+    stage->feat_pending = 0;
+    stage->skip_feat = 0;
+    GeoArrowVisitorPipelineInitStageVisitor(stage, &stage->v);
+    next = &stage->v;
+  }
+
+  GeoArrowVisitorPipelineInitStageVisitor(private->stages, v);
+}
+
+void GeoArrowVisitorPipelineReset(struct GeoArrowVisitorPipeline* pipeline) {
+  struct PipelinePrivate* private = (struct PipelinePrivate*)pipeline->private_data;
+  for (int64_t i = 0; i < private->n_stages; i++) {
+    ArrowBufferReset(&private->stages[i].scratch);
+  }
+
+  if (private->stages != NULL) {
+    ArrowFree(private->stages);
+  }
+
+  ArrowFree(private);
+}
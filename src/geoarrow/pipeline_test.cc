@@ -0,0 +1,223 @@
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+TEST(PipelineTest, PipelineTestEmpty) {
+  struct GeoArrowVisitorPipeline pipeline;
+  ASSERT_EQ(GeoArrowVisitorPipelineInit(&pipeline), GEOARROW_OK);
+
+  WKXTester tester;
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorPipelineInitVisitor(&pipeline, tester.WKTVisitor(), &v);
+  VisitWKT(&v, {"POINT (0 1)", "", "LINESTRING (1 2, 3 4)"});
+  EXPECT_EQ(tester.WKTValues("<null value>"),
+            std::vector<std::string>(
+                {"POINT (0 1)", "<null value>", "LINESTRING (1 2, 3 4)"}));
+
+  GeoArrowVisitorPipelineReset(&pipeline);
+}
+
+TEST(PipelineTest, PipelineTestTransform) {
+  struct GeoArrowVisitorPipeline pipeline;
+  ASSERT_EQ(GeoArrowVisitorPipelineInit(&pipeline), GEOARROW_OK);
+
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  affine.matrix[0][3] = 10;
+  affine.matrix[2][2] = 2;
+  ASSERT_EQ(GeoArrowVisitorPipelineAppendTransform(&pipeline, &affine), GEOARROW_OK);
+
+  // Swap x and y; the two transforms are applied in order
+  GeoArrowAffineInitIdentity(&affine);
+  affine.matrix[0][0] = 0;
+  affine.matrix[0][1] = 1;
+  affine.matrix[1][0] = 1;
+  affine.matrix[1][1] = 0;
+  ASSERT_EQ(GeoArrowVisitorPipelineAppendTransform(&pipeline, &affine), GEOARROW_OK);
+
+  WKXTester tester;
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorPipelineInitVisitor(&pipeline, tester.WKTVisitor(), &v);
+  VisitWKT(&v, {"POINT (0 1)", "LINESTRING Z (1 2 3, 4 5 6)", "POINT M (1 2 3)",
+                "POLYGON ((0 0, 1 0, 0 1, 0 0))", ""});
+  EXPECT_EQ(tester.WKTValues("<null value>"),
+            std::vector<std::string>({"POINT (1 10)", "LINESTRING Z (2 11 6, 5 14 12)",
+                                      "POINT M (2 11 3)",
+                                      "POLYGON ((0 10, 0 11, 1 10, 0 10))",
+                                      "<null value>"}));
+
+  GeoArrowVisitorPipelineReset(&pipeline);
+}
+
+TEST(PipelineTest, PipelineTestTee) {
+  struct GeoArrowVisitorPipeline pipeline;
+  ASSERT_EQ(GeoArrowVisitorPipelineInit(&pipeline), GEOARROW_OK);
+
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  affine.matrix[0][0] = 2;
+
+  // The tee sees the coordinates before the transform; the sink sees them after
+  WKXTester before;
+  ASSERT_EQ(GeoArrowVisitorPipelineAppendTee(&pipeline, before.WKTVisitor()),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowVisitorPipelineAppendTransform(&pipeline, &affine), GEOARROW_OK);
+
+  WKXTester after;
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorPipelineInitVisitor(&pipeline, after.WKTVisitor(), &v);
+  VisitWKT(&v, {"MULTIPOINT ((1 2), (3 4))", ""});
+  EXPECT_EQ(before.WKTValues("<null value>"),
+            std::vector<std::string>({"MULTIPOINT ((1 2), (3 4))", "<null value>"}));
+  EXPECT_EQ(after.WKTValues("<null value>"),
+            std::vector<std::string>({"MULTIPOINT ((2 2), (6 4))", "<null value>"}));
+
+  GeoArrowVisitorPipelineReset(&pipeline);
+}
+
+TEST(PipelineTest, PipelineTestDropDimensions) {
+  struct GeoArrowVisitorPipeline pipeline;
+  ASSERT_EQ(GeoArrowVisitorPipelineInit(&pipeline), GEOARROW_OK);
+  ASSERT_EQ(
+      GeoArrowVisitorPipelineAppendDropDimensions(&pipeline, GEOARROW_DIMENSIONS_XYM),
+      GEOARROW_OK);
+
+  WKXTester tester;
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorPipelineInitVisitor(&pipeline, tester.WKTVisitor(), &v);
+  VisitWKT(&v, {"POINT ZM (1 2 3 4)", "POINT Z (1 2 3)", "POINT M (1 2 4)",
+                "GEOMETRYCOLLECTION (POINT ZM (1 2 3 4), LINESTRING (0 0, 1 1))"});
+  EXPECT_EQ(tester.WKTValues(),
+            std::vector<std::string>(
+                {"POINT M (1 2 4)", "POINT (1 2)", "POINT M (1 2 4)",
+                 "GEOMETRYCOLLECTION (POINT M (1 2 4), LINESTRING (0 0, 1 1))"}));
+  GeoArrowVisitorPipelineReset(&pipeline);
+
+  EXPECT_EQ(GeoArrowVisitorPipelineInit(&pipeline), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowVisitorPipelineAppendDropDimensions(&pipeline,
+                                                         GEOARROW_DIMENSIONS_UNKNOWN),
+            EINVAL);
+  GeoArrowVisitorPipelineReset(&pipeline);
+}
+
+TEST(PipelineTest, PipelineTestFilterType) {
+  struct GeoArrowVisitorPipeline pipeline;
+  ASSERT_EQ(GeoArrowVisitorPipelineInit(&pipeline), GEOARROW_OK);
+
+  enum GeoArrowGeometryType types[] = {GEOARROW_GEOMETRY_TYPE_POINT,
+                                       GEOARROW_GEOMETRY_TYPE_POLYGON};
+  ASSERT_EQ(GeoArrowVisitorPipelineAppendFilterType(&pipeline, types, 2), GEOARROW_OK);
+
+  WKXTester tester;
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorPipelineInitVisitor(&pipeline, tester.WKTVisitor(), &v);
+  VisitWKT(&v, {"POINT (0 1)", "LINESTRING (1 2, 3 4)", "",
+                "GEOMETRYCOLLECTION (POINT (0 1))", "POLYGON ((0 0, 1 0, 0 1, 0 0))",
+                "POINT EMPTY"});
+  EXPECT_EQ(tester.WKTValues("<null value>"),
+            std::vector<std::string>({"POINT (0 1)", "<null value>",
+                                      "POLYGON ((0 0, 1 0, 0 1, 0 0))", "POINT EMPTY"}));
+  GeoArrowVisitorPipelineReset(&pipeline);
+
+  enum GeoArrowGeometryType invalid = static_cast<enum GeoArrowGeometryType>(100);
+  ASSERT_EQ(GeoArrowVisitorPipelineInit(&pipeline), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowVisitorPipelineAppendFilterType(&pipeline, &invalid, 1), EINVAL);
+  GeoArrowVisitorPipelineReset(&pipeline);
+}
+
+TEST(PipelineTest, PipelineTestErrors) {
+  struct GeoArrowVisitorPipeline pipeline;
+  struct GeoArrowVisitor other;
+  GeoArrowVisitorInitVoid(&other);
+  ASSERT_EQ(GeoArrowVisitorPipelineInit(&pipeline), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowVisitorPipelineAppendTee(&pipeline, &other), GEOARROW_OK);
+  ASSERT_EQ(
+      GeoArrowVisitorPipelineAppendDropDimensions(&pipeline, GEOARROW_DIMENSIONS_XY),
+      GEOARROW_OK);
+
+  struct GeoArrowVisitor sink;
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorInitVoid(&sink);
+  GeoArrowVisitorPipelineInitVisitor(&pipeline, &sink, &v);
+
+  // The stages point to each other once the visitor is initialized
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  EXPECT_EQ(GeoArrowVisitorPipelineAppendTransform(&pipeline, &affine), EINVAL);
+
+  // Errors go to the sink's error even if it is set after initialization
+  struct GeoArrowError error;
+  error.message[0] = '\0';
+  sink.error = &error;
+  struct GeoArrowCoordView coords;
+  memset(&coords, 0, sizeof(coords));
+  coords.n_values = 2;
+  ASSERT_EQ(v.feat_start(&v), GEOARROW_OK);
+  EXPECT_EQ(v.coords(&v, &coords), EINVAL);
+  EXPECT_STREQ(error.message, "Coordinates outside of a geometry");
+
+  GeoArrowVisitorPipelineReset(&pipeline);
+}
+
+TEST(PipelineTest, PipelineTestWKBToNative) {
+  // Read WKB, keep linestrings, drop z, transform, and build a native array in a
+  // single traversal of the input
+  WKXTester tester;
+  std::vector<std::basic_string<uint8_t>> wkbs = {
+      tester.AsWKB("LINESTRING Z (0 0 1, 1 1 2)"), tester.AsWKB("POINT (0 0)"),
+      tester.AsWKB("LINESTRING (2 2, 3 3)")};
+
+  struct GeoArrowVisitorPipeline pipeline;
+  ASSERT_EQ(GeoArrowVisitorPipelineInit(&pipeline), GEOARROW_OK);
+  enum GeoArrowGeometryType type = GEOARROW_GEOMETRY_TYPE_LINESTRING;
+  ASSERT_EQ(GeoArrowVisitorPipelineAppendFilterType(&pipeline, &type, 1), GEOARROW_OK);
+  ASSERT_EQ(
+      GeoArrowVisitorPipelineAppendDropDimensions(&pipeline, GEOARROW_DIMENSIONS_XY),
+      GEOARROW_OK);
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  affine.matrix[1][3] = -1;
+  ASSERT_EQ(GeoArrowVisitorPipelineAppendTransform(&pipeline, &affine), GEOARROW_OK);
+
+  struct GeoArrowBuilder builder;
+  struct GeoArrowVisitor sink;
+  struct GeoArrowVisitor v;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  GeoArrowBuilderInitVisitor(&builder, &sink);
+  sink.error = &error;
+  GeoArrowVisitorPipelineInitVisitor(&pipeline, &sink, &v);
+  v.error = &error;
+
+  // Coordinates in WKB start at an odd offset, so the transform stage sees
+  // unaligned pointers
+  struct GeoArrowWKBReader reader;
+  GeoArrowWKBReaderInit(&reader);
+  reader.use_unaligned_coords = 1;
+  for (const auto& wkb : wkbs) {
+    struct GeoArrowBufferView item = {wkb.data(), (int64_t)wkb.size()};
+    ASSERT_EQ(GeoArrowWKBReaderVisit(&reader, item, &v), GEOARROW_OK) << error.message;
+  }
+  GeoArrowWKBReaderReset(&reader);
+  GeoArrowVisitorPipelineReset(&pipeline);
+
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array, &error), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+  WKXTester out;
+  EXPECT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array.length, out.WKTVisitor()),
+            GEOARROW_OK);
+  EXPECT_EQ(out.WKTValues(), std::vector<std::string>({"LINESTRING (0 -1, 1 0)",
+                                                      "LINESTRING (2 1, 3 2)"}));
+  array.release(&array);
+}
@@ -0,0 +1,150 @@
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "geoarrow.h"
+
+#include "nanoarrow.h"
+
+#include "cpu_features.h"
+
+// x86 builds select a vectorized rounding loop at runtime
+#if defined(GEOARROW_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
+typedef void (*GeoArrowSnapFn)(double* values, int64_t n, double scale, double offset);
+
+// nearbyint() and the _MM_FROUND_TO_NEAREST_INT intrinsics both round halfway
+// cases to even, so every implementation snaps to the same grid point
+static void GeoArrowSnapScalar(double* values, int64_t n, double scale, double offset) {
+  for (int64_t i = 0; i < n; i++) {
+    values[i] = nearbyint((values[i] - offset) * scale) / scale + offset;
+  }
+}
+
+#if defined(GEOARROW_X86_DISPATCH)
+__attribute__((target("sse4.1"))) static void GeoArrowSnapSSE41(double* values,
+                                                                int64_t n, double scale,
+                                                                double offset) {
+  const __m128d scale_v = _mm_set1_pd(scale);
+  const __m128d offset_v = _mm_set1_pd(offset);
+  int64_t i = 0;
+  for (; (i + 2) <= n; i += 2) {
+    __m128d value = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(values + i), offset_v), scale_v);
+    value = _mm_round_pd(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm_storeu_pd(values + i, _mm_add_pd(_mm_div_pd(value, scale_v), offset_v));
+  }
+
+  GeoArrowSnapScalar(values + i, n - i, scale, offset);
+}
+
+__attribute__((target("avx"))) static void GeoArrowSnapAVX(double* values, int64_t n,
+                                                            double scale, double offset) {
+  const __m256d scale_v = _mm256_set1_pd(scale);
+  const __m256d offset_v = _mm256_set1_pd(offset);
+  int64_t i = 0;
+  for (; (i + 4) <= n; i += 4) {
+    __m256d value =
+        _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(values + i), offset_v), scale_v);
+    value = _mm256_round_pd(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm256_storeu_pd(values + i, _mm256_add_pd(_mm256_div_pd(value, scale_v), offset_v));
+  }
+
+  GeoArrowSnapScalar(values + i, n - i, scale, offset);
+}
+#endif
+
+static GeoArrowSnapFn GeoArrowResolveSnap(void) {
+#if defined(GEOARROW_X86_DISPATCH)
+  int features = GeoArrowCpuFeatures();
+  if (features & GEOARROW_CPU_AVX) {
+    return &GeoArrowSnapAVX;
+  } else if (features & GEOARROW_CPU_SSE41) {
+    return &GeoArrowSnapSSE41;
+  }
+#endif
+
+  return &GeoArrowSnapScalar;
+}
+
+void GeoArrowGridInitDecimal(struct GeoArrowGrid* grid, int decimal_places) {
+  double scale = pow(10, decimal_places);
+  for (int i = 0; i < 4; i++) {
+    grid->scale[i] = scale;
+    grid->offset[i] = 0;
+  }
+}
+
+GeoArrowErrorCode GeoArrowWritableArrayViewSnapToGrid(
+    struct GeoArrowWritableArrayView* writable_view, const struct GeoArrowGrid* grid) {
+  switch (writable_view->schema_view.coord_type) {
+    case GEOARROW_COORD_TYPE_SEPARATE:
+      break;
+    default:
+      return ENOTSUP;
+  }
+
+  GeoArrowSnapFn snap = GeoArrowResolveSnap();
+
+  // The coordinate buffers are always the last n_values buffers
+  int32_t n_values = writable_view->coords.n_values;
+  for (int32_t j = 0; j < n_values; j++) {
+    struct GeoArrowWritableBufferView* buffer =
+        writable_view->buffers + writable_view->n_buffers - n_values + j;
+    snap(buffer->data.as_double, buffer->size_bytes / sizeof(double), grid->scale[j],
+         grid->offset[j]);
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowCoordViewQuantize(const struct GeoArrowCoordView* coords,
+                                            const struct GeoArrowGrid* grid,
+                                            int32_t** out, struct GeoArrowError* error) {
+  for (int32_t j = 0; j < coords->n_values; j++) {
+    double scale = grid->scale[j];
+    double offset = grid->offset[j];
+    int32_t* out_j = out[j];
+
+    for (int64_t i = 0; i < coords->n_coords; i++) {
+      double value = GeoArrowCoordViewValueUnaligned(coords, i, j);
+      if (isnan(value)) {
+        out_j[i] = GEOARROW_QUANTIZED_NAN;
+        continue;
+      }
+
+      double step = nearbyint((value - offset) * scale);
+      if (!(step > GEOARROW_QUANTIZED_NAN && step <= INT32_MAX)) {
+        ArrowErrorSet((struct ArrowError*)error,
+                      "Coordinate value %g in dimension %d is outside the range of "
+                      "the grid",
+                      value, (int)j);
+        return ERANGE;
+      }
+
+      out_j[i] = (int32_t)step;
+    }
+  }
+
+  return GEOARROW_OK;
+}
+
+void GeoArrowDequantize(const int32_t* const* values, int64_t n_coords, int32_t n_values,
+                        const struct GeoArrowGrid* grid, double** out) {
+  for (int32_t j = 0; j < n_values; j++) {
+    double scale = grid->scale[j];
+    double offset = grid->offset[j];
+    const int32_t* values_j = values[j];
+    double* out_j = out[j];
+
+    for (int64_t i = 0; i < n_coords; i++) {
+      if (values_j[i] == GEOARROW_QUANTIZED_NAN) {
+        out_j[i] = NAN;
+      } else {
+        out_j[i] = values_j[i] / scale + offset;
+      }
+    }
+  }
+}
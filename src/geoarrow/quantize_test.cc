@@ -0,0 +1,144 @@
+
+#include <cmath>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+static std::vector<std::string> FinishToWKT(struct GeoArrowBuilder* builder) {
+  struct ArrowArray array;
+  EXPECT_EQ(GeoArrowBuilderFinish(builder, &array, nullptr), GEOARROW_OK);
+
+  struct GeoArrowArrayView array_view;
+  EXPECT_EQ(GeoArrowArrayViewInitFromType(&array_view, builder->view.schema_view.type),
+            GEOARROW_OK);
+  EXPECT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  WKXTester tester;
+  EXPECT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  array.release(&array);
+  return tester.WKTValues("<null value>");
+}
+
+TEST(QuantizeTest, QuantizeTestGridInitDecimal) {
+  struct GeoArrowGrid grid;
+  GeoArrowGridInitDecimal(&grid, 3);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(grid.scale[i], 1000);
+    EXPECT_EQ(grid.offset[i], 0);
+  }
+
+  GeoArrowGridInitDecimal(&grid, -2);
+  EXPECT_EQ(grid.scale[0], 0.01);
+}
+
+TEST(QuantizeTest, QuantizeTestSnapToGrid) {
+  struct GeoArrowBuilder builder;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  BuildFromWKT(&builder, {"LINESTRING (0.123456 1.987654, -2.5 3.45)",
+                          "LINESTRING (10.0049 -0.001, 1 2, 3 4)"});
+
+  struct GeoArrowGrid grid;
+  GeoArrowGridInitDecimal(&grid, 2);
+  ASSERT_EQ(GeoArrowWritableArrayViewSnapToGrid(&builder.view, &grid), GEOARROW_OK);
+  EXPECT_EQ(FinishToWKT(&builder),
+            std::vector<std::string>(
+                {"LINESTRING (0.12 1.99, -2.5 3.45)", "LINESTRING (10 0, 1 2, 3 4)"}));
+
+  // A grid with steps of 2 starting at 1 in x and steps of 0.5 in y
+  grid.scale[0] = 0.5;
+  grid.offset[0] = 1;
+  grid.scale[1] = 2;
+  grid.offset[1] = 0;
+  BuildFromWKT(&builder, {"LINESTRING (4 0.2, 6.2 0.8, -1.2 -0.3)"});
+  ASSERT_EQ(GeoArrowWritableArrayViewSnapToGrid(&builder.view, &grid), GEOARROW_OK);
+  EXPECT_EQ(FinishToWKT(&builder),
+            std::vector<std::string>({"LINESTRING (5 0, 7 1, -1 -0.5)"}));
+
+  GeoArrowBuilderReset(&builder);
+}
+
+TEST(QuantizeTest, QuantizeTestSnapToGridMany) {
+  // Enough values to exercise both the vectorized loop and the scalar remainder
+  std::vector<std::string> wkts;
+  std::vector<double> expected;
+  std::string wkt = "MULTIPOINT Z (";
+  for (int i = 0; i < 1023; i++) {
+    std::string value = std::to_string((i - 511) * 0.0137);
+    expected.push_back(std::nearbyint(std::stod(value) * 10) / 10);
+    if (i > 0) {
+      wkt += ", ";
+    }
+    wkt += value + " " + value + " " + value;
+  }
+  wkts.push_back(wkt + ")");
+
+  struct GeoArrowBuilder builder;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_MULTIPOINT_Z),
+            GEOARROW_OK);
+  BuildFromWKT(&builder, wkts);
+
+  struct GeoArrowGrid grid;
+  GeoArrowGridInitDecimal(&grid, 1);
+  ASSERT_EQ(GeoArrowWritableArrayViewSnapToGrid(&builder.view, &grid), GEOARROW_OK);
+
+  for (int64_t j = 0; j < 3; j++) {
+    struct GeoArrowWritableBufferView* buffer = builder.view.buffers + 2 + j;
+    ASSERT_EQ(buffer->size_bytes / sizeof(double), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+      ASSERT_EQ(buffer->data.as_double[i], expected[i]) << "value " << i;
+    }
+  }
+
+  GeoArrowBuilderReset(&builder);
+}
+
+TEST(QuantizeTest, QuantizeTestQuantizeRoundtrip) {
+  double x[] = {0.123, -45.678, NAN, 1e-9};
+  double y[] = {10, 20.5, NAN, -0.0049};
+  struct GeoArrowCoordView coords;
+  coords.values[0] = x;
+  coords.values[1] = y;
+  coords.n_coords = 4;
+  coords.n_values = 2;
+  coords.coords_stride = 1;
+
+  struct GeoArrowGrid grid;
+  GeoArrowGridInitDecimal(&grid, 2);
+  grid.offset[1] = 10;
+
+  int32_t qx[4];
+  int32_t qy[4];
+  int32_t* quantized[] = {qx, qy};
+  ASSERT_EQ(GeoArrowCoordViewQuantize(&coords, &grid, quantized, nullptr), GEOARROW_OK);
+  EXPECT_EQ(std::vector<int32_t>(qx, qx + 4),
+            std::vector<int32_t>({12, -4568, GEOARROW_QUANTIZED_NAN, 0}));
+  EXPECT_EQ(std::vector<int32_t>(qy, qy + 4),
+            std::vector<int32_t>({0, 1050, GEOARROW_QUANTIZED_NAN, -1000}));
+
+  double x_out[4];
+  double y_out[4];
+  double* dequantized[] = {x_out, y_out};
+  GeoArrowDequantize(quantized, 4, 2, &grid, dequantized);
+  EXPECT_EQ(x_out[0], 0.12);
+  EXPECT_EQ(x_out[1], -45.68);
+  EXPECT_TRUE(std::isnan(x_out[2]));
+  EXPECT_EQ(x_out[3], 0);
+  EXPECT_EQ(y_out[0], 10);
+  EXPECT_EQ(y_out[1], 20.5);
+  EXPECT_TRUE(std::isnan(y_out[2]));
+  EXPECT_EQ(y_out[3], 0);
+
+  // Values that don't fit in an int32 number of steps
+  x[0] = 1e8;
+  struct GeoArrowError error;
+  EXPECT_EQ(GeoArrowCoordViewQuantize(&coords, &grid, quantized, &error), ERANGE);
+  EXPECT_STREQ(error.message,
+               "Coordinate value 1e+08 in dimension 0 is outside the range of the grid");
+}
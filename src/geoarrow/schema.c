@@ -1,5 +1,6 @@
 
 #include <errno.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "nanoarrow.h"
@@ -46,6 +47,35 @@ static GeoArrowErrorCode GeoArrowSchemaInitListStruct(struct ArrowSchema* schema
 #define CHILD_NAMES_MULTIPOLYGON \
   (const char*[]) { "polygons", "rings", "vertices" }
 
+// A dense union with one child for each native geometry type with dimensions, in
+// geometry type order
+static GeoArrowErrorCode GeoArrowSchemaInitUnion(struct ArrowSchema* schema,
+                                                 enum GeoArrowDimensions dimensions) {
+  static const char* child_names[] = {"point",      "linestring",      "polygon",
+                                      "multipoint", "multilinestring", "multipolygon"};
+
+  char format[32];
+  int n_chars = snprintf(format, sizeof(format), "+ud:");
+  for (int i = 0; i < 6; i++) {
+    n_chars += snprintf(format + n_chars, sizeof(format) - n_chars, i == 0 ? "%d" : ",%d",
+                        (int)GeoArrowUnionTypeId(GEOARROW_GEOMETRY_TYPE_POINT + i,
+                                                 dimensions));
+  }
+
+  NANOARROW_RETURN_NOT_OK(ArrowSchemaInit(schema, NANOARROW_TYPE_UNINITIALIZED));
+  NANOARROW_RETURN_NOT_OK(ArrowSchemaSetFormat(schema, format));
+  NANOARROW_RETURN_NOT_OK(ArrowSchemaAllocateChildren(schema, 6));
+  for (int i = 0; i < 6; i++) {
+    enum GeoArrowType child_type = GeoArrowMakeType(GEOARROW_GEOMETRY_TYPE_POINT + i,
+                                                    dimensions,
+                                                    GEOARROW_COORD_TYPE_SEPARATE);
+    NANOARROW_RETURN_NOT_OK(GeoArrowSchemaInit(schema->children[i], child_type));
+    NANOARROW_RETURN_NOT_OK(ArrowSchemaSetName(schema->children[i], child_names[i]));
+  }
+
+  return GEOARROW_OK;
+}
+
 GeoArrowErrorCode GeoArrowSchemaInit(struct ArrowSchema* schema, enum GeoArrowType type) {
   schema->release = NULL;
 
@@ -54,6 +84,10 @@ GeoArrowErrorCode GeoArrowSchemaInit(struct ArrowSchema* schema, enum GeoArrowTy
       return ArrowSchemaInit(schema, NANOARROW_TYPE_BINARY);
     case GEOARROW_TYPE_LARGE_WKB:
       return ArrowSchemaInit(schema, NANOARROW_TYPE_LARGE_BINARY);
+    case GEOARROW_TYPE_WKT:
+      return ArrowSchemaInit(schema, NANOARROW_TYPE_STRING);
+    case GEOARROW_TYPE_LARGE_WKT:
+      return ArrowSchemaInit(schema, NANOARROW_TYPE_LARGE_STRING);
 
     case GEOARROW_TYPE_POINT:
       return GeoArrowSchemaInitCoordStruct(schema, "xy");
@@ -107,6 +141,12 @@ GeoArrowErrorCode GeoArrowSchemaInit(struct ArrowSchema* schema, enum GeoArrowTy
     case GEOARROW_TYPE_MULTIPOLYGON_ZM:
       return GeoArrowSchemaInitListStruct(schema, "xyzm", 3, CHILD_NAMES_MULTIPOLYGON);
 
+    case GEOARROW_TYPE_GEOMETRY:
+    case GEOARROW_TYPE_GEOMETRY_Z:
+    case GEOARROW_TYPE_GEOMETRY_M:
+    case GEOARROW_TYPE_GEOMETRY_ZM:
+      return GeoArrowSchemaInitUnion(schema, GeoArrowDimensionsFromType(type));
+
     default:
       break;
   }
@@ -1,6 +1,7 @@
 
 #include <errno.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "geoarrow.h"
@@ -80,6 +81,74 @@ static GeoArrowErrorCode GeoArrowParseNestedSchema(struct ArrowSchema* schema, i
   }
 }
 
+// Parses a dense union whose type ids are geometry_type + 10 * (dimensions - 1) and
+// whose children are native arrays of the corresponding type
+static GeoArrowErrorCode GeoArrowParseUnionSchema(struct ArrowSchema* schema,
+                                                  struct ArrowSchemaView* na_schema_view,
+                                                  struct GeoArrowSchemaView* schema_view,
+                                                  struct ArrowError* error) {
+  static const int n_nested[] = {-1, 0, 1, 2, 1, 2, 3};
+
+  if (na_schema_view->data_type != NANOARROW_TYPE_DENSE_UNION) {
+    ArrowErrorSet(error,
+                  "Expected storage type dense union for extension 'geoarrow.geometry'");
+    return EINVAL;
+  }
+
+  if (schema->n_children < 1 || schema->n_children > 6) {
+    ArrowErrorSet(error,
+                  "Expected 1 to 6 children for extension 'geoarrow.geometry' but got %d",
+                  (int)schema->n_children);
+    return EINVAL;
+  }
+
+  const char* type_ids = na_schema_view->union_type_ids.data;
+  const char* type_ids_end = type_ids + na_schema_view->union_type_ids.n_bytes;
+  struct GeoArrowSchemaView child_view;
+  schema_view->dimensions = GEOARROW_DIMENSIONS_UNKNOWN;
+
+  for (int64_t i = 0; i < schema->n_children; i++) {
+    char* end = (char*)type_ids;
+    long type_id = type_ids < type_ids_end ? strtol(type_ids, &end, 10) : 0;
+    if (end == type_ids || type_id < 1 || type_id > 36 ||
+        (type_id % 10) < 1 || (type_id % 10) > 6) {
+      ArrowErrorSet(error,
+                    "Expected type id of child %d for extension 'geoarrow.geometry' to "
+                    "be a native geometry type",
+                    (int)i);
+      return EINVAL;
+    }
+
+    type_ids = end + 1;
+    enum GeoArrowDimensions dimensions = (enum GeoArrowDimensions)(type_id / 10 + 1);
+    if (schema_view->dimensions != GEOARROW_DIMENSIONS_UNKNOWN &&
+        dimensions != schema_view->dimensions) {
+      ArrowErrorSet(error,
+                    "Expected all children for extension 'geoarrow.geometry' to have the "
+                    "same dimensions");
+      return EINVAL;
+    }
+
+    NANOARROW_RETURN_NOT_OK(GeoArrowParseNestedSchema(
+        schema->children[i], n_nested[type_id % 10], &child_view, error,
+        "geoarrow.geometry"));
+    if (child_view.dimensions != dimensions) {
+      ArrowErrorSet(error,
+                    "Expected dimensions of child %d for extension 'geoarrow.geometry' "
+                    "to match its type id %d",
+                    (int)i, (int)type_id);
+      return EINVAL;
+    }
+
+    schema_view->dimensions = dimensions;
+  }
+
+  schema_view->geometry_type = GEOARROW_GEOMETRY_TYPE_GEOMETRY;
+  schema_view->coord_type = GEOARROW_COORD_TYPE_SEPARATE;
+  schema_view->type = GeoArrowMakeUnionType(schema_view->dimensions);
+  return GEOARROW_OK;
+}
+
 static GeoArrowErrorCode GeoArrowSchemaViewInitInternal(
     struct GeoArrowSchemaView* schema_view, struct ArrowSchema* schema,
     struct ArrowSchemaView* na_schema_view, struct ArrowError* na_error) {
@@ -122,6 +191,9 @@ static GeoArrowErrorCode GeoArrowSchemaViewInitInternal(
                                                       "geoarrow.multipolygon"));
     schema_view->type = GeoArrowMakeType(
         schema_view->geometry_type, schema_view->dimensions, schema_view->coord_type);
+  } else if (ext_len >= 17 && strncmp(ext_name, "geoarrow.geometry", 17) == 0) {
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowParseUnionSchema(schema, na_schema_view, schema_view, na_error));
   } else if (ext_len >= 12 && strncmp(ext_name, "geoarrow.wkb", 12) == 0) {
     switch (na_schema_view->data_type) {
       case NANOARROW_TYPE_BINARY:
@@ -137,6 +209,24 @@ static GeoArrowErrorCode GeoArrowSchemaViewInitInternal(
         return EINVAL;
     }
 
+    schema_view->geometry_type = GeoArrowGeometryTypeFromType(schema_view->type);
+    schema_view->dimensions = GeoArrowDimensionsFromType(schema_view->type);
+    schema_view->coord_type = GeoArrowCoordTypeFromType(schema_view->type);
+  } else if (ext_len >= 12 && strncmp(ext_name, "geoarrow.wkt", 12) == 0) {
+    switch (na_schema_view->data_type) {
+      case NANOARROW_TYPE_STRING:
+        schema_view->type = GEOARROW_TYPE_WKT;
+        break;
+      case NANOARROW_TYPE_LARGE_STRING:
+        schema_view->type = GEOARROW_TYPE_LARGE_WKT;
+        break;
+      default:
+        ArrowErrorSet(na_error,
+                      "Expected storage type of string or large_string for extension "
+                      "'geoarrow.wkt'");
+        return EINVAL;
+    }
+
     schema_view->geometry_type = GeoArrowGeometryTypeFromType(schema_view->type);
     schema_view->dimensions = GeoArrowDimensionsFromType(schema_view->type);
     schema_view->coord_type = GeoArrowCoordTypeFromType(schema_view->type);
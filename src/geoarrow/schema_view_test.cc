@@ -61,6 +61,20 @@ TEST(SchemaViewTest, SchemaViewTestInitFromStorage) {
   schema.release(&schema);
 }
 
+TEST(SchemaViewTest, SchemaViewTestTypeValuesAreStable) {
+  // Callers may store or pass enum GeoArrowType values as integers
+  EXPECT_EQ(GEOARROW_TYPE_WKB, 1);
+  EXPECT_EQ(GEOARROW_TYPE_LARGE_WKB, 2);
+  EXPECT_EQ(GEOARROW_TYPE_POINT, 3);
+  EXPECT_EQ(GEOARROW_TYPE_MULTIPOLYGON, 8);
+  EXPECT_EQ(GEOARROW_TYPE_POINT_Z, 9);
+  EXPECT_EQ(GEOARROW_TYPE_POINT_M, 15);
+  EXPECT_EQ(GEOARROW_TYPE_POINT_ZM, 21);
+  EXPECT_EQ(GEOARROW_TYPE_MULTIPOLYGON_ZM, 26);
+  EXPECT_GT(GEOARROW_TYPE_WKT, GEOARROW_TYPE_MULTIPOLYGON_ZM);
+  EXPECT_GT(GEOARROW_TYPE_LARGE_WKT, GEOARROW_TYPE_MULTIPOLYGON_ZM);
+}
+
 class TypeParameterizedTestFixture : public ::testing::TestWithParam<enum GeoArrowType> {
  protected:
   enum GeoArrowType type;
@@ -87,7 +101,8 @@ TEST_P(TypeParameterizedTestFixture, SchemaViewTestInitFromSchema) {
 
 INSTANTIATE_TEST_SUITE_P(
     SchemaViewTest, TypeParameterizedTestFixture,
-    ::testing::Values(GEOARROW_TYPE_WKB, GEOARROW_TYPE_LARGE_WKB,
+    ::testing::Values(GEOARROW_TYPE_WKB, GEOARROW_TYPE_LARGE_WKB, GEOARROW_TYPE_WKT,
+                      GEOARROW_TYPE_LARGE_WKT,
 
                       GEOARROW_TYPE_POINT, GEOARROW_TYPE_LINESTRING,
                       GEOARROW_TYPE_POLYGON, GEOARROW_TYPE_MULTIPOINT,
@@ -201,3 +216,81 @@ TEST(SchemaViewTest, SchemaViewTestInitInvalidWKB) {
 
   good_schema.release(&good_schema);
 }
+
+TEST(SchemaViewTest, SchemaViewTestInitInvalidWKT) {
+  struct ArrowSchema good_schema;
+  struct ArrowSchema bad_schema;
+  struct GeoArrowSchemaView schema_view;
+  struct GeoArrowError error;
+
+  ASSERT_EQ(GeoArrowSchemaInitExtension(&good_schema, GEOARROW_TYPE_WKT), GEOARROW_OK);
+
+  ASSERT_EQ(ArrowSchemaInit(&bad_schema, NANOARROW_TYPE_BINARY), GEOARROW_OK);
+  ASSERT_EQ(ArrowSchemaSetMetadata(&bad_schema, good_schema.metadata), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowSchemaViewInit(&schema_view, &bad_schema, &error), EINVAL);
+  EXPECT_STREQ(
+      error.message,
+      "Expected storage type of string or large_string for extension 'geoarrow.wkt'");
+  bad_schema.release(&bad_schema);
+
+  good_schema.release(&good_schema);
+}
+
+TEST(SchemaViewTest, SchemaViewTestUnion) {
+  struct ArrowSchema schema;
+  struct GeoArrowSchemaView schema_view;
+  struct GeoArrowError error;
+
+  ASSERT_EQ(GeoArrowSchemaInitExtension(&schema, GEOARROW_TYPE_GEOMETRY_Z), GEOARROW_OK);
+  EXPECT_STREQ(schema.format, "+ud:11,12,13,14,15,16");
+  ASSERT_EQ(GeoArrowSchemaViewInit(&schema_view, &schema, &error), GEOARROW_OK);
+  EXPECT_EQ(schema_view.type, GEOARROW_TYPE_GEOMETRY_Z);
+  EXPECT_EQ(schema_view.geometry_type, GEOARROW_GEOMETRY_TYPE_GEOMETRY);
+  EXPECT_EQ(schema_view.dimensions, GEOARROW_DIMENSIONS_XYZ);
+  EXPECT_EQ(schema_view.coord_type, GEOARROW_COORD_TYPE_SEPARATE);
+  schema.release(&schema);
+
+  // Children may be any subset of geometry types in any order
+  ASSERT_EQ(ArrowSchemaInit(&schema, NANOARROW_TYPE_UNINITIALIZED), GEOARROW_OK);
+  ASSERT_EQ(ArrowSchemaAllocateChildren(&schema, 2), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowSchemaInit(schema.children[0], GEOARROW_TYPE_MULTILINESTRING_Z),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowSchemaInit(schema.children[1], GEOARROW_TYPE_LINESTRING_Z),
+            GEOARROW_OK);
+  struct GeoArrowStringView ext = {"geoarrow.geometry", 17};
+
+  ASSERT_EQ(ArrowSchemaSetFormat(&schema, "+ud:15,12"), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowSchemaViewInitFromStorage(&schema_view, &schema, ext, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(schema_view.type, GEOARROW_TYPE_GEOMETRY_Z);
+
+  // ...but they must all have the dimensions of their type id
+  ASSERT_EQ(ArrowSchemaSetFormat(&schema, "+ud:15,2"), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowSchemaViewInitFromStorage(&schema_view, &schema, ext, &error),
+            EINVAL);
+  EXPECT_STREQ(error.message,
+               "Expected all children for extension 'geoarrow.geometry' to have the "
+               "same dimensions");
+
+  ASSERT_EQ(ArrowSchemaSetFormat(&schema, "+ud:5,2"), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowSchemaViewInitFromStorage(&schema_view, &schema, ext, &error),
+            EINVAL);
+  EXPECT_STREQ(error.message,
+               "Expected dimensions of child 0 for extension 'geoarrow.geometry' to "
+               "match its type id 5");
+
+  ASSERT_EQ(ArrowSchemaSetFormat(&schema, "+ud:17,12"), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowSchemaViewInitFromStorage(&schema_view, &schema, ext, &error),
+            EINVAL);
+  EXPECT_STREQ(error.message,
+               "Expected type id of child 0 for extension 'geoarrow.geometry' to be a "
+               "native geometry type");
+
+  ASSERT_EQ(ArrowSchemaSetFormat(&schema, "+us:15,12"), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowSchemaViewInitFromStorage(&schema_view, &schema, ext, &error),
+            EINVAL);
+  EXPECT_STREQ(error.message,
+               "Expected storage type dense union for extension 'geoarrow.geometry'");
+
+  schema.release(&schema);
+}
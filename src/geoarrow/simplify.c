@@ -0,0 +1,401 @@
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "geoarrow.h"
+
+#include "nanoarrow.h"
+
+struct SimplifierPrivate {
+  // The visitor of the builder being appended to
+  struct GeoArrowVisitor builder_v;
+
+  // Geometry type stack used to find coordinate sequences that can be simplified
+  enum GeoArrowGeometryType geometry_type[32];
+  int32_t level;
+  int in_ring;
+
+  // Scratch space that is reused for every coordinate sequence
+  struct ArrowBuffer keep;
+  struct ArrowBuffer indices;
+  struct ArrowBuffer areas;
+  struct ArrowBuffer values;
+};
+
+static int SimplifierReserve(struct SimplifierPrivate* private, int64_t n_coords) {
+  NANOARROW_RETURN_NOT_OK(ArrowBufferResize(&private->keep, n_coords, 0));
+  NANOARROW_RETURN_NOT_OK(
+      ArrowBufferResize(&private->indices, 4 * n_coords * sizeof(int64_t), 0));
+  NANOARROW_RETURN_NOT_OK(
+      ArrowBufferResize(&private->areas, n_coords * sizeof(double), 0));
+  return ArrowBufferResize(&private->values, 4 * n_coords * sizeof(double), 0);
+}
+
+// Squared distance from the point at i to the segment from a to b
+static inline double SimplifierSegmentDistance2(const struct GeoArrowCoordView* coords,
+                                                int64_t i, int64_t a, int64_t b) {
+  double x = GeoArrowCoordViewValueUnaligned(coords, i, 0);
+  double y = GeoArrowCoordViewValueUnaligned(coords, i, 1);
+  double x0 = GeoArrowCoordViewValueUnaligned(coords, a, 0);
+  double y0 = GeoArrowCoordViewValueUnaligned(coords, a, 1);
+  double dx = GeoArrowCoordViewValueUnaligned(coords, b, 0) - x0;
+  double dy = GeoArrowCoordViewValueUnaligned(coords, b, 1) - y0;
+
+  double length2 = dx * dx + dy * dy;
+  if (length2 > 0) {
+    double t = ((x - x0) * dx + (y - y0) * dy) / length2;
+    if (t > 1) {
+      t = 1;
+    } else if (t < 0) {
+      t = 0;
+    }
+
+    x0 += t * dx;
+    y0 += t * dy;
+  }
+
+  return (x - x0) * (x - x0) + (y - y0) * (y - y0);
+}
+
+// Marks coordinates to keep using an explicit stack of index ranges instead of
+// recursion so that long sequences can't overflow the call stack
+static void SimplifierDouglasPeucker(struct SimplifierPrivate* private,
+                                     const struct GeoArrowCoordView* coords,
+                                     double tolerance) {
+  int64_t n = coords->n_coords;
+  uint8_t* keep = private->keep.data;
+  int64_t* stack = (int64_t*)private->indices.data;
+  double tolerance2 = tolerance * tolerance;
+
+  memset(keep, 0, n);
+  keep[0] = 1;
+  keep[n - 1] = 1;
+
+  int64_t stack_size = 0;
+  stack[stack_size++] = 0;
+  stack[stack_size++] = n - 1;
+
+  while (stack_size > 0) {
+    int64_t b = stack[--stack_size];
+    int64_t a = stack[--stack_size];
+
+    int64_t farthest = -1;
+    double farthest_distance2 = tolerance2;
+    for (int64_t i = a + 1; i < b; i++) {
+      double distance2 = SimplifierSegmentDistance2(coords, i, a, b);
+      if (distance2 > farthest_distance2) {
+        farthest = i;
+        farthest_distance2 = distance2;
+      }
+    }
+
+    if (farthest != -1) {
+      keep[farthest] = 1;
+      stack[stack_size++] = a;
+      stack[stack_size++] = farthest;
+      stack[stack_size++] = farthest;
+      stack[stack_size++] = b;
+    }
+  }
+}
+
+static inline double SimplifierTriangleArea(const struct GeoArrowCoordView* coords,
+                                            int64_t a, int64_t b, int64_t c) {
+  double xa = GeoArrowCoordViewValueUnaligned(coords, a, 0);
+  double ya = GeoArrowCoordViewValueUnaligned(coords, a, 1);
+  double xb = GeoArrowCoordViewValueUnaligned(coords, b, 0);
+  double yb = GeoArrowCoordViewValueUnaligned(coords, b, 1);
+  double xc = GeoArrowCoordViewValueUnaligned(coords, c, 0);
+  double yc = GeoArrowCoordViewValueUnaligned(coords, c, 1);
+  return fabs((xb - xa) * (yc - ya) - (xc - xa) * (yb - ya)) / 2;
+}
+
+static inline void SimplifierHeapSwap(int64_t* heap, int64_t* heap_pos, int64_t i,
+                                      int64_t j) {
+  int64_t tmp = heap[i];
+  heap[i] = heap[j];
+  heap[j] = tmp;
+  heap_pos[heap[i]] = i;
+  heap_pos[heap[j]] = j;
+}
+
+// Restores the heap property for the item at heap index i in either direction
+static void SimplifierHeapUpdate(int64_t* heap, int64_t* heap_pos, int64_t heap_size,
+                                 const double* areas, int64_t i) {
+  while (i > 0 && areas[heap[i]] < areas[heap[(i - 1) / 2]]) {
+    SimplifierHeapSwap(heap, heap_pos, i, (i - 1) / 2);
+    i = (i - 1) / 2;
+  }
+
+  while (1) {
+    int64_t smallest = i;
+    int64_t left = 2 * i + 1;
+    int64_t right = 2 * i + 2;
+    if (left < heap_size && areas[heap[left]] < areas[heap[smallest]]) {
+      smallest = left;
+    }
+
+    if (right < heap_size && areas[heap[right]] < areas[heap[smallest]]) {
+      smallest = right;
+    }
+
+    if (smallest == i) {
+      break;
+    }
+
+    SimplifierHeapSwap(heap, heap_pos, i, smallest);
+    i = smallest;
+  }
+}
+
+// Removes the coordinate with the smallest effective area until every remaining
+// area is at least tolerance or only min_coords coordinates are left
+static void SimplifierVisvalingam(struct SimplifierPrivate* private,
+                                  const struct GeoArrowCoordView* coords,
+                                  double tolerance, int64_t min_coords) {
+  int64_t n = coords->n_coords;
+  uint8_t* keep = private->keep.data;
+  int64_t* prev = (int64_t*)private->indices.data;
+  int64_t* next = prev + n;
+  int64_t* heap = next + n;
+  int64_t* heap_pos = heap + n;
+  double* areas = (double*)private->areas.data;
+
+  memset(keep, 1, n);
+  int64_t heap_size = 0;
+  for (int64_t i = 1; i < (n - 1); i++) {
+    prev[i] = i - 1;
+    next[i] = i + 1;
+    areas[i] = SimplifierTriangleArea(coords, i - 1, i, i + 1);
+    heap[heap_size] = i;
+    heap_pos[i] = heap_size;
+    heap_size++;
+  }
+
+  for (int64_t i = (heap_size / 2) - 1; i >= 0; i--) {
+    SimplifierHeapUpdate(heap, heap_pos, heap_size, areas, i);
+  }
+
+  int64_t n_remaining = n;
+  while (heap_size > 0 && n_remaining > min_coords) {
+    int64_t i = heap[0];
+    double area = areas[i];
+    if (area >= tolerance) {
+      break;
+    }
+
+    SimplifierHeapSwap(heap, heap_pos, 0, --heap_size);
+    SimplifierHeapUpdate(heap, heap_pos, heap_size, areas, 0);
+    keep[i] = 0;
+    n_remaining--;
+
+    // Neighbours inherit the removed area if their new area is smaller so that
+    // the removal order is consistent with the effective area
+    int64_t before = prev[i];
+    int64_t after = next[i];
+    if (before > 0) {
+      next[before] = after;
+      areas[before] = SimplifierTriangleArea(coords, prev[before], before, after);
+      areas[before] = areas[before] < area ? area : areas[before];
+      SimplifierHeapUpdate(heap, heap_pos, heap_size, areas, heap_pos[before]);
+    }
+
+    if (after < (n - 1)) {
+      prev[after] = before;
+      areas[after] = SimplifierTriangleArea(coords, before, after, next[after]);
+      areas[after] = areas[after] < area ? area : areas[after];
+      SimplifierHeapUpdate(heap, heap_pos, heap_size, areas, heap_pos[after]);
+    }
+  }
+}
+
+static int coords_simplify(struct GeoArrowVisitor* v,
+                           const struct GeoArrowCoordView* coords) {
+  struct GeoArrowSimplifier* simplifier = (struct GeoArrowSimplifier*)v->private_data;
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+
+  // Only linestrings and rings are simplified
+  int64_t min_coords;
+  if (private->in_ring) {
+    min_coords = 4;
+  } else if (private->level > 0 && private->geometry_type[private->level - 1] ==
+                                       GEOARROW_GEOMETRY_TYPE_LINESTRING) {
+    min_coords = 2;
+  } else {
+    return private->builder_v.coords(&private->builder_v, coords);
+  }
+
+  if (coords->n_coords <= min_coords) {
+    return private->builder_v.coords(&private->builder_v, coords);
+  }
+
+  NANOARROW_RETURN_NOT_OK(SimplifierReserve(private, coords->n_coords));
+  switch (simplifier->method) {
+    case GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER:
+      SimplifierDouglasPeucker(private, coords, simplifier->tolerance);
+      break;
+    case GEOARROW_SIMPLIFY_METHOD_VISVALINGAM:
+      SimplifierVisvalingam(private, coords, simplifier->tolerance, min_coords);
+      break;
+    default:
+      ArrowErrorSet((struct ArrowError*)v->error, "Unknown simplify method %d",
+                    (int)simplifier->method);
+      return EINVAL;
+  }
+
+  // Gather the kept coordinates into the scratch values
+  const uint8_t* keep = private->keep.data;
+  struct GeoArrowCoordView out;
+  out.n_values = coords->n_values;
+  out.coords_stride = 1;
+  for (int32_t j = 0; j < coords->n_values; j++) {
+    out.values[j] = (const double*)private->values.data + j * coords->n_coords;
+  }
+
+  int64_t n_kept = 0;
+  for (int64_t i = 0; i < coords->n_coords; i++) {
+    if (!keep[i]) {
+      continue;
+    }
+
+    for (int32_t j = 0; j < coords->n_values; j++) {
+      ((double*)out.values[j])[n_kept] = GeoArrowCoordViewValueUnaligned(coords, i, j);
+    }
+
+    n_kept++;
+  }
+
+  // Douglas-Peucker can collapse a ring; these rings are kept as they are
+  if (n_kept < min_coords) {
+    return private->builder_v.coords(&private->builder_v, coords);
+  }
+
+  out.n_coords = n_kept;
+  return private->builder_v.coords(&private->builder_v, &out);
+}
+
+static int reserve_coord_simplify(struct GeoArrowVisitor* v, int64_t n) {
+  struct GeoArrowSimplifier* simplifier = (struct GeoArrowSimplifier*)v->private_data;
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  return private->builder_v.reserve_coord(&private->builder_v, n);
+}
+
+static int reserve_feat_simplify(struct GeoArrowVisitor* v, int64_t n) {
+  struct GeoArrowSimplifier* simplifier = (struct GeoArrowSimplifier*)v->private_data;
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  return private->builder_v.reserve_feat(&private->builder_v, n);
+}
+
+static int feat_start_simplify(struct GeoArrowVisitor* v) {
+  struct GeoArrowSimplifier* simplifier = (struct GeoArrowSimplifier*)v->private_data;
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  private->level = 0;
+  private->in_ring = 0;
+  return private->builder_v.feat_start(&private->builder_v);
+}
+
+static int null_feat_simplify(struct GeoArrowVisitor* v) {
+  struct GeoArrowSimplifier* simplifier = (struct GeoArrowSimplifier*)v->private_data;
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  return private->builder_v.null_feat(&private->builder_v);
+}
+
+static int geom_start_simplify(struct GeoArrowVisitor* v,
+                               enum GeoArrowGeometryType geometry_type,
+                               enum GeoArrowDimensions dimensions) {
+  struct GeoArrowSimplifier* simplifier = (struct GeoArrowSimplifier*)v->private_data;
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  if (private->level < 0 || private->level > 30) {
+    return EINVAL;
+  }
+
+  private->geometry_type[private->level++] = geometry_type;
+  return private->builder_v.geom_start(&private->builder_v, geometry_type, dimensions);
+}
+
+static int ring_start_simplify(struct GeoArrowVisitor* v) {
+  struct GeoArrowSimplifier* simplifier = (struct GeoArrowSimplifier*)v->private_data;
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  private->in_ring = 1;
+  return private->builder_v.ring_start(&private->builder_v);
+}
+
+static int ring_end_simplify(struct GeoArrowVisitor* v) {
+  struct GeoArrowSimplifier* simplifier = (struct GeoArrowSimplifier*)v->private_data;
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  private->in_ring = 0;
+  return private->builder_v.ring_end(&private->builder_v);
+}
+
+static int geom_end_simplify(struct GeoArrowVisitor* v) {
+  struct GeoArrowSimplifier* simplifier = (struct GeoArrowSimplifier*)v->private_data;
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  private->level--;
+  return private->builder_v.geom_end(&private->builder_v);
+}
+
+static int feat_end_simplify(struct GeoArrowVisitor* v) {
+  struct GeoArrowSimplifier* simplifier = (struct GeoArrowSimplifier*)v->private_data;
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  return private->builder_v.feat_end(&private->builder_v);
+}
+
+GeoArrowErrorCode GeoArrowSimplifierInit(struct GeoArrowSimplifier* simplifier) {
+  struct SimplifierPrivate* private =
+      (struct SimplifierPrivate*)ArrowMalloc(sizeof(struct SimplifierPrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct SimplifierPrivate));
+  ArrowBufferInit(&private->keep);
+  ArrowBufferInit(&private->indices);
+  ArrowBufferInit(&private->areas);
+  ArrowBufferInit(&private->values);
+
+  simplifier->method = GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER;
+  simplifier->tolerance = 0;
+  simplifier->private_data = private;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowSimplifierAppend(struct GeoArrowSimplifier* simplifier,
+                                           struct GeoArrowArrayView* array_view,
+                                           int64_t offset, int64_t length,
+                                           struct GeoArrowBuilder* builder,
+                                           struct GeoArrowError* error) {
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  GeoArrowBuilderInitVisitor(builder, &private->builder_v);
+  private->builder_v.error = error;
+
+  // Array views visit each linestring or ring with exactly one call to coords(),
+  // so every call to coords_simplify() sees a complete sequence
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorInitVoid(&v);
+  v.reserve_coord = &reserve_coord_simplify;
+  v.reserve_feat = &reserve_feat_simplify;
+  v.feat_start = &feat_start_simplify;
+  v.null_feat = &null_feat_simplify;
+  v.geom_start = &geom_start_simplify;
+  v.ring_start = &ring_start_simplify;
+  v.coords = &coords_simplify;
+  v.ring_end = &ring_end_simplify;
+  v.geom_end = &geom_end_simplify;
+  v.feat_end = &feat_end_simplify;
+  v.error = error;
+  v.private_data = simplifier;
+
+  return GeoArrowArrayViewVisit(array_view, offset, length, &v);
+}
+
+void GeoArrowSimplifierReset(struct GeoArrowSimplifier* simplifier) {
+  struct SimplifierPrivate* private = (struct SimplifierPrivate*)simplifier->private_data;
+  ArrowBufferReset(&private->keep);
+  ArrowBufferReset(&private->indices);
+  ArrowBufferReset(&private->areas);
+  ArrowBufferReset(&private->values);
+  ArrowFree(private);
+  simplifier->private_data = NULL;
+}
@@ -0,0 +1,158 @@
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+static std::vector<std::string> SimplifyWKT(enum GeoArrowType type,
+                                            enum GeoArrowSimplifyMethod method,
+                                            double tolerance,
+                                            const std::vector<std::string>& wkts) {
+  struct ArrowArray array;
+  ArrayFromWKT(type, wkts, &array);
+
+  struct GeoArrowArrayView array_view;
+  EXPECT_EQ(GeoArrowArrayViewInitFromType(&array_view, type), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  struct GeoArrowSimplifier simplifier;
+  struct GeoArrowBuilder builder;
+  struct GeoArrowError error;
+  EXPECT_EQ(GeoArrowSimplifierInit(&simplifier), GEOARROW_OK);
+  simplifier.method = method;
+  simplifier.tolerance = tolerance;
+  EXPECT_EQ(GeoArrowBuilderInitFromType(&builder, type), GEOARROW_OK);
+
+  // Append one feature at a time to check that scratch space is reused correctly
+  for (int64_t i = 0; i < array.length; i++) {
+    EXPECT_EQ(GeoArrowSimplifierAppend(&simplifier, &array_view, i, 1, &builder, &error),
+              GEOARROW_OK)
+        << error.message;
+  }
+
+  GeoArrowSimplifierReset(&simplifier);
+  array.release(&array);
+
+  struct ArrowArray array_out;
+  EXPECT_EQ(GeoArrowBuilderFinish(&builder, &array_out, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+
+  EXPECT_EQ(GeoArrowArrayViewSetArray(&array_view, &array_out, nullptr), GEOARROW_OK);
+  WKXTester tester;
+  EXPECT_EQ(GeoArrowArrayViewVisit(&array_view, 0, array_out.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  array_out.release(&array_out);
+  return tester.WKTValues("<null value>");
+}
+
+TEST(SimplifyTest, SimplifyTestDouglasPeuckerLinestring) {
+  auto values = SimplifyWKT(
+      GEOARROW_TYPE_LINESTRING, GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER, 0.5,
+      {"LINESTRING (0 0, 1 0.1, 2 0, 3 0.1, 4 0)", "", "LINESTRING (0 0, 1 1)",
+       "LINESTRING (0 0, 1 0.1, 2 0, 3 3, 4 0)", "LINESTRING EMPTY"});
+  EXPECT_EQ(values, std::vector<std::string>(
+                        {"LINESTRING (0 0, 4 0)", "<null value>", "LINESTRING (0 0, 1 1)",
+                         "LINESTRING (0 0, 2 0, 3 3, 4 0)", "LINESTRING EMPTY"}));
+
+  // Exactly collinear points are removed with a tolerance of zero
+  values =
+      SimplifyWKT(GEOARROW_TYPE_LINESTRING_Z, GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER, 0,
+                  {"LINESTRING Z (0 0 1, 1 1 2, 2 2 3, 2 3 4)"});
+  EXPECT_EQ(values, std::vector<std::string>({"LINESTRING Z (0 0 1, 2 2 3, 2 3 4)"}));
+}
+
+TEST(SimplifyTest, SimplifyTestDouglasPeuckerPolygon) {
+  auto values = SimplifyWKT(
+      GEOARROW_TYPE_MULTIPOLYGON, GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER, 0.1,
+      {"MULTIPOLYGON (((0 0, 5 0.01, 10 0, 10 10, 0 10, 0 0)), ((0 0, 1 0, 0 1, 0 0)))",
+       "POLYGON ((0 0, 1 0, 1 1, 0 1, 0 0))"});
+  EXPECT_EQ(values,
+            std::vector<std::string>(
+                {"MULTIPOLYGON (((0 0, 10 0, 10 10, 0 10, 0 0)), ((0 0, 1 0, 0 1, 0 0)))",
+                 "MULTIPOLYGON (((0 0, 1 0, 1 1, 0 1, 0 0)))"}));
+
+  // Rings that would collapse are kept as they are
+  values = SimplifyWKT(GEOARROW_TYPE_POLYGON, GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER,
+                       10, {"POLYGON ((0 0, 1 0, 1 1, 0 1, 0 0))"});
+  EXPECT_EQ(values, std::vector<std::string>({"POLYGON ((0 0, 1 0, 1 1, 0 1, 0 0))"}));
+}
+
+TEST(SimplifyTest, SimplifyTestVisvalingam) {
+  auto values = SimplifyWKT(
+      GEOARROW_TYPE_MULTILINESTRING, GEOARROW_SIMPLIFY_METHOD_VISVALINGAM, 0.5,
+      {"MULTILINESTRING ((0 0, 1 0.1, 2 0, 3 3, 4 0), (0 0, 1 1))"});
+  EXPECT_EQ(values, std::vector<std::string>(
+                        {"MULTILINESTRING ((0 0, 2 0, 3 3, 4 0), (0 0, 1 1))"}));
+
+  values = SimplifyWKT(GEOARROW_TYPE_LINESTRING, GEOARROW_SIMPLIFY_METHOD_VISVALINGAM,
+                       100, {"LINESTRING (0 0, 1 0.1, 2 0, 3 3, 4 0)"});
+  EXPECT_EQ(values, std::vector<std::string>({"LINESTRING (0 0, 4 0)"}));
+
+  // Rings keep at least four coordinates
+  values = SimplifyWKT(GEOARROW_TYPE_POLYGON, GEOARROW_SIMPLIFY_METHOD_VISVALINGAM, 100,
+                       {"POLYGON ((0 0, 5 0.01, 10 0, 10 10, 2 9, 0 0))"});
+  EXPECT_EQ(values, std::vector<std::string>({"POLYGON ((0 0, 10 0, 10 10, 0 0))"}));
+}
+
+TEST(SimplifyTest, SimplifyTestPointsUnchanged) {
+  auto values =
+      SimplifyWKT(GEOARROW_TYPE_MULTIPOINT, GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER, 100,
+                  {"MULTIPOINT ((0 0), (1 0.1), (2 0))", ""});
+  EXPECT_EQ(values, std::vector<std::string>(
+                        {"MULTIPOINT ((0 0), (1 0.1), (2 0))", "<null value>"}));
+}
+
+TEST(SimplifyTest, SimplifyTestLongLinestring) {
+  // Long enough that a recursive implementation would be a problem for a
+  // pathological input; the points zigzag by less than the tolerance
+  std::string wkt = "LINESTRING (";
+  for (int i = 0; i < 100000; i++) {
+    if (i > 0) {
+      wkt += ", ";
+    }
+    wkt += std::to_string(i) + (i % 2 == 0 ? " 0" : " 0.001");
+  }
+  wkt += ")";
+
+  for (auto method :
+       {GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER, GEOARROW_SIMPLIFY_METHOD_VISVALINGAM}) {
+    auto values = SimplifyWKT(GEOARROW_TYPE_LINESTRING, method, 100, {wkt});
+    EXPECT_EQ(values, std::vector<std::string>({"LINESTRING (0 0, 99999 0.001)"}));
+  }
+}
+
+TEST(SimplifyTest, SimplifyTestErrors) {
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_LINESTRING, {"LINESTRING (0 0, 1 1, 2 0)"}, &array);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  struct GeoArrowSimplifier simplifier;
+  struct GeoArrowBuilder builder;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowSimplifierInit(&simplifier), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_LINESTRING), GEOARROW_OK);
+
+  simplifier.method = static_cast<enum GeoArrowSimplifyMethod>(100);
+  EXPECT_EQ(GeoArrowSimplifierAppend(&simplifier, &array_view, 0, 1, &builder, &error),
+            EINVAL);
+  EXPECT_STREQ(error.message, "Unknown simplify method 100");
+  GeoArrowBuilderReset(&builder);
+
+  // Errors from the builder are propagated
+  simplifier.method = GEOARROW_SIMPLIFY_METHOD_DOUGLAS_PEUCKER;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowSimplifierAppend(&simplifier, &array_view, 0, 1, &builder, &error),
+            EINVAL);
+  EXPECT_STREQ(error.message,
+               "Can't append geometry of type LINESTRING to builder of type POINT");
+
+  GeoArrowBuilderReset(&builder);
+  GeoArrowSimplifierReset(&simplifier);
+  array.release(&array);
+}
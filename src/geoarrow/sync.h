@@ -0,0 +1,103 @@
+
+#ifndef GEOARROW_SYNC_H_INCLUDED
+#define GEOARROW_SYNC_H_INCLUDED
+
+// Not part of the public API: the mutex and atomic pointer accesses behind the objects
+// that may be shared between threads. Windows uses slim reader/writer locks and
+// Interlocked functions, GCC and clang use pthreads and __atomic builtins. Other
+// compilers have neither, so GEOARROW_SYNC_SUPPORTED is 0 and GeoArrowMutexInit()
+// fails with ENOTSUP rather than handing out an object that isn't thread-safe.
+
+#include <errno.h>
+
+#include "geoarrow.h"
+
+#if defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#define GEOARROW_SYNC_SUPPORTED 1
+
+struct GeoArrowMutex {
+  SRWLOCK lock;
+};
+
+static inline GeoArrowErrorCode GeoArrowMutexInit(struct GeoArrowMutex* mutex) {
+  InitializeSRWLock(&mutex->lock);
+  return GEOARROW_OK;
+}
+
+static inline void GeoArrowMutexLock(struct GeoArrowMutex* mutex) {
+  AcquireSRWLockExclusive(&mutex->lock);
+}
+
+static inline void GeoArrowMutexUnlock(struct GeoArrowMutex* mutex) {
+  ReleaseSRWLockExclusive(&mutex->lock);
+}
+
+static inline void GeoArrowMutexReset(struct GeoArrowMutex* mutex) { (void)mutex; }
+
+// Both are full barriers, which is stronger than the acquire load and release store
+// that are needed
+#define GEOARROW_ATOMIC_LOAD_PTR(ptr) \
+  InterlockedCompareExchangePointer((void* volatile*)(ptr), NULL, NULL)
+#define GEOARROW_ATOMIC_STORE_PTR(ptr, value) \
+  ((void)InterlockedExchangePointer((void* volatile*)(ptr), (void*)(value)))
+
+#elif defined(__GNUC__) || defined(__clang__)
+
+#include <pthread.h>
+
+#define GEOARROW_SYNC_SUPPORTED 1
+
+struct GeoArrowMutex {
+  pthread_mutex_t mutex;
+};
+
+static inline GeoArrowErrorCode GeoArrowMutexInit(struct GeoArrowMutex* mutex) {
+  return pthread_mutex_init(&mutex->mutex, NULL) == 0 ? GEOARROW_OK : EINVAL;
+}
+
+static inline void GeoArrowMutexLock(struct GeoArrowMutex* mutex) {
+  pthread_mutex_lock(&mutex->mutex);
+}
+
+static inline void GeoArrowMutexUnlock(struct GeoArrowMutex* mutex) {
+  pthread_mutex_unlock(&mutex->mutex);
+}
+
+static inline void GeoArrowMutexReset(struct GeoArrowMutex* mutex) {
+  pthread_mutex_destroy(&mutex->mutex);
+}
+
+#define GEOARROW_ATOMIC_LOAD_PTR(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define GEOARROW_ATOMIC_STORE_PTR(ptr, value) \
+  __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+
+#else
+
+#define GEOARROW_SYNC_SUPPORTED 0
+
+struct GeoArrowMutex {
+  int unused;
+};
+
+static inline GeoArrowErrorCode GeoArrowMutexInit(struct GeoArrowMutex* mutex) {
+  (void)mutex;
+  return ENOTSUP;
+}
+
+static inline void GeoArrowMutexLock(struct GeoArrowMutex* mutex) { (void)mutex; }
+
+static inline void GeoArrowMutexUnlock(struct GeoArrowMutex* mutex) { (void)mutex; }
+
+static inline void GeoArrowMutexReset(struct GeoArrowMutex* mutex) { (void)mutex; }
+
+// Only reachable through objects whose mutex was initialized, which never happens here
+#define GEOARROW_ATOMIC_LOAD_PTR(ptr) (*(ptr))
+#define GEOARROW_ATOMIC_STORE_PTR(ptr, value) ((void)(*(ptr) = (value)))
+
+#endif
+
+#endif
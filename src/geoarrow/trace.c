@@ -0,0 +1,19 @@
+#include "geoarrow.h"
+#include "sync.h"
+
+static struct GeoArrowTracer* global_tracer = NULL;
+
+// Every traced entry point reads global_tracer, so it is accessed atomically. The
+// release store publishes the contents of tracer to threads that load it. Where there
+// are no atomics tracing is unavailable rather than racy.
+void GeoArrowSetTracer(struct GeoArrowTracer* tracer) {
+#if GEOARROW_SYNC_SUPPORTED
+  GEOARROW_ATOMIC_STORE_PTR(&global_tracer, tracer);
+#else
+  (void)tracer;
+#endif
+}
+
+struct GeoArrowTracer* GeoArrowGetTracer(void) {
+  return (struct GeoArrowTracer*)GEOARROW_ATOMIC_LOAD_PTR(&global_tracer);
+}
@@ -0,0 +1,151 @@
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+struct TraceRecord {
+  enum GeoArrowTraceEvent event;
+  int64_t n_rows;
+  int64_t n_bytes;
+  GeoArrowErrorCode result;
+};
+
+struct RecordingTracer {
+  std::vector<enum GeoArrowTraceEvent> begun;
+  std::vector<TraceRecord> ended;
+};
+
+static void RecordingTracerBegin(struct GeoArrowTracer* tracer,
+                                 enum GeoArrowTraceEvent event) {
+  auto recorder = reinterpret_cast<RecordingTracer*>(tracer->private_data);
+  recorder->begun.push_back(event);
+}
+
+static void RecordingTracerEnd(struct GeoArrowTracer* tracer,
+                               enum GeoArrowTraceEvent event, int64_t n_rows,
+                               int64_t n_bytes, GeoArrowErrorCode result) {
+  auto recorder = reinterpret_cast<RecordingTracer*>(tracer->private_data);
+  recorder->ended.push_back({event, n_rows, n_bytes, result});
+}
+
+static void InitRecordingTracer(struct GeoArrowTracer* tracer,
+                                RecordingTracer* recorder) {
+  tracer->begin = &RecordingTracerBegin;
+  tracer->end = &RecordingTracerEnd;
+  tracer->private_data = recorder;
+}
+
+TEST(TraceTest, TraceTestDefault) { EXPECT_EQ(GeoArrowGetTracer(), nullptr); }
+
+TEST(TraceTest, TraceTestWKTReaderBuilder) {
+  RecordingTracer recorder;
+  struct GeoArrowTracer tracer;
+  InitRecordingTracer(&tracer, &recorder);
+  GeoArrowSetTracer(&tracer);
+  EXPECT_EQ(GeoArrowGetTracer(), &tracer);
+
+  std::vector<std::string> wkts = {"LINESTRING (0 1, 2 3)", "LINESTRING (4 5, 6 7, 8 9)"};
+  // ArrayFromWKT() calls the WKT reader once per item and then finishes a builder
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_LINESTRING, wkts, &array);
+  GeoArrowSetTracer(nullptr);
+
+  ASSERT_EQ(recorder.begun.size(), 3);
+  ASSERT_EQ(recorder.ended.size(), 3);
+  for (size_t i = 0; i < 2; i++) {
+    EXPECT_EQ(recorder.begun[i], GEOARROW_TRACE_EVENT_WKT_READER_VISIT);
+    EXPECT_EQ(recorder.ended[i].event, GEOARROW_TRACE_EVENT_WKT_READER_VISIT);
+    EXPECT_EQ(recorder.ended[i].n_rows, 1);
+    EXPECT_EQ(recorder.ended[i].n_bytes, wkts[i].size());
+    EXPECT_EQ(recorder.ended[i].result, GEOARROW_OK);
+  }
+
+  // Offsets for 3 rows plus two coordinate buffers of 5 doubles
+  EXPECT_EQ(recorder.begun[2], GEOARROW_TRACE_EVENT_BUILDER_FINISH);
+  EXPECT_EQ(recorder.ended[2].event, GEOARROW_TRACE_EVENT_BUILDER_FINISH);
+  EXPECT_EQ(recorder.ended[2].n_rows, 2);
+  EXPECT_EQ(recorder.ended[2].n_bytes, 3 * sizeof(int32_t) + 2 * 5 * sizeof(double));
+  EXPECT_EQ(recorder.ended[2].result, GEOARROW_OK);
+
+  // Visiting the result reports the number of bytes of coordinates visited
+  recorder.begun.clear();
+  recorder.ended.clear();
+  GeoArrowSetTracer(&tracer);
+
+  struct GeoArrowArrayView array_view;
+  struct GeoArrowError error;
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorInitVoid(&v);
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, &error), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewVisit(&array_view, 1, 1, &v), GEOARROW_OK);
+  GeoArrowSetTracer(nullptr);
+
+  ASSERT_EQ(recorder.ended.size(), 1);
+  EXPECT_EQ(recorder.begun[0], GEOARROW_TRACE_EVENT_ARRAY_VIEW_VISIT);
+  EXPECT_EQ(recorder.ended[0].event, GEOARROW_TRACE_EVENT_ARRAY_VIEW_VISIT);
+  EXPECT_EQ(recorder.ended[0].n_rows, 1);
+  EXPECT_EQ(recorder.ended[0].n_bytes, 3 * 2 * sizeof(double));
+  EXPECT_EQ(recorder.ended[0].result, GEOARROW_OK);
+
+  array.release(&array);
+}
+
+TEST(TraceTest, TraceTestWriters) {
+  RecordingTracer recorder;
+  struct GeoArrowTracer tracer;
+  InitRecordingTracer(&tracer, &recorder);
+  GeoArrowSetTracer(&tracer);
+
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_WKT, {"POINT (0 1)", "POINT (2 3)"}, &array);
+  ASSERT_EQ(recorder.ended.size(), 3);
+  EXPECT_EQ(recorder.begun[2], GEOARROW_TRACE_EVENT_WKT_WRITER_FINISH);
+  EXPECT_EQ(recorder.ended[2].event, GEOARROW_TRACE_EVENT_WKT_WRITER_FINISH);
+  EXPECT_EQ(recorder.ended[2].n_rows, 2);
+  EXPECT_EQ(recorder.ended[2].n_bytes, 2 * strlen("POINT (0 1)"));
+  EXPECT_EQ(recorder.ended[2].result, GEOARROW_OK);
+  array.release(&array);
+
+  recorder.begun.clear();
+  recorder.ended.clear();
+  ArrayFromWKT(GEOARROW_TYPE_WKB, {"POINT (0 1)", "POINT (2 3)"}, &array);
+  ASSERT_EQ(recorder.ended.size(), 3);
+  EXPECT_EQ(recorder.begun[2], GEOARROW_TRACE_EVENT_WKB_WRITER_FINISH);
+  EXPECT_EQ(recorder.ended[2].event, GEOARROW_TRACE_EVENT_WKB_WRITER_FINISH);
+  EXPECT_EQ(recorder.ended[2].n_rows, 2);
+  EXPECT_EQ(recorder.ended[2].n_bytes, 2 * 21);
+  EXPECT_EQ(recorder.ended[2].result, GEOARROW_OK);
+
+  // Reading the WKB back reports the size of each item
+  recorder.begun.clear();
+  recorder.ended.clear();
+  struct GeoArrowWKBReader reader;
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorInitVoid(&v);
+  ASSERT_EQ(GeoArrowWKBReaderInit(&reader), GEOARROW_OK);
+  struct GeoArrowBufferView item = {reinterpret_cast<const uint8_t*>(array.buffers[2]),
+                                    21};
+  ASSERT_EQ(GeoArrowWKBReaderVisit(&reader, item, &v), GEOARROW_OK);
+  GeoArrowWKBReaderReset(&reader);
+  array.release(&array);
+
+  // Nothing is reported once the tracer is removed
+  GeoArrowSetTracer(nullptr);
+  ArrayFromWKT(GEOARROW_TYPE_WKB, {"POINT (0 1)"}, &array);
+  array.release(&array);
+
+  ASSERT_EQ(recorder.ended.size(), 1);
+  EXPECT_EQ(recorder.begun[0], GEOARROW_TRACE_EVENT_WKB_READER_VISIT);
+  EXPECT_EQ(recorder.ended[0].event, GEOARROW_TRACE_EVENT_WKB_READER_VISIT);
+  EXPECT_EQ(recorder.ended[0].n_rows, 1);
+  EXPECT_EQ(recorder.ended[0].n_bytes, 21);
+  EXPECT_EQ(recorder.ended[0].result, GEOARROW_OK);
+}
@@ -0,0 +1,914 @@
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "geoarrow.h"
+
+#include "nanoarrow.h"
+
+#include "cpu_features.h"
+
+// x86 builds select a vectorized loop at runtime
+#if defined(GEOARROW_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
+// All kernels read every input dimension of a coordinate before writing any output
+// dimension so that src and dst may point to the same buffers
+typedef void (*GeoArrowScaleTranslateFn)(const double* src, double* dst, int64_t n,
+                                         double scale, double translate);
+typedef void (*GeoArrowAffineFn)(const double* const* src, double* const* dst,
+                                 int64_t n, const struct GeoArrowAffine* affine);
+
+struct GeoArrowAffineKernels {
+  GeoArrowScaleTranslateFn scale_translate;
+  GeoArrowAffineFn xy;
+  GeoArrowAffineFn xyz;
+};
+
+static void GeoArrowScaleTranslateScalar(const double* src, double* dst, int64_t n,
+                                         double scale, double translate) {
+  for (int64_t i = 0; i < n; i++) {
+    dst[i] = src[i] * scale + translate;
+  }
+}
+
+static void GeoArrowAffineXYScalar(const double* const* src, double* const* dst,
+                                   int64_t n, const struct GeoArrowAffine* affine) {
+  const double(*m)[4] = affine->matrix;
+  const double* x = src[0];
+  const double* y = src[1];
+  double* x_out = dst[0];
+  double* y_out = dst[1];
+
+  for (int64_t i = 0; i < n; i++) {
+    double xi = x[i];
+    double yi = y[i];
+    x_out[i] = m[0][0] * xi + m[0][1] * yi + m[0][3];
+    y_out[i] = m[1][0] * xi + m[1][1] * yi + m[1][3];
+  }
+}
+
+static void GeoArrowAffineXYZScalar(const double* const* src, double* const* dst,
+                                    int64_t n, const struct GeoArrowAffine* affine) {
+  const double(*m)[4] = affine->matrix;
+  const double* x = src[0];
+  const double* y = src[1];
+  const double* z = src[2];
+  double* x_out = dst[0];
+  double* y_out = dst[1];
+  double* z_out = dst[2];
+
+  for (int64_t i = 0; i < n; i++) {
+    double xi = x[i];
+    double yi = y[i];
+    double zi = z[i];
+    x_out[i] = m[0][0] * xi + m[0][1] * yi + m[0][2] * zi + m[0][3];
+    y_out[i] = m[1][0] * xi + m[1][1] * yi + m[1][2] * zi + m[1][3];
+    z_out[i] = m[2][0] * xi + m[2][1] * yi + m[2][2] * zi + m[2][3];
+  }
+}
+
+#if defined(GEOARROW_X86_DISPATCH)
+// These don't use fused multiply-add so that results are identical to the scalar
+// loops
+__attribute__((target("avx"))) static void GeoArrowScaleTranslateAVX(
+    const double* src, double* dst, int64_t n, double scale, double translate) {
+  const __m256d scale_v = _mm256_set1_pd(scale);
+  const __m256d translate_v = _mm256_set1_pd(translate);
+  int64_t i = 0;
+  for (; (i + 4) <= n; i += 4) {
+    __m256d value = _mm256_mul_pd(_mm256_loadu_pd(src + i), scale_v);
+    _mm256_storeu_pd(dst + i, _mm256_add_pd(value, translate_v));
+  }
+
+  GeoArrowScaleTranslateScalar(src + i, dst + i, n - i, scale, translate);
+}
+
+__attribute__((target("avx"))) static void GeoArrowAffineXYAVX(
+    const double* const* src, double* const* dst, int64_t n,
+    const struct GeoArrowAffine* affine) {
+  const double(*m)[4] = affine->matrix;
+  const __m256d m00 = _mm256_set1_pd(m[0][0]);
+  const __m256d m01 = _mm256_set1_pd(m[0][1]);
+  const __m256d m03 = _mm256_set1_pd(m[0][3]);
+  const __m256d m10 = _mm256_set1_pd(m[1][0]);
+  const __m256d m11 = _mm256_set1_pd(m[1][1]);
+  const __m256d m13 = _mm256_set1_pd(m[1][3]);
+
+  int64_t i = 0;
+  for (; (i + 4) <= n; i += 4) {
+    __m256d x = _mm256_loadu_pd(src[0] + i);
+    __m256d y = _mm256_loadu_pd(src[1] + i);
+    __m256d x_out =
+        _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m00, x), _mm256_mul_pd(m01, y)), m03);
+    __m256d y_out =
+        _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m10, x), _mm256_mul_pd(m11, y)), m13);
+    _mm256_storeu_pd(dst[0] + i, x_out);
+    _mm256_storeu_pd(dst[1] + i, y_out);
+  }
+
+  const double* src_rest[] = {src[0] + i, src[1] + i};
+  double* dst_rest[] = {dst[0] + i, dst[1] + i};
+  GeoArrowAffineXYScalar(src_rest, dst_rest, n - i, affine);
+}
+
+__attribute__((target("avx"))) static __m256d GeoArrowAffineRowAVX(const double* row,
+                                                                    __m256d x, __m256d y,
+                                                                    __m256d z) {
+  __m256d value = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(row[0]), x),
+                                _mm256_mul_pd(_mm256_set1_pd(row[1]), y));
+  value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_set1_pd(row[2]), z));
+  return _mm256_add_pd(value, _mm256_set1_pd(row[3]));
+}
+
+__attribute__((target("avx"))) static void GeoArrowAffineXYZAVX(
+    const double* const* src, double* const* dst, int64_t n,
+    const struct GeoArrowAffine* affine) {
+  int64_t i = 0;
+  for (; (i + 4) <= n; i += 4) {
+    __m256d x = _mm256_loadu_pd(src[0] + i);
+    __m256d y = _mm256_loadu_pd(src[1] + i);
+    __m256d z = _mm256_loadu_pd(src[2] + i);
+    __m256d x_out = GeoArrowAffineRowAVX(affine->matrix[0], x, y, z);
+    __m256d y_out = GeoArrowAffineRowAVX(affine->matrix[1], x, y, z);
+    __m256d z_out = GeoArrowAffineRowAVX(affine->matrix[2], x, y, z);
+    _mm256_storeu_pd(dst[0] + i, x_out);
+    _mm256_storeu_pd(dst[1] + i, y_out);
+    _mm256_storeu_pd(dst[2] + i, z_out);
+  }
+
+  const double* src_rest[] = {src[0] + i, src[1] + i, src[2] + i};
+  double* dst_rest[] = {dst[0] + i, dst[1] + i, dst[2] + i};
+  GeoArrowAffineXYZScalar(src_rest, dst_rest, n - i, affine);
+}
+#endif
+
+static struct GeoArrowAffineKernels GeoArrowResolveAffine(void) {
+  struct GeoArrowAffineKernels kernels = {&GeoArrowScaleTranslateScalar,
+                                          &GeoArrowAffineXYScalar,
+                                          &GeoArrowAffineXYZScalar};
+#if defined(GEOARROW_X86_DISPATCH)
+  if (GeoArrowCpuFeatures() & GEOARROW_CPU_AVX) {
+    kernels.scale_translate = &GeoArrowScaleTranslateAVX;
+    kernels.xy = &GeoArrowAffineXYAVX;
+    kernels.xyz = &GeoArrowAffineXYZAVX;
+  }
+#endif
+
+  return kernels;
+}
+
+static int GeoArrowDimensionsHasZ(enum GeoArrowDimensions dimensions) {
+  return dimensions == GEOARROW_DIMENSIONS_XYZ || dimensions == GEOARROW_DIMENSIONS_XYZM;
+}
+
+// Transforms n coordinates from src to dst. m values are not touched and must be
+// copied by the caller if src and dst are different.
+static void GeoArrowAffineApply(const double* const* src, double* const* dst,
+                                int64_t n, int has_z,
+                                const struct GeoArrowAffine* affine) {
+  struct GeoArrowAffineKernels kernels = GeoArrowResolveAffine();
+  int n_dims = has_z ? 3 : 2;
+
+  // Scaling and translation (the common case when going from world to pixel
+  // coordinates) transforms each dimension independently
+  int is_diagonal = 1;
+  for (int row = 0; row < n_dims; row++) {
+    for (int col = 0; col < n_dims; col++) {
+      if (row != col && affine->matrix[row][col] != 0) {
+        is_diagonal = 0;
+      }
+    }
+  }
+
+  if (is_diagonal) {
+    for (int j = 0; j < n_dims; j++) {
+      kernels.scale_translate(src[j], dst[j], n, affine->matrix[j][j],
+                              affine->matrix[j][3]);
+    }
+  } else if (has_z) {
+    kernels.xyz(src, dst, n, affine);
+  } else {
+    kernels.xy(src, dst, n, affine);
+  }
+}
+
+void GeoArrowAffineInitIdentity(struct GeoArrowAffine* affine) {
+  memset(affine, 0, sizeof(struct GeoArrowAffine));
+  for (int i = 0; i < 3; i++) {
+    affine->matrix[i][i] = 1;
+  }
+}
+
+// The kernels read values through double pointers, which must be aligned
+static int GeoArrowCoordViewIsAligned(const struct GeoArrowCoordView* coords) {
+  for (int32_t j = 0; j < coords->n_values; j++) {
+    if (((uintptr_t)coords->values[j]) % sizeof(double) != 0) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+void GeoArrowCoordViewTransform(const struct GeoArrowCoordView* coords,
+                                enum GeoArrowDimensions dimensions,
+                                const struct GeoArrowAffine* affine, double** out) {
+  int64_t n = coords->n_coords;
+  int has_z =
+      coords->n_values == 4 ||
+      (coords->n_values == 3 && dimensions != GEOARROW_DIMENSIONS_XYM);
+
+  if (coords->coords_stride == 1 && GeoArrowCoordViewIsAligned(coords)) {
+    GeoArrowAffineApply(coords->values, out, n, has_z, affine);
+    for (int32_t j = has_z ? 3 : 2; j < coords->n_values; j++) {
+      memcpy(out[j], coords->values[j], n * sizeof(double));
+    }
+    return;
+  }
+
+  // Interleaved or unaligned values (e.g., from a GeoArrowWKBReader with
+  // use_unaligned_coords set) are gathered first and transformed in place
+  for (int32_t j = 0; j < coords->n_values; j++) {
+    for (int64_t i = 0; i < n; i++) {
+      out[j][i] = GeoArrowCoordViewValueUnaligned(coords, i, j);
+    }
+  }
+
+  GeoArrowAffineApply((const double* const*)out, out, n, has_z, affine);
+}
+
+// The coordinate buffers are always the last n_values buffers of a writable view
+static GeoArrowErrorCode GeoArrowWritableArrayViewCoords(
+    struct GeoArrowWritableArrayView* writable_view, double** values,
+    int64_t* n_coords) {
+  switch (writable_view->schema_view.coord_type) {
+    case GEOARROW_COORD_TYPE_SEPARATE:
+      break;
+    default:
+      return ENOTSUP;
+  }
+
+  int32_t n_values = writable_view->coords.n_values;
+  struct GeoArrowWritableBufferView* buffers =
+      writable_view->buffers + writable_view->n_buffers - n_values;
+  for (int32_t j = 0; j < n_values; j++) {
+    values[j] = buffers[j].data.as_double;
+  }
+
+  *n_coords = buffers[0].size_bytes / sizeof(double);
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowWritableArrayViewTransform(
+    struct GeoArrowWritableArrayView* writable_view,
+    const struct GeoArrowAffine* affine) {
+  double* values[4];
+  int64_t n_coords;
+  NANOARROW_RETURN_NOT_OK(
+      GeoArrowWritableArrayViewCoords(writable_view, values, &n_coords));
+  GeoArrowAffineApply((const double* const*)values, values, n_coords,
+                      GeoArrowDimensionsHasZ(writable_view->schema_view.dimensions),
+                      affine);
+  return GEOARROW_OK;
+}
+
+// Keeps the source array alive until every buffer that points into it is released
+struct GeoArrowSharedArray {
+  struct ArrowArray array;
+  int64_t refcount;
+};
+
+static void GeoArrowSharedArrayRelease(struct GeoArrowSharedArray* shared) {
+  shared->refcount--;
+  if (shared->refcount == 0) {
+    shared->array.release(&shared->array);
+    ArrowFree(shared);
+  }
+}
+
+static void GeoArrowSharedBufferFree(struct ArrowBufferAllocator* allocator,
+                                     uint8_t* ptr, int64_t size) {
+  GeoArrowSharedArrayRelease((struct GeoArrowSharedArray*)allocator->private_data);
+}
+
+struct GeoArrowTransformCoords {
+  const double* src[4];
+  double* dst[4];
+  int64_t n_coords[4];
+  int32_t n_values;
+};
+
+// Writes n_coords transformed values from every coords->src to coords->dst
+typedef GeoArrowErrorCode (*GeoArrowTransformCoordsFn)(
+    const struct GeoArrowTransformCoords* coords, int64_t n_coords, int has_z,
+    void* private_data, struct GeoArrowError* error);
+
+// Walks the source and output arrays together, pointing every buffer of out at the
+// corresponding source buffer except for the coordinate values, which are allocated
+static GeoArrowErrorCode GeoArrowTransformShareBuffers(
+    struct ArrowArrayView* src_view, struct ArrowArray* out,
+    struct GeoArrowSharedArray* shared, struct GeoArrowTransformCoords* coords) {
+  out->length = src_view->array->length;
+  out->offset = src_view->array->offset;
+  out->null_count = src_view->array->null_count;
+
+  for (int64_t i = 0; i < out->n_buffers; i++) {
+    struct ArrowBuffer* buffer = ArrowArrayBuffer(out, i);
+    struct ArrowBufferView* src_buffer = src_view->buffer_views + i;
+
+    if (src_view->storage_type == NANOARROW_TYPE_DOUBLE && i == 1) {
+      if (coords->n_values == 4) {
+        return EINVAL;
+      }
+
+      NANOARROW_RETURN_NOT_OK(ArrowBufferResize(buffer, src_buffer->n_bytes, 0));
+      buffer->size_bytes = src_buffer->n_bytes;
+      coords->src[coords->n_values] = src_buffer->data.as_double;
+      coords->dst[coords->n_values] = (double*)buffer->data;
+      coords->n_coords[coords->n_values] = src_buffer->n_bytes / sizeof(double);
+      coords->n_values++;
+    } else if (src_buffer->data.data != NULL) {
+      NANOARROW_RETURN_NOT_OK(ArrowBufferSetAllocator(
+          buffer, ArrowBufferDeallocator(&GeoArrowSharedBufferFree, shared)));
+      buffer->data = (uint8_t*)src_buffer->data.data;
+      buffer->size_bytes = src_buffer->n_bytes;
+      buffer->capacity_bytes = src_buffer->n_bytes;
+      shared->refcount++;
+    }
+  }
+
+  for (int64_t i = 0; i < out->n_children; i++) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowTransformShareBuffers(
+        src_view->children[i], out->children[i], shared, coords));
+  }
+
+  return GEOARROW_OK;
+}
+
+static GeoArrowErrorCode GeoArrowArrayViewTransformInternal(
+    struct GeoArrowArrayView* array_view, struct ArrowArrayView* src_view,
+    struct ArrowArray* array, GeoArrowTransformCoordsFn transform_coords,
+    void* private_data, struct ArrowArray* out, struct GeoArrowSharedArray* shared,
+    struct GeoArrowError* error) {
+  NANOARROW_RETURN_NOT_OK(
+      ArrowArrayViewSetArray(src_view, array, (struct ArrowError*)error));
+
+  struct GeoArrowTransformCoords coords;
+  memset(&coords, 0, sizeof(struct GeoArrowTransformCoords));
+  NANOARROW_RETURN_NOT_OK(GeoArrowTransformShareBuffers(src_view, out, shared, &coords));
+
+  if (coords.n_values != array_view->coords.n_values) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Expected %d coordinate buffers but found %d",
+                  (int)array_view->coords.n_values, (int)coords.n_values);
+    return EINVAL;
+  }
+
+  for (int32_t j = 1; j < coords.n_values; j++) {
+    if (coords.n_coords[j] != coords.n_coords[0]) {
+      ArrowErrorSet((struct ArrowError*)error,
+                    "Expected coordinate buffers with equal lengths but found %ld and "
+                    "%ld",
+                    (long)coords.n_coords[0], (long)coords.n_coords[j]);
+      return EINVAL;
+    }
+  }
+
+  int has_z = GeoArrowDimensionsHasZ(array_view->schema_view.dimensions);
+  NANOARROW_RETURN_NOT_OK(
+      transform_coords(&coords, coords.n_coords[0], has_z, private_data, error));
+  return ArrowArrayFinishBuilding(out, (struct ArrowError*)error);
+}
+
+static GeoArrowErrorCode GeoArrowArrayViewTransformCoords(
+    struct GeoArrowArrayView* array_view, struct ArrowArray* array,
+    GeoArrowTransformCoordsFn transform_coords, void* private_data,
+    struct ArrowArray* out, struct GeoArrowError* error) {
+  if (array_view->schema_view.coord_type != GEOARROW_COORD_TYPE_SEPARATE) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Can't transform array of type %d: expected a native array with "
+                  "separate coordinates",
+                  (int)array_view->schema_view.type);
+    return ENOTSUP;
+  }
+
+  struct ArrowSchema schema;
+  NANOARROW_RETURN_NOT_OK(GeoArrowSchemaInit(&schema, array_view->schema_view.type));
+
+  struct ArrowArrayView src_view;
+  int result =
+      ArrowArrayViewInitFromSchema(&src_view, &schema, (struct ArrowError*)error);
+  if (result != GEOARROW_OK) {
+    schema.release(&schema);
+    return result;
+  }
+
+  result = ArrowArrayInitFromSchema(out, &schema, (struct ArrowError*)error);
+  schema.release(&schema);
+  if (result != GEOARROW_OK) {
+    ArrowArrayViewReset(&src_view);
+    return result;
+  }
+
+  struct GeoArrowSharedArray* shared =
+      (struct GeoArrowSharedArray*)ArrowMalloc(sizeof(struct GeoArrowSharedArray));
+  if (shared == NULL) {
+    ArrowArrayViewReset(&src_view);
+    out->release(out);
+    return ENOMEM;
+  }
+
+  // The reference held here keeps the source from being released if an error
+  // occurs after some buffers have been shared
+  memcpy(&shared->array, array, sizeof(struct ArrowArray));
+  shared->refcount = 1;
+
+  result = GeoArrowArrayViewTransformInternal(array_view, &src_view, array,
+                                              transform_coords, private_data, out,
+                                              shared, error);
+  ArrowArrayViewReset(&src_view);
+  if (result != GEOARROW_OK) {
+    // Releasing out drops every other reference, leaving array with the caller
+    out->release(out);
+    ArrowFree(shared);
+    return result;
+  }
+
+  array->release = NULL;
+  GeoArrowSharedArrayRelease(shared);
+  return GEOARROW_OK;
+}
+
+static GeoArrowErrorCode GeoArrowAffineTransformCoords(
+    const struct GeoArrowTransformCoords* coords, int64_t n_coords, int has_z,
+    void* private_data, struct GeoArrowError* error) {
+  const struct GeoArrowAffine* affine = (const struct GeoArrowAffine*)private_data;
+  GeoArrowAffineApply(coords->src, coords->dst, n_coords, has_z, affine);
+
+  // m values are the last dimension when present and are copied as they are
+  int32_t n_transformed = has_z ? 3 : 2;
+  for (int32_t j = n_transformed; j < coords->n_values; j++) {
+    if (n_coords > 0) {
+      memcpy(coords->dst[j], coords->src[j], n_coords * sizeof(double));
+    }
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowArrayViewTransform(struct GeoArrowArrayView* array_view,
+                                             struct ArrowArray* array,
+                                             const struct GeoArrowAffine* affine,
+                                             struct ArrowArray* out,
+                                             struct GeoArrowError* error) {
+  return GeoArrowArrayViewTransformCoords(array_view, array,
+                                          &GeoArrowAffineTransformCoords,
+                                          (void*)affine, out, error);
+}
+
+static GeoArrowErrorCode GeoArrowCoordTransformApply(
+    struct GeoArrowCoordTransform* transform, double* x, double* y, double* z,
+    int64_t n, struct GeoArrowError* error) {
+  if (n == 0) {
+    return GEOARROW_OK;
+  }
+
+  int result = transform->transform(transform, x, y, z, n);
+  if (result != GEOARROW_OK) {
+    ArrowErrorSet((struct ArrowError*)error, "Coordinate transform failed with code %d",
+                  result);
+    return result;
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowCoordTransformUpdateSchema(
+    const struct GeoArrowCoordTransform* transform, struct ArrowSchema* schema,
+    struct GeoArrowError* error) {
+  struct GeoArrowSchemaView schema_view;
+  NANOARROW_RETURN_NOT_OK(GeoArrowSchemaViewInit(&schema_view, schema, error));
+
+  struct GeoArrowMetadataView metadata_view;
+  NANOARROW_RETURN_NOT_OK(
+      GeoArrowMetadataViewInit(&metadata_view, schema_view.extension_metadata, error));
+
+  metadata_view.crs_type = transform->crs_type;
+  metadata_view.crs = transform->crs;
+  return GeoArrowSchemaSetMetadata(schema, &metadata_view);
+}
+
+GeoArrowErrorCode GeoArrowWritableArrayViewReproject(
+    struct GeoArrowWritableArrayView* writable_view,
+    struct GeoArrowCoordTransform* transform, struct GeoArrowError* error) {
+  double* values[4];
+  int64_t n_coords;
+  NANOARROW_RETURN_NOT_OK(
+      GeoArrowWritableArrayViewCoords(writable_view, values, &n_coords));
+
+  double* z = NULL;
+  if (GeoArrowDimensionsHasZ(writable_view->schema_view.dimensions)) {
+    z = values[2];
+  }
+
+  return GeoArrowCoordTransformApply(transform, values[0], values[1], z, n_coords,
+                                     error);
+}
+
+static GeoArrowErrorCode GeoArrowReprojectCoords(
+    const struct GeoArrowTransformCoords* coords, int64_t n_coords, int has_z,
+    void* private_data, struct GeoArrowError* error) {
+  if (n_coords == 0) {
+    return GEOARROW_OK;
+  }
+
+  for (int32_t j = 0; j < coords->n_values; j++) {
+    memcpy(coords->dst[j], coords->src[j], n_coords * sizeof(double));
+  }
+
+  double* z = has_z ? coords->dst[2] : NULL;
+  return GeoArrowCoordTransformApply((struct GeoArrowCoordTransform*)private_data,
+                                     coords->dst[0], coords->dst[1], z, n_coords,
+                                     error);
+}
+
+GeoArrowErrorCode GeoArrowArrayViewReproject(struct GeoArrowArrayView* array_view,
+                                             struct ArrowArray* array,
+                                             struct GeoArrowCoordTransform* transform,
+                                             struct ArrowArray* out,
+                                             struct GeoArrowError* error) {
+  return GeoArrowArrayViewTransformCoords(array_view, array, &GeoArrowReprojectCoords,
+                                          transform, out, error);
+}
+
+enum ReprojectorEventType {
+  REPROJECTOR_EVENT_FEAT_START,
+  REPROJECTOR_EVENT_NULL_FEAT,
+  REPROJECTOR_EVENT_GEOM_START,
+  REPROJECTOR_EVENT_RING_START,
+  REPROJECTOR_EVENT_COORDS,
+  REPROJECTOR_EVENT_RING_END,
+  REPROJECTOR_EVENT_GEOM_END,
+  REPROJECTOR_EVENT_FEAT_END
+};
+
+struct ReprojectorEvent {
+  enum ReprojectorEventType type;
+  enum GeoArrowGeometryType geometry_type;
+  enum GeoArrowDimensions dimensions;
+  int64_t n_coords;
+};
+
+struct ReprojectorPrivate {
+  struct GeoArrowCoordTransform* transform;
+  struct GeoArrowVisitor* next;
+
+  // Dimensions of the geometries currently being visited
+  enum GeoArrowDimensions dimensions[32];
+  int32_t level;
+
+  // Events and coordinates that haven't been forwarded to next yet. Values are
+  // stored as separate x, y, z, and m buffers; z is only kept once a coordinate with
+  // a z value is seen (and is zero for coordinates without one).
+  struct ArrowBuffer events;
+  struct ArrowBuffer values[4];
+  int64_t n_coords;
+  int has_z;
+};
+
+static int ReprojectorAppendEvent(struct ReprojectorPrivate* private,
+                                  enum ReprojectorEventType type) {
+  struct ReprojectorEvent event;
+  memset(&event, 0, sizeof(struct ReprojectorEvent));
+  event.type = type;
+  return ArrowBufferAppend(&private->events, &event, sizeof(struct ReprojectorEvent));
+}
+
+// Appends column col of coords to buffer or zeroes if col is -1
+static int ReprojectorAppendValues(struct ArrowBuffer* buffer,
+                                   const struct GeoArrowCoordView* coords, int col) {
+  int64_t n = coords->n_coords;
+  if (col == -1) {
+    return ArrowBufferAppendFill(buffer, 0, n * sizeof(double));
+  }
+
+  NANOARROW_RETURN_NOT_OK(ArrowBufferReserve(buffer, n * sizeof(double)));
+  double* out = (double*)(buffer->data + buffer->size_bytes);
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = GeoArrowCoordViewValueUnaligned(coords, i, col);
+  }
+
+  buffer->size_bytes += n * sizeof(double);
+  return GEOARROW_OK;
+}
+
+static int ReprojectorAppendCoords(struct ReprojectorPrivate* private,
+                                   const struct GeoArrowCoordView* coords) {
+  enum GeoArrowDimensions dimensions = GEOARROW_DIMENSIONS_XY;
+  if (private->level > 0) {
+    dimensions = private->dimensions[private->level - 1];
+  }
+
+  // The number of values is what decides where z and m are
+  int z_col = -1;
+  int m_col = -1;
+  switch (coords->n_values) {
+    case 2:
+      dimensions = GEOARROW_DIMENSIONS_XY;
+      break;
+    case 3:
+      if (dimensions == GEOARROW_DIMENSIONS_XYM) {
+        m_col = 2;
+      } else {
+        dimensions = GEOARROW_DIMENSIONS_XYZ;
+        z_col = 2;
+      }
+      break;
+    case 4:
+      dimensions = GEOARROW_DIMENSIONS_XYZM;
+      z_col = 2;
+      m_col = 3;
+      break;
+    default:
+      return EINVAL;
+  }
+
+  struct ReprojectorEvent event;
+  memset(&event, 0, sizeof(struct ReprojectorEvent));
+  event.type = REPROJECTOR_EVENT_COORDS;
+  event.dimensions = dimensions;
+  event.n_coords = coords->n_coords;
+  NANOARROW_RETURN_NOT_OK(
+      ArrowBufferAppend(&private->events, &event, sizeof(struct ReprojectorEvent)));
+
+  // Keep z aligned with x and y from the first coordinate with a z value onwards
+  if (z_col != -1 && !private->has_z) {
+    NANOARROW_RETURN_NOT_OK(ArrowBufferAppendFill(&private->values[2], 0,
+                                                  private->n_coords * sizeof(double)));
+    private->has_z = 1;
+  }
+
+  NANOARROW_RETURN_NOT_OK(ReprojectorAppendValues(&private->values[0], coords, 0));
+  NANOARROW_RETURN_NOT_OK(ReprojectorAppendValues(&private->values[1], coords, 1));
+  if (private->has_z) {
+    NANOARROW_RETURN_NOT_OK(ReprojectorAppendValues(&private->values[2], coords, z_col));
+  }
+
+  if (m_col != -1) {
+    NANOARROW_RETURN_NOT_OK(ReprojectorAppendValues(&private->values[3], coords, m_col));
+  }
+
+  private->n_coords += coords->n_coords;
+  return GEOARROW_OK;
+}
+
+static int ReprojectorReplay(struct ReprojectorPrivate* private) {
+  struct GeoArrowVisitor* next = private->next;
+  const struct ReprojectorEvent* events =
+      (const struct ReprojectorEvent*)private->events.data;
+  int64_t n_events = private->events.size_bytes / sizeof(struct ReprojectorEvent);
+
+  const double* x = (const double*)private->values[0].data;
+  const double* y = (const double*)private->values[1].data;
+  const double* z = (const double*)private->values[2].data;
+  const double* m = (const double*)private->values[3].data;
+  int64_t xyz_offset = 0;
+  int64_t m_offset = 0;
+
+  struct GeoArrowCoordView coords;
+  coords.coords_stride = 1;
+
+  for (int64_t i = 0; i < n_events; i++) {
+    const struct ReprojectorEvent* event = events + i;
+    switch (event->type) {
+      case REPROJECTOR_EVENT_FEAT_START:
+        NANOARROW_RETURN_NOT_OK(next->feat_start(next));
+        break;
+      case REPROJECTOR_EVENT_NULL_FEAT:
+        NANOARROW_RETURN_NOT_OK(next->null_feat(next));
+        break;
+      case REPROJECTOR_EVENT_GEOM_START:
+        NANOARROW_RETURN_NOT_OK(
+            next->geom_start(next, event->geometry_type, event->dimensions));
+        break;
+      case REPROJECTOR_EVENT_RING_START:
+        NANOARROW_RETURN_NOT_OK(next->ring_start(next));
+        break;
+      case REPROJECTOR_EVENT_COORDS:
+        coords.n_coords = event->n_coords;
+        coords.values[0] = x + xyz_offset;
+        coords.values[1] = y + xyz_offset;
+        switch (event->dimensions) {
+          case GEOARROW_DIMENSIONS_XYZ:
+            coords.values[2] = z + xyz_offset;
+            coords.n_values = 3;
+            break;
+          case GEOARROW_DIMENSIONS_XYM:
+            coords.values[2] = m + m_offset;
+            coords.n_values = 3;
+            m_offset += event->n_coords;
+            break;
+          case GEOARROW_DIMENSIONS_XYZM:
+            coords.values[2] = z + xyz_offset;
+            coords.values[3] = m + m_offset;
+            coords.n_values = 4;
+            m_offset += event->n_coords;
+            break;
+          default:
+            coords.n_values = 2;
+            break;
+        }
+
+        xyz_offset += event->n_coords;
+        NANOARROW_RETURN_NOT_OK(next->coords(next, &coords));
+        break;
+      case REPROJECTOR_EVENT_RING_END:
+        NANOARROW_RETURN_NOT_OK(next->ring_end(next));
+        break;
+      case REPROJECTOR_EVENT_GEOM_END:
+        NANOARROW_RETURN_NOT_OK(next->geom_end(next));
+        break;
+      case REPROJECTOR_EVENT_FEAT_END:
+        NANOARROW_RETURN_NOT_OK(next->feat_end(next));
+        break;
+    }
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowReprojectorFlush(struct GeoArrowReprojector* reprojector,
+                                           struct GeoArrowError* error) {
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+
+  double* z = NULL;
+  if (private->has_z) {
+    z = (double*)private->values[2].data;
+  }
+
+  int result = GeoArrowCoordTransformApply(
+      private->transform, (double*)private->values[0].data,
+      (double*)private->values[1].data, z, private->n_coords, error);
+  if (result == GEOARROW_OK) {
+    result = ReprojectorReplay(private);
+  }
+
+  // Pending features are dropped even if the transform or the next visitor failed
+  private->events.size_bytes = 0;
+  for (int j = 0; j < 4; j++) {
+    private->values[j].size_bytes = 0;
+  }
+  private->n_coords = 0;
+  private->has_z = 0;
+  return result;
+}
+
+static int reserve_coord_reproject(struct GeoArrowVisitor* v, int64_t n) {
+  struct GeoArrowReprojector* reprojector = (struct GeoArrowReprojector*)v->private_data;
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  return private->next->reserve_coord(private->next, n);
+}
+
+static int reserve_feat_reproject(struct GeoArrowVisitor* v, int64_t n) {
+  struct GeoArrowReprojector* reprojector = (struct GeoArrowReprojector*)v->private_data;
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  return private->next->reserve_feat(private->next, n);
+}
+
+static int feat_start_reproject(struct GeoArrowVisitor* v) {
+  struct GeoArrowReprojector* reprojector = (struct GeoArrowReprojector*)v->private_data;
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  private->level = 0;
+  return ReprojectorAppendEvent(private, REPROJECTOR_EVENT_FEAT_START);
+}
+
+static int null_feat_reproject(struct GeoArrowVisitor* v) {
+  struct GeoArrowReprojector* reprojector = (struct GeoArrowReprojector*)v->private_data;
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  return ReprojectorAppendEvent(private, REPROJECTOR_EVENT_NULL_FEAT);
+}
+
+static int geom_start_reproject(struct GeoArrowVisitor* v,
+                                enum GeoArrowGeometryType geometry_type,
+                                enum GeoArrowDimensions dimensions) {
+  struct GeoArrowReprojector* reprojector = (struct GeoArrowReprojector*)v->private_data;
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  if (private->level < 0 || private->level > 30) {
+    return EINVAL;
+  }
+
+  private->dimensions[private->level++] = dimensions;
+
+  struct ReprojectorEvent event;
+  memset(&event, 0, sizeof(struct ReprojectorEvent));
+  event.type = REPROJECTOR_EVENT_GEOM_START;
+  event.geometry_type = geometry_type;
+  event.dimensions = dimensions;
+  return ArrowBufferAppend(&private->events, &event, sizeof(struct ReprojectorEvent));
+}
+
+static int ring_start_reproject(struct GeoArrowVisitor* v) {
+  struct GeoArrowReprojector* reprojector = (struct GeoArrowReprojector*)v->private_data;
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  return ReprojectorAppendEvent(private, REPROJECTOR_EVENT_RING_START);
+}
+
+static int coords_reproject(struct GeoArrowVisitor* v,
+                            const struct GeoArrowCoordView* coords) {
+  struct GeoArrowReprojector* reprojector = (struct GeoArrowReprojector*)v->private_data;
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  return ReprojectorAppendCoords(private, coords);
+}
+
+static int ring_end_reproject(struct GeoArrowVisitor* v) {
+  struct GeoArrowReprojector* reprojector = (struct GeoArrowReprojector*)v->private_data;
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  return ReprojectorAppendEvent(private, REPROJECTOR_EVENT_RING_END);
+}
+
+static int geom_end_reproject(struct GeoArrowVisitor* v) {
+  struct GeoArrowReprojector* reprojector = (struct GeoArrowReprojector*)v->private_data;
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  private->level--;
+  return ReprojectorAppendEvent(private, REPROJECTOR_EVENT_GEOM_END);
+}
+
+static int feat_end_reproject(struct GeoArrowVisitor* v) {
+  struct GeoArrowReprojector* reprojector = (struct GeoArrowReprojector*)v->private_data;
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  NANOARROW_RETURN_NOT_OK(ReprojectorAppendEvent(private, REPROJECTOR_EVENT_FEAT_END));
+
+  // Features are never split between batches
+  if (private->n_coords >= reprojector->batch_size) {
+    return GeoArrowReprojectorFlush(reprojector, v->error);
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowReprojectorInit(struct GeoArrowReprojector* reprojector,
+                                          struct GeoArrowCoordTransform* transform) {
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)ArrowMalloc(sizeof(struct ReprojectorPrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct ReprojectorPrivate));
+  private->transform = transform;
+  ArrowBufferInit(&private->events);
+  for (int j = 0; j < 4; j++) {
+    ArrowBufferInit(&private->values[j]);
+  }
+
+  reprojector->batch_size = 65536;
+  reprojector->private_data = private;
+  return GEOARROW_OK;
+}
+
+void GeoArrowReprojectorInitVisitor(struct GeoArrowReprojector* reprojector,
+                                    struct GeoArrowVisitor* next,
+                                    struct GeoArrowVisitor* v) {
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  private->next = next;
+
+  GeoArrowVisitorInitVoid(v);
+  v->reserve_coord = &reserve_coord_reproject;
+  v->reserve_feat = &reserve_feat_reproject;
+  v->feat_start = &feat_start_reproject;
+  v->null_feat = &null_feat_reproject;
+  v->geom_start = &geom_start_reproject;
+  v->ring_start = &ring_start_reproject;
+  v->coords = &coords_reproject;
+  v->ring_end = &ring_end_reproject;
+  v->geom_end = &geom_end_reproject;
+  v->feat_end = &feat_end_reproject;
+  v->private_data = reprojector;
+}
+
+void GeoArrowReprojectorReset(struct GeoArrowReprojector* reprojector) {
+  struct ReprojectorPrivate* private =
+      (struct ReprojectorPrivate*)reprojector->private_data;
+  ArrowBufferReset(&private->events);
+  for (int j = 0; j < 4; j++) {
+    ArrowBufferReset(&private->values[j]);
+  }
+
+  ArrowFree(private);
+  reprojector->private_data = NULL;
+}
@@ -0,0 +1,483 @@
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+static std::vector<std::string> TransformInPlace(enum GeoArrowType type,
+                                                 const struct GeoArrowAffine& affine,
+                                                 const std::vector<std::string>& wkts) {
+  struct GeoArrowBuilder builder;
+  EXPECT_EQ(GeoArrowBuilderInitFromType(&builder, type), GEOARROW_OK);
+  BuildFromWKT(&builder, wkts);
+  EXPECT_EQ(GeoArrowWritableArrayViewTransform(&builder.view, &affine), GEOARROW_OK);
+
+  struct ArrowArray array;
+  EXPECT_EQ(GeoArrowBuilderFinish(&builder, &array, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+
+  auto values = ArrayToWKT(type, &array);
+  array.release(&array);
+  return values;
+}
+
+TEST(TransformTest, TransformTestIdentity) {
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) {
+      EXPECT_EQ(affine.matrix[i][j], i == j ? 1 : 0);
+    }
+  }
+
+  EXPECT_EQ(TransformInPlace(GEOARROW_TYPE_LINESTRING_Z, affine,
+                             {"LINESTRING Z (0 1 2, 3 4 5)"}),
+            std::vector<std::string>({"LINESTRING Z (0 1 2, 3 4 5)"}));
+}
+
+TEST(TransformTest, TransformTestScaleTranslate) {
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  affine.matrix[0][0] = 2;
+  affine.matrix[0][3] = 10;
+  affine.matrix[1][1] = -1;
+  affine.matrix[1][3] = 256;
+
+  EXPECT_EQ(TransformInPlace(GEOARROW_TYPE_MULTILINESTRING, affine,
+                             {"MULTILINESTRING ((0 0, 1 1), (2 3, 4 5))", "",
+                              "MULTILINESTRING EMPTY"}),
+            std::vector<std::string>(
+                {"MULTILINESTRING ((10 256, 12 255), (14 253, 18 251))", "<null value>",
+                 "MULTILINESTRING EMPTY"}));
+
+  // m values are never transformed
+  EXPECT_EQ(TransformInPlace(GEOARROW_TYPE_POINT_M, affine, {"POINT M (1 2 3)"}),
+            std::vector<std::string>({"POINT M (12 254 3)"}));
+
+  // z terms are ignored when there is no z
+  affine.matrix[0][2] = 100;
+  EXPECT_EQ(TransformInPlace(GEOARROW_TYPE_POINT, affine, {"POINT (1 2)"}),
+            std::vector<std::string>({"POINT (12 254)"}));
+}
+
+TEST(TransformTest, TransformTestGeneral) {
+  // Rotate 90 degrees counterclockwise around the origin, then translate
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  affine.matrix[0][0] = 0;
+  affine.matrix[0][1] = -1;
+  affine.matrix[0][3] = 1;
+  affine.matrix[1][0] = 1;
+  affine.matrix[1][1] = 0;
+
+  EXPECT_EQ(TransformInPlace(GEOARROW_TYPE_POLYGON, affine,
+                             {"POLYGON ((0 0, 1 0, 0 1, 0 0))"}),
+            std::vector<std::string>({"POLYGON ((1 0, 1 1, 0 0, 1 0))"}));
+
+  EXPECT_EQ(TransformInPlace(GEOARROW_TYPE_POINT_ZM, affine, {"POINT ZM (1 2 3 4)"}),
+            std::vector<std::string>({"POINT ZM (-1 1 3 4)"}));
+
+  // Shear z by x
+  affine.matrix[2][0] = 2;
+  EXPECT_EQ(TransformInPlace(GEOARROW_TYPE_POINT_Z, affine, {"POINT Z (1 2 3)"}),
+            std::vector<std::string>({"POINT Z (-1 1 5)"}));
+}
+
+TEST(TransformTest, TransformTestMany) {
+  // Enough coordinates to exercise both the vectorized loop and the scalar remainder
+  std::string wkt = "MULTIPOINT Z (";
+  for (int i = 0; i < 1023; i++) {
+    if (i > 0) {
+      wkt += ", ";
+    }
+    wkt += std::to_string(i) + " " + std::to_string(-i) + " " + std::to_string(2 * i);
+  }
+  wkt += ")";
+
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) {
+      affine.matrix[i][j] = i + 2 * j + 0.5;
+    }
+  }
+
+  struct GeoArrowBuilder builder;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_MULTIPOINT_Z),
+            GEOARROW_OK);
+  BuildFromWKT(&builder, {wkt});
+  ASSERT_EQ(GeoArrowWritableArrayViewTransform(&builder.view, &affine), GEOARROW_OK);
+
+  for (int64_t i = 0; i < 1023; i++) {
+    double x = i;
+    double y = -i;
+    double z = 2 * i;
+    for (int j = 0; j < 3; j++) {
+      const double* m = affine.matrix[j];
+      double expected = m[0] * x + m[1] * y + m[2] * z + m[3];
+      ASSERT_EQ(builder.view.buffers[2 + j].data.as_double[i], expected)
+          << "dimension " << j << " coordinate " << i;
+    }
+  }
+
+  GeoArrowBuilderReset(&builder);
+}
+
+TEST(TransformTest, TransformTestArrayView) {
+  struct GeoArrowBuilder builder;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_MULTIPOLYGON),
+            GEOARROW_OK);
+  BuildFromWKT(&builder, {"MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)))", "",
+                          "MULTIPOLYGON (((10 10, 11 10, 10 11, 10 10)), "
+                          "((0 0, 1 0, 0 1, 0 0), (0 0, 0.5 0, 0 0.5, 0 0)))",
+                          "MULTIPOLYGON EMPTY"});
+
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+
+  const void* validity = array.buffers[0];
+  const void* offsets = array.children[0]->children[0]->buffers[1];
+  const void* x = array.children[0]->children[0]->children[0]->children[0]->buffers[1];
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_MULTIPOLYGON),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  affine.matrix[0][0] = 2;
+  affine.matrix[1][1] = 2;
+  affine.matrix[1][3] = 1;
+
+  struct ArrowArray out;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowArrayViewTransform(&array_view, &array, &affine, &out, &error),
+            GEOARROW_OK)
+      << error.message;
+  EXPECT_EQ(array.release, nullptr);
+
+  // Validity and offsets are shared, coordinates are not
+  EXPECT_EQ(out.buffers[0], validity);
+  EXPECT_EQ(out.children[0]->children[0]->buffers[1], offsets);
+  EXPECT_NE(out.children[0]->children[0]->children[0]->children[0]->buffers[1], x);
+
+  EXPECT_EQ(out.null_count, 1);
+  EXPECT_EQ(ArrayToWKT(GEOARROW_TYPE_MULTIPOLYGON, &out),
+            std::vector<std::string>(
+                {"MULTIPOLYGON (((0 1, 2 1, 0 3, 0 1)))", "<null value>",
+                 "MULTIPOLYGON (((20 21, 22 21, 20 23, 20 21)), "
+                 "((0 1, 2 1, 0 3, 0 1), (0 1, 1 1, 0 2, 0 1)))",
+                 "MULTIPOLYGON EMPTY"}));
+
+  // The original coordinates are untouched
+  EXPECT_EQ(array_view.coords.values[0][0], 0);
+
+  out.release(&out);
+}
+
+TEST(TransformTest, TransformTestArrayViewM) {
+  struct GeoArrowBuilder builder;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_LINESTRING_M),
+            GEOARROW_OK);
+  BuildFromWKT(&builder, {"LINESTRING M (0 1 2, 3 4 5)"});
+
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_LINESTRING_M),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  affine.matrix[0][1] = 1;
+
+  struct ArrowArray out;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowArrayViewTransform(&array_view, &array, &affine, &out, &error),
+            GEOARROW_OK)
+      << error.message;
+  EXPECT_EQ(ArrayToWKT(GEOARROW_TYPE_LINESTRING_M, &out),
+            std::vector<std::string>({"LINESTRING M (1 1 2, 7 4 5)"}));
+  out.release(&out);
+}
+
+TEST(TransformTest, TransformTestErrors) {
+  struct GeoArrowBuilder builder;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  BuildFromWKT(&builder, {"POINT (0 1)"});
+
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_POINT),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  struct GeoArrowAffine affine;
+  GeoArrowAffineInitIdentity(&affine);
+  struct ArrowArray out;
+  struct GeoArrowError error;
+
+  // An array that doesn't match the array view is left with the caller
+  array_view.schema_view.type = GEOARROW_TYPE_LINESTRING;
+  EXPECT_EQ(GeoArrowArrayViewTransform(&array_view, &array, &affine, &out, &error),
+            EINVAL);
+  ASSERT_NE(array.release, nullptr);
+
+  array_view.schema_view.type = GEOARROW_TYPE_WKB;
+  array_view.schema_view.coord_type = GEOARROW_COORD_TYPE_UNKNOWN;
+  EXPECT_EQ(GeoArrowArrayViewTransform(&array_view, &array, &affine, &out, &error),
+            ENOTSUP);
+  ASSERT_NE(array.release, nullptr);
+
+  array.release(&array);
+}
+
+struct TestTransformState {
+  std::vector<int64_t> batch_sizes;
+  std::vector<bool> has_z;
+  int result = GEOARROW_OK;
+};
+
+// Doubles x, adds one to y, and multiplies z by ten
+static int TestTransform(struct GeoArrowCoordTransform* transform, double* x, double* y,
+                         double* z, int64_t n) {
+  auto state = reinterpret_cast<TestTransformState*>(transform->private_data);
+  state->batch_sizes.push_back(n);
+  state->has_z.push_back(z != nullptr);
+  for (int64_t i = 0; i < n; i++) {
+    x[i] *= 2;
+    y[i] += 1;
+    if (z != nullptr) {
+      z[i] *= 10;
+    }
+  }
+
+  return state->result;
+}
+
+static void TestTransformInit(struct GeoArrowCoordTransform* transform,
+                              TestTransformState* state) {
+  transform->transform = &TestTransform;
+  transform->crs_type = GEOARROW_CRS_TYPE_UNKNOWN;
+  transform->crs = {"EPSG:3857", 9};
+  transform->private_data = state;
+}
+
+TEST(TransformTest, TransformTestReprojectorBatches) {
+  std::vector<std::string> wkts;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 1000; i++) {
+    wkts.push_back("POINT (" + std::to_string(i) + " 0)");
+    expected.push_back("POINT (" + std::to_string(2 * i) + " 1)");
+  }
+
+  struct GeoArrowBuilder builder;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  BuildFromWKT(&builder, wkts);
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_POINT),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  TestTransformState state;
+  struct GeoArrowCoordTransform transform;
+  TestTransformInit(&transform, &state);
+
+  struct GeoArrowReprojector reprojector;
+  ASSERT_EQ(GeoArrowReprojectorInit(&reprojector, &transform), GEOARROW_OK);
+  EXPECT_EQ(reprojector.batch_size, 65536);
+  reprojector.batch_size = 128;
+
+  WKXTester tester;
+  struct GeoArrowVisitor v;
+  struct GeoArrowError error;
+  GeoArrowReprojectorInitVisitor(&reprojector, tester.WKTVisitor(), &v);
+  v.error = &error;
+
+  ASSERT_EQ(GeoArrowArrayViewVisit(&array_view, 0, 600, &v), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewVisit(&array_view, 600, 400, &v), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowReprojectorFlush(&reprojector, &error), GEOARROW_OK);
+
+  // Flushing with nothing pending doesn't call the transform
+  ASSERT_EQ(GeoArrowReprojectorFlush(&reprojector, &error), GEOARROW_OK);
+  GeoArrowReprojectorReset(&reprojector);
+
+  EXPECT_EQ(state.batch_sizes,
+            std::vector<int64_t>({128, 128, 128, 128, 128, 128, 128, 104}));
+  EXPECT_EQ(state.has_z, std::vector<bool>(8, false));
+  EXPECT_EQ(tester.WKTValues(), expected);
+  array.release(&array);
+}
+
+TEST(TransformTest, TransformTestReprojectorDimensions) {
+  TestTransformState state;
+  struct GeoArrowCoordTransform transform;
+  TestTransformInit(&transform, &state);
+
+  struct GeoArrowReprojector reprojector;
+  ASSERT_EQ(GeoArrowReprojectorInit(&reprojector, &transform), GEOARROW_OK);
+
+  WKXTester tester;
+  struct GeoArrowVisitor v;
+  struct GeoArrowError error;
+  GeoArrowReprojectorInitVisitor(&reprojector, tester.WKTVisitor(), &v);
+  v.error = &error;
+
+  struct GeoArrowWKTReader reader;
+  GeoArrowWKTReaderInit(&reader);
+  for (std::string wkt :
+       {"POINT (1 2)", "LINESTRING M (1 2 3, 4 5 6)", "POINT Z (1 2 3)",
+        "POLYGON ZM ((0 0 1 7, 1 0 2 8, 0 1 3 9, 0 0 1 7))",
+        "GEOMETRYCOLLECTION (POINT (1 2), POINT M (1 2 3))"}) {
+    struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+    ASSERT_EQ(GeoArrowWKTReaderVisit(&reader, item, &v), GEOARROW_OK) << error.message;
+  }
+
+  ASSERT_EQ(v.feat_start(&v), GEOARROW_OK);
+  ASSERT_EQ(v.null_feat(&v), GEOARROW_OK);
+  ASSERT_EQ(v.feat_end(&v), GEOARROW_OK);
+
+  // Nothing is forwarded until the flush
+  EXPECT_TRUE(state.batch_sizes.empty());
+  ASSERT_EQ(GeoArrowReprojectorFlush(&reprojector, &error), GEOARROW_OK);
+  GeoArrowWKTReaderReset(&reader);
+  GeoArrowReprojectorReset(&reprojector);
+
+  EXPECT_EQ(state.batch_sizes, std::vector<int64_t>({10}));
+  EXPECT_EQ(state.has_z, std::vector<bool>({true}));
+  EXPECT_EQ(tester.WKTValues("<null value>"),
+            std::vector<std::string>(
+                {"POINT (2 3)", "LINESTRING M (2 3 3, 8 6 6)", "POINT Z (2 3 30)",
+                 "POLYGON ZM ((0 1 10 7, 2 1 20 8, 0 2 30 9, 0 1 10 7))",
+                 "GEOMETRYCOLLECTION (POINT (2 3), POINT M (2 3 3))", "<null value>"}));
+}
+
+TEST(TransformTest, TransformTestReprojectorError) {
+  TestTransformState state;
+  state.result = EDOM;
+  struct GeoArrowCoordTransform transform;
+  TestTransformInit(&transform, &state);
+
+  struct GeoArrowReprojector reprojector;
+  ASSERT_EQ(GeoArrowReprojectorInit(&reprojector, &transform), GEOARROW_OK);
+  reprojector.batch_size = 1;
+
+  WKXTester tester;
+  struct GeoArrowVisitor v;
+  struct GeoArrowError error;
+  GeoArrowReprojectorInitVisitor(&reprojector, tester.WKTVisitor(), &v);
+  v.error = &error;
+
+  struct GeoArrowWKTReader reader;
+  GeoArrowWKTReaderInit(&reader);
+  std::string wkt = "POINT (1 2)";
+  struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+  EXPECT_EQ(GeoArrowWKTReaderVisit(&reader, item, &v), EDOM);
+  EXPECT_STREQ(error.message, "Coordinate transform failed with code 33");
+
+  GeoArrowWKTReaderReset(&reader);
+  GeoArrowReprojectorReset(&reprojector);
+}
+
+TEST(TransformTest, TransformTestReprojectArray) {
+  struct GeoArrowBuilder builder;
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_LINESTRING_Z),
+            GEOARROW_OK);
+  BuildFromWKT(&builder,
+               {"LINESTRING Z (0 0 1, 1 1 2)", "", "LINESTRING Z (2 2 3, 3 3 4)"});
+
+  TestTransformState state;
+  struct GeoArrowCoordTransform transform;
+  TestTransformInit(&transform, &state);
+  struct GeoArrowError error;
+
+  // In place
+  ASSERT_EQ(GeoArrowWritableArrayViewReproject(&builder.view, &transform, &error),
+            GEOARROW_OK);
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+  EXPECT_EQ(state.batch_sizes, std::vector<int64_t>({4}));
+  EXPECT_EQ(state.has_z, std::vector<bool>({true}));
+
+  // Into a new array that shares the offsets
+  struct GeoArrowArrayView array_view;
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_LINESTRING_Z),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+  const void* offsets = array.buffers[1];
+
+  struct ArrowArray out;
+  ASSERT_EQ(GeoArrowArrayViewReproject(&array_view, &array, &transform, &out, &error),
+            GEOARROW_OK)
+      << error.message;
+  EXPECT_EQ(out.buffers[1], offsets);
+  EXPECT_EQ(state.batch_sizes, std::vector<int64_t>({4, 4}));
+  EXPECT_EQ(ArrayToWKT(GEOARROW_TYPE_LINESTRING_Z, &out),
+            std::vector<std::string>({"LINESTRING Z (0 2 100, 4 3 200)", "<null value>",
+                                      "LINESTRING Z (8 4 300, 12 5 400)"}));
+  out.release(&out);
+
+  // Errors leave the input with the caller
+  ASSERT_EQ(GeoArrowBuilderInitFromType(&builder, GEOARROW_TYPE_POINT), GEOARROW_OK);
+  BuildFromWKT(&builder, {"POINT (0 1)"});
+  ASSERT_EQ(GeoArrowBuilderFinish(&builder, &array, nullptr), GEOARROW_OK);
+  GeoArrowBuilderReset(&builder);
+  ASSERT_EQ(GeoArrowArrayViewInitFromType(&array_view, GEOARROW_TYPE_POINT),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+
+  state.result = EDOM;
+  EXPECT_EQ(GeoArrowArrayViewReproject(&array_view, &array, &transform, &out, &error),
+            EDOM);
+  EXPECT_STREQ(error.message, "Coordinate transform failed with code 33");
+  ASSERT_NE(array.release, nullptr);
+  array.release(&array);
+}
+
+TEST(TransformTest, TransformTestUpdateSchema) {
+  struct ArrowSchema schema;
+  ASSERT_EQ(GeoArrowSchemaInitExtension(&schema, GEOARROW_TYPE_POINT), GEOARROW_OK);
+
+  struct GeoArrowMetadataView metadata_view;
+  ASSERT_EQ(GeoArrowMetadataViewInit(&metadata_view, {nullptr, 0}, nullptr),
+            GEOARROW_OK);
+  metadata_view.edge_type = GEOARROW_EDGE_TYPE_SPHERICAL;
+  metadata_view.crs_type = GEOARROW_CRS_TYPE_UNKNOWN;
+  metadata_view.crs = {"OGC:CRS84", 9};
+  ASSERT_EQ(GeoArrowSchemaSetMetadata(&schema, &metadata_view), GEOARROW_OK);
+
+  TestTransformState state;
+  struct GeoArrowCoordTransform transform;
+  TestTransformInit(&transform, &state);
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowCoordTransformUpdateSchema(&transform, &schema, &error),
+            GEOARROW_OK)
+      << error.message;
+
+  struct GeoArrowSchemaView schema_view;
+  ASSERT_EQ(GeoArrowSchemaViewInit(&schema_view, &schema, &error), GEOARROW_OK);
+  EXPECT_EQ(std::string(schema_view.extension_metadata.data,
+                        schema_view.extension_metadata.n_bytes),
+            R"({"edges":"spherical","crs":"EPSG:3857"})");
+
+  // The storage type isn't a geoarrow extension type
+  schema.release(&schema);
+  ASSERT_EQ(ArrowSchemaInit(&schema, NANOARROW_TYPE_INT32), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowCoordTransformUpdateSchema(&transform, &schema, &error), EINVAL);
+  schema.release(&schema);
+}
@@ -0,0 +1,451 @@
+
+#include <errno.h>
+#include <string.h>
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+#include "sync.h"
+
+// Geoarrow storage types nest only a few levels deep, so no schema that
+// GeoArrowSchemaViewInit() accepts has more ancestors than this
+#define TYPE_CACHE_MAX_DEPTH 16
+
+// Lookups don't take a lock: entries and slot arrays are published with release
+// stores and read with acquire loads, and nothing a reader can reach is modified or
+// freed before GeoArrowTypeCacheReset(). Only inserts are serialized.
+#define TYPE_CACHE_LOAD(ptr) GEOARROW_ATOMIC_LOAD_PTR(ptr)
+#define TYPE_CACHE_STORE(ptr, value) GEOARROW_ATOMIC_STORE_PTR(ptr, value)
+
+struct TypeCacheEntry {
+  uint64_t hash;
+  struct ArrowBuffer fingerprint;
+
+  // Holds the extension name and metadata; the string views in schema_view and
+  // metadata_view point into it
+  struct ArrowBuffer strings;
+  struct GeoArrowSchemaView schema_view;
+  struct GeoArrowMetadataView metadata_view;
+};
+
+// An open addressing table with linear probing whose number of slots is a power of
+// two. Growing allocates a new table instead of rehashing in place so that a reader
+// still probing the old one sees a consistent (if stale) set of entries.
+struct TypeCacheTable {
+  int64_t n_slots;
+  struct TypeCacheTable* previous;
+  struct TypeCacheEntry* slots[];
+};
+
+struct TypeCachePrivate {
+  struct TypeCacheTable* table;
+  int64_t n_entries;
+  struct GeoArrowMutex insert_lock;
+};
+
+static void GeoArrowTypeCacheLock(struct TypeCachePrivate* private) {
+  GeoArrowMutexLock(&private->insert_lock);
+}
+
+static void GeoArrowTypeCacheUnlock(struct TypeCachePrivate* private) {
+  GeoArrowMutexUnlock(&private->insert_lock);
+}
+
+// The number of bytes of serialized metadata (like ArrowMetadataSizeOf()), reading
+// only the lengths
+static inline int64_t GeoArrowTypeCacheMetadataSize(const char* metadata) {
+  if (metadata == NULL) {
+    return 0;
+  }
+
+  int32_t n_items;
+  int32_t n_bytes;
+  memcpy(&n_items, metadata, sizeof(int32_t));
+  int64_t size = sizeof(int32_t);
+  for (int32_t i = 0; i < (2 * n_items); i++) {
+    memcpy(&n_bytes, metadata + size, sizeof(int32_t));
+    size += sizeof(int32_t) + n_bytes;
+  }
+
+  return size;
+}
+
+// A cheap hash of the root of schema: the start of its format, its number of children
+// and the size and last bytes of its metadata (where the CRS ends). Everything else is
+// only checked by GeoArrowTypeCacheMatch(), which has to visit it anyway, so hashing
+// costs the same for any size of metadata.
+static inline uint64_t GeoArrowTypeCacheHash(struct ArrowSchema* schema,
+                                             int64_t metadata_size) {
+  uint64_t hash = ((uint64_t)schema->n_children << 48) | ((uint64_t)metadata_size << 16);
+  if (schema->format != NULL && schema->format[0] != '\0') {
+    hash |= ((uint64_t)(uint8_t)schema->format[0] << 8) | (uint8_t)schema->format[1];
+  }
+
+  uint64_t tail = 0;
+  if (metadata_size >= (int64_t)sizeof(uint64_t)) {
+    memcpy(&tail, schema->metadata + metadata_size - sizeof(uint64_t),
+           sizeof(uint64_t));
+  }
+
+  // Mix every bit into the low bits used to pick a slot
+  hash ^= tail * 0x9E3779B97F4A7C15ULL;
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDULL;
+  return hash ^ (hash >> 33);
+}
+
+// Writes the parts of a schema tree that GeoArrowSchemaViewInit() reads below the
+// root: the format and number of children of each node, plus the names of the
+// children of a struct (which carry the coordinate dimensions). Other names, flags
+// and child metadata can't change the result of parsing and are left out so that
+// matching stays cheap.
+static GeoArrowErrorCode GeoArrowTypeCacheFingerprintNode(struct ArrowSchema* schema,
+                                                          int name_matters, int depth,
+                                                          struct ArrowBuffer* out) {
+  if (schema->n_children > 0 && depth == TYPE_CACHE_MAX_DEPTH) {
+    return EINVAL;
+  }
+
+  NANOARROW_RETURN_NOT_OK(ArrowBufferAppend(out, &schema->n_children, sizeof(int64_t)));
+  NANOARROW_RETURN_NOT_OK(
+      ArrowBufferAppend(out, schema->format, strlen(schema->format) + 1));
+  if (name_matters) {
+    NANOARROW_RETURN_NOT_OK(
+        ArrowBufferAppend(out, schema->name, strlen(schema->name) + 1));
+  }
+
+  int is_struct = strcmp(schema->format, "+s") == 0;
+  for (int64_t i = 0; i < schema->n_children; i++) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowTypeCacheFingerprintNode(schema->children[i],
+                                                             is_struct, depth + 1, out));
+  }
+
+  return GEOARROW_OK;
+}
+
+// Only called for schemas that GeoArrowSchemaViewInit() accepted, whose formats and
+// fingerprinted names are never NULL
+static GeoArrowErrorCode GeoArrowTypeCacheFingerprint(struct ArrowSchema* schema,
+                                                      int64_t metadata_size,
+                                                      struct ArrowBuffer* out) {
+  NANOARROW_RETURN_NOT_OK(ArrowBufferAppend(out, &metadata_size, sizeof(int64_t)));
+  if (metadata_size > 0) {
+    NANOARROW_RETURN_NOT_OK(ArrowBufferAppend(out, schema->metadata, metadata_size));
+  }
+
+  return GeoArrowTypeCacheFingerprintNode(schema, 0, 0, out);
+}
+
+// Compares value against the nul-terminated string at *data and advances *data past
+// it on a match. The stored terminator stops the loop before either string ends.
+static inline int GeoArrowTypeCacheMatchString(const char* value,
+                                               const uint8_t** data) {
+  const uint8_t* stored = *data;
+  if (value == NULL) {
+    return 0;
+  }
+
+  while (*stored == (uint8_t)*value) {
+    if (*value == '\0') {
+      *data = stored + 1;
+      return 1;
+    }
+
+    stored++;
+    value++;
+  }
+
+  return 0;
+}
+
+// Compares the tree of schema in place against the fingerprint written by
+// GeoArrowTypeCacheFingerprintNode(), visiting nodes in the same depth-first order.
+// This is the bulk of a cache hit, so it keeps its own stack of parents instead of
+// recursing. Fields are compared in the order they were written, so data never moves
+// past the end of the fingerprint. Returns non-zero on a match.
+static int GeoArrowTypeCacheMatchTree(struct ArrowSchema* schema, const uint8_t* data) {
+  struct ArrowSchema* parents[TYPE_CACHE_MAX_DEPTH];
+  int64_t child_index[TYPE_CACHE_MAX_DEPTH];
+  int depth = 0;
+  int name_matters = 0;
+
+  for (;;) {
+    int64_t n_children;
+    memcpy(&n_children, data, sizeof(int64_t));
+    data += sizeof(int64_t);
+    if (n_children != schema->n_children ||
+        !GeoArrowTypeCacheMatchString(schema->format, &data) ||
+        (name_matters && !GeoArrowTypeCacheMatchString(schema->name, &data))) {
+      return 0;
+    }
+
+    if (n_children > 0) {
+      // The fingerprint was never this deep, so this can't be a match
+      if (depth == TYPE_CACHE_MAX_DEPTH) {
+        return 0;
+      }
+
+      parents[depth] = schema;
+      child_index[depth] = 0;
+      depth++;
+    } else {
+      // Go back up to the closest parent that still has children to visit
+      while (depth > 0 && child_index[depth - 1] + 1 == parents[depth - 1]->n_children) {
+        depth--;
+      }
+
+      if (depth == 0) {
+        return 1;
+      }
+
+      child_index[depth - 1]++;
+    }
+
+    // Fields of a struct are matched by name as well
+    const char* format = parents[depth - 1]->format;
+    name_matters = format[0] == '+' && format[1] == 's' && format[2] == '\0';
+    schema = parents[depth - 1]->children[child_index[depth - 1]];
+  }
+}
+
+static int GeoArrowTypeCacheMatch(struct ArrowSchema* schema, int64_t metadata_size,
+                                  const uint8_t* data) {
+  int64_t stored_metadata_size;
+  memcpy(&stored_metadata_size, data, sizeof(int64_t));
+  if (stored_metadata_size != metadata_size) {
+    return 0;
+  }
+
+  data += sizeof(int64_t);
+  if (metadata_size > 0 && memcmp(data, schema->metadata, metadata_size) != 0) {
+    return 0;
+  }
+
+  data += metadata_size;
+  return GeoArrowTypeCacheMatchTree(schema, data);
+}
+
+static struct TypeCacheEntry* GeoArrowTypeCacheFind(struct TypeCachePrivate* private,
+                                                    struct ArrowSchema* schema,
+                                                    int64_t metadata_size,
+                                                    uint64_t hash) {
+  struct TypeCacheTable* table = TYPE_CACHE_LOAD(&private->table);
+  if (table == NULL) {
+    return NULL;
+  }
+
+  int64_t mask = table->n_slots - 1;
+  for (int64_t i = hash & mask;; i = (i + 1) & mask) {
+    struct TypeCacheEntry* entry = TYPE_CACHE_LOAD(&table->slots[i]);
+    if (entry == NULL) {
+      return NULL;
+    }
+
+    if (entry->hash == hash &&
+        GeoArrowTypeCacheMatch(schema, metadata_size, entry->fingerprint.data)) {
+      return entry;
+    }
+  }
+}
+
+static void GeoArrowTypeCacheTablePut(struct TypeCacheTable* table,
+                                      struct TypeCacheEntry* entry) {
+  int64_t mask = table->n_slots - 1;
+  int64_t i = entry->hash & mask;
+  while (table->slots[i] != NULL) {
+    i = (i + 1) & mask;
+  }
+
+  TYPE_CACHE_STORE(&table->slots[i], entry);
+}
+
+// Must be called with the insert lock held
+static GeoArrowErrorCode GeoArrowTypeCacheInsert(struct TypeCachePrivate* private,
+                                                 struct TypeCacheEntry* entry) {
+  // Keep the table at most half full so that probe sequences stay short
+  struct TypeCacheTable* table = private->table;
+  if (table == NULL || (private->n_entries + 1) * 2 > table->n_slots) {
+    int64_t n_slots = table == NULL ? 16 : table->n_slots * 2;
+    struct TypeCacheTable* new_table = (struct TypeCacheTable*)ArrowMalloc(
+        sizeof(struct TypeCacheTable) + n_slots * sizeof(struct TypeCacheEntry*));
+    if (new_table == NULL) {
+      return ENOMEM;
+    }
+
+    memset(new_table->slots, 0, n_slots * sizeof(struct TypeCacheEntry*));
+    new_table->n_slots = n_slots;
+    new_table->previous = table;
+    for (int64_t i = 0; table != NULL && i < table->n_slots; i++) {
+      if (table->slots[i] != NULL) {
+        GeoArrowTypeCacheTablePut(new_table, table->slots[i]);
+      }
+    }
+
+    // Readers may still be probing the old table, so it is only freed on reset
+    table = new_table;
+    TYPE_CACHE_STORE(&private->table, table);
+  }
+
+  GeoArrowTypeCacheTablePut(table, entry);
+  private->n_entries++;
+  return GEOARROW_OK;
+}
+
+static void GeoArrowTypeCacheEntryFree(struct TypeCacheEntry* entry) {
+  ArrowBufferReset(&entry->fingerprint);
+  ArrowBufferReset(&entry->strings);
+  ArrowFree(entry);
+}
+
+// Parses schema into a new entry whose views don't point into schema
+static GeoArrowErrorCode GeoArrowTypeCacheEntryInit(struct TypeCacheEntry* entry,
+                                                    struct ArrowSchema* schema,
+                                                    struct GeoArrowError* error) {
+  struct GeoArrowSchemaView schema_view;
+  NANOARROW_RETURN_NOT_OK(GeoArrowSchemaViewInit(&schema_view, schema, error));
+
+  struct GeoArrowStringView ext_name = schema_view.extension_name;
+  struct GeoArrowStringView ext_metadata = schema_view.extension_metadata;
+  NANOARROW_RETURN_NOT_OK(
+      ArrowBufferReserve(&entry->strings, ext_name.n_bytes + ext_metadata.n_bytes + 1));
+  if (ext_name.n_bytes > 0) {
+    ArrowBufferAppendUnsafe(&entry->strings, ext_name.data, ext_name.n_bytes);
+  }
+
+  if (ext_metadata.n_bytes > 0) {
+    ArrowBufferAppendUnsafe(&entry->strings, ext_metadata.data, ext_metadata.n_bytes);
+  }
+
+  schema_view.schema = NULL;
+  schema_view.extension_name.data = (const char*)entry->strings.data;
+  if (ext_metadata.data != NULL) {
+    schema_view.extension_metadata.data =
+        (const char*)entry->strings.data + ext_name.n_bytes;
+  }
+
+  NANOARROW_RETURN_NOT_OK(GeoArrowMetadataViewInit(
+      &entry->metadata_view, schema_view.extension_metadata, error));
+  entry->schema_view = schema_view;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowTypeCacheInit(struct GeoArrowTypeCache* cache) {
+  struct TypeCachePrivate* private =
+      (struct TypeCachePrivate*)ArrowMalloc(sizeof(struct TypeCachePrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct TypeCachePrivate));
+
+  // Fails where there is no lock to serialize inserts with
+  int result = GeoArrowMutexInit(&private->insert_lock);
+  if (result != GEOARROW_OK) {
+    ArrowFree(private);
+    return result;
+  }
+
+  cache->private_data = private;
+  return GEOARROW_OK;
+}
+
+// Parses schema into a new entry outside the lock and inserts it, unless another
+// thread inserted an equal entry first
+static GeoArrowErrorCode GeoArrowTypeCacheAdd(struct TypeCachePrivate* private,
+                                              struct ArrowSchema* schema,
+                                              int64_t metadata_size, uint64_t hash,
+                                              struct TypeCacheEntry** entry_out,
+                                              struct GeoArrowError* error) {
+  struct TypeCacheEntry* entry =
+      (struct TypeCacheEntry*)ArrowMalloc(sizeof(struct TypeCacheEntry));
+  if (entry == NULL) {
+    return ENOMEM;
+  }
+
+  memset(entry, 0, sizeof(struct TypeCacheEntry));
+  ArrowBufferInit(&entry->fingerprint);
+  ArrowBufferInit(&entry->strings);
+  entry->hash = hash;
+  int result = GeoArrowTypeCacheEntryInit(entry, schema, error);
+  if (result == GEOARROW_OK) {
+    result = GeoArrowTypeCacheFingerprint(schema, metadata_size, &entry->fingerprint);
+  }
+
+  if (result != GEOARROW_OK) {
+    GeoArrowTypeCacheEntryFree(entry);
+    return result;
+  }
+
+  GeoArrowTypeCacheLock(private);
+  struct TypeCacheEntry* existing =
+      GeoArrowTypeCacheFind(private, schema, metadata_size, hash);
+  if (existing == NULL) {
+    result = GeoArrowTypeCacheInsert(private, entry);
+  }
+  GeoArrowTypeCacheUnlock(private);
+
+  if (existing != NULL) {
+    GeoArrowTypeCacheEntryFree(entry);
+    entry = existing;
+  } else if (result != GEOARROW_OK) {
+    GeoArrowTypeCacheEntryFree(entry);
+    return result;
+  }
+
+  *entry_out = entry;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowTypeCacheGet(struct GeoArrowTypeCache* cache,
+                                       struct ArrowSchema* schema,
+                                       struct GeoArrowSchemaView* schema_view,
+                                       struct GeoArrowMetadataView* metadata_view,
+                                       struct GeoArrowError* error) {
+  struct TypeCachePrivate* private = (struct TypeCachePrivate*)cache->private_data;
+  int64_t metadata_size = GeoArrowTypeCacheMetadataSize(schema->metadata);
+  uint64_t hash = GeoArrowTypeCacheHash(schema, metadata_size);
+
+  struct TypeCacheEntry* entry =
+      GeoArrowTypeCacheFind(private, schema, metadata_size, hash);
+
+  if (entry == NULL) {
+    NANOARROW_RETURN_NOT_OK(GeoArrowTypeCacheAdd(private, schema, metadata_size, hash,
+                                                 &entry, error));
+  }
+
+  *schema_view = entry->schema_view;
+  schema_view->schema = schema;
+  if (metadata_view != NULL) {
+    *metadata_view = entry->metadata_view;
+  }
+
+  return GEOARROW_OK;
+}
+
+int64_t GeoArrowTypeCacheSize(struct GeoArrowTypeCache* cache) {
+  struct TypeCachePrivate* private = (struct TypeCachePrivate*)cache->private_data;
+  GeoArrowTypeCacheLock(private);
+  int64_t n_entries = private->n_entries;
+  GeoArrowTypeCacheUnlock(private);
+  return n_entries;
+}
+
+void GeoArrowTypeCacheReset(struct GeoArrowTypeCache* cache) {
+  struct TypeCachePrivate* private = (struct TypeCachePrivate*)cache->private_data;
+  struct TypeCacheTable* table = private->table;
+  for (int64_t i = 0; table != NULL && i < table->n_slots; i++) {
+    if (table->slots[i] != NULL) {
+      GeoArrowTypeCacheEntryFree(table->slots[i]);
+    }
+  }
+
+  while (table != NULL) {
+    struct TypeCacheTable* previous = table->previous;
+    ArrowFree(table);
+    table = previous;
+  }
+
+  GeoArrowMutexReset(&private->insert_lock);
+  ArrowFree(private);
+  cache->private_data = NULL;
+}
@@ -0,0 +1,247 @@
+
+#include <pthread.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+static void SchemaWithCrs(struct ArrowSchema* schema, enum GeoArrowType type,
+                          const char* crs) {
+  struct GeoArrowMetadataView metadata_view;
+  struct GeoArrowStringView metadata = {nullptr, 0};
+  ASSERT_EQ(GeoArrowSchemaInitExtension(schema, type), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowMetadataViewInit(&metadata_view, metadata, nullptr), GEOARROW_OK);
+  metadata_view.crs.data = crs;
+  metadata_view.crs.n_bytes = strlen(crs);
+  metadata_view.crs_type = GEOARROW_CRS_TYPE_UNKNOWN;
+  ASSERT_EQ(GeoArrowSchemaSetMetadata(schema, &metadata_view), GEOARROW_OK);
+}
+
+TEST(TypeCacheTest, TypeCacheTestBasic) {
+  struct GeoArrowTypeCache cache;
+  struct GeoArrowSchemaView schema_view;
+  struct GeoArrowMetadataView metadata_view;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowTypeCacheInit(&cache), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowTypeCacheSize(&cache), 0);
+
+  // Two separately allocated schemas with the same content share an entry
+  struct ArrowSchema schema;
+  SchemaWithCrs(&schema, GEOARROW_TYPE_POLYGON_Z, "OGC:CRS84");
+  ASSERT_EQ(GeoArrowTypeCacheGet(&cache, &schema, &schema_view, &metadata_view, &error),
+            GEOARROW_OK)
+      << error.message;
+  EXPECT_EQ(schema_view.schema, &schema);
+  EXPECT_EQ(schema_view.type, GEOARROW_TYPE_POLYGON_Z);
+  EXPECT_EQ(std::string(metadata_view.crs.data, metadata_view.crs.n_bytes),
+            "\"OGC:CRS84\"");
+  EXPECT_EQ(GeoArrowTypeCacheSize(&cache), 1);
+  schema.release(&schema);
+
+  SchemaWithCrs(&schema, GEOARROW_TYPE_POLYGON_Z, "OGC:CRS84");
+  ASSERT_EQ(GeoArrowTypeCacheGet(&cache, &schema, &schema_view, nullptr, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(schema_view.type, GEOARROW_TYPE_POLYGON_Z);
+  EXPECT_EQ(GeoArrowTypeCacheSize(&cache), 1);
+  schema.release(&schema);
+
+  // Views point into the cache and not the (released) schema
+  EXPECT_EQ(
+      std::string(schema_view.extension_name.data, schema_view.extension_name.n_bytes),
+      "geoarrow.polygon");
+  EXPECT_EQ(std::string(metadata_view.crs.data, metadata_view.crs.n_bytes),
+            "\"OGC:CRS84\"");
+
+  // Other metadata or another type is another entry
+  SchemaWithCrs(&schema, GEOARROW_TYPE_POLYGON_Z, "EPSG:32620");
+  ASSERT_EQ(GeoArrowTypeCacheGet(&cache, &schema, &schema_view, &metadata_view, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(std::string(metadata_view.crs.data, metadata_view.crs.n_bytes),
+            "\"EPSG:32620\"");
+  EXPECT_EQ(GeoArrowTypeCacheSize(&cache), 2);
+  schema.release(&schema);
+
+  ASSERT_EQ(GeoArrowSchemaInitExtension(&schema, GEOARROW_TYPE_WKB), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowTypeCacheGet(&cache, &schema, &schema_view, &metadata_view, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(schema_view.type, GEOARROW_TYPE_WKB);
+  EXPECT_EQ(metadata_view.crs_type, GEOARROW_CRS_TYPE_NONE);
+  EXPECT_EQ(GeoArrowTypeCacheSize(&cache), 3);
+  schema.release(&schema);
+
+  // Only the names of coordinate fields are part of the key
+  SchemaWithCrs(&schema, GEOARROW_TYPE_POLYGON_Z, "OGC:CRS84");
+  ASSERT_EQ(ArrowSchemaSetName(schema.children[0], "not rings"), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowTypeCacheGet(&cache, &schema, &schema_view, nullptr, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(GeoArrowTypeCacheSize(&cache), 3);
+
+  ASSERT_EQ(ArrowSchemaSetName(schema.children[0]->children[0]->children[2], "m"),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowTypeCacheGet(&cache, &schema, &schema_view, nullptr, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(schema_view.type, GEOARROW_TYPE_POLYGON_M);
+  EXPECT_EQ(GeoArrowTypeCacheSize(&cache), 4);
+  schema.release(&schema);
+
+  GeoArrowTypeCacheReset(&cache);
+}
+
+TEST(TypeCacheTest, TypeCacheTestErrors) {
+  struct GeoArrowTypeCache cache;
+  struct GeoArrowSchemaView schema_view;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowTypeCacheInit(&cache), GEOARROW_OK);
+
+  // Schemas that can't be parsed aren't cached
+  struct ArrowSchema schema;
+  ASSERT_EQ(ArrowSchemaInit(&schema, NANOARROW_TYPE_INT32), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowTypeCacheGet(&cache, &schema, &schema_view, nullptr, &error), EINVAL);
+  EXPECT_EQ(GeoArrowTypeCacheGet(&cache, &schema, &schema_view, nullptr, &error), EINVAL);
+  EXPECT_EQ(GeoArrowTypeCacheSize(&cache), 0);
+  schema.release(&schema);
+
+  GeoArrowTypeCacheReset(&cache);
+}
+
+TEST(TypeCacheTest, TypeCacheTestRepeatedGet) {
+  struct GeoArrowTypeCache cache;
+  ASSERT_EQ(GeoArrowTypeCacheInit(&cache), GEOARROW_OK);
+
+  // A nested type without a CRS and with a 3 KB CRS (longer than what is hashed)
+  std::vector<std::string> crses = {"", std::string(3000, 'x')};
+  for (const auto& crs : crses) {
+    struct ArrowSchema schema;
+    if (crs.empty()) {
+      ASSERT_EQ(GeoArrowSchemaInitExtension(&schema, GEOARROW_TYPE_MULTIPOLYGON),
+                GEOARROW_OK);
+    } else {
+      SchemaWithCrs(&schema, GEOARROW_TYPE_MULTIPOLYGON, crs.c_str());
+    }
+
+    struct GeoArrowSchemaView schema_view;
+    struct GeoArrowMetadataView metadata_view;
+    for (int i = 0; i < 100; i++) {
+      ASSERT_EQ(GeoArrowTypeCacheGet(&cache, &schema, &schema_view, &metadata_view,
+                                     nullptr),
+                GEOARROW_OK);
+      EXPECT_EQ(schema_view.type, GEOARROW_TYPE_MULTIPOLYGON);
+      EXPECT_EQ(metadata_view.crs.n_bytes,
+                static_cast<int64_t>(crs.empty() ? 0 : crs.size() + 2));
+    }
+
+    schema.release(&schema);
+  }
+
+  EXPECT_EQ(GeoArrowTypeCacheSize(&cache), 2);
+  GeoArrowTypeCacheReset(&cache);
+}
+
+// The time of n calls to fun, in nanoseconds per call
+template <typename Fun>
+static double NanosPerCall(int n, Fun fun) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    fun();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / n;
+}
+
+// Compares the time of a cache hit with the time of parsing the same schema. Wall
+// clock timings depend on the build and the machine, so this only reports them; run
+// with --gtest_also_run_disabled_tests in an optimized build.
+TEST(TypeCacheTest, DISABLED_TypeCacheBenchmarkHitVsParse) {
+  struct GeoArrowTypeCache cache;
+  ASSERT_EQ(GeoArrowTypeCacheInit(&cache), GEOARROW_OK);
+
+  std::vector<std::string> crses = {"", std::string(3000, 'x')};
+  for (const auto& crs : crses) {
+    struct ArrowSchema schema;
+    if (crs.empty()) {
+      ASSERT_EQ(GeoArrowSchemaInitExtension(&schema, GEOARROW_TYPE_MULTIPOLYGON),
+                GEOARROW_OK);
+    } else {
+      SchemaWithCrs(&schema, GEOARROW_TYPE_MULTIPOLYGON, crs.c_str());
+    }
+
+    struct GeoArrowSchemaView schema_view;
+    struct GeoArrowMetadataView metadata_view;
+    auto parse = [&] {
+      GeoArrowSchemaViewInit(&schema_view, &schema, nullptr);
+      GeoArrowMetadataViewInit(&metadata_view, schema_view.extension_metadata, nullptr);
+    };
+    auto cached = [&] {
+      GeoArrowTypeCacheGet(&cache, &schema, &schema_view, &metadata_view, nullptr);
+    };
+
+    // Alternate between the two and keep the fastest run of each so that load from
+    // other processes doesn't favour either
+    double parse_ns = -1;
+    double cached_ns = -1;
+    for (int run = 0; run < 10; run++) {
+      double ns = NanosPerCall(10000, parse);
+      parse_ns = (parse_ns < 0 || ns < parse_ns) ? ns : parse_ns;
+      ns = NanosPerCall(10000, cached);
+      cached_ns = (cached_ns < 0 || ns < cached_ns) ? ns : cached_ns;
+    }
+
+    std::cout << "CRS of " << crs.size() << " bytes: parse " << parse_ns
+              << " ns, cache hit " << cached_ns << " ns" << std::endl;
+    schema.release(&schema);
+  }
+
+  GeoArrowTypeCacheReset(&cache);
+}
+
+struct TypeCacheThreadArgs {
+  struct GeoArrowTypeCache* cache;
+  enum GeoArrowType type;
+  int n_ok;
+};
+
+static void* TypeCacheThread(void* arg) {
+  struct TypeCacheThreadArgs* args = reinterpret_cast<struct TypeCacheThreadArgs*>(arg);
+  struct GeoArrowSchemaView schema_view;
+  struct ArrowSchema schema;
+  if (GeoArrowSchemaInitExtension(&schema, args->type) != GEOARROW_OK) {
+    return nullptr;
+  }
+
+  for (int i = 0; i < 1000; i++) {
+    if (GeoArrowTypeCacheGet(args->cache, &schema, &schema_view, nullptr, nullptr) ==
+            GEOARROW_OK &&
+        schema_view.type == args->type) {
+      args->n_ok++;
+    }
+  }
+
+  schema.release(&schema);
+  return nullptr;
+}
+
+TEST(TypeCacheTest, TypeCacheTestThreads) {
+  struct GeoArrowTypeCache cache;
+  ASSERT_EQ(GeoArrowTypeCacheInit(&cache), GEOARROW_OK);
+
+  pthread_t threads[8];
+  struct TypeCacheThreadArgs args[8];
+  for (int i = 0; i < 8; i++) {
+    args[i] = {&cache, i % 2 == 0 ? GEOARROW_TYPE_POINT : GEOARROW_TYPE_LINESTRING, 0};
+    ASSERT_EQ(pthread_create(&threads[i], nullptr, &TypeCacheThread, &args[i]), 0);
+  }
+
+  for (int i = 0; i < 8; i++) {
+    pthread_join(threads[i], nullptr);
+    EXPECT_EQ(args[i].n_ok, 1000);
+  }
+
+  EXPECT_EQ(GeoArrowTypeCacheSize(&cache), 2);
+  GeoArrowTypeCacheReset(&cache);
+}
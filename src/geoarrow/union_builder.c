@@ -0,0 +1,272 @@
+
+#include <errno.h>
+#include <string.h>
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+
+struct UnionBuilderPrivate {
+  enum GeoArrowDimensions dimensions;
+
+  // One builder for each native geometry type, indexed by geometry_type - 1
+  struct GeoArrowBuilder children[6];
+  struct GeoArrowVisitor children_v[6];
+  int64_t children_length[6];
+
+  struct ArrowBuffer type_ids;
+  struct ArrowBuffer offsets;
+  int64_t length;
+
+  // The visitor of the child that the current feature is written to (NULL until
+  // the geometry type of the feature is known)
+  struct GeoArrowVisitor* child_v;
+};
+
+// Appends the type id and offset of a feature of geometry_type and passes on
+// feat_start to its child
+static int GeoArrowUnionBuilderStartChild(struct UnionBuilderPrivate* private,
+                                          enum GeoArrowGeometryType geometry_type,
+                                          struct GeoArrowError* error) {
+  if (geometry_type < GEOARROW_GEOMETRY_TYPE_POINT ||
+      geometry_type > GEOARROW_GEOMETRY_TYPE_MULTIPOLYGON) {
+    const char* name = GeoArrowGeometryTypeString(geometry_type);
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Can't build a geoarrow.geometry array from geometry of type %s",
+                  name == NULL ? "<unknown>" : name);
+    return ENOTSUP;
+  }
+
+  int64_t child_length = private->children_length[geometry_type - 1];
+  if (child_length >= INT32_MAX) {
+    return EOVERFLOW;
+  }
+
+  NANOARROW_RETURN_NOT_OK(ArrowBufferAppendInt8(
+      &private->type_ids, GeoArrowUnionTypeId(geometry_type, private->dimensions)));
+  NANOARROW_RETURN_NOT_OK(
+      ArrowBufferAppendInt32(&private->offsets, (int32_t)child_length));
+  private->children_length[geometry_type - 1]++;
+  private->length++;
+
+  private->child_v = &private->children_v[geometry_type - 1];
+  private->child_v->error = error;
+  return private->child_v->feat_start(private->child_v);
+}
+
+static int reserve_feat_union(struct GeoArrowVisitor* v, int64_t n) {
+  struct GeoArrowUnionBuilder* builder = (struct GeoArrowUnionBuilder*)v->private_data;
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+  NANOARROW_RETURN_NOT_OK(ArrowBufferReserve(&private->type_ids, n * sizeof(int8_t)));
+  return ArrowBufferReserve(&private->offsets, n * sizeof(int32_t));
+}
+
+static int feat_start_union(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnionBuilder* builder = (struct GeoArrowUnionBuilder*)v->private_data;
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+  private->child_v = NULL;
+  return GEOARROW_OK;
+}
+
+// Dense unions don't have a validity buffer: null features are written as null
+// points
+static int null_feat_union(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnionBuilder* builder = (struct GeoArrowUnionBuilder*)v->private_data;
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+  if (private->child_v == NULL) {
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowUnionBuilderStartChild(private, GEOARROW_GEOMETRY_TYPE_POINT, v->error));
+  }
+
+  return private->child_v->null_feat(private->child_v);
+}
+
+static int geom_start_union(struct GeoArrowVisitor* v,
+                            enum GeoArrowGeometryType geometry_type,
+                            enum GeoArrowDimensions dimensions) {
+  struct GeoArrowUnionBuilder* builder = (struct GeoArrowUnionBuilder*)v->private_data;
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+
+  // The child of a feature is chosen by its outermost geometry
+  if (private->child_v == NULL) {
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowUnionBuilderStartChild(private, geometry_type, v->error));
+  }
+
+  return private->child_v->geom_start(private->child_v, geometry_type, dimensions);
+}
+
+static int ring_start_union(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnionBuilder* builder = (struct GeoArrowUnionBuilder*)v->private_data;
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+  return private->child_v->ring_start(private->child_v);
+}
+
+static int coords_union(struct GeoArrowVisitor* v,
+                        const struct GeoArrowCoordView* coords) {
+  struct GeoArrowUnionBuilder* builder = (struct GeoArrowUnionBuilder*)v->private_data;
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+  return private->child_v->coords(private->child_v, coords);
+}
+
+static int ring_end_union(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnionBuilder* builder = (struct GeoArrowUnionBuilder*)v->private_data;
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+  return private->child_v->ring_end(private->child_v);
+}
+
+static int geom_end_union(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnionBuilder* builder = (struct GeoArrowUnionBuilder*)v->private_data;
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+  return private->child_v->geom_end(private->child_v);
+}
+
+static int feat_end_union(struct GeoArrowVisitor* v) {
+  struct GeoArrowUnionBuilder* builder = (struct GeoArrowUnionBuilder*)v->private_data;
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+
+  // A feature without any geometry is treated as null
+  if (private->child_v == NULL) {
+    NANOARROW_RETURN_NOT_OK(null_feat_union(v));
+  }
+
+  return private->child_v->feat_end(private->child_v);
+}
+
+GeoArrowErrorCode GeoArrowUnionBuilderInitFromType(struct GeoArrowUnionBuilder* builder,
+                                                   enum GeoArrowType type) {
+  enum GeoArrowDimensions dimensions = GeoArrowDimensionsFromType(type);
+  if (GeoArrowGeometryTypeFromType(type) != GEOARROW_GEOMETRY_TYPE_GEOMETRY ||
+      dimensions == GEOARROW_DIMENSIONS_UNKNOWN) {
+    return EINVAL;
+  }
+
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)ArrowMalloc(sizeof(struct UnionBuilderPrivate));
+  if (private == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private, 0, sizeof(struct UnionBuilderPrivate));
+  private->dimensions = dimensions;
+  ArrowBufferInit(&private->type_ids);
+  ArrowBufferInit(&private->offsets);
+
+  for (int i = 0; i < 6; i++) {
+    enum GeoArrowType child_type = GeoArrowMakeType(
+        GEOARROW_GEOMETRY_TYPE_POINT + i, dimensions, GEOARROW_COORD_TYPE_SEPARATE);
+    int result = GeoArrowBuilderInitFromType(&private->children[i], child_type);
+    if (result != GEOARROW_OK) {
+      for (int j = 0; j < i; j++) {
+        GeoArrowBuilderReset(&private->children[j]);
+      }
+
+      ArrowFree(private);
+      return result;
+    }
+
+    // Geometries with other dimensions are coerced to those of the union
+    private->children[i].coerce_dimensions = 1;
+    GeoArrowBuilderInitVisitor(&private->children[i], &private->children_v[i]);
+  }
+
+  builder->type = type;
+  builder->private_data = private;
+  return GEOARROW_OK;
+}
+
+void GeoArrowUnionBuilderInitVisitor(struct GeoArrowUnionBuilder* builder,
+                                     struct GeoArrowVisitor* v) {
+  GeoArrowVisitorInitVoid(v);
+  v->reserve_feat = &reserve_feat_union;
+  v->feat_start = &feat_start_union;
+  v->null_feat = &null_feat_union;
+  v->geom_start = &geom_start_union;
+  v->ring_start = &ring_start_union;
+  v->coords = &coords_union;
+  v->ring_end = &ring_end_union;
+  v->geom_end = &geom_end_union;
+  v->feat_end = &feat_end_union;
+  v->private_data = builder;
+}
+
+GeoArrowErrorCode GeoArrowUnionBuilderSetAllocator(
+    struct GeoArrowUnionBuilder* builder, struct GeoArrowBufferAllocator allocator) {
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+  if (private->type_ids.data != NULL || private->offsets.data != NULL) {
+    return EINVAL;
+  }
+
+  for (int i = 0; i < 6; i++) {
+    NANOARROW_RETURN_NOT_OK(
+        GeoArrowBuilderSetAllocator(&private->children[i], allocator));
+  }
+
+  struct ArrowBufferAllocator arrow_allocator;
+  arrow_allocator.reallocate = allocator.reallocate;
+  arrow_allocator.free = allocator.free;
+  arrow_allocator.private_data = allocator.private_data;
+  ArrowBufferSetAllocator(&private->type_ids, arrow_allocator);
+  ArrowBufferSetAllocator(&private->offsets, arrow_allocator);
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowUnionBuilderFinish(struct GeoArrowUnionBuilder* builder,
+                                             struct ArrowArray* array,
+                                             struct GeoArrowError* error) {
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+
+  struct ArrowSchema schema;
+  NANOARROW_RETURN_NOT_OK(GeoArrowSchemaInit(&schema, builder->type));
+  int result = ArrowArrayInitFromSchema(array, &schema, (struct ArrowError*)error);
+  schema.release(&schema);
+  NANOARROW_RETURN_NOT_OK(result);
+
+  for (int i = 0; i < 6; i++) {
+    array->children[i]->release(array->children[i]);
+    result = GeoArrowBuilderFinish(&private->children[i], array->children[i], error);
+    if (result != GEOARROW_OK) {
+      array->release(array);
+      return result;
+    }
+  }
+
+  ArrowBufferMove(&private->type_ids, ArrowArrayBuffer(array, 0));
+  ArrowBufferMove(&private->offsets, ArrowArrayBuffer(array, 1));
+  array->length = private->length;
+  array->null_count = 0;
+  private->length = 0;
+  memset(private->children_length, 0, sizeof(private->children_length));
+
+  result = ArrowArrayFinishBuilding(array, (struct ArrowError*)error);
+  if (result != GEOARROW_OK) {
+    array->release(array);
+    return result;
+  }
+
+  return GEOARROW_OK;
+}
+
+void GeoArrowUnionBuilderReset(struct GeoArrowUnionBuilder* builder) {
+  struct UnionBuilderPrivate* private =
+      (struct UnionBuilderPrivate*)builder->private_data;
+  for (int i = 0; i < 6; i++) {
+    GeoArrowBuilderReset(&private->children[i]);
+  }
+
+  ArrowBufferReset(&private->type_ids);
+  ArrowBufferReset(&private->offsets);
+  ArrowFree(private);
+  builder->private_data = NULL;
+}
@@ -0,0 +1,182 @@
+
+#include <gtest/gtest.h>
+
+#include "geoarrow.h"
+#include "nanoarrow.h"
+
+#include "wkx_testing.hpp"
+
+static std::vector<std::string> ReadWKT(enum GeoArrowType type, struct ArrowArray* array,
+                                        int64_t offset = 0, int64_t length = -1) {
+  struct GeoArrowArrayReader reader;
+  struct GeoArrowError error;
+  EXPECT_EQ(GeoArrowArrayReaderInitFromType(&reader, type), GEOARROW_OK);
+  EXPECT_EQ(GeoArrowArrayReaderSetArray(&reader, array, &error), GEOARROW_OK)
+      << error.message;
+
+  WKXTester tester;
+  EXPECT_EQ(GeoArrowArrayReaderVisit(&reader, offset,
+                                     length == -1 ? array->length : length,
+                                     tester.WKTVisitor()),
+            GEOARROW_OK);
+  GeoArrowArrayReaderReset(&reader);
+  return tester.WKTValues("<null value>");
+}
+
+TEST(UnionBuilderTest, UnionBuilderTestMixed) {
+  std::vector<std::string> wkts = {"POINT (0 1)",
+                                   "LINESTRING (0 1, 2 3)",
+                                   "",
+                                   "POLYGON ((0 0, 1 0, 0 1, 0 0))",
+                                   "POINT (2 3)",
+                                   "MULTIPOINT ((1 2), (3 4))",
+                                   "MULTILINESTRING ((0 1, 2 3))",
+                                   "MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)))",
+                                   "POINT (4 5)",
+                                   "POINT (6 7)"};
+
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_GEOMETRY, wkts, &array);
+  ASSERT_EQ(array.length, 10);
+  ASSERT_EQ(array.n_children, 6);
+  EXPECT_EQ(array.null_count, 0);
+
+  // Nulls are null points; features are appended to their child in order
+  const int8_t* type_ids = reinterpret_cast<const int8_t*>(array.buffers[0]);
+  const int32_t* offsets = reinterpret_cast<const int32_t*>(array.buffers[1]);
+  EXPECT_EQ(std::vector<int8_t>(type_ids, type_ids + 10),
+            std::vector<int8_t>({1, 2, 1, 3, 1, 4, 5, 6, 1, 1}));
+  EXPECT_EQ(std::vector<int32_t>(offsets, offsets + 10),
+            std::vector<int32_t>({0, 0, 1, 0, 2, 0, 0, 0, 3, 4}));
+  EXPECT_EQ(array.children[0]->length, 5);
+  EXPECT_EQ(array.children[0]->null_count, 1);
+
+  wkts[2] = "<null value>";
+  EXPECT_EQ(ReadWKT(GEOARROW_TYPE_GEOMETRY, &array), wkts);
+  EXPECT_EQ(ReadWKT(GEOARROW_TYPE_GEOMETRY, &array, 4, 5),
+            std::vector<std::string>(wkts.begin() + 4, wkts.begin() + 9));
+  array.release(&array);
+
+  ArrayFromWKT(GEOARROW_TYPE_GEOMETRY, {}, &array);
+  EXPECT_EQ(array.length, 0);
+  EXPECT_EQ(ReadWKT(GEOARROW_TYPE_GEOMETRY, &array), std::vector<std::string>({}));
+  array.release(&array);
+}
+
+TEST(UnionBuilderTest, UnionBuilderTestDimensions) {
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_GEOMETRY_Z,
+               {"POINT (0 1)", "LINESTRING Z (0 1 2, 3 4 5)", "MULTIPOINT M ((0 1 2))"},
+               &array);
+  const int8_t* type_ids = reinterpret_cast<const int8_t*>(array.buffers[0]);
+  EXPECT_EQ(std::vector<int8_t>(type_ids, type_ids + 3),
+            std::vector<int8_t>({11, 12, 14}));
+  EXPECT_EQ(ReadWKT(GEOARROW_TYPE_GEOMETRY_Z, &array),
+            std::vector<std::string>({"POINT Z (0 1 0)", "LINESTRING Z (0 1 2, 3 4 5)",
+                                      "MULTIPOINT Z ((0 1 0))"}));
+
+  // A union with other dimensions can't read the array
+  struct GeoArrowArrayReader reader;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowArrayReaderInitFromType(&reader, GEOARROW_TYPE_GEOMETRY),
+            GEOARROW_OK);
+  EXPECT_EQ(GeoArrowArrayReaderSetArray(&reader, &array, &error), EINVAL);
+  GeoArrowArrayReaderReset(&reader);
+  array.release(&array);
+}
+
+TEST(UnionBuilderTest, UnionBuilderTestSchema) {
+  // Read a union with a subset of children in another order
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_GEOMETRY,
+               {"LINESTRING (0 1, 2 3)", "POINT (0 1)", "LINESTRING (4 5, 6 7)"}, &array);
+
+  struct ArrowArray* point = array.children[0];
+  array.children[0] = array.children[1];
+  array.children[1] = point;
+  for (int i = 2; i < 6; i++) {
+    array.children[i]->release(array.children[i]);
+    ArrowFree(array.children[i]);
+  }
+  array.n_children = 2;
+
+  struct ArrowSchema schema;
+  ASSERT_EQ(ArrowSchemaInit(&schema, NANOARROW_TYPE_UNINITIALIZED), GEOARROW_OK);
+  ASSERT_EQ(ArrowSchemaSetFormat(&schema, "+ud:2,1"), GEOARROW_OK);
+  ASSERT_EQ(ArrowSchemaAllocateChildren(&schema, 2), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowSchemaInit(schema.children[0], GEOARROW_TYPE_LINESTRING),
+            GEOARROW_OK);
+  ASSERT_EQ(GeoArrowSchemaInit(schema.children[1], GEOARROW_TYPE_POINT), GEOARROW_OK);
+  struct ArrowBuffer metadata;
+  ASSERT_EQ(ArrowMetadataBuilderInit(&metadata, nullptr), GEOARROW_OK);
+  ASSERT_EQ(ArrowMetadataBuilderAppend(&metadata, ArrowCharView("ARROW:extension:name"),
+                                       ArrowCharView("geoarrow.geometry")),
+            GEOARROW_OK);
+  ASSERT_EQ(ArrowSchemaSetMetadata(&schema, (const char*)metadata.data), GEOARROW_OK);
+  ArrowBufferReset(&metadata);
+
+  struct GeoArrowArrayReader reader;
+  struct GeoArrowError error;
+  ASSERT_EQ(GeoArrowArrayReaderInitFromSchema(&reader, &schema, &error), GEOARROW_OK)
+      << error.message;
+  ASSERT_EQ(GeoArrowArrayReaderSetArray(&reader, &array, &error), GEOARROW_OK)
+      << error.message;
+  WKXTester tester;
+  EXPECT_EQ(GeoArrowArrayReaderVisit(&reader, 0, array.length, tester.WKTVisitor()),
+            GEOARROW_OK);
+  EXPECT_EQ(tester.WKTValues(),
+            std::vector<std::string>(
+                {"LINESTRING (0 1, 2 3)", "POINT (0 1)", "LINESTRING (4 5, 6 7)"}));
+  GeoArrowArrayReaderReset(&reader);
+
+  schema.release(&schema);
+  array.release(&array);
+}
+
+TEST(UnionBuilderTest, UnionBuilderTestErrors) {
+  struct GeoArrowUnionBuilder builder;
+  EXPECT_EQ(GeoArrowUnionBuilderInitFromType(&builder, GEOARROW_TYPE_POINT), EINVAL);
+  EXPECT_EQ(GeoArrowUnionBuilderInitFromType(&builder, GEOARROW_TYPE_WKB), EINVAL);
+
+  ASSERT_EQ(GeoArrowUnionBuilderInitFromType(&builder, GEOARROW_TYPE_GEOMETRY),
+            GEOARROW_OK);
+  struct GeoArrowVisitor v;
+  struct GeoArrowError error;
+  GeoArrowUnionBuilderInitVisitor(&builder, &v);
+  v.error = &error;
+
+  struct GeoArrowWKTReader reader;
+  GeoArrowWKTReaderInit(&reader);
+  std::string wkt = "GEOMETRYCOLLECTION (POINT (0 1))";
+  struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+  EXPECT_EQ(GeoArrowWKTReaderVisit(&reader, item, &v), ENOTSUP);
+  EXPECT_STREQ(error.message,
+               "Can't build a geoarrow.geometry array from geometry of type "
+               "GEOMETRYCOLLECTION");
+  GeoArrowWKTReaderReset(&reader);
+  GeoArrowUnionBuilderReset(&builder);
+}
+
+TEST(UnionBuilderTest, UnionBuilderTestRebind) {
+  struct GeoArrowUnionArrayView array_view;
+  ASSERT_EQ(GeoArrowUnionArrayViewInitFromType(&array_view, GEOARROW_TYPE_GEOMETRY),
+            GEOARROW_OK);
+
+  struct ArrowArray array;
+  ArrayFromWKT(GEOARROW_TYPE_GEOMETRY, {"POINT (0 1)", "LINESTRING (0 1, 2 3)"}, &array);
+  ASSERT_EQ(GeoArrowUnionArrayViewSetArray(&array_view, &array, nullptr), GEOARROW_OK);
+  array.release(&array);
+
+  std::vector<std::string> wkts = {"MULTIPOINT ((1 2))", "POINT (3 4)",
+                                   "POLYGON ((0 0, 1 0, 0 1, 0 0))"};
+  ArrayFromWKT(GEOARROW_TYPE_GEOMETRY, wkts, &array);
+  ASSERT_EQ(GeoArrowUnionArrayViewRebind(&array_view, &array, nullptr), GEOARROW_OK);
+  EXPECT_EQ(array_view.length, 3);
+
+  WKXTester tester;
+  EXPECT_EQ(
+      GeoArrowUnionArrayViewVisit(&array_view, 0, array.length, tester.WKTVisitor()),
+      GEOARROW_OK);
+  EXPECT_EQ(tester.WKTValues(), wkts);
+  array.release(&array);
+}
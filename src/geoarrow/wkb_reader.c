@@ -1,11 +1,15 @@
 
 #include <errno.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "geoarrow.h"
 
 #include "nanoarrow.h"
 
+#include "cpu_features.h"
+#include "instrumentation.h"
+
 #define EWKB_Z_BIT 0x80000000
 #define EWKB_M_BIT 0x40000000
 #define EWKB_SRID_BIT 0x20000000
@@ -14,6 +18,14 @@
 #define GEOARROW_NATIVE_ENDIAN 0x01
 #endif
 
+#if !defined(GEOARROW_BSWAP32) && (defined(__GNUC__) || defined(__clang__))
+#define GEOARROW_BSWAP32(x) __builtin_bswap32(x)
+#endif
+
+#if !defined(GEOARROW_BSWAP64) && (defined(__GNUC__) || defined(__clang__))
+#define GEOARROW_BSWAP64(x) __builtin_bswap64(x)
+#endif
+
 #ifndef GEOARROW_BSWAP32
 static inline uint32_t bswap_32(uint32_t x) {
   return (((x & 0xFF) << 24) | ((x & 0xFF00) << 8) | ((x & 0xFF0000) >> 8) |
@@ -32,18 +44,90 @@ static inline uint64_t bswap_64(uint64_t x) {
 #define GEOARROW_BSWAP64(x) bswap_64(x)
 #endif
 
+// x86 builds select a shuffle-based byte swap at runtime
+#if defined(GEOARROW_X86_DISPATCH)
+#include <immintrin.h>
+#endif
+
 // This must be divisible by 2, 3, and 4
 #define COORD_CACHE_SIZE_ELEMENTS 3072
 
+typedef void (*WKBReaderBswapCopyFn)(double* dst, const uint8_t* src, int64_t n);
+
 struct WKBReaderPrivate {
   const uint8_t* data;
   int64_t n_bytes;
   const uint8_t* data0;
   int need_swapping;
+  int use_unaligned_coords;
+  WKBReaderBswapCopyFn bswap_copy;
   double coords[COORD_CACHE_SIZE_ELEMENTS];
   struct GeoArrowCoordView coord_view;
+
+  // Dimension coercion: when coerce is non-zero, coordinates are passed to the
+  // visitor with coerce_n_values values taken from positions coerce_map of each
+  // source coordinate (or zero where the position is -1)
+  enum GeoArrowDimensions dimensions;
+  int coerce;
+  int32_t coerce_n_values;
+  int32_t coerce_map[4];
+
+  struct GeoArrowInstrumentation instrumentation;
 };
 
+static void WKBReaderBswapCopyScalar(double* dst, const uint8_t* src, int64_t n) {
+  uint64_t value;
+  for (int64_t i = 0; i < n; i++) {
+    memcpy(&value, src + i * sizeof(double), sizeof(uint64_t));
+    value = GEOARROW_BSWAP64(value);
+    memcpy(dst + i, &value, sizeof(double));
+  }
+}
+
+#if defined(GEOARROW_X86_DISPATCH)
+__attribute__((target("ssse3"))) static void WKBReaderBswapCopySSSE3(double* dst,
+                                                                     const uint8_t* src,
+                                                                     int64_t n) {
+  const __m128i mask =
+      _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  int64_t i = 0;
+  for (; (i + 2) <= n; i += 2) {
+    __m128i value = _mm_loadu_si128((const __m128i*)(src + i * sizeof(double)));
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_shuffle_epi8(value, mask));
+  }
+
+  WKBReaderBswapCopyScalar(dst + i, src + i * sizeof(double), n - i);
+}
+
+__attribute__((target("avx2"))) static void WKBReaderBswapCopyAVX2(double* dst,
+                                                                   const uint8_t* src,
+                                                                   int64_t n) {
+  const __m256i mask =
+      _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4,
+                       3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  int64_t i = 0;
+  for (; (i + 4) <= n; i += 4) {
+    __m256i value = _mm256_loadu_si256((const __m256i*)(src + i * sizeof(double)));
+    _mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(value, mask));
+  }
+
+  WKBReaderBswapCopyScalar(dst + i, src + i * sizeof(double), n - i);
+}
+#endif
+
+static WKBReaderBswapCopyFn WKBReaderResolveBswapCopy(void) {
+#if defined(GEOARROW_X86_DISPATCH)
+  int features = GeoArrowCpuFeatures();
+  if (features & GEOARROW_CPU_AVX2) {
+    return &WKBReaderBswapCopyAVX2;
+  } else if (features & GEOARROW_CPU_SSSE3) {
+    return &WKBReaderBswapCopySSSE3;
+  }
+#endif
+
+  return &WKBReaderBswapCopyScalar;
+}
+
 static inline int WKBReaderReadEndian(struct WKBReaderPrivate* s,
                                       struct GeoArrowError* error) {
   if (s->n_bytes > 0) {
@@ -77,15 +161,94 @@ static inline int WKBReaderReadUInt32(struct WKBReaderPrivate* s, uint32_t* out,
   }
 }
 
-static inline void WKBReaderMaybeBswapCoords(struct WKBReaderPrivate* s, int64_t n) {
+// Fills the coordinate cache with n values, swapping bytes while copying if needed
+static inline void WKBReaderCopyCoords(struct WKBReaderPrivate* s, int64_t n) {
   if (s->need_swapping) {
-    uint64_t* data64 = (uint64_t*)s->coords;
-    for (int i = 0; i < n; i++) {
-      data64[i] = GEOARROW_BSWAP64(data64[i]);
+    s->bswap_copy(s->coords, s->data, n);
+    GEOARROW_INSTRUMENT(s->instrumentation.n_values_swapped += n);
+  } else {
+    memcpy(s->coords, s->data, n * sizeof(double));
+  }
+}
+
+// Copies only the requested ordinates of n_coords source coordinates into the
+// coordinate cache, swapping bytes if needed
+static void WKBReaderCopyCoordsCoerce(struct WKBReaderPrivate* s, int64_t n_coords) {
+  int32_t n_src = s->coord_view.n_values;
+  int32_t n_dst = s->coerce_n_values;
+  uint64_t value;
+  for (int64_t i = 0; i < n_coords; i++) {
+    const uint8_t* src = s->data + i * n_src * sizeof(double);
+    double* dst = s->coords + i * n_dst;
+    for (int32_t j = 0; j < n_dst; j++) {
+      if (s->coerce_map[j] == -1) {
+        dst[j] = 0;
+        continue;
+      }
+
+      memcpy(&value, src + s->coerce_map[j] * sizeof(double), sizeof(uint64_t));
+      if (s->need_swapping) {
+        value = GEOARROW_BSWAP64(value);
+        GEOARROW_INSTRUMENT(s->instrumentation.n_values_swapped++);
+      }
+      memcpy(dst + j, &value, sizeof(double));
     }
   }
 }
 
+static int WKBReaderReadCoordinatesCoerce(struct WKBReaderPrivate* s, int64_t n_coords,
+                                          struct GeoArrowVisitor* v) {
+  int64_t src_bytes_per_coord = s->coord_view.n_values * sizeof(double);
+  struct GeoArrowCoordView coords;
+  coords.n_values = s->coerce_n_values;
+
+  // Dropping ordinates from native-endian coordinates only needs different pointers
+  // into the source buffer
+  int only_drop = 1;
+  for (int32_t j = 0; j < s->coerce_n_values; j++) {
+    only_drop = only_drop && s->coerce_map[j] != -1;
+  }
+
+  if (only_drop && !s->need_swapping &&
+      (s->use_unaligned_coords || ((uintptr_t)s->data % sizeof(double)) == 0)) {
+    coords.n_coords = n_coords;
+    coords.coords_stride = s->coord_view.n_values;
+    for (int32_t j = 0; j < coords.n_values; j++) {
+      coords.values[j] = ((const double*)s->data) + s->coerce_map[j];
+    }
+
+    s->data += n_coords * src_bytes_per_coord;
+    s->n_bytes -= n_coords * src_bytes_per_coord;
+    return v->coords(v, &coords);
+  }
+
+  coords.coords_stride = coords.n_values;
+  for (int32_t j = 0; j < coords.n_values; j++) {
+    coords.values[j] = s->coords + j;
+  }
+
+  int64_t chunk_size = COORD_CACHE_SIZE_ELEMENTS / coords.n_values;
+  coords.n_coords = chunk_size;
+
+  // Process full chunks
+  while (n_coords > chunk_size) {
+    WKBReaderCopyCoordsCoerce(s, chunk_size);
+    GEOARROW_INSTRUMENT(s->instrumentation.n_chunks_flushed++);
+    NANOARROW_RETURN_NOT_OK(v->coords(v, &coords));
+    s->data += chunk_size * src_bytes_per_coord;
+    s->n_bytes -= chunk_size * src_bytes_per_coord;
+    n_coords -= chunk_size;
+  }
+
+  // Process the last chunk
+  WKBReaderCopyCoordsCoerce(s, n_coords);
+  s->data += n_coords * src_bytes_per_coord;
+  s->n_bytes -= n_coords * src_bytes_per_coord;
+  coords.n_coords = n_coords;
+  GEOARROW_INSTRUMENT(s->instrumentation.n_chunks_flushed++);
+  return v->coords(v, &coords);
+}
+
 static int WKBReaderReadCoordinates(struct WKBReaderPrivate* s, int64_t n_coords,
                                     struct GeoArrowVisitor* v) {
   int64_t bytes_needed = n_coords * s->coord_view.n_values * sizeof(double);
@@ -98,13 +261,34 @@ static int WKBReaderReadCoordinates(struct WKBReaderPrivate* s, int64_t n_coords
     return EINVAL;
   }
 
+  GEOARROW_INSTRUMENT(s->instrumentation.n_coords += n_coords);
+  if (s->coerce) {
+    return WKBReaderReadCoordinatesCoerce(s, n_coords, v);
+  }
+
+  // Native-endian coordinates that happen to be aligned (or any native-endian
+  // coordinates if the visitor can read unaligned values) can be passed to the
+  // visitor without copying
+  if (!s->need_swapping &&
+      (s->use_unaligned_coords || ((uintptr_t)s->data % sizeof(double)) == 0)) {
+    struct GeoArrowCoordView coords = s->coord_view;
+    coords.n_coords = n_coords;
+    for (int32_t i = 0; i < coords.n_values; i++) {
+      coords.values[i] = ((const double*)s->data) + i;
+    }
+
+    s->data += bytes_needed;
+    s->n_bytes -= bytes_needed;
+    return v->coords(v, &coords);
+  }
+
   int32_t chunk_size = COORD_CACHE_SIZE_ELEMENTS / s->coord_view.n_values;
   s->coord_view.n_coords = chunk_size;
 
   // Process full chunks
   while (n_coords > chunk_size) {
-    memcpy(s->coords, s->data, COORD_CACHE_SIZE_ELEMENTS * sizeof(double));
-    WKBReaderMaybeBswapCoords(s, COORD_CACHE_SIZE_ELEMENTS);
+    WKBReaderCopyCoords(s, COORD_CACHE_SIZE_ELEMENTS);
+    GEOARROW_INSTRUMENT(s->instrumentation.n_chunks_flushed++);
     NANOARROW_RETURN_NOT_OK(v->coords(v, &s->coord_view));
     s->data += COORD_CACHE_SIZE_ELEMENTS * sizeof(double);
     s->n_bytes -= COORD_CACHE_SIZE_ELEMENTS * sizeof(double);
@@ -113,11 +297,11 @@ static int WKBReaderReadCoordinates(struct WKBReaderPrivate* s, int64_t n_coords
 
   // Process the last chunk
   int64_t remaining_bytes = n_coords * s->coord_view.n_values * sizeof(double);
-  memcpy(s->coords, s->data, remaining_bytes);
+  WKBReaderCopyCoords(s, n_coords * s->coord_view.n_values);
   s->data += remaining_bytes;
   s->n_bytes -= remaining_bytes;
   s->coord_view.n_coords = n_coords;
-  WKBReaderMaybeBswapCoords(s, n_coords * s->coord_view.n_values);
+  GEOARROW_INSTRUMENT(s->instrumentation.n_chunks_flushed++);
   return v->coords(v, &s->coord_view);
 }
 
@@ -186,6 +370,13 @@ static int WKBReaderReadGeometry(struct WKBReaderPrivate* s, struct GeoArrowVisi
     dimensions = GEOARROW_DIMENSIONS_XY;
   }
 
+  s->coerce = s->dimensions != GEOARROW_DIMENSIONS_UNKNOWN && s->dimensions != dimensions;
+  if (s->coerce) {
+    s->coerce_n_values = GeoArrowDimensionsMapValues(dimensions, s->dimensions,
+                                                     s->coerce_map);
+    dimensions = s->dimensions;
+  }
+
   NANOARROW_RETURN_NOT_OK(v->geom_start(v, geometry_type, dimensions));
 
   switch (geometry_type) {
@@ -220,6 +411,177 @@ static int WKBReaderReadGeometry(struct WKBReaderPrivate* s, struct GeoArrowVisi
   return v->geom_end(v);
 }
 
+static inline uint32_t WKBSizeReadUInt32(const uint8_t* data, int need_swapping) {
+  uint32_t out;
+  memcpy(&out, data, sizeof(uint32_t));
+  if (need_swapping) {
+    out = GEOARROW_BSWAP32(out);
+  }
+  return out;
+}
+
+// Walks only the headers and counts of the geometry starting at data + *offset
+// and advances *offset past its last byte; coordinates are skipped arithmetically
+static int WKBSizeInternal(const uint8_t* data, int64_t n_bytes, int64_t* offset,
+                           int depth, struct GeoArrowError* error) {
+  if (depth > 31) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Maximum WKB nesting depth exceeded at byte %ld", (long)*offset);
+    return EINVAL;
+  }
+
+  if ((n_bytes - *offset) < 5) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Expected endian byte and geometry type but found end of buffer at "
+                  "byte %ld",
+                  (long)*offset);
+    return EINVAL;
+  }
+
+  int need_swapping = data[*offset] != GEOARROW_NATIVE_ENDIAN;
+  const int64_t geometry_type_offset = *offset + 1;
+  uint32_t geometry_type = WKBSizeReadUInt32(data + geometry_type_offset, need_swapping);
+  *offset += 5;
+
+  int64_t n_values = 2;
+  if (geometry_type & EWKB_Z_BIT) {
+    n_values++;
+  }
+
+  if (geometry_type & EWKB_M_BIT) {
+    n_values++;
+  }
+
+  if (geometry_type & EWKB_SRID_BIT) {
+    *offset += sizeof(uint32_t);
+  }
+
+  geometry_type = geometry_type & 0x0000ffff;
+  if (geometry_type >= 3000) {
+    geometry_type = geometry_type - 3000;
+    n_values += 2;
+  } else if (geometry_type >= 1000) {
+    geometry_type = geometry_type % 1000;
+    n_values++;
+  }
+
+  int64_t coord_size = n_values * sizeof(double);
+  uint32_t size = 0;
+  if (geometry_type == GEOARROW_GEOMETRY_TYPE_POINT) {
+    *offset += coord_size;
+  } else if (geometry_type <= GEOARROW_GEOMETRY_TYPE_GEOMETRYCOLLECTION &&
+             geometry_type != GEOARROW_GEOMETRY_TYPE_GEOMETRY) {
+    if ((n_bytes - *offset) < 4) {
+      ArrowErrorSet((struct ArrowError*)error,
+                    "Expected uint32 but found end of buffer at byte %ld", (long)*offset);
+      return EINVAL;
+    }
+
+    size = WKBSizeReadUInt32(data + *offset, need_swapping);
+    *offset += sizeof(uint32_t);
+  }
+
+  switch (geometry_type) {
+    case GEOARROW_GEOMETRY_TYPE_POINT:
+      break;
+    case GEOARROW_GEOMETRY_TYPE_LINESTRING:
+      *offset += size * coord_size;
+      break;
+    case GEOARROW_GEOMETRY_TYPE_POLYGON:
+      for (uint32_t i = 0; i < size; i++) {
+        if ((n_bytes - *offset) < 4) {
+          ArrowErrorSet((struct ArrowError*)error,
+                        "Expected uint32 but found end of buffer at byte %ld",
+                        (long)*offset);
+          return EINVAL;
+        }
+
+        *offset += sizeof(uint32_t) +
+                   WKBSizeReadUInt32(data + *offset, need_swapping) * coord_size;
+      }
+      break;
+    case GEOARROW_GEOMETRY_TYPE_MULTIPOINT:
+    case GEOARROW_GEOMETRY_TYPE_MULTILINESTRING:
+    case GEOARROW_GEOMETRY_TYPE_MULTIPOLYGON:
+    case GEOARROW_GEOMETRY_TYPE_GEOMETRYCOLLECTION:
+      for (uint32_t i = 0; i < size; i++) {
+        NANOARROW_RETURN_NOT_OK(WKBSizeInternal(data, n_bytes, offset, depth + 1, error));
+      }
+      break;
+    default:
+      ArrowErrorSet((struct ArrowError*)error,
+                    "Expected valid geometry type code but found %u at byte %ld",
+                    (unsigned int)geometry_type, (long)geometry_type_offset);
+      return EINVAL;
+  }
+
+  if (*offset > n_bytes) {
+    ArrowErrorSet((struct ArrowError*)error,
+                  "Expected WKB geometry of %ld bytes but found %ld bytes", (long)*offset,
+                  (long)n_bytes);
+    return EINVAL;
+  }
+
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowWKBSize(struct GeoArrowBufferView src, int64_t* size_out,
+                                  struct GeoArrowError* error) {
+  int64_t offset = 0;
+  NANOARROW_RETURN_NOT_OK(WKBSizeInternal(src.data, src.n_bytes, &offset, 0, error));
+  *size_out = offset;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowWKBOffsetsInt32(struct GeoArrowBufferView src, int32_t* offsets,
+                                          int64_t n_offsets, int64_t* n_items_out,
+                                          struct GeoArrowError* error) {
+  int64_t offset = 0;
+  int64_t n_items = 0;
+  if (offsets != NULL && n_offsets > 0) {
+    offsets[0] = 0;
+  }
+
+  while (offset < src.n_bytes && (offsets == NULL || (n_items + 1) < n_offsets)) {
+    NANOARROW_RETURN_NOT_OK(WKBSizeInternal(src.data, src.n_bytes, &offset, 0, error));
+    if (offset > INT32_MAX) {
+      ArrowErrorSet((struct ArrowError*)error,
+                    "WKB item %ld ends at byte %ld which overflows int32 offsets",
+                    (long)n_items, (long)offset);
+      return EOVERFLOW;
+    }
+
+    n_items++;
+    if (offsets != NULL) {
+      offsets[n_items] = (int32_t)offset;
+    }
+  }
+
+  *n_items_out = n_items;
+  return GEOARROW_OK;
+}
+
+GeoArrowErrorCode GeoArrowWKBOffsetsInt64(struct GeoArrowBufferView src, int64_t* offsets,
+                                          int64_t n_offsets, int64_t* n_items_out,
+                                          struct GeoArrowError* error) {
+  int64_t offset = 0;
+  int64_t n_items = 0;
+  if (offsets != NULL && n_offsets > 0) {
+    offsets[0] = 0;
+  }
+
+  while (offset < src.n_bytes && (offsets == NULL || (n_items + 1) < n_offsets)) {
+    NANOARROW_RETURN_NOT_OK(WKBSizeInternal(src.data, src.n_bytes, &offset, 0, error));
+    n_items++;
+    if (offsets != NULL) {
+      offsets[n_items] = offset;
+    }
+  }
+
+  *n_items_out = n_items;
+  return GEOARROW_OK;
+}
+
 GeoArrowErrorCode GeoArrowWKBReaderInit(struct GeoArrowWKBReader* reader) {
   struct WKBReaderPrivate* s =
       (struct WKBReaderPrivate*)ArrowMalloc(sizeof(struct WKBReaderPrivate));
@@ -232,6 +594,8 @@ GeoArrowErrorCode GeoArrowWKBReaderInit(struct GeoArrowWKBReader* reader) {
   s->data = NULL;
   s->n_bytes = 0;
   s->need_swapping = 0;
+  s->use_unaligned_coords = 0;
+  s->bswap_copy = WKBReaderResolveBswapCopy();
 
   s->coord_view.coords_stride = 2;
   s->coord_view.n_values = 2;
@@ -241,6 +605,12 @@ GeoArrowErrorCode GeoArrowWKBReaderInit(struct GeoArrowWKBReader* reader) {
   s->coord_view.values[2] = s->coords + 2;
   s->coord_view.values[3] = s->coords + 3;
 
+  s->dimensions = GEOARROW_DIMENSIONS_UNKNOWN;
+  s->coerce = 0;
+  memset(&s->instrumentation, 0, sizeof(struct GeoArrowInstrumentation));
+
+  reader->use_unaligned_coords = 0;
+  reader->dimensions = GEOARROW_DIMENSIONS_UNKNOWN;
   reader->private_data = s;
   return GEOARROW_OK;
 }
@@ -256,10 +626,43 @@ GeoArrowErrorCode GeoArrowWKBReaderVisit(struct GeoArrowWKBReader* reader,
   s->data0 = src.data;
   s->data = src.data;
   s->n_bytes = src.n_bytes;
+  s->use_unaligned_coords = reader->use_unaligned_coords;
+  s->dimensions = reader->dimensions;
+  GEOARROW_INSTRUMENT(int64_t start_ns = GeoArrowInstrumentationNowNs());
 
-  NANOARROW_RETURN_NOT_OK(v->feat_start(v));
-  NANOARROW_RETURN_NOT_OK(WKBReaderReadGeometry(s, v));
-  NANOARROW_RETURN_NOT_OK(v->feat_end(v));
+  struct GeoArrowTracer* tracer = GeoArrowGetTracer();
+  if (tracer != NULL) {
+    tracer->begin(tracer, GEOARROW_TRACE_EVENT_WKB_READER_VISIT);
+  }
+
+  int result = v->feat_start(v);
+  if (result == GEOARROW_OK) {
+    result = WKBReaderReadGeometry(s, v);
+  }
 
+  if (result == GEOARROW_OK) {
+    result = v->feat_end(v);
+  }
+
+  GEOARROW_INSTRUMENT(s->instrumentation.n_features++);
+  GEOARROW_INSTRUMENT(s->instrumentation.n_bytes_in += src.n_bytes);
+  GEOARROW_INSTRUMENT(GeoArrowInstrumentationEnd(&s->instrumentation, start_ns));
+
+  if (tracer != NULL) {
+    tracer->end(tracer, GEOARROW_TRACE_EVENT_WKB_READER_VISIT, 1, src.n_bytes, result);
+  }
+
+  return result;
+}
+
+GeoArrowErrorCode GeoArrowWKBReaderGetInstrumentation(
+    struct GeoArrowWKBReader* reader, struct GeoArrowInstrumentation* out) {
+#if defined(GEOARROW_INSTRUMENTATION)
+  struct WKBReaderPrivate* s = (struct WKBReaderPrivate*)reader->private_data;
+  memcpy(out, &s->instrumentation, sizeof(struct GeoArrowInstrumentation));
   return GEOARROW_OK;
+#else
+  memset(out, 0, sizeof(struct GeoArrowInstrumentation));
+  return ENOTSUP;
+#endif
 }
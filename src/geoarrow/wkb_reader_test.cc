@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include "wkx_testing.hpp"
 
 #include <gtest/gtest.h>
@@ -222,3 +224,311 @@ TEST(WKTReaderTest, WKTReaderTestManyCoordinates) {
   std::basic_string<uint8_t> big_linestring_wkb = tester.AsWKB(ss.str());
   EXPECT_WKB_ROUNDTRIP(tester, big_linestring_wkb);
 }
+
+TEST(WKBReaderTest, WKBReaderTestSize) {
+  WKXTester tester;
+  struct GeoArrowError error;
+  int64_t size;
+
+  for (const auto& wkt :
+       {"POINT (0 1)", "POINT ZM (0 1 2 3)", "LINESTRING EMPTY",
+        "LINESTRING M (0 1 2, 3 4 5)",
+        "POLYGON ((0 0, 1 0, 0 1, 0 0), (0.1 0.1, 0.2 0.1, 0.1 0.2, 0.1 0.1))",
+        "MULTIPOINT Z ((0 1 2), (3 4 5))",
+        "MULTILINESTRING ((0 1, 2 3), (4 5, 6 7, 8 9))",
+        "MULTIPOLYGON (((0 0, 1 0, 0 1, 0 0)), EMPTY)",
+        "GEOMETRYCOLLECTION (POINT (0 1), GEOMETRYCOLLECTION (LINESTRING (0 1, 2 3)))"}) {
+    std::basic_string<uint8_t> wkb = tester.AsWKB(wkt);
+
+    // Trailing bytes are not part of the item
+    std::basic_string<uint8_t> wkb_padded = wkb + std::basic_string<uint8_t>(7, 0xff);
+    struct GeoArrowBufferView src = {wkb_padded.data(), (int64_t)wkb_padded.size()};
+    ASSERT_EQ(GeoArrowWKBSize(src, &size, &error), GEOARROW_OK) << wkt;
+    EXPECT_EQ(size, wkb.size()) << wkt;
+
+    // Truncated items are an error
+    src.n_bytes = wkb.size() - 1;
+    EXPECT_EQ(GeoArrowWKBSize(src, &size, &error), EINVAL) << wkt;
+  }
+
+  // Big endian and EWKB with an embedded SRID
+  std::basic_string<uint8_t> point_be({0x00, 0x00, 0x00, 0x00, 0x01, 0x40, 0x3e, 0x00,
+                                       0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x24, 0x00,
+                                       0x00, 0x00, 0x00, 0x00, 0x00});
+  struct GeoArrowBufferView src = {point_be.data(), (int64_t)point_be.size()};
+  ASSERT_EQ(GeoArrowWKBSize(src, &size, &error), GEOARROW_OK);
+  EXPECT_EQ(size, 21);
+
+  std::basic_string<uint8_t> point_srid(
+      {0x01, 0x01, 0x00, 0x00, 0xa0, 0xe6, 0x10, 0x00, 0x00, 0x00, 0x00,
+       0x00, 0x00, 0x00, 0x00, 0x3e, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+       0x00, 0x24, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x40});
+  src = {point_srid.data(), (int64_t)point_srid.size()};
+  ASSERT_EQ(GeoArrowWKBSize(src, &size, &error), GEOARROW_OK);
+  EXPECT_EQ(size, 33);
+
+  std::basic_string<uint8_t> invalid({0x01, 0x0b, 0x00, 0x00, 0x00});
+  src = {invalid.data(), (int64_t)invalid.size()};
+  EXPECT_EQ(GeoArrowWKBSize(src, &size, &error), EINVAL);
+  EXPECT_STREQ(error.message, "Expected valid geometry type code but found 11 at byte 1");
+}
+
+TEST(WKBReaderTest, WKBReaderTestOffsets) {
+  WKXTester tester;
+  struct GeoArrowError error;
+  std::basic_string<uint8_t> blob = tester.AsWKB("POINT (0 1)") +
+                                    tester.AsWKB("LINESTRING (0 1, 2 3)") +
+                                    tester.AsWKB("POINT Z (0 1 2)");
+  struct GeoArrowBufferView src = {blob.data(), (int64_t)blob.size()};
+  int64_t n_items;
+
+  // Count only
+  ASSERT_EQ(GeoArrowWKBOffsetsInt32(src, nullptr, 0, &n_items, &error), GEOARROW_OK);
+  EXPECT_EQ(n_items, 3);
+
+  std::vector<int32_t> offsets32(4);
+  ASSERT_EQ(GeoArrowWKBOffsetsInt32(src, offsets32.data(), offsets32.size(), &n_items,
+                                    &error),
+            GEOARROW_OK);
+  EXPECT_EQ(n_items, 3);
+  EXPECT_EQ(offsets32, std::vector<int32_t>({0, 21, 62, 91}));
+
+  std::vector<int64_t> offsets64(4);
+  ASSERT_EQ(GeoArrowWKBOffsetsInt64(src, offsets64.data(), offsets64.size(), &n_items,
+                                    &error),
+            GEOARROW_OK);
+  EXPECT_EQ(n_items, 3);
+  EXPECT_EQ(offsets64, std::vector<int64_t>({0, 21, 62, 91}));
+
+  // Output that is too small stops early
+  ASSERT_EQ(GeoArrowWKBOffsetsInt64(src, offsets64.data(), 2, &n_items, &error),
+            GEOARROW_OK);
+  EXPECT_EQ(n_items, 1);
+  EXPECT_EQ(offsets64[1], 21);
+
+  // Trailing bytes that are not a complete item are an error
+  blob.push_back(0x01);
+  src.n_bytes = blob.size();
+  EXPECT_EQ(GeoArrowWKBOffsetsInt32(src, nullptr, 0, &n_items, &error), EINVAL);
+}
+
+static std::basic_string<uint8_t> SwapWKBLinestring(const std::basic_string<uint8_t>& wkb) {
+  // Converts a little endian WKB linestring to big endian
+  std::basic_string<uint8_t> out = wkb;
+  out[0] = 0x00;
+  std::reverse(out.begin() + 1, out.begin() + 5);
+  std::reverse(out.begin() + 5, out.begin() + 9);
+  for (size_t i = 9; i < out.size(); i += sizeof(double)) {
+    std::reverse(out.begin() + i, out.begin() + i + sizeof(double));
+  }
+  return out;
+}
+
+TEST(WKBReaderTest, WKBReaderTestBigEndianManyCoordinates) {
+  WKXTester tester;
+
+  // Odd numbers of ordinates and enough coordinates to need more than one chunk
+  // exercise the vectorized swap and its scalar remainder
+  for (int n : {1, 2, 3, 5, 1537, 3000}) {
+    std::stringstream ss;
+    ss << "LINESTRING Z (0 1 2";
+    for (int i = 1; i < n; i++) {
+      ss << ", " << i << " " << (i + 1) << " " << (i + 0.5);
+    }
+    ss << ")";
+
+    std::basic_string<uint8_t> wkb_le = tester.AsWKB(ss.str());
+    std::basic_string<uint8_t> wkb_be = SwapWKBLinestring(wkb_le);
+    EXPECT_EQ(tester.AsWKB(wkb_be), wkb_le) << n;
+  }
+}
+
+TEST(WKBReaderTest, WKBReaderTestAlignedNoCopy) {
+  WKXTester tester;
+  std::basic_string<uint8_t> wkb = tester.AsWKB("LINESTRING (0 1, 2 3, 4 5)");
+
+  // Place the linestring so that its coordinates (which start at byte 9) are aligned
+  std::vector<double> storage(wkb.size() / sizeof(double) + 2);
+  uint8_t* aligned_start = reinterpret_cast<uint8_t*>(storage.data()) + 7;
+  memcpy(aligned_start, wkb.data(), wkb.size());
+
+  struct CoordsCapture {
+    const double* first;
+    int64_t n_coords;
+  } capture;
+
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorInitVoid(&v);
+  v.private_data = &capture;
+  v.coords = [](struct GeoArrowVisitor* v, const struct GeoArrowCoordView* coords) {
+    auto capture = reinterpret_cast<CoordsCapture*>(v->private_data);
+    capture->first = coords->values[0];
+    capture->n_coords = coords->n_coords;
+    return GEOARROW_OK;
+  };
+
+  struct GeoArrowWKBReader reader;
+  ASSERT_EQ(GeoArrowWKBReaderInit(&reader), GEOARROW_OK);
+  struct GeoArrowBufferView src = {aligned_start, (int64_t)wkb.size()};
+  ASSERT_EQ(GeoArrowWKBReaderVisit(&reader, src, &v), GEOARROW_OK);
+  GeoArrowWKBReaderReset(&reader);
+
+  EXPECT_EQ(capture.first, storage.data() + 2);
+  EXPECT_EQ(capture.n_coords, 3);
+
+  // ...and the output is the same as the copying path
+  EXPECT_EQ(tester.AsWKT(std::basic_string<uint8_t>(aligned_start, wkb.size())),
+            "LINESTRING (0 1, 2 3, 4 5)");
+}
+
+TEST(WKBReaderTest, WKBReaderTestUnalignedNoCopy) {
+  WKXTester tester;
+  std::basic_string<uint8_t> wkb = tester.AsWKB("LINESTRING (0 1, 2 3, 4 5)");
+
+  // Place the linestring so that its coordinates (which start at byte 9) are unaligned
+  std::vector<double> storage(wkb.size() / sizeof(double) + 2);
+  uint8_t* unaligned_start = reinterpret_cast<uint8_t*>(storage.data()) + 8;
+  memcpy(unaligned_start, wkb.data(), wkb.size());
+  struct GeoArrowBufferView src = {unaligned_start, (int64_t)wkb.size()};
+
+  struct CoordsCapture {
+    const void* first;
+    std::vector<double> values;
+  } capture;
+
+  struct GeoArrowVisitor v;
+  GeoArrowVisitorInitVoid(&v);
+  v.private_data = &capture;
+  v.coords = [](struct GeoArrowVisitor* v, const struct GeoArrowCoordView* coords) {
+    auto capture = reinterpret_cast<CoordsCapture*>(v->private_data);
+    capture->first = coords->values[0];
+    for (int64_t i = 0; i < coords->n_coords; i++) {
+      for (int32_t j = 0; j < coords->n_values; j++) {
+        capture->values.push_back(GeoArrowCoordViewValueUnaligned(coords, i, j));
+      }
+    }
+    return GEOARROW_OK;
+  };
+
+  struct GeoArrowWKBReader reader;
+  ASSERT_EQ(GeoArrowWKBReaderInit(&reader), GEOARROW_OK);
+  EXPECT_EQ(reader.use_unaligned_coords, 0);
+
+  // By default, unaligned coordinates are copied
+  ASSERT_EQ(GeoArrowWKBReaderVisit(&reader, src, &v), GEOARROW_OK);
+  EXPECT_NE(capture.first, unaligned_start + 9);
+  EXPECT_EQ(capture.values, std::vector<double>({0, 1, 2, 3, 4, 5}));
+
+  // ...but can be passed through if the visitor reads them as unaligned values
+  capture.values.clear();
+  reader.use_unaligned_coords = 1;
+  ASSERT_EQ(GeoArrowWKBReaderVisit(&reader, src, &v), GEOARROW_OK);
+  EXPECT_EQ(capture.first, unaligned_start + 9);
+  EXPECT_EQ(capture.values, std::vector<double>({0, 1, 2, 3, 4, 5}));
+
+  // The WKB writer can consume unaligned coordinates directly
+  struct GeoArrowWKBWriter writer;
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowWKBWriterInit(&writer), GEOARROW_OK);
+  GeoArrowWKBWriterInitVisitor(&writer, &v);
+  ASSERT_EQ(GeoArrowWKBReaderVisit(&reader, src, &v), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowWKBWriterFinish(&writer, &array, nullptr), GEOARROW_OK);
+  GeoArrowWKBWriterReset(&writer);
+  GeoArrowWKBReaderReset(&reader);
+
+  ASSERT_EQ(array.length, 1);
+  const int32_t* offsets = reinterpret_cast<const int32_t*>(array.buffers[1]);
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(array.buffers[2]);
+  EXPECT_EQ(std::basic_string<uint8_t>(data + offsets[0], offsets[1] - offsets[0]), wkb);
+  array.release(&array);
+}
+
+static std::string CoerceWKB(const std::basic_string<uint8_t>& wkb,
+                             enum GeoArrowDimensions dimensions) {
+  WKXTester tester;
+  struct GeoArrowWKBReader reader;
+  GeoArrowWKBReaderInit(&reader);
+  EXPECT_EQ(reader.dimensions, GEOARROW_DIMENSIONS_UNKNOWN);
+  reader.dimensions = dimensions;
+
+  struct GeoArrowBufferView item = {wkb.data(), (int64_t)wkb.size()};
+  EXPECT_EQ(GeoArrowWKBReaderVisit(&reader, item, tester.WKTVisitor()), GEOARROW_OK);
+  GeoArrowWKBReaderReset(&reader);
+  return tester.WKTValue();
+}
+
+TEST(WKBReaderTest, WKBReaderTestCoerceDimensions) {
+  WKXTester tester;
+  EXPECT_EQ(CoerceWKB(tester.AsWKB("POINT ZM (1 2 3 4)"), GEOARROW_DIMENSIONS_XY),
+            "POINT (1 2)");
+  EXPECT_EQ(CoerceWKB(tester.AsWKB("POINT ZM (1 2 3 4)"), GEOARROW_DIMENSIONS_XYM),
+            "POINT M (1 2 4)");
+  EXPECT_EQ(CoerceWKB(tester.AsWKB("POINT (1 2)"), GEOARROW_DIMENSIONS_XYZM),
+            "POINT ZM (1 2 0 0)");
+  EXPECT_EQ(CoerceWKB(tester.AsWKB("POLYGON M ((0 0 1, 1 0 2, 0 1 3, 0 0 1))"),
+                      GEOARROW_DIMENSIONS_XYZ),
+            "POLYGON Z ((0 0 0, 1 0 0, 0 1 0, 0 0 0))");
+  EXPECT_EQ(
+      CoerceWKB(tester.AsWKB("GEOMETRYCOLLECTION (POINT Z (1 2 3), POINT (4 5))"),
+                GEOARROW_DIMENSIONS_XY),
+      "GEOMETRYCOLLECTION (POINT (1 2), POINT (4 5))");
+
+  // Enough coordinates to need more than one chunk, in both byte orders
+  for (auto dimensions : {GEOARROW_DIMENSIONS_XY, GEOARROW_DIMENSIONS_XYZM}) {
+    std::stringstream ss;
+    std::stringstream expected;
+    ss << "LINESTRING Z (0 1 2";
+    expected << (dimensions == GEOARROW_DIMENSIONS_XY ? "LINESTRING (0 1"
+                                                      : "LINESTRING ZM (0 1 2 0");
+    for (int i = 1; i < 1537; i++) {
+      ss << ", " << i << " " << (i + 1) << " " << (i + 2);
+      expected << ", " << i << " " << (i + 1);
+      if (dimensions == GEOARROW_DIMENSIONS_XYZM) {
+        expected << " " << (i + 2) << " 0";
+      }
+    }
+    ss << ")";
+    expected << ")";
+
+    std::basic_string<uint8_t> wkb_le = tester.AsWKB(ss.str());
+    EXPECT_EQ(CoerceWKB(wkb_le, dimensions), expected.str());
+    EXPECT_EQ(CoerceWKB(SwapWKBLinestring(wkb_le), dimensions), expected.str());
+  }
+}
+
+TEST(WKBReaderTest, WKBReaderTestInstrumentation) {
+  WKXTester tester;
+  std::stringstream ss;
+  ss << "LINESTRING Z (0 1 2";
+  for (int i = 1; i < 1537; i++) {
+    ss << ", " << i << " " << (i + 1) << " " << (i + 2);
+  }
+  ss << ")";
+  std::basic_string<uint8_t> wkb = SwapWKBLinestring(tester.AsWKB(ss.str()));
+
+  struct GeoArrowWKBReader reader;
+  struct GeoArrowVisitor v;
+  struct GeoArrowInstrumentation instrumentation;
+  ASSERT_EQ(GeoArrowWKBReaderInit(&reader), GEOARROW_OK);
+  GeoArrowVisitorInitVoid(&v);
+  if (GeoArrowWKBReaderGetInstrumentation(&reader, &instrumentation) == ENOTSUP) {
+    EXPECT_EQ(instrumentation.n_calls, 0);
+    GeoArrowWKBReaderReset(&reader);
+    GTEST_SKIP() << "Built without GEOARROW_INSTRUMENTATION";
+  }
+
+  struct GeoArrowBufferView src = {wkb.data(), (int64_t)wkb.size()};
+  ASSERT_EQ(GeoArrowWKBReaderVisit(&reader, src, &v), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowWKBReaderVisit(&reader, src, &v), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowWKBReaderGetInstrumentation(&reader, &instrumentation), GEOARROW_OK);
+  GeoArrowWKBReaderReset(&reader);
+
+  // 1024 XYZ coordinates fit in the coordinate cache
+  EXPECT_EQ(instrumentation.n_calls, 2);
+  EXPECT_EQ(instrumentation.n_features, 2);
+  EXPECT_EQ(instrumentation.n_coords, 2 * 1537);
+  EXPECT_EQ(instrumentation.n_bytes_in, 2 * (int64_t)wkb.size());
+  EXPECT_EQ(instrumentation.n_values_swapped, 2 * 1537 * 3);
+  EXPECT_EQ(instrumentation.n_chunks_flushed, 4);
+  EXPECT_GE(instrumentation.elapsed_ns, 0);
+}
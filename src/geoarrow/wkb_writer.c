@@ -5,11 +5,17 @@
 
 #include "geoarrow.h"
 
+#include "instrumentation.h"
+#include "writer_buffers.h"
+
 struct WKBWriterPrivate {
   enum ArrowType storage_type;
   struct ArrowBitmap validity;
   struct ArrowBuffer offsets;
   struct ArrowBuffer values;
+  struct ArrowBufferAllocator allocator;
+  int retain_buffers;
+  struct GeoArrowInstrumentation instrumentation;
   enum GeoArrowGeometryType geometry_type[32];
   enum GeoArrowDimensions dimensions[32];
   int64_t size_pos[32];
@@ -47,18 +53,32 @@ static int feat_start_wkb(struct GeoArrowVisitor* v) {
   private->level = 0;
   private->size[private->level] = 0;
   private->length++;
+  GEOARROW_INSTRUMENT(private->instrumentation.n_features++);
   return ArrowBufferAppendInt32(&private->offsets, private->values.size_bytes);
 }
 
 static int null_feat_wkb(struct GeoArrowVisitor* v) {
   struct WKBWriterPrivate* private = (struct WKBWriterPrivate*)v->private_data;
-  if (private->validity.buffer.data == NULL && private->length > 0) {
-    NANOARROW_RETURN_NOT_OK(ArrowBitmapReserve(&private->validity, private->length));
-    ArrowBitmapAppendUnsafe(&private->validity, 1, private->length - 1);
+  if (private->length == 0) {
+    return EINVAL;
+  }
+
+  // The validity bitmap is only written up to the last null: the valid features
+  // before this one are filled in at once here and the ones after the last null when
+  // the array is finished
+  int64_t n_valid = private->length - 1 - private->validity.size_bits;
+  if (n_valid < 0) {
+    return GEOARROW_OK;
   }
 
+  NANOARROW_RETURN_NOT_OK(ArrowBitmapReserve(&private->validity, n_valid + 1));
+  if (n_valid > 0) {
+    ArrowBitmapAppendUnsafe(&private->validity, 1, n_valid);
+  }
+
+  ArrowBitmapAppendUnsafe(&private->validity, 0, 1);
   private->null_count++;
-  return ArrowBitmapAppend(&private->validity, 0, 1);
+  return GEOARROW_OK;
 }
 
 static int geom_start_wkb(struct GeoArrowVisitor* v,
@@ -99,6 +119,7 @@ static int coords_wkb(struct GeoArrowVisitor* v, const struct GeoArrowCoordView*
   struct WKBWriterPrivate* private = (struct WKBWriterPrivate*)v->private_data;
   NANOARROW_RETURN_NOT_OK(WKBWriterCheckLevel(private));
   private->size[private->level] += coords->n_coords;
+  GEOARROW_INSTRUMENT(private->instrumentation.n_coords += coords->n_coords);
   NANOARROW_RETURN_NOT_OK(ArrowBufferReserve(
       &private->values, coords->n_values * coords->n_coords * sizeof(double)));
   for (int64_t i = 0; i < coords->n_coords; i++) {
@@ -175,6 +196,9 @@ GeoArrowErrorCode GeoArrowWKBWriterInit(struct GeoArrowWKBWriter* writer) {
   ArrowBitmapInit(&private->validity);
   ArrowBufferInit(&private->offsets);
   ArrowBufferInit(&private->values);
+  private->allocator = ArrowBufferAllocatorDefault();
+  private->retain_buffers = 0;
+  memset(&private->instrumentation, 0, sizeof(struct GeoArrowInstrumentation));
   writer->private_data = private;
 
   return GEOARROW_OK;
@@ -196,18 +220,44 @@ void GeoArrowWKBWriterInitVisitor(struct GeoArrowWKBWriter* writer,
   v->geom_end = &geom_end_wkb;
 }
 
-GeoArrowErrorCode GeoArrowWKBWriterFinish(struct GeoArrowWKBWriter* writer,
-                                          struct ArrowArray* array,
-                                          struct GeoArrowError* error) {
+GeoArrowErrorCode GeoArrowWKBWriterSetAllocator(
+    struct GeoArrowWKBWriter* writer, struct GeoArrowBufferAllocator allocator) {
   struct WKBWriterPrivate* private = (struct WKBWriterPrivate*)writer->private_data;
-  array->release = NULL;
+  if (private->validity.buffer.data != NULL || private->offsets.data != NULL ||
+      private->values.data != NULL) {
+    return EINVAL;
+  }
+
+  private->allocator.reallocate = allocator.reallocate;
+  private->allocator.free = allocator.free;
+  private->allocator.private_data = allocator.private_data;
+  ArrowBufferSetAllocator(&private->validity.buffer, private->allocator);
+  ArrowBufferSetAllocator(&private->offsets, private->allocator);
+  ArrowBufferSetAllocator(&private->values, private->allocator);
+  return GEOARROW_OK;
+}
 
+void GeoArrowWKBWriterSetRetainBuffers(struct GeoArrowWKBWriter* writer,
+                                      int retain_buffers) {
+  struct WKBWriterPrivate* private = (struct WKBWriterPrivate*)writer->private_data;
+  private->retain_buffers = retain_buffers;
+}
+
+static GeoArrowErrorCode WKBWriterFinishArray(struct WKBWriterPrivate* private,
+                                             struct ArrowArray* array,
+                                             struct GeoArrowError* error) {
   NANOARROW_RETURN_NOT_OK(
       ArrowBufferAppendInt32(&private->offsets, private->values.size_bytes));
+  if (private->null_count > 0 && private->validity.size_bits < private->length) {
+    NANOARROW_RETURN_NOT_OK(ArrowBitmapAppend(
+        &private->validity, 1, private->length - private->validity.size_bits));
+  }
+
   NANOARROW_RETURN_NOT_OK(ArrowArrayInit(array, private->storage_type));
-  ArrowArraySetValidityBitmap(array, &private->validity);
-  NANOARROW_RETURN_NOT_OK(ArrowArraySetBuffer(array, 1, &private->offsets));
-  NANOARROW_RETURN_NOT_OK(ArrowArraySetBuffer(array, 2, &private->values));
+  NANOARROW_RETURN_NOT_OK(GeoArrowWriterSetBuffers(&private->validity, &private->offsets,
+                                                   &private->values, private->allocator,
+                                                   private->retain_buffers, array));
+
   array->length = private->length;
   array->null_count = private->null_count;
   private->length = 0;
@@ -215,6 +265,45 @@ GeoArrowErrorCode GeoArrowWKBWriterFinish(struct GeoArrowWKBWriter* writer,
   return ArrowArrayFinishBuilding(array, (struct ArrowError*)error);
 }
 
+GeoArrowErrorCode GeoArrowWKBWriterFinish(struct GeoArrowWKBWriter* writer,
+                                          struct ArrowArray* array,
+                                          struct GeoArrowError* error) {
+  struct WKBWriterPrivate* private = (struct WKBWriterPrivate*)writer->private_data;
+  array->release = NULL;
+
+  int64_t n_rows = private->length;
+  int64_t n_bytes = private->values.size_bytes;
+  GEOARROW_INSTRUMENT(int64_t start_ns = GeoArrowInstrumentationNowNs());
+
+  struct GeoArrowTracer* tracer = GeoArrowGetTracer();
+  if (tracer != NULL) {
+    tracer->begin(tracer, GEOARROW_TRACE_EVENT_WKB_WRITER_FINISH);
+  }
+
+  int result = WKBWriterFinishArray(private, array, error);
+
+  GEOARROW_INSTRUMENT(private->instrumentation.n_bytes_out += n_bytes);
+  GEOARROW_INSTRUMENT(GeoArrowInstrumentationEnd(&private->instrumentation, start_ns));
+
+  if (tracer != NULL) {
+    tracer->end(tracer, GEOARROW_TRACE_EVENT_WKB_WRITER_FINISH, n_rows, n_bytes, result);
+  }
+
+  return result;
+}
+
+GeoArrowErrorCode GeoArrowWKBWriterGetInstrumentation(
+    struct GeoArrowWKBWriter* writer, struct GeoArrowInstrumentation* out) {
+#if defined(GEOARROW_INSTRUMENTATION)
+  struct WKBWriterPrivate* private = (struct WKBWriterPrivate*)writer->private_data;
+  memcpy(out, &private->instrumentation, sizeof(struct GeoArrowInstrumentation));
+  return GEOARROW_OK;
+#else
+  memset(out, 0, sizeof(struct GeoArrowInstrumentation));
+  return ENOTSUP;
+#endif
+}
+
 void GeoArrowWKBWriterReset(struct GeoArrowWKBWriter* writer) {
   struct WKBWriterPrivate* private = (struct WKBWriterPrivate*)writer->private_data;
   ArrowBitmapReset(&private->validity);
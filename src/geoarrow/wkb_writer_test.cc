@@ -72,6 +72,43 @@ TEST(WKBWriterTest, WKBWriterTestOneValidOneNull) {
   GeoArrowWKBWriterReset(&writer);
 }
 
+TEST(WKBWriterTest, WKBWriterTestNullThenValid) {
+  struct GeoArrowWKBWriter writer;
+  struct GeoArrowVisitor v;
+  GeoArrowWKBWriterInit(&writer);
+  GeoArrowWKBWriterInitVisitor(&writer, &v);
+
+  EXPECT_EQ(v.feat_start(&v), GEOARROW_OK);
+  EXPECT_EQ(v.null_feat(&v), GEOARROW_OK);
+  EXPECT_EQ(v.feat_end(&v), GEOARROW_OK);
+
+  for (int i = 0; i < 9; i++) {
+    EXPECT_EQ(v.feat_start(&v), GEOARROW_OK);
+    EXPECT_EQ(v.geom_start(&v, GEOARROW_GEOMETRY_TYPE_POINT, GEOARROW_DIMENSIONS_XY),
+              GEOARROW_OK);
+    EXPECT_EQ(v.geom_end(&v), GEOARROW_OK);
+    EXPECT_EQ(v.feat_end(&v), GEOARROW_OK);
+  }
+
+  struct ArrowArray array;
+  EXPECT_EQ(GeoArrowWKBWriterFinish(&writer, &array, nullptr), GEOARROW_OK);
+  EXPECT_EQ(array.length, 10);
+  EXPECT_EQ(array.null_count, 1);
+
+  struct ArrowArrayView view;
+  ArrowArrayViewInit(&view, NANOARROW_TYPE_BINARY);
+  ASSERT_EQ(ArrowArrayViewSetArray(&view, &array, nullptr), GEOARROW_OK);
+
+  EXPECT_TRUE(ArrowArrayViewIsNull(&view, 0));
+  for (int64_t i = 1; i < 10; i++) {
+    EXPECT_FALSE(ArrowArrayViewIsNull(&view, i));
+  }
+
+  ArrowArrayViewReset(&view);
+  array.release(&array);
+  GeoArrowWKBWriterReset(&writer);
+}
+
 TEST(WKBWriterTest, WKBWriterTestErrors) {
   struct GeoArrowWKBWriter writer;
   struct GeoArrowVisitor v;
@@ -199,3 +236,85 @@ TEST(WKBWriterTest, WKBWriterTestNestedCollection) {
            0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x40, 0x00,
            0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x40}));
 }
+
+TEST(WKBWriterTest, WKBWriterTestRetainBuffers) {
+  struct GeoArrowWKBWriter writer;
+  struct GeoArrowVisitor v;
+  ASSERT_EQ(GeoArrowWKBWriterInit(&writer), GEOARROW_OK);
+  GeoArrowWKBWriterSetRetainBuffers(&writer, 1);
+  GeoArrowWKBWriterInitVisitor(&writer, &v);
+
+  // Arrays finished earlier are independent of the writer's buffers
+  struct ArrowArray arrays[2];
+  struct GeoArrowWKTReader wkt_reader;
+  GeoArrowWKTReaderInit(&wkt_reader);
+  std::string wkts[2] = {"POINT (0 1)", "LINESTRING (0 1, 2 3)"};
+  for (int i = 0; i < 2; i++) {
+    ASSERT_EQ(v.feat_start(&v), GEOARROW_OK);
+    ASSERT_EQ(v.null_feat(&v), GEOARROW_OK);
+    ASSERT_EQ(v.feat_end(&v), GEOARROW_OK);
+    struct GeoArrowStringView item = {wkts[i].data(), (int64_t)wkts[i].size()};
+    ASSERT_EQ(GeoArrowWKTReaderVisit(&wkt_reader, item, &v), GEOARROW_OK);
+    ASSERT_EQ(GeoArrowWKBWriterFinish(&writer, &arrays[i], nullptr), GEOARROW_OK);
+    EXPECT_EQ(arrays[i].length, 2);
+    EXPECT_EQ(arrays[i].null_count, 1);
+  }
+
+  GeoArrowWKTReaderReset(&wkt_reader);
+  GeoArrowWKBWriterReset(&writer);
+
+  for (int i = 0; i < 2; i++) {
+    struct GeoArrowArrayReader reader;
+    ASSERT_EQ(GeoArrowArrayReaderInitFromType(&reader, GEOARROW_TYPE_WKB), GEOARROW_OK);
+    ASSERT_EQ(GeoArrowArrayReaderSetArray(&reader, &arrays[i], nullptr), GEOARROW_OK);
+    WKXTester out;
+    ASSERT_EQ(GeoArrowArrayReaderVisit(&reader, 0, arrays[i].length, out.WKTVisitor()),
+              GEOARROW_OK);
+    EXPECT_EQ(out.WKTValues("<null value>"),
+              std::vector<std::string>({"<null value>", wkts[i]}));
+    GeoArrowArrayReaderReset(&reader);
+    arrays[i].release(&arrays[i]);
+  }
+}
+
+TEST(WKBWriterTest, WKBWriterTestInstrumentation) {
+  struct GeoArrowWKBWriter writer;
+  struct GeoArrowVisitor v;
+  struct GeoArrowInstrumentation instrumentation;
+  ASSERT_EQ(GeoArrowWKBWriterInit(&writer), GEOARROW_OK);
+  if (GeoArrowWKBWriterGetInstrumentation(&writer, &instrumentation) == ENOTSUP) {
+    EXPECT_EQ(instrumentation.n_calls, 0);
+    GeoArrowWKBWriterReset(&writer);
+    GTEST_SKIP() << "Built without GEOARROW_INSTRUMENTATION";
+  }
+
+  GeoArrowWKBWriterInitVisitor(&writer, &v);
+  ASSERT_EQ(v.feat_start(&v), GEOARROW_OK);
+  ASSERT_EQ(v.null_feat(&v), GEOARROW_OK);
+  ASSERT_EQ(v.feat_end(&v), GEOARROW_OK);
+
+  struct GeoArrowWKTReader wkt_reader;
+  GeoArrowWKTReaderInit(&wkt_reader);
+  std::string wkts[2] = {"POINT (0 1)", "LINESTRING (0 1, 2 3)"};
+  for (const auto& wkt : wkts) {
+    struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+    ASSERT_EQ(GeoArrowWKTReaderVisit(&wkt_reader, item, &v), GEOARROW_OK);
+  }
+  GeoArrowWKTReaderReset(&wkt_reader);
+
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowWKBWriterFinish(&writer, &array, nullptr), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowWKBWriterGetInstrumentation(&writer, &instrumentation),
+            GEOARROW_OK);
+  GeoArrowWKBWriterReset(&writer);
+  array.release(&array);
+
+  // Null features are counted as features
+  EXPECT_EQ(instrumentation.n_calls, 1);
+  EXPECT_EQ(instrumentation.n_features, 3);
+  EXPECT_EQ(instrumentation.n_coords, 3);
+
+  // A point is 21 bytes and a linestring with two coordinates is 41 bytes
+  EXPECT_EQ(instrumentation.n_bytes_out, 21 + 41);
+  EXPECT_GE(instrumentation.elapsed_ns, 0);
+}
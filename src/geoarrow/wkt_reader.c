@@ -6,14 +6,27 @@
 
 #include "geoarrow.h"
 
+#include "instrumentation.h"
+
 #define COORD_CACHE_SIZE_COORDS 64
 
 struct WKTReaderPrivate {
   const char* data;
   int64_t n_bytes;
   const char* data0;
-  double coords[4 * COORD_CACHE_SIZE_COORDS];
+  // The fifth column of the cache receives ordinates that are dropped
+  double coords[5 * COORD_CACHE_SIZE_COORDS];
   struct GeoArrowCoordView coord_view;
+
+  // Each ordinate of a source coordinate is read into ordinate_values; columns of
+  // coord_view that the source doesn't have are zeroed via fill_values
+  enum GeoArrowDimensions dimensions;
+  int32_t n_ordinates;
+  double* ordinate_values[4];
+  int32_t n_fill;
+  double* fill_values[4];
+
+  struct GeoArrowInstrumentation instrumentation;
 };
 
 // Using fastfloat for char* -> double is ~5x faster and is not locale dependent
@@ -160,6 +173,8 @@ static inline void ResetCoordCache(struct WKTReaderPrivate* s) {
 
 static inline int FlushCoordCache(struct WKTReaderPrivate* s, struct GeoArrowVisitor* v) {
   if (s->coord_view.n_coords > 0) {
+    GEOARROW_INSTRUMENT(s->instrumentation.n_coords += s->coord_view.n_coords);
+    GEOARROW_INSTRUMENT(s->instrumentation.n_chunks_flushed++);
     int result = v->coords(v, &s->coord_view);
     s->coord_view.n_coords = 0;
     return result;
@@ -173,18 +188,55 @@ static inline int ReadCoordinate(struct WKTReaderPrivate* s, struct GeoArrowVisi
     NANOARROW_RETURN_NOT_OK(FlushCoordCache(s, v));
   }
 
-  NANOARROW_RETURN_NOT_OK(
-      ReadOrdinate(s, (double*)s->coord_view.values[0] + s->coord_view.n_coords, v->error));
-  for (int i = 1; i < s->coord_view.n_values; i++) {
+  int64_t n_coords = s->coord_view.n_coords;
+  NANOARROW_RETURN_NOT_OK(ReadOrdinate(s, s->ordinate_values[0] + n_coords, v->error));
+  for (int i = 1; i < s->n_ordinates; i++) {
     NANOARROW_RETURN_NOT_OK(AssertWhitespace(s, v->error));
-    NANOARROW_RETURN_NOT_OK(
-        ReadOrdinate(s, (double*)s->coord_view.values[i] + s->coord_view.n_coords, v->error));
+    NANOARROW_RETURN_NOT_OK(ReadOrdinate(s, s->ordinate_values[i] + n_coords, v->error));
+  }
+
+  for (int i = 0; i < s->n_fill; i++) {
+    s->fill_values[i][n_coords] = 0;
   }
 
   s->coord_view.n_coords++;
   return NANOARROW_OK;
 }
 
+// Sets up the coordinate cache for geometries with the given dimensions and returns
+// the dimensions that should be passed to the visitor
+static inline enum GeoArrowDimensions SetDimensions(struct WKTReaderPrivate* s,
+                                                    enum GeoArrowDimensions dimensions,
+                                                    int32_t n_ordinates) {
+  s->n_ordinates = n_ordinates;
+  s->n_fill = 0;
+  if (s->dimensions == GEOARROW_DIMENSIONS_UNKNOWN || s->dimensions == dimensions) {
+    s->coord_view.n_values = n_ordinates;
+    for (int32_t i = 0; i < n_ordinates; i++) {
+      s->ordinate_values[i] = s->coords + i * COORD_CACHE_SIZE_COORDS;
+    }
+
+    return dimensions;
+  }
+
+  int32_t map[4];
+  s->coord_view.n_values = GeoArrowDimensionsMapValues(dimensions, s->dimensions, map);
+  for (int32_t i = 0; i < n_ordinates; i++) {
+    s->ordinate_values[i] = s->coords + 4 * COORD_CACHE_SIZE_COORDS;
+  }
+
+  for (int32_t j = 0; j < s->coord_view.n_values; j++) {
+    double* column = s->coords + j * COORD_CACHE_SIZE_COORDS;
+    if (map[j] == -1) {
+      s->fill_values[s->n_fill++] = column;
+    } else {
+      s->ordinate_values[map[j]] = column;
+    }
+  }
+
+  return s->dimensions;
+}
+
 static inline int ReadEmptyOrCoordinates(struct WKTReaderPrivate* s,
                                          struct GeoArrowVisitor* v) {
   SkipWhitespace(s);
@@ -458,22 +510,23 @@ static inline int ReadTaggedGeometry(struct WKTReaderPrivate* s,
   SkipWhitespace(s);
 
   enum GeoArrowDimensions dimensions = GEOARROW_DIMENSIONS_XY;
-  s->coord_view.n_values = 2;
+  int32_t n_ordinates = 2;
   word = PeekUntilSep(s, 3);
   if (word.n_bytes == 1 && strncmp(word.data, "Z", 1) == 0) {
     dimensions = GEOARROW_DIMENSIONS_XYZ;
-    s->coord_view.n_values = 3;
+    n_ordinates = 3;
     AdvanceUnsafe(s, 1);
   } else if (word.n_bytes == 1 && strncmp(word.data, "M", 1) == 0) {
     dimensions = GEOARROW_DIMENSIONS_XYM;
-    s->coord_view.n_values = 3;
+    n_ordinates = 3;
     AdvanceUnsafe(s, 1);
   } else if (word.n_bytes == 2 && strncmp(word.data, "ZM", 2) == 0) {
     dimensions = GEOARROW_DIMENSIONS_XYZM;
-    s->coord_view.n_values = 4;
+    n_ordinates = 4;
     AdvanceUnsafe(s, 2);
   }
 
+  dimensions = SetDimensions(s, dimensions, n_ordinates);
   NANOARROW_RETURN_NOT_OK(v->geom_start(v, geometry_type, dimensions));
 
   switch (geometry_type) {
@@ -525,6 +578,11 @@ GeoArrowErrorCode GeoArrowWKTReaderInit(struct GeoArrowWKTReader* reader) {
     s->coord_view.values[i] = s->coord_view.values[i - 1] + COORD_CACHE_SIZE_COORDS;
   }
 
+  s->dimensions = GEOARROW_DIMENSIONS_UNKNOWN;
+  SetDimensions(s, GEOARROW_DIMENSIONS_XY, 2);
+  memset(&s->instrumentation, 0, sizeof(struct GeoArrowInstrumentation));
+
+  reader->dimensions = GEOARROW_DIMENSIONS_UNKNOWN;
   reader->private_data = s;
   return GEOARROW_OK;
 }
@@ -533,6 +591,19 @@ void GeoArrowWKTReaderReset(struct GeoArrowWKTReader* reader) {
   ArrowFree(reader->private_data);
 }
 
+static int WKTReaderVisitFeature(struct WKTReaderPrivate* s, struct GeoArrowVisitor* v) {
+  NANOARROW_RETURN_NOT_OK(v->feat_start(v));
+  NANOARROW_RETURN_NOT_OK(ReadTaggedGeometry(s, v));
+  NANOARROW_RETURN_NOT_OK(v->feat_end(v));
+  SkipWhitespace(s);
+  if (PeekChar(s) != '\0') {
+    SetParseErrorAuto("end of input", s, v->error);
+    return EINVAL;
+  }
+
+  return GEOARROW_OK;
+}
+
 GeoArrowErrorCode GeoArrowWKTReaderVisit(struct GeoArrowWKTReader* reader,
                                          struct GeoArrowStringView src,
                                          struct GeoArrowVisitor* v) {
@@ -540,15 +611,36 @@ GeoArrowErrorCode GeoArrowWKTReaderVisit(struct GeoArrowWKTReader* reader,
   s->data0 = src.data;
   s->data = src.data;
   s->n_bytes = src.n_bytes;
+  s->dimensions = reader->dimensions;
 
-  NANOARROW_RETURN_NOT_OK(v->feat_start(v));
-  NANOARROW_RETURN_NOT_OK(ReadTaggedGeometry(s, v));
-  NANOARROW_RETURN_NOT_OK(v->feat_end(v));
-  SkipWhitespace(s);
-  if (PeekChar(s) != '\0') {
-    SetParseErrorAuto("end of input", s, v->error);
-    return EINVAL;
+  GEOARROW_INSTRUMENT(int64_t start_ns = GeoArrowInstrumentationNowNs());
+
+  struct GeoArrowTracer* tracer = GeoArrowGetTracer();
+  if (tracer != NULL) {
+    tracer->begin(tracer, GEOARROW_TRACE_EVENT_WKT_READER_VISIT);
+  }
+
+  int result = WKTReaderVisitFeature(s, v);
+
+  GEOARROW_INSTRUMENT(s->instrumentation.n_features++);
+  GEOARROW_INSTRUMENT(s->instrumentation.n_bytes_in += src.n_bytes);
+  GEOARROW_INSTRUMENT(GeoArrowInstrumentationEnd(&s->instrumentation, start_ns));
+
+  if (tracer != NULL) {
+    tracer->end(tracer, GEOARROW_TRACE_EVENT_WKT_READER_VISIT, 1, src.n_bytes, result);
   }
 
+  return result;
+}
+
+GeoArrowErrorCode GeoArrowWKTReaderGetInstrumentation(
+    struct GeoArrowWKTReader* reader, struct GeoArrowInstrumentation* out) {
+#if defined(GEOARROW_INSTRUMENTATION)
+  struct WKTReaderPrivate* s = (struct WKTReaderPrivate*)reader->private_data;
+  memcpy(out, &s->instrumentation, sizeof(struct GeoArrowInstrumentation));
   return GEOARROW_OK;
+#else
+  memset(out, 0, sizeof(struct GeoArrowInstrumentation));
+  return ENOTSUP;
+#endif
 }
@@ -214,3 +214,78 @@ TEST(WKTReaderTest, WKTReaderTestLongCoordinates) {
   WKXTester tester;
   EXPECT_WKT_ROUNDTRIP(tester, ss.str());
 }
+
+static std::string CoerceWKT(const std::string& wkt, enum GeoArrowDimensions dimensions) {
+  WKXTester tester;
+  struct GeoArrowWKTReader reader;
+  GeoArrowWKTReaderInit(&reader);
+  EXPECT_EQ(reader.dimensions, GEOARROW_DIMENSIONS_UNKNOWN);
+  reader.dimensions = dimensions;
+
+  struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+  EXPECT_EQ(GeoArrowWKTReaderVisit(&reader, item, tester.WKTVisitor()), GEOARROW_OK);
+  GeoArrowWKTReaderReset(&reader);
+  return tester.WKTValue();
+}
+
+TEST(WKTReaderTest, WKTReaderTestCoerceDimensions) {
+  EXPECT_EQ(CoerceWKT("POINT ZM (1 2 3 4)", GEOARROW_DIMENSIONS_XY), "POINT (1 2)");
+  EXPECT_EQ(CoerceWKT("POINT ZM (1 2 3 4)", GEOARROW_DIMENSIONS_XYM),
+            "POINT M (1 2 4)");
+  EXPECT_EQ(CoerceWKT("POINT (1 2)", GEOARROW_DIMENSIONS_XYZM), "POINT ZM (1 2 0 0)");
+  EXPECT_EQ(CoerceWKT("POINT M (1 2 4)", GEOARROW_DIMENSIONS_XYZ), "POINT Z (1 2 0)");
+  EXPECT_EQ(CoerceWKT("POINT Z EMPTY", GEOARROW_DIMENSIONS_XY), "POINT EMPTY");
+  EXPECT_EQ(CoerceWKT("MULTIPOINT Z ((1 2 3), (4 5 6))", GEOARROW_DIMENSIONS_XY),
+            "MULTIPOINT ((1 2), (4 5))");
+  EXPECT_EQ(CoerceWKT("GEOMETRYCOLLECTION (POINT Z (1 2 3), LINESTRING (0 0, 1 1))",
+                      GEOARROW_DIMENSIONS_XYZ),
+            "GEOMETRYCOLLECTION Z (POINT Z (1 2 3), LINESTRING Z (0 0 0, 1 1 0))");
+
+  // Enough coordinates to flush the coordinate cache
+  std::stringstream ss;
+  std::stringstream expected;
+  ss << "LINESTRING Z (0 1 2";
+  expected << "LINESTRING (0 1";
+  for (int i = 1; i < 130; i++) {
+    ss << ", " << i << " " << (i + 1) << " " << (i + 2);
+    expected << ", " << i << " " << (i + 1);
+  }
+  ss << ")";
+  expected << ")";
+  EXPECT_EQ(CoerceWKT(ss.str(), GEOARROW_DIMENSIONS_XY), expected.str());
+}
+
+TEST(WKTReaderTest, WKTReaderTestInstrumentation) {
+  // 100 coordinates are passed on in two chunks (the cache holds 64)
+  std::stringstream ss;
+  ss << "LINESTRING (0 1";
+  for (int i = 1; i < 100; i++) {
+    ss << ", " << i << " " << (i + 1);
+  }
+  ss << ")";
+  std::string wkt = ss.str();
+
+  struct GeoArrowWKTReader reader;
+  struct GeoArrowVisitor v;
+  struct GeoArrowInstrumentation instrumentation;
+  ASSERT_EQ(GeoArrowWKTReaderInit(&reader), GEOARROW_OK);
+  GeoArrowVisitorInitVoid(&v);
+  if (GeoArrowWKTReaderGetInstrumentation(&reader, &instrumentation) == ENOTSUP) {
+    EXPECT_EQ(instrumentation.n_calls, 0);
+    GeoArrowWKTReaderReset(&reader);
+    GTEST_SKIP() << "Built without GEOARROW_INSTRUMENTATION";
+  }
+
+  struct GeoArrowStringView src = {wkt.data(), (int64_t)wkt.size()};
+  ASSERT_EQ(GeoArrowWKTReaderVisit(&reader, src, &v), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowWKTReaderVisit(&reader, src, &v), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowWKTReaderGetInstrumentation(&reader, &instrumentation), GEOARROW_OK);
+  GeoArrowWKTReaderReset(&reader);
+
+  EXPECT_EQ(instrumentation.n_calls, 2);
+  EXPECT_EQ(instrumentation.n_features, 2);
+  EXPECT_EQ(instrumentation.n_coords, 2 * 100);
+  EXPECT_EQ(instrumentation.n_bytes_in, 2 * (int64_t)wkt.size());
+  EXPECT_EQ(instrumentation.n_chunks_flushed, 4);
+  EXPECT_GE(instrumentation.elapsed_ns, 0);
+}
@@ -6,6 +6,9 @@
 
 #include "geoarrow.h"
 
+#include "instrumentation.h"
+#include "writer_buffers.h"
+
 // Using ryu for double -> char* is ~5x faster and is not locale dependent
 // could also use to_chars() if C++17 is available
 // https://github.com/paleolimbot/geoarrow/tree/58ccd0a9606f3f6e51f200e143d8c7672782e30a/src/ryu
@@ -23,6 +26,9 @@ struct WKTWriterPrivate {
   struct ArrowBitmap validity;
   struct ArrowBuffer offsets;
   struct ArrowBuffer values;
+  struct ArrowBufferAllocator allocator;
+  int retain_buffers;
+  struct GeoArrowInstrumentation instrumentation;
   enum GeoArrowGeometryType geometry_type[32];
   int64_t i[32];
   int32_t level;
@@ -55,18 +61,32 @@ static int feat_start_wkt(struct GeoArrowVisitor* v) {
   struct WKTWriterPrivate* private = (struct WKTWriterPrivate*)v->private_data;
   private->level = -1;
   private->length++;
+  GEOARROW_INSTRUMENT(private->instrumentation.n_features++);
   return ArrowBufferAppendInt32(&private->offsets, private->values.size_bytes);
 }
 
 static int null_feat_wkt(struct GeoArrowVisitor* v) {
   struct WKTWriterPrivate* private = (struct WKTWriterPrivate*)v->private_data;
-  if (private->validity.buffer.data == NULL && private->length > 0) {
-    NANOARROW_RETURN_NOT_OK(ArrowBitmapReserve(&private->validity, private->length));
-    ArrowBitmapAppendUnsafe(&private->validity, 1, private->length - 1);
+  if (private->length == 0) {
+    return EINVAL;
+  }
+
+  // The validity bitmap is only written up to the last null: the valid features
+  // before this one are filled in at once here and the ones after the last null when
+  // the array is finished
+  int64_t n_valid = private->length - 1 - private->validity.size_bits;
+  if (n_valid < 0) {
+    return GEOARROW_OK;
   }
 
+  NANOARROW_RETURN_NOT_OK(ArrowBitmapReserve(&private->validity, n_valid + 1));
+  if (n_valid > 0) {
+    ArrowBitmapAppendUnsafe(&private->validity, 1, n_valid);
+  }
+
+  ArrowBitmapAppendUnsafe(&private->validity, 0, 1);
   private->null_count++;
-  return ArrowBitmapAppend(&private->validity, 0, 1);
+  return GEOARROW_OK;
 }
 
 static int geom_start_wkt(struct GeoArrowVisitor* v,
@@ -152,6 +172,7 @@ static int coords_wkt(struct GeoArrowVisitor* v, const struct GeoArrowCoordView*
 
   struct WKTWriterPrivate* private = (struct WKTWriterPrivate*)v->private_data;
   NANOARROW_RETURN_NOT_OK(WKTWriterCheckLevel(private));
+  GEOARROW_INSTRUMENT(private->instrumentation.n_coords += n_coords);
 
   int64_t max_chars_needed = (n_coords * 2) +  // space + comma after coordinate
                              (n_coords * (n_dims - 1)) +  // spaces between ordinates
@@ -171,19 +192,19 @@ static int coords_wkt(struct GeoArrowVisitor* v, const struct GeoArrowCoordView*
     ArrowBufferAppendUnsafe(&private->values, "(", 1);
   }
 
-  WKTWriterWriteDoubleUnsafe(private, coords->values[0][0]);
+  WKTWriterWriteDoubleUnsafe(private, GeoArrowCoordViewValueUnaligned(coords, 0, 0));
   for (int32_t j = 1; j < n_dims; j++) {
     ArrowBufferAppendUnsafe(&private->values, " ", 1);
-    WKTWriterWriteDoubleUnsafe(private, coords->values[j][0]);
+    WKTWriterWriteDoubleUnsafe(private, GeoArrowCoordViewValueUnaligned(coords, 0, j));
   }
 
   // Write the remaining coordinates (which all have leading commas)
   for (int64_t i = 1; i < n_coords; i++) {
     ArrowBufferAppendUnsafe(&private->values, ", ", 2);
-    WKTWriterWriteDoubleUnsafe(private, coords->values[0][i * coords->coords_stride]);
+    WKTWriterWriteDoubleUnsafe(private, GeoArrowCoordViewValueUnaligned(coords, i, 0));
     for (int32_t j = 1; j < n_dims; j++) {
       ArrowBufferAppendUnsafe(&private->values, " ", 1);
-      WKTWriterWriteDoubleUnsafe(private, coords->values[j][i * coords->coords_stride]);
+      WKTWriterWriteDoubleUnsafe(private, GeoArrowCoordViewValueUnaligned(coords, i, j));
     }
   }
 
@@ -235,6 +256,9 @@ GeoArrowErrorCode GeoArrowWKTWriterInit(struct GeoArrowWKTWriter* writer) {
   ArrowBitmapInit(&private->validity);
   ArrowBufferInit(&private->offsets);
   ArrowBufferInit(&private->values);
+  private->allocator = ArrowBufferAllocatorDefault();
+  private->retain_buffers = 0;
+  memset(&private->instrumentation, 0, sizeof(struct GeoArrowInstrumentation));
   writer->significant_digits = 16;
   private->significant_digits = 16;
   writer->use_flat_multipoint = 1;
@@ -262,18 +286,44 @@ void GeoArrowWKTWriterInitVisitor(struct GeoArrowWKTWriter* writer,
   v->geom_end = &geom_end_wkt;
 }
 
-GeoArrowErrorCode GeoArrowWKTWriterFinish(struct GeoArrowWKTWriter* writer,
-                                          struct ArrowArray* array,
-                                          struct GeoArrowError* error) {
+GeoArrowErrorCode GeoArrowWKTWriterSetAllocator(
+    struct GeoArrowWKTWriter* writer, struct GeoArrowBufferAllocator allocator) {
   struct WKTWriterPrivate* private = (struct WKTWriterPrivate*)writer->private_data;
-  array->release = NULL;
+  if (private->validity.buffer.data != NULL || private->offsets.data != NULL ||
+      private->values.data != NULL) {
+    return EINVAL;
+  }
+
+  private->allocator.reallocate = allocator.reallocate;
+  private->allocator.free = allocator.free;
+  private->allocator.private_data = allocator.private_data;
+  ArrowBufferSetAllocator(&private->validity.buffer, private->allocator);
+  ArrowBufferSetAllocator(&private->offsets, private->allocator);
+  ArrowBufferSetAllocator(&private->values, private->allocator);
+  return GEOARROW_OK;
+}
 
+void GeoArrowWKTWriterSetRetainBuffers(struct GeoArrowWKTWriter* writer,
+                                      int retain_buffers) {
+  struct WKTWriterPrivate* private = (struct WKTWriterPrivate*)writer->private_data;
+  private->retain_buffers = retain_buffers;
+}
+
+static GeoArrowErrorCode WKTWriterFinishArray(struct WKTWriterPrivate* private,
+                                             struct ArrowArray* array,
+                                             struct GeoArrowError* error) {
   NANOARROW_RETURN_NOT_OK(
       ArrowBufferAppendInt32(&private->offsets, private->values.size_bytes));
+  if (private->null_count > 0 && private->validity.size_bits < private->length) {
+    NANOARROW_RETURN_NOT_OK(ArrowBitmapAppend(
+        &private->validity, 1, private->length - private->validity.size_bits));
+  }
+
   NANOARROW_RETURN_NOT_OK(ArrowArrayInit(array, private->storage_type));
-  ArrowArraySetValidityBitmap(array, &private->validity);
-  NANOARROW_RETURN_NOT_OK(ArrowArraySetBuffer(array, 1, &private->offsets));
-  NANOARROW_RETURN_NOT_OK(ArrowArraySetBuffer(array, 2, &private->values));
+  NANOARROW_RETURN_NOT_OK(GeoArrowWriterSetBuffers(&private->validity, &private->offsets,
+                                                   &private->values, private->allocator,
+                                                   private->retain_buffers, array));
+
   array->length = private->length;
   array->null_count = private->null_count;
   private->length = 0;
@@ -281,6 +331,45 @@ GeoArrowErrorCode GeoArrowWKTWriterFinish(struct GeoArrowWKTWriter* writer,
   return ArrowArrayFinishBuilding(array, (struct ArrowError*)error);
 }
 
+GeoArrowErrorCode GeoArrowWKTWriterFinish(struct GeoArrowWKTWriter* writer,
+                                          struct ArrowArray* array,
+                                          struct GeoArrowError* error) {
+  struct WKTWriterPrivate* private = (struct WKTWriterPrivate*)writer->private_data;
+  array->release = NULL;
+
+  int64_t n_rows = private->length;
+  int64_t n_bytes = private->values.size_bytes;
+  GEOARROW_INSTRUMENT(int64_t start_ns = GeoArrowInstrumentationNowNs());
+
+  struct GeoArrowTracer* tracer = GeoArrowGetTracer();
+  if (tracer != NULL) {
+    tracer->begin(tracer, GEOARROW_TRACE_EVENT_WKT_WRITER_FINISH);
+  }
+
+  int result = WKTWriterFinishArray(private, array, error);
+
+  GEOARROW_INSTRUMENT(private->instrumentation.n_bytes_out += n_bytes);
+  GEOARROW_INSTRUMENT(GeoArrowInstrumentationEnd(&private->instrumentation, start_ns));
+
+  if (tracer != NULL) {
+    tracer->end(tracer, GEOARROW_TRACE_EVENT_WKT_WRITER_FINISH, n_rows, n_bytes, result);
+  }
+
+  return result;
+}
+
+GeoArrowErrorCode GeoArrowWKTWriterGetInstrumentation(
+    struct GeoArrowWKTWriter* writer, struct GeoArrowInstrumentation* out) {
+#if defined(GEOARROW_INSTRUMENTATION)
+  struct WKTWriterPrivate* private = (struct WKTWriterPrivate*)writer->private_data;
+  memcpy(out, &private->instrumentation, sizeof(struct GeoArrowInstrumentation));
+  return GEOARROW_OK;
+#else
+  memset(out, 0, sizeof(struct GeoArrowInstrumentation));
+  return ENOTSUP;
+#endif
+}
+
 void GeoArrowWKTWriterReset(struct GeoArrowWKTWriter* writer) {
   struct WKTWriterPrivate* private = (struct WKTWriterPrivate*)writer->private_data;
   ArrowBitmapReset(&private->validity);
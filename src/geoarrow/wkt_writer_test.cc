@@ -98,6 +98,43 @@ TEST(WKTWriterTest, WKTWriterTestOneValidOneNull) {
   GeoArrowWKTWriterReset(&writer);
 }
 
+TEST(WKTWriterTest, WKTWriterTestNullThenValid) {
+  struct GeoArrowWKTWriter writer;
+  struct GeoArrowVisitor v;
+  GeoArrowWKTWriterInit(&writer);
+  GeoArrowWKTWriterInitVisitor(&writer, &v);
+
+  EXPECT_EQ(v.feat_start(&v), GEOARROW_OK);
+  EXPECT_EQ(v.null_feat(&v), GEOARROW_OK);
+  EXPECT_EQ(v.feat_end(&v), GEOARROW_OK);
+
+  for (int i = 0; i < 9; i++) {
+    EXPECT_EQ(v.feat_start(&v), GEOARROW_OK);
+    EXPECT_EQ(v.geom_start(&v, GEOARROW_GEOMETRY_TYPE_POINT, GEOARROW_DIMENSIONS_XY),
+              GEOARROW_OK);
+    EXPECT_EQ(v.geom_end(&v), GEOARROW_OK);
+    EXPECT_EQ(v.feat_end(&v), GEOARROW_OK);
+  }
+
+  struct ArrowArray array;
+  EXPECT_EQ(GeoArrowWKTWriterFinish(&writer, &array, nullptr), GEOARROW_OK);
+  EXPECT_EQ(array.length, 10);
+  EXPECT_EQ(array.null_count, 1);
+
+  struct ArrowArrayView view;
+  ArrowArrayViewInit(&view, NANOARROW_TYPE_STRING);
+  ASSERT_EQ(ArrowArrayViewSetArray(&view, &array, nullptr), GEOARROW_OK);
+
+  EXPECT_TRUE(ArrowArrayViewIsNull(&view, 0));
+  for (int64_t i = 1; i < 10; i++) {
+    EXPECT_FALSE(ArrowArrayViewIsNull(&view, i));
+  }
+
+  ArrowArrayViewReset(&view);
+  array.release(&array);
+  GeoArrowWKTWriterReset(&writer);
+}
+
 TEST(WKTWriterTest, WKTWriterTestErrors) {
   struct GeoArrowWKTWriter writer;
   struct GeoArrowVisitor v;
@@ -753,3 +790,129 @@ TEST(WKTWriterTest, WKTWriterTestVeryLongCoords) {
   array.release(&array);
   GeoArrowWKTWriterReset(&writer);
 }
+
+static uint8_t* CountingReallocate(struct ArrowBufferAllocator* allocator, uint8_t* ptr,
+                                   int64_t old_size, int64_t new_size) {
+  (*reinterpret_cast<int64_t*>(allocator->private_data))++;
+  return reinterpret_cast<uint8_t*>(realloc(ptr, new_size));
+}
+
+static void CountingFree(struct ArrowBufferAllocator* allocator, uint8_t* ptr,
+                         int64_t size) {
+  free(ptr);
+}
+
+static std::vector<std::string> WriteWKTBatch(struct GeoArrowWKTWriter* writer,
+                                              const std::vector<std::string>& wkts,
+                                              int64_t* null_count) {
+  struct GeoArrowVisitor v;
+  struct GeoArrowWKTReader reader;
+  GeoArrowWKTWriterInitVisitor(writer, &v);
+  GeoArrowWKTReaderInit(&reader);
+  for (const auto& wkt : wkts) {
+    if (wkt == "") {
+      EXPECT_EQ(v.feat_start(&v), GEOARROW_OK);
+      EXPECT_EQ(v.null_feat(&v), GEOARROW_OK);
+      EXPECT_EQ(v.feat_end(&v), GEOARROW_OK);
+    } else {
+      struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+      EXPECT_EQ(GeoArrowWKTReaderVisit(&reader, item, &v), GEOARROW_OK);
+    }
+  }
+
+  GeoArrowWKTReaderReset(&reader);
+
+  struct ArrowArray array;
+  EXPECT_EQ(GeoArrowWKTWriterFinish(writer, &array, nullptr), GEOARROW_OK);
+  *null_count = array.null_count;
+
+  struct ArrowArrayView view;
+  ArrowArrayViewInit(&view, NANOARROW_TYPE_STRING);
+  EXPECT_EQ(ArrowArrayViewSetArray(&view, &array, nullptr), GEOARROW_OK);
+  std::vector<std::string> out;
+  for (int64_t i = 0; i < array.length; i++) {
+    if (ArrowArrayViewIsNull(&view, i)) {
+      out.push_back("");
+    } else {
+      struct ArrowStringView value = ArrowArrayViewGetStringUnsafe(&view, i);
+      out.push_back(std::string(value.data, value.n_bytes));
+    }
+  }
+
+  ArrowArrayViewReset(&view);
+  array.release(&array);
+  return out;
+}
+
+TEST(WKTWriterTest, WKTWriterTestRetainBuffers) {
+  int64_t n_reallocations = 0;
+  struct GeoArrowBufferAllocator allocator = {&CountingReallocate, &CountingFree,
+                                              &n_reallocations};
+
+  struct GeoArrowWKTWriter writer;
+  ASSERT_EQ(GeoArrowWKTWriterInit(&writer), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowWKTWriterSetAllocator(&writer, allocator), GEOARROW_OK);
+  GeoArrowWKTWriterSetRetainBuffers(&writer, 1);
+
+  std::vector<std::string> batch = {"POINT (0 1)", "", "LINESTRING (0 1, 2 3)"};
+  int64_t null_count;
+  EXPECT_EQ(WriteWKTBatch(&writer, batch, &null_count), batch);
+  EXPECT_EQ(null_count, 1);
+
+  // The same batch again only allocates the output: one each for the validity,
+  // offset and data buffers
+  n_reallocations = 0;
+  EXPECT_EQ(WriteWKTBatch(&writer, batch, &null_count), batch);
+  EXPECT_EQ(null_count, 1);
+  EXPECT_EQ(n_reallocations, 3);
+
+  // A batch without nulls doesn't get a validity buffer
+  n_reallocations = 0;
+  batch = {"POINT (2 3)"};
+  EXPECT_EQ(WriteWKTBatch(&writer, batch, &null_count), batch);
+  EXPECT_EQ(null_count, 0);
+  EXPECT_EQ(n_reallocations, 2);
+
+  GeoArrowWKTWriterReset(&writer);
+}
+
+TEST(WKTWriterTest, WKTWriterTestInstrumentation) {
+  struct GeoArrowWKTWriter writer;
+  struct GeoArrowVisitor v;
+  struct GeoArrowInstrumentation instrumentation;
+  ASSERT_EQ(GeoArrowWKTWriterInit(&writer), GEOARROW_OK);
+  if (GeoArrowWKTWriterGetInstrumentation(&writer, &instrumentation) == ENOTSUP) {
+    EXPECT_EQ(instrumentation.n_calls, 0);
+    GeoArrowWKTWriterReset(&writer);
+    GTEST_SKIP() << "Built without GEOARROW_INSTRUMENTATION";
+  }
+
+  GeoArrowWKTWriterInitVisitor(&writer, &v);
+  ASSERT_EQ(v.feat_start(&v), GEOARROW_OK);
+  ASSERT_EQ(v.null_feat(&v), GEOARROW_OK);
+  ASSERT_EQ(v.feat_end(&v), GEOARROW_OK);
+
+  struct GeoArrowWKTReader wkt_reader;
+  GeoArrowWKTReaderInit(&wkt_reader);
+  std::string wkts[2] = {"POINT (0 1)", "LINESTRING (0 1, 2 3)"};
+  for (const auto& wkt : wkts) {
+    struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+    ASSERT_EQ(GeoArrowWKTReaderVisit(&wkt_reader, item, &v), GEOARROW_OK);
+  }
+  GeoArrowWKTReaderReset(&wkt_reader);
+
+  struct ArrowArray array;
+  ASSERT_EQ(GeoArrowWKTWriterFinish(&writer, &array, nullptr), GEOARROW_OK);
+  ASSERT_EQ(GeoArrowWKTWriterGetInstrumentation(&writer, &instrumentation),
+            GEOARROW_OK);
+  GeoArrowWKTWriterReset(&writer);
+  array.release(&array);
+
+  // Null features are counted as features
+  EXPECT_EQ(instrumentation.n_calls, 1);
+  EXPECT_EQ(instrumentation.n_features, 3);
+  EXPECT_EQ(instrumentation.n_coords, 3);
+  EXPECT_EQ(instrumentation.n_bytes_out,
+            static_cast<int64_t>(wkts[0].size() + wkts[1].size()));
+  EXPECT_GE(instrumentation.elapsed_ns, 0);
+}
@@ -3,6 +3,7 @@
 
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "geoarrow.h"
@@ -258,3 +259,115 @@ static inline struct GeoArrowBufferView MakeBufferView(const std::vector<T>& v)
   buffer_view.n_bytes = v.size() * sizeof(T);
   return buffer_view;
 }
+
+// Visits each of wkts with v, where an empty string is visited as a null feature
+static inline void VisitWKT(struct GeoArrowVisitor* v,
+                            const std::vector<std::string>& wkts) {
+  struct GeoArrowWKTReader reader;
+  struct GeoArrowError error;
+  struct GeoArrowError* previous_error = v->error;
+  GeoArrowWKTReaderInit(&reader);
+  error.message[0] = '\0';
+  v->error = &error;
+
+  int result = GEOARROW_OK;
+  for (const auto& wkt : wkts) {
+    if (wkt == "") {
+      result = v->feat_start(v);
+      if (result == GEOARROW_OK) {
+        result = v->null_feat(v);
+      }
+      if (result == GEOARROW_OK) {
+        result = v->feat_end(v);
+      }
+    } else {
+      struct GeoArrowStringView item = {wkt.data(), (int64_t)wkt.size()};
+      result = GeoArrowWKTReaderVisit(&reader, item, v);
+    }
+
+    if (result != GEOARROW_OK) {
+      break;
+    }
+  }
+
+  GeoArrowWKTReaderReset(&reader);
+  v->error = previous_error;
+  if (result != GEOARROW_OK) {
+    throw WKXTestException("GeoArrowWKTReaderVisit", result, error.message);
+  }
+}
+
+// Appends wkts to builder (see VisitWKT())
+static inline void BuildFromWKT(struct GeoArrowBuilder* builder,
+                                const std::vector<std::string>& wkts) {
+  struct GeoArrowVisitor v;
+  GeoArrowBuilderInitVisitor(builder, &v);
+  VisitWKT(&v, wkts);
+}
+
+// Writes wkts (see VisitWKT()) to an array of type, allocating its buffers with
+// allocator if it is not nullptr
+static inline void ArrayFromWKT(enum GeoArrowType type,
+                                const std::vector<std::string>& wkts,
+                                struct ArrowArray* array,
+                                struct GeoArrowBufferAllocator* allocator = nullptr) {
+  struct GeoArrowArrayWriter writer;
+  struct GeoArrowVisitor v;
+  struct GeoArrowError error;
+  error.message[0] = '\0';
+  int result = GeoArrowArrayWriterInitFromType(&writer, type);
+  if (result != GEOARROW_OK) {
+    throw WKXTestException("GeoArrowArrayWriterInitFromType", result, "");
+  }
+
+  if (allocator != nullptr) {
+    result = GeoArrowArrayWriterSetAllocator(&writer, *allocator);
+  }
+
+  if (result == GEOARROW_OK) {
+    result = GeoArrowArrayWriterInitVisitor(&writer, &v);
+  }
+
+  if (result != GEOARROW_OK) {
+    GeoArrowArrayWriterReset(&writer);
+    throw WKXTestException("GeoArrowArrayWriterInitVisitor", result, "");
+  }
+
+  try {
+    VisitWKT(&v, wkts);
+  } catch (...) {
+    GeoArrowArrayWriterReset(&writer);
+    throw;
+  }
+
+  result = GeoArrowArrayWriterFinish(&writer, array, &error);
+  GeoArrowArrayWriterReset(&writer);
+  if (result != GEOARROW_OK) {
+    throw WKXTestException("GeoArrowArrayWriterFinish", result, error.message);
+  }
+}
+
+// Visits all of array (a native array of type) and returns its features as WKT
+static inline std::vector<std::string> ArrayToWKT(enum GeoArrowType type,
+                                                  struct ArrowArray* array) {
+  struct GeoArrowArrayView array_view;
+  struct GeoArrowError error;
+  error.message[0] = '\0';
+  int result = GeoArrowArrayViewInitFromType(&array_view, type);
+  if (result == GEOARROW_OK) {
+    result = GeoArrowArrayViewSetArray(&array_view, array, &error);
+  }
+
+  if (result != GEOARROW_OK) {
+    throw WKXTestException("GeoArrowArrayViewSetArray", result, error.message);
+  }
+
+  WKXTester tester;
+  result = GeoArrowArrayViewVisit(&array_view, 0, array->length, tester.WKTVisitor());
+  if (result != GEOARROW_OK) {
+    throw WKXTestException("GeoArrowArrayViewVisit", result,
+                           tester.LastErrorMessage().c_str());
+  }
+
+  return tester.WKTValues("<null value>");
+}
@@ -0,0 +1,66 @@
+
+#ifndef GEOARROW_WRITER_BUFFERS_H_INCLUDED
+#define GEOARROW_WRITER_BUFFERS_H_INCLUDED
+
+// Not part of the public API: shared by the WKB and WKT writers, which both build a
+// validity bitmap, offsets and values and hand them to an array on finish
+
+#include "nanoarrow.h"
+
+#include "geoarrow.h"
+
+// Copies the writer's buffers into array (allocating exactly what is needed) and
+// empties them without giving back their capacity
+static inline GeoArrowErrorCode GeoArrowWriterCopyBuffers(
+    struct ArrowBitmap* validity, struct ArrowBuffer* offsets, struct ArrowBuffer* values,
+    struct ArrowBufferAllocator allocator, struct ArrowArray* array) {
+  // The validity bitmap is only filled in once there is a null
+  if (validity->size_bits > 0) {
+    struct ArrowBitmap* out = ArrowArrayValidityBitmap(array);
+    ArrowBufferSetAllocator(&out->buffer, allocator);
+    NANOARROW_RETURN_NOT_OK(ArrowBufferAppend(&out->buffer, validity->buffer.data,
+                                              validity->buffer.size_bytes));
+    out->size_bits = validity->size_bits;
+  }
+
+  struct ArrowBuffer* buffers[2] = {offsets, values};
+  for (int64_t i = 0; i < 2; i++) {
+    struct ArrowBuffer* out = ArrowArrayBuffer(array, 1 + i);
+    ArrowBufferSetAllocator(out, allocator);
+    if (buffers[i]->size_bytes > 0) {
+      NANOARROW_RETURN_NOT_OK(
+          ArrowBufferAppend(out, buffers[i]->data, buffers[i]->size_bytes));
+    }
+  }
+
+  validity->buffer.size_bytes = 0;
+  validity->size_bits = 0;
+  offsets->size_bytes = 0;
+  values->size_bytes = 0;
+  return GEOARROW_OK;
+}
+
+// Gives the writer's buffers to array, or copies them if retain_buffers is non-zero so
+// that the writer keeps their capacity for the next batch. Releases array on error.
+static inline GeoArrowErrorCode GeoArrowWriterSetBuffers(
+    struct ArrowBitmap* validity, struct ArrowBuffer* offsets, struct ArrowBuffer* values,
+    struct ArrowBufferAllocator allocator, int retain_buffers, struct ArrowArray* array) {
+  int result;
+  if (retain_buffers) {
+    result = GeoArrowWriterCopyBuffers(validity, offsets, values, allocator, array);
+  } else {
+    ArrowArraySetValidityBitmap(array, validity);
+    result = ArrowArraySetBuffer(array, 1, offsets);
+    if (result == GEOARROW_OK) {
+      result = ArrowArraySetBuffer(array, 2, values);
+    }
+  }
+
+  if (result != GEOARROW_OK) {
+    array->release(array);
+  }
+
+  return result;
+}
+
+#endif